@@ -0,0 +1,288 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/atomic.h"
+#include "common/ptr.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+#include "audio/audiostream.h"
+#include "audio/decode_ahead.h"
+
+namespace Audio {
+
+enum {
+	/** Interval of the timer callback, in microseconds. */
+	kDecodeAheadInterval = 10000,
+	/** Time the timer callback may spend decoding per call, in microseconds. */
+	kDecodeAheadBudget = 2000,
+	/** Size of the ring buffer of each stream, in samples. Must be a power of two. */
+	kDecodeAheadBufferSize = 16384,
+	/** Do not bother the decoder for less than this number of samples. */
+	kDecodeAheadMinChunk = 1024,
+	/** Do not ask the decoder for more than this number of samples at once. */
+	kDecodeAheadMaxChunk = 4096
+};
+
+/**
+ * Stream returned by DecodeAheadWorker::wrapStream().
+ *
+ * The ring buffer has a single producer and a single consumer. The consumer
+ * is the mixer, calling readBuffer(). The producer is whoever holds
+ * _streamMutex, which also guards all accesses to the wrapped stream: usually
+ * the worker, but readBuffer() takes over if the buffer runs dry.
+ */
+class DecodeAheadStream : public AudioStream {
+public:
+	DecodeAheadStream(DecodeAheadWorker *worker, AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+	~DecodeAheadStream();
+
+	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool isStereo() const { return _isStereo; }
+	virtual int getRate() const { return _rate; }
+	virtual bool endOfData() const;
+	virtual bool endOfStream() const;
+
+	/**
+	 * Decode a chunk into the ring buffer from the timer callback. Returns
+	 * whether there is room for more.
+	 */
+	bool decodeAhead();
+
+	/** Number of frames in the ring buffer. */
+	uint32 getQueuedFrames() const;
+
+private:
+	/** Copy up to @p numSamples samples out of the ring buffer. */
+	int readFromRing(int16 *buffer, int numSamples);
+	/** Decode a chunk into the ring buffer. Needs _streamMutex. */
+	bool decodeChunk();
+	/** Record the end of data state of the wrapped stream. Needs _streamMutex. */
+	void updateEndState();
+
+	DecodeAheadWorker *_worker;
+	Common::DisposablePtr<AudioStream> _stream;
+	const bool _isStereo;
+	const int _rate;
+
+	int16 *_ring;
+	volatile uint32 _readPos;
+	volatile uint32 _writePos;
+
+	Common::Mutex _streamMutex;
+	volatile bool _streamEndOfData;
+	volatile bool _streamEndOfStream;
+};
+
+DecodeAheadStream::DecodeAheadStream(DecodeAheadWorker *worker, AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse)
+	: _worker(worker), _stream(stream, disposeAfterUse), _isStereo(stream->isStereo()), _rate(stream->getRate()),
+	  _readPos(0), _writePos(0), _streamEndOfData(false), _streamEndOfStream(false) {
+	_ring = new int16[kDecodeAheadBufferSize];
+	updateEndState();
+
+	_worker->registerStream(this);
+}
+
+DecodeAheadStream::~DecodeAheadStream() {
+	// Once we are unregistered, the timer callback will not touch us anymore
+	_worker->unregisterStream(this);
+	delete[] _ring;
+}
+
+int DecodeAheadStream::readFromRing(int16 *buffer, int numSamples) {
+	const uint32 readPos = _readPos;
+	const uint32 available = _writePos - readPos;
+	Common::memoryBarrier();
+
+	int samples = MIN<uint32>(numSamples, available);
+	const uint32 offset = readPos & (kDecodeAheadBufferSize - 1);
+	const int firstPart = MIN<int>(samples, kDecodeAheadBufferSize - offset);
+	memcpy(buffer, _ring + offset, firstPart * sizeof(int16));
+	memcpy(buffer + firstPart, _ring, (samples - firstPart) * sizeof(int16));
+
+	Common::memoryBarrier();
+	_readPos = readPos + samples;
+	return samples;
+}
+
+bool DecodeAheadStream::decodeChunk() {
+	if (_streamEndOfData)
+		return false;
+
+	const uint32 writePos = _writePos;
+	const uint32 space = kDecodeAheadBufferSize - (writePos - _readPos);
+	if (space < kDecodeAheadMinChunk)
+		return false;
+
+	// Do not overwrite samples the mixer has not finished copying yet
+	Common::memoryBarrier();
+
+	// Only decode into the contiguous part of the buffer; the buffer size
+	// and the chunk size are even, so this does not split stereo sample
+	// pairs.
+	const uint32 offset = writePos & (kDecodeAheadBufferSize - 1);
+	const int len = MIN<uint32>(MIN<uint32>(space, kDecodeAheadBufferSize - offset), kDecodeAheadMaxChunk);
+	const int samples = _stream->readBuffer(_ring + offset, len);
+
+	if (samples > 0) {
+		Common::memoryBarrier();
+		_writePos = writePos + samples;
+	}
+
+	updateEndState();
+	return samples > 0 && !_streamEndOfData && space - samples >= kDecodeAheadMinChunk;
+}
+
+void DecodeAheadStream::updateEndState() {
+	// Set after publishing the samples, so that a consumer seeing the end
+	// flag also sees all samples which were decoded before.
+	Common::memoryBarrier();
+	_streamEndOfStream = _stream->endOfStream();
+	_streamEndOfData = _stream->endOfData();
+}
+
+bool DecodeAheadStream::decodeAhead() {
+	Common::StackLock lock(_streamMutex);
+	return decodeChunk();
+}
+
+int DecodeAheadStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = readFromRing(buffer, numSamples);
+
+	// The worker did not keep up. Decode the rest ourselves. If the worker
+	// is busy with this very stream right now, wait for it: it only decodes
+	// a single chunk at a time, and that is better than a gap of silence.
+	if (samples < numSamples && !_streamEndOfData) {
+		Common::StackLock lock(_streamMutex);
+
+		// The worker might have produced more samples before we got the lock
+		samples += readFromRing(buffer + samples, numSamples - samples);
+
+		if (samples < numSamples && !_streamEndOfData) {
+			const int decoded = _stream->readBuffer(buffer + samples, numSamples - samples);
+			if (decoded > 0)
+				samples += decoded;
+			updateEndState();
+		}
+	}
+
+	return samples;
+}
+
+uint32 DecodeAheadStream::getQueuedFrames() const {
+	const uint32 samples = _writePos - _readPos;
+	return _isStereo ? samples / 2 : samples;
+}
+
+bool DecodeAheadStream::endOfData() const {
+	const bool streamEndOfData = _streamEndOfData;
+	Common::memoryBarrier();
+	return streamEndOfData && _readPos == _writePos;
+}
+
+bool DecodeAheadStream::endOfStream() const {
+	const bool streamEndOfStream = _streamEndOfStream;
+	Common::memoryBarrier();
+	return streamEndOfStream && _readPos == _writePos;
+}
+
+#pragma mark -
+
+DecodeAheadWorker::DecodeAheadWorker() : _nextStream(0) {
+	g_system->getTimerManager()->installTimerProc(&timerProc, kDecodeAheadInterval, this, "AudioDecodeAhead");
+}
+
+DecodeAheadWorker::~DecodeAheadWorker() {
+	g_system->getTimerManager()->removeTimerProc(&timerProc);
+	assert(_streams.empty());
+}
+
+bool DecodeAheadWorker::canDecodeAhead(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	// Streams which are kept by their creator might be queried or modified
+	// by it while playing, and queuing or synthesizer streams depend on the
+	// engine feeding them in time. Only decoders of sound data and the
+	// looping wrappers around them qualify.
+	if (disposeAfterUse != DisposeAfterUse::YES)
+		return false;
+
+	return dynamic_cast<RewindableAudioStream *>(stream) != 0
+		|| dynamic_cast<LoopingAudioStream *>(stream) != 0
+		|| dynamic_cast<SubLoopingAudioStream *>(stream) != 0;
+}
+
+AudioStream *DecodeAheadWorker::wrapStream(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	return new DecodeAheadStream(this, stream, disposeAfterUse);
+}
+
+uint32 DecodeAheadWorker::getQueuedFrames(const AudioStream *stream) {
+	const DecodeAheadStream *decodeAheadStream = dynamic_cast<const DecodeAheadStream *>(stream);
+	return decodeAheadStream ? decodeAheadStream->getQueuedFrames() : 0;
+}
+
+void DecodeAheadWorker::timerProc(void *refCon) {
+	((DecodeAheadWorker *)refCon)->decodeAhead();
+}
+
+void DecodeAheadWorker::decodeAhead() {
+	Common::StackLock lock(_mutex);
+
+	// The timer thread also runs the engine and MIDI timer callbacks, so
+	// only decode for a limited time per call, a chunk of each stream at a
+	// time. Whatever is still missing when the mixer needs it is decoded by
+	// the mixer itself.
+	const uint64 deadline = g_system->getMicros() + kDecodeAheadBudget;
+	bool more = true;
+	while (more && !_streams.empty()) {
+		more = false;
+		for (uint i = 0; i < _streams.size(); i++) {
+			// Start where the previous call ran out of time, so every
+			// stream gets its turn.
+			const uint index = (_nextStream + i) % _streams.size();
+			if (_streams[index]->decodeAhead())
+				more = true;
+
+			if (g_system->getMicros() >= deadline) {
+				_nextStream = index + 1;
+				return;
+			}
+		}
+	}
+}
+
+void DecodeAheadWorker::registerStream(DecodeAheadStream *stream) {
+	Common::StackLock lock(_mutex);
+	_streams.push_back(stream);
+}
+
+void DecodeAheadWorker::unregisterStream(DecodeAheadStream *stream) {
+	Common::StackLock lock(_mutex);
+
+	for (Common::Array<DecodeAheadStream *>::iterator i = _streams.begin(); i != _streams.end(); ++i) {
+		if (*i == stream) {
+			_streams.erase(i);
+			break;
+		}
+	}
+}
+
+} // End of namespace Audio
@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_DECODE_AHEAD_H
+#define AUDIO_DECODE_AHEAD_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/types.h"
+
+namespace Audio {
+
+class AudioStream;
+class DecodeAheadStream;
+
+/**
+ * Decodes audio streams ahead of the mixer.
+ *
+ * Streams wrapped by this class are read from a timer callback into a ring
+ * buffer, which the mixer then only copies from. The timer callback only
+ * spends a limited time decoding per call, to not hold up the other timer
+ * callbacks. This keeps the expensive
+ * codec work (MP3, Vorbis, FLAC, ...) out of the audio callback. If the
+ * timer falls behind, the mixer decodes the missing samples itself, like it
+ * would without decoding ahead.
+ *
+ * Only streams which are not accessed by anyone else once they are passed
+ * to the mixer may be wrapped, see canDecodeAhead().
+ */
+class DecodeAheadWorker {
+public:
+	DecodeAheadWorker();
+	~DecodeAheadWorker();
+
+	/**
+	 * Returns whether @p stream is a plain decoder stream which is safe to
+	 * be read from the timer thread.
+	 */
+	static bool canDecodeAhead(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+
+	/**
+	 * Wrap @p stream in a stream which is decoded ahead by this worker. The
+	 * returned stream must be destroyed before the worker.
+	 */
+	AudioStream *wrapStream(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+
+	/**
+	 * Return the number of frames decoded ahead for @p stream which were
+	 * not read yet, or 0 if it was not returned by wrapStream(). This does
+	 * not wait for the worker, and may be called from any thread as long
+	 * as the stream exists.
+	 */
+	static uint32 getQueuedFrames(const AudioStream *stream);
+
+private:
+	friend class DecodeAheadStream;
+
+	static void timerProc(void *refCon);
+	void decodeAhead();
+
+	void registerStream(DecodeAheadStream *stream);
+	void unregisterStream(DecodeAheadStream *stream);
+
+	Common::Mutex _mutex;
+	Common::Array<DecodeAheadStream *> _streams;
+	/** Stream to decode first by the next timer callback. */
+	uint _nextStream;
+};
+
+} // End of namespace Audio
+
+#endif
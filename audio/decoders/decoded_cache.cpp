@@ -0,0 +1,341 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/config-manager.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+#include "common/textconsole.h"
+
+#include "audio/audiostream.h"
+#include "audio/decoders/decoded_cache.h"
+#include "audio/decoders/raw.h"
+
+namespace Audio {
+
+enum {
+	/**
+	 * Extra room in the copy of a sound for decoders which return a few more
+	 * samples than their length claims, in samples.
+	 */
+	kLengthSlack = 4096
+};
+
+struct CachedSound;
+
+typedef Common::List<CachedSound *> SoundList;
+
+struct CachedSound {
+	Common::String key;
+	byte *data;
+	uint32 size;
+	int rate;
+	bool stereo;
+
+	int refCount;
+	/** Whether the sound is still in the cache, or just kept for playing. */
+	bool cached;
+	/** Position in the list of cached sounds, valid while cached is set. */
+	SoundList::iterator lruPosition;
+};
+
+/**
+ * Keeps the decoded sounds, and drops the least recently used ones once the
+ * cache gets too big. Sounds dropped while playing are freed when they are
+ * done.
+ */
+class DecodedAudioCache : public Common::Singleton<DecodedAudioCache> {
+public:
+	CachedSound *acquire(const Common::String &key);
+	/** Add a sound, taking over @p data, which was allocated with malloc. */
+	void insert(const Common::String &key, byte *data, uint32 size, int rate, bool stereo);
+	void release(CachedSound *sound);
+	void purge();
+
+	/** Return the size limit of the cache, in bytes. */
+	static uint32 getMaxSize();
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	DecodedAudioCache() : _size(0) {}
+	~DecodedAudioCache();
+
+	void remove(CachedSound *sound);
+	void shrink(uint32 maxSize);
+
+	typedef Common::HashMap<Common::String, CachedSound *> SoundMap;
+
+	Common::Mutex _mutex;
+	SoundMap _sounds;
+	/** The cached sounds, from the least to the most recently used one. */
+	SoundList _lruList;
+	uint32 _size;
+};
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::DecodedAudioCache);
+}
+
+namespace Audio {
+
+DecodedAudioCache::~DecodedAudioCache() {
+	for (SoundMap::iterator i = _sounds.begin(); i != _sounds.end(); ++i) {
+		free(i->_value->data);
+		delete i->_value;
+	}
+}
+
+uint32 DecodedAudioCache::getMaxSize() {
+	if (!ConfMan.hasKey("audio_cache_size"))
+		return 0;
+	return MAX(0, ConfMan.getInt("audio_cache_size")) * 1024;
+}
+
+CachedSound *DecodedAudioCache::acquire(const Common::String &key) {
+	Common::StackLock lock(_mutex);
+
+	SoundMap::iterator i = _sounds.find(key);
+	if (i == _sounds.end())
+		return 0;
+
+	CachedSound *sound = i->_value;
+	sound->refCount++;
+	_lruList.erase(sound->lruPosition);
+	_lruList.push_back(sound);
+	sound->lruPosition = _lruList.reverse_begin();
+	return sound;
+}
+
+void DecodedAudioCache::insert(const Common::String &key, byte *data, uint32 size, int rate, bool stereo) {
+	Common::StackLock lock(_mutex);
+
+	// Someone else might have decoded the same sound in the meantime
+	SoundMap::iterator i = _sounds.find(key);
+	if (i != _sounds.end())
+		remove(i->_value);
+
+	const uint32 maxSize = getMaxSize();
+	shrink(maxSize > size ? maxSize - size : 0);
+
+	CachedSound *sound = new CachedSound();
+	sound->key = key;
+	sound->data = data;
+	sound->size = size;
+	sound->rate = rate;
+	sound->stereo = stereo;
+	sound->refCount = 0;
+	sound->cached = true;
+	_lruList.push_back(sound);
+	sound->lruPosition = _lruList.reverse_begin();
+
+	_sounds[key] = sound;
+	_size += size;
+}
+
+void DecodedAudioCache::release(CachedSound *sound) {
+	Common::StackLock lock(_mutex);
+
+	if (--sound->refCount == 0 && !sound->cached) {
+		free(sound->data);
+		delete sound;
+	}
+}
+
+void DecodedAudioCache::purge() {
+	Common::StackLock lock(_mutex);
+	shrink(0);
+}
+
+void DecodedAudioCache::remove(CachedSound *sound) {
+	_sounds.erase(sound->key);
+	_lruList.erase(sound->lruPosition);
+	_size -= sound->size;
+	sound->cached = false;
+
+	if (sound->refCount == 0) {
+		free(sound->data);
+		delete sound;
+	}
+}
+
+void DecodedAudioCache::shrink(uint32 maxSize) {
+	while (_size > maxSize)
+		remove(_lruList.front());
+}
+
+/**
+ * Memory stream over the samples of a cached sound, which keeps them from
+ * being freed while it exists.
+ */
+class CachedSoundReadStream : public Common::MemoryReadStream {
+public:
+	CachedSoundReadStream(CachedSound *sound) : Common::MemoryReadStream(sound->data, sound->size), _sound(sound) {}
+	~CachedSoundReadStream() { DecodedAudioCache::instance().release(_sound); }
+
+private:
+	CachedSound *_sound;
+};
+
+static SeekableAudioStream *makeCachedSoundStream(CachedSound *sound) {
+	byte flags = FLAG_16BITS;
+	if (sound->stereo)
+		flags |= FLAG_STEREO;
+#ifdef SCUMM_LITTLE_ENDIAN
+	flags |= FLAG_LITTLE_ENDIAN;
+#endif
+
+	return makeRawStream(new CachedSoundReadStream(sound), sound->rate, flags, DisposeAfterUse::YES);
+}
+
+/**
+ * Plays a sound through its decoder and keeps a copy of the decoded
+ * samples. If the whole sound was played from its start, the copy is added
+ * to the cache once the stream is destroyed. This way, the sound starts
+ * playing right away, and the decoding is done by the mixer as usual.
+ *
+ * Since readBuffer() runs on the audio thread, the copy is allocated up
+ * front from the length of the sound, and never grown or freed there.
+ * Sounds of unknown length are not recorded.
+ */
+class CachingAudioStream : public SeekableAudioStream {
+public:
+	CachingAudioStream(const Common::String &key, SeekableAudioStream *decoder, uint32 maxSize);
+	~CachingAudioStream();
+
+	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool isStereo() const { return _decoder->isStereo(); }
+	virtual int getRate() const { return _decoder->getRate(); }
+	virtual bool endOfData() const { return _decoder->endOfData(); }
+	virtual bool seek(const Timestamp &where);
+	virtual Timestamp getLength() const { return _decoder->getLength(); }
+
+private:
+	/** Append @p count samples to the copy, unless it gets too big. */
+	void record(const int16 *samples, uint32 count);
+	void stopRecording() { _recording = false; }
+
+	const Common::String _key;
+	SeekableAudioStream *_decoder;
+
+	/** The copy of the samples played so far, freed by the destructor. */
+	int16 *_samples;
+	uint32 _count;
+	uint32 _capacity;
+	bool _recording;
+	/** Whether _samples holds the whole sound. */
+	bool _complete;
+};
+
+CachingAudioStream::CachingAudioStream(const Common::String &key, SeekableAudioStream *decoder, uint32 maxSize)
+	: _key(key), _decoder(decoder), _samples(0), _count(0), _capacity(0), _recording(false), _complete(false) {
+	const Timestamp length = decoder->getLength();
+	if (length.totalNumberOfFrames() <= 0)
+		return;
+
+	const int channels = decoder->isStereo() ? 2 : 1;
+	const uint32 maxSamples = maxSize / sizeof(int16);
+	const uint32 samples = length.convertToFramerate(decoder->getRate()).totalNumberOfFrames() * channels;
+	if (samples > maxSamples)
+		return;
+
+	_capacity = MIN<uint32>(samples + kLengthSlack, maxSamples);
+	_samples = (int16 *)malloc(_capacity * sizeof(int16));
+	_recording = _samples != 0;
+}
+
+CachingAudioStream::~CachingAudioStream() {
+	if (_recording && _complete && _count) {
+		byte *data = (byte *)realloc(_samples, _count * sizeof(int16));
+		if (!data)
+			data = (byte *)_samples;
+		DecodedAudioCache::instance().insert(_key, data, _count * sizeof(int16), _decoder->getRate(), _decoder->isStereo());
+	} else {
+		free(_samples);
+	}
+
+	delete _decoder;
+}
+
+int CachingAudioStream::readBuffer(int16 *buffer, const int numSamples) {
+	const int decoded = _decoder->readBuffer(buffer, numSamples);
+
+	if (_recording && !_complete) {
+		if (decoded > 0)
+			record(buffer, decoded);
+		if (_recording && _decoder->endOfData())
+			_complete = true;
+	}
+
+	return decoded;
+}
+
+void CachingAudioStream::record(const int16 *samples, uint32 count) {
+	if (_count + count > _capacity) {
+		stopRecording();
+		return;
+	}
+
+	memcpy(_samples + _count, samples, count * sizeof(int16));
+	_count += count;
+}
+
+bool CachingAudioStream::seek(const Timestamp &where) {
+	// The copy needs to be played without gaps. Once it is complete,
+	// looping back does not matter anymore.
+	if (!_complete && (_count || where.totalNumberOfFrames() != 0))
+		stopRecording();
+
+	return _decoder->seek(where);
+}
+
+SeekableAudioStream *makeCachedAudioStream(const Common::String &name, uint32 offset, Common::SeekableReadStream *stream,
+                                           DisposeAfterUse::Flag disposeAfterUse, SeekableAudioStreamFactory factory) {
+	// The compressed size guards against different files of the same name
+	const Common::String key = Common::String::format("%s:%u:%u", name.c_str(), offset, (uint32)stream->size());
+
+	CachedSound *sound = DecodedAudioCache::instance().acquire(key);
+	if (sound) {
+		if (disposeAfterUse == DisposeAfterUse::YES)
+			delete stream;
+		return makeCachedSoundStream(sound);
+	}
+
+	SeekableAudioStream *decoder = factory(stream, disposeAfterUse);
+	const uint32 maxSize = DecodedAudioCache::getMaxSize();
+	if (!decoder || !maxSize)
+		return decoder;
+
+	// Only cache sounds which take up at most a quarter of the cache
+	return new CachingAudioStream(key, decoder, maxSize / 4);
+}
+
+void purgeDecodedAudioCache() {
+	DecodedAudioCache::instance().purge();
+}
+
+} // End of namespace Audio
@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * Cache of decoded sounds used in engines:
+ *  - scumm
+ *  - sword1
+ *  - sword2
+ */
+
+#ifndef AUDIO_DECODED_CACHE_H
+#define AUDIO_DECODED_CACHE_H
+
+#include "common/scummsys.h"
+#include "common/types.h"
+
+namespace Common {
+class SeekableReadStream;
+class String;
+}
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/** A factory like makeMP3Stream(), makeVorbisStream() or makeFLACStream(). */
+typedef SeekableAudioStream *(*SeekableAudioStreamFactory)(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+
+/**
+ * Create a new SeekableAudioStream for compressed sound data, keeping the
+ * decoded samples around for the next time the same sound is played.
+ *
+ * The sound is identified by the archive member it is stored in and its
+ * offset there. On a cache hit, the returned stream plays the cached
+ * samples and @p stream is not read at all. Otherwise @p factory is used to
+ * create a decoder for @p stream, which is played as usual. For short
+ * sounds, the samples are recorded while playing, and added to the cache
+ * once the stream is destroyed, if the sound was played from start to end.
+ *
+ * The cache size is set by the audio_cache_size option, in kilobytes. The
+ * least recently used sounds are dropped from it when it is full.
+ *
+ * @param name				the name of the archive member the sound is stored in
+ * @param offset			the offset of the sound in the archive member
+ * @param stream			the SeekableReadStream from which to read the compressed data
+ * @param disposeAfterUse	whether to delete the stream after use
+ * @param factory			the function creating a decoder for @p stream
+ * @return	a new SeekableAudioStream, or NULL, if an error occurred
+ */
+SeekableAudioStream *makeCachedAudioStream(
+	const Common::String &name, uint32 offset,
+	Common::SeekableReadStream *stream,
+	DisposeAfterUse::Flag disposeAfterUse,
+	SeekableAudioStreamFactory factory);
+
+/**
+ * Drop all sounds from the decoded audio cache. Sounds which are still
+ * playing stay in memory until they are done.
+ */
+void purgeDecodedAudioCache();
+
+} // End of namespace Audio
+
+#endif
@@ -45,15 +45,25 @@ namespace Audio {
 
 /**
  * This is a stream, which allows for playing raw PCM data from a stream.
+ *
+ * The data is read in blocks of kSampleBufferLength samples, so streams
+ * from files are played using constant memory. Samples of streams which
+ * are in memory already are converted in place, without copying them to
+ * the block buffer first.
  */
 template<bool is16Bit, bool isUnsigned, bool isLE>
 class RawStream : public SeekableAudioStream {
 public:
 	RawStream(int rate, bool stereo, DisposeAfterUse::Flag disposeStream, Common::SeekableReadStream *stream)
-		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false), _buffer(0) {
-		// Setup our buffer for readBuffer
-		_buffer = new byte[kSampleBufferLength * (is16Bit ? 2 : 1)];
-		assert(_buffer);
+		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false), _data(0), _buffer(0) {
+		const Common::MemoryReadStream *memoryStream = dynamic_cast<const Common::MemoryReadStream *>(stream);
+		if (memoryStream) {
+			_data = memoryStream->getData();
+		} else {
+			// Setup our buffer for readBuffer
+			_buffer = new byte[kSampleBufferLength * (is16Bit ? 2 : 1)];
+			assert(_buffer);
+		}
 
 		// Calculate the total playtime of the stream
 		_playtime = Timestamp(0, _stream->size() / (_isStereo ? 2 : 1) / (is16Bit ? 2 : 1), rate);
@@ -79,6 +89,7 @@ private:
 	Common::DisposablePtr<Common::SeekableReadStream> _stream; ///< Stream to read data from
 	bool _endOfData;                                           ///< Whether the stream end has been reached
 
+	const byte *_data;                                         ///< Data of the stream, if it is a MemoryReadStream
 	byte *_buffer;                                             ///< Buffer used in readBuffer
 	enum {
 		/**
@@ -97,10 +108,16 @@ private:
 	 * @return actual count of samples read.
 	 */
 	int fillBuffer(int maxSamples);
+
+	/** readBuffer for streams in memory. */
+	int readFromMemory(int16 *buffer, const int numSamples);
 };
 
 template<bool is16Bit, bool isUnsigned, bool isLE>
 int RawStream<is16Bit, isUnsigned, isLE>::readBuffer(int16 *buffer, const int numSamples) {
+	if (_data)
+		return readFromMemory(buffer, numSamples);
+
 	int samplesLeft = numSamples;
 
 	while (samplesLeft > 0) {
@@ -159,6 +176,28 @@ int RawStream<is16Bit, isUnsigned, isLE>::fillBuffer(int maxSamples) {
 	return bufferedSamples;
 }
 
+template<bool is16Bit, bool isUnsigned, bool isLE>
+int RawStream<is16Bit, isUnsigned, isLE>::readFromMemory(int16 *buffer, const int numSamples) {
+	if (endOfData())
+		return 0;
+
+	// The stream is only used to keep track of the position
+	const int32 pos = _stream->pos();
+	const int samples = MIN<int>(numSamples, (_stream->size() - pos) / (is16Bit ? 2 : 1));
+
+	const byte *src = _data + pos;
+	for (int i = 0; i < samples; i++) {
+		*buffer++ = READ_ENDIAN_SAMPLE(is16Bit, isUnsigned, src, isLE);
+		src += (is16Bit ? 2 : 1);
+	}
+
+	_stream->seek(samples * (is16Bit ? 2 : 1), SEEK_CUR);
+	if (samples < numSamples || _stream->pos() == _stream->size())
+		_endOfData = true;
+
+	return samples;
+}
+
 template<bool is16Bit, bool isUnsigned, bool isLE>
 bool RawStream<is16Bit, isUnsigned, isLE>::seek(const Timestamp &where) {
 	_endOfData = true;
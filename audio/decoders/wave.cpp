@@ -23,6 +23,7 @@
 #include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/stream.h"
+#include "common/substream.h"
 
 #include "audio/audiostream.h"
 #include "audio/decoders/wave_types.h"
@@ -208,8 +209,14 @@ SeekableAudioStream *makeWAVStream(Common::SeekableReadStream *stream, DisposeAf
 		size &= ~(sampleSize - 1);
 	}
 
-	// Raw PCM. Just read everything at once.
-	// TODO: More elegant would be to wrap the stream.
+	// Raw PCM. If we own the stream, play straight from it. Otherwise the
+	// caller might delete it while we are playing, so read everything at once.
+	if (disposeAfterUse == DisposeAfterUse::YES) {
+		const int32 start = stream->pos();
+		return makeRawStream(new Common::SeekableSubReadStream(stream, start, start + size, DisposeAfterUse::YES),
+		                     rate, flags, DisposeAfterUse::YES);
+	}
+
 	byte *data = (byte *)malloc(size);
 	assert(data);
 	stream->read(data, size);
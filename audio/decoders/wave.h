@@ -82,6 +82,9 @@ extern bool loadWAVFromStream(
  *
  * This function uses loadWAVFromStream() internally.
  *
+ * If disposeAfterUse is YES, raw PCM data is read from the stream while
+ * playing, like compressed data. Otherwise it is read into memory first.
+ *
  * @param stream			the SeekableReadStream from which to read the WAVE data
  * @param disposeAfterUse	whether to delete the stream after use
  * @return	a new SeekableAudioStream, or NULL, if an error occurred
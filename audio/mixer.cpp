@@ -22,9 +22,12 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
+#include "audio/decode_ahead.h"
 #include "audio/mixer_intern.h"
 #include "audio/rate.h"
 #include "audio/audiostream.h"
@@ -33,6 +36,21 @@
 
 namespace Audio {
 
+#if defined(__GNUC__)
+#define MIXER_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define MIXER_THREAD_LOCAL __declspec(thread)
+#elif __cplusplus >= 201103L
+#define MIXER_THREAD_LOCAL thread_local
+#else
+// Without thread local storage, stopping a sound from another thread while
+// the callback runs defers its destruction like the callback itself does.
+#define MIXER_THREAD_LOCAL
+#endif
+
+/** The mixer whose mixCallback() the current thread is running, if any. */
+static MIXER_THREAD_LOCAL MixerImpl *s_callbackMixer = 0;
+
 #pragma mark -
 #pragma mark --- Channel classes ---
 #pragma mark -
@@ -57,6 +75,19 @@ public:
 	 */
 	int mix(int16 *data, uint len);
 
+	/**
+	 * Claims the channel for destruction, for either the mixer side when
+	 * the channel finished, or the public Mixer methods when it is stopped.
+	 * Returns false if the other side claimed it first.
+	 */
+	bool claim() { return Common::atomicCompareAndSwap(&_stopped, 0, 1); }
+
+	/**
+	 * Queries whether the channel was claimed for destruction. The mixer
+	 * side does not mix such channels anymore.
+	 */
+	bool isStopped() const { return _stopped != 0; }
+
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
@@ -87,6 +118,18 @@ public:
 	 */
 	bool isPaused() const { return (_pauseLevel != 0); }
 
+	/**
+	 * Sets whether the channel is skipped by the mixer. Only called from
+	 * the mixer side, which learns about pause() calls through the mixer's
+	 * command queue.
+	 */
+	void setMixPaused(bool paused) { _mixPaused = paused; }
+
+	/**
+	 * Queries whether the channel is skipped by the mixer.
+	 */
+	bool isMixPaused() const { return _mixPaused; }
+
 	/**
 	 * Sets the channel's own volume.
 	 *
@@ -121,6 +164,18 @@ public:
 	 */
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
+	/**
+	 * Gets the effective left and right volume, as computed from the
+	 * channel volume, balance and the global volume settings.
+	 */
+	void getVolumes(st_volume_t &volL, st_volume_t &volR) const { volL = _volL; volR = _volR; }
+
+	/**
+	 * Sets the left and right volume used for mixing. Only called from
+	 * the mixer side, see getVolumes().
+	 */
+	void setMixVolumes(st_volume_t volL, st_volume_t volR) { _mixVolL = volL; _mixVolR = volR; }
+
 	/**
 	 * Queries how long the channel has been playing.
 	 */
@@ -143,6 +198,23 @@ public:
 	 */
 	SoundHandle getHandle() const { return _handle; }
 
+	/**
+	 * Accounts for a mix() call which produced @p frames of the
+	 * @p requested sample pairs in @p micros microseconds. Only called from
+	 * the mixer side.
+	 *
+	 * @return true if the stream just ran out of data before its end.
+	 */
+	bool updateStatistics(uint frames, uint requested, uint32 micros);
+
+	/** Zero the performance counters. Only called from the mixer side. */
+	void resetStatistics();
+
+	/** Copy the performance counters into @p stats. */
+	void getStatistics(MixerStatistics::Channel &stats) const;
+
+	const AudioStream *getStream() const { return _stream.get(); }
+
 private:
 	const Mixer::SoundType _type;
 	SoundHandle _handle;
@@ -158,14 +230,36 @@ private:
 
 	Mixer *_mixer;
 
-	uint32 _samplesConsumed;
+	volatile int32 _stopped;
+
+	// State owned by the mixer side
+	bool _mixPaused;
+	st_volume_t _mixVolL, _mixVolR;
+
+	/**
+	 * Reads _samplesConsumed and _mixerTimeStamp as a consistent pair.
+	 * These are updated by mix() while other threads may query them, so
+	 * _mixStateSeq is incremented before and after every update.
+	 */
+	void getMixState(uint32 &samplesConsumed, uint32 &mixerTimeStamp) const;
+
+	volatile uint32 _mixStateSeq;
+	volatile uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
-	uint32 _mixerTimeStamp;
+	volatile uint32 _mixerTimeStamp;
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
+	// The value of _mixerTimeStamp when _pauseTime was recorded
+	uint32 _pauseTimeBase;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
+
+	// Performance counters, owned by the mixer side
+	uint64 _statFrames;
+	uint64 _statMixMicros;
+	uint32 _statUnderruns;
+	bool _statStarved;
 };
 
 #pragma mark -
@@ -173,17 +267,32 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commands(COMMAND_QUEUE_SIZE), _deadChannels(COMMAND_QUEUE_SIZE + NUM_CHANNELS), _mixLock(0),
+	  _callbackEpoch(0), _mixingIndex(-1), _mixingStopped(false), _decodeAheadWorker(0), _decodeAheadState(0), _statsEnabled(false), _statsResetPending(false),
+	  _statsSeq(0), _lastCallbackStart(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	if (ConfMan.hasKey("audio_statistics"))
+		_statsEnabled = ConfMan.getBool("audio_statistics");
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_mixChannels[i] = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	// The backend does not call mixCallback() anymore at this point, so
+	// apply the pending commands here to get hold of every channel.
+	processCommands();
+	reclaimChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		delete _channels[i];
+		delete _mixChannels[i];
+
+	delete _decodeAheadWorker;
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -196,6 +305,156 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+void MixerImpl::pushCommand(Command::Type type, int index, Channel *chan) {
+	Command cmd;
+	cmd.type = type;
+	cmd.index = index;
+	cmd.channel = chan;
+	cmd.volL = cmd.volR = 0;
+	cmd.paused = false;
+
+	if (type == Command::kSetVolume) {
+		st_volume_t volL, volR;
+		chan->getVolumes(volL, volR);
+		cmd.volL = volL;
+		cmd.volR = volR;
+	} else if (type == Command::kPause) {
+		cmd.paused = chan->isPaused();
+	}
+
+	while (!_commands.push(cmd)) {
+		// A stream read by mixCallback() filled the queue. The callback
+		// holds _mixLock for us, so make room right away.
+		if (isMixerThread()) {
+			processCommands();
+			continue;
+		}
+
+		// mixCallback() has not been called for a long time, e.g. because
+		// the backend suspended audio output. Apply the commands ourselves.
+		if (Common::atomicCompareAndSwap(&_mixLock, 0, 1)) {
+			processCommands();
+			Common::memoryBarrier();
+			_mixLock = 0;
+		} else {
+			g_system->delayMillis(1);
+		}
+	}
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		Channel *chan = _mixChannels[cmd.index];
+
+		// Except for kPlay, the command is ignored if the channel
+		// finished on its own in the meantime.
+		switch (cmd.type) {
+		case Command::kPlay:
+			assert(!chan);
+			_mixChannels[cmd.index] = cmd.channel;
+			break;
+		case Command::kStop:
+			if (chan == cmd.channel) {
+				if (cmd.index == _mixingIndex) {
+					// A stream of the channel stopped it while being read
+					// by mixCallback(), which retires it once done.
+					_mixChannels[cmd.index] = 0;
+					_mixingStopped = true;
+				} else {
+					retireChannel(cmd.index);
+				}
+			}
+			break;
+		case Command::kDetach:
+			if (chan == cmd.channel)
+				_mixChannels[cmd.index] = 0;
+			break;
+		case Command::kSetVolume:
+			if (chan == cmd.channel)
+				chan->setMixVolumes(cmd.volL, cmd.volR);
+			break;
+		case Command::kPause:
+			if (chan == cmd.channel)
+				chan->setMixPaused(cmd.paused);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void MixerImpl::retireChannel(int index) {
+	// This cannot fail: the queue has room for every channel which can
+	// exist at the same time.
+	_deadChannels.push(_mixChannels[index]);
+	_mixChannels[index] = 0;
+}
+
+void MixerImpl::reclaimChannels() {
+	Channel *chan;
+	while (_deadChannels.pop(chan)) {
+		const int index = chan->getHandle()._val % NUM_CHANNELS;
+		if (_channels[index] == chan)
+			_channels[index] = 0;
+		delete chan;
+	}
+}
+
+bool MixerImpl::isMixerThread() {
+	return s_callbackMixer == this;
+}
+
+void MixerImpl::removeChannel(int index, bool fromMixerThread, StoppedChannels &stopped) {
+	Channel *chan = _channels[index];
+	_channels[index] = 0;
+
+	// A channel which finished on its own is already on its way back
+	// through _deadChannels.
+	if (!chan->claim())
+		return;
+
+	if (fromMixerThread) {
+		// The callback may be mixing this very channel, so let it hand the
+		// channel back once it is done.
+		pushCommand(Command::kStop, index, chan);
+	} else {
+		pushCommand(Command::kDetach, index, chan);
+		stopped.push_back(chan);
+	}
+}
+
+void MixerImpl::destroyChannels(const StoppedChannels &stopped) {
+	if (!stopped.empty()) {
+		// The kDetach commands are applied once a callback started after
+		// they were queued has returned. Since the callback may not be
+		// called again for a while, apply them ourselves if it is not
+		// running. Afterwards, the mixer side cannot see the channels
+		// anymore.
+		Common::memoryBarrier();
+		const uint32 epoch = _callbackEpoch;
+		const uint32 appliedEpoch = ((epoch + 1) | 1) + 1;
+
+		while ((int32)(_callbackEpoch - appliedEpoch) < 0) {
+			if (Common::atomicCompareAndSwap(&_mixLock, 0, 1)) {
+				processCommands();
+				Common::memoryBarrier();
+				_mixLock = 0;
+				break;
+			}
+			g_system->delayMillis(1);
+		}
+		Common::memoryBarrier();
+	}
+
+	for (uint i = 0; i < stopped.size(); i++)
+		delete stopped[i];
+
+	// Also destroy channels which finished while being stopped.
+	Common::StackLock lock(_mutex);
+	reclaimChannels();
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -219,6 +478,11 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	st_volume_t volL, volR;
+	chan->getVolumes(volL, volR);
+	chan->setMixVolumes(volL, volR);
+	pushCommand(Command::kPlay, index, chan);
 }
 
 void MixerImpl::playStream(
@@ -229,7 +493,19 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
+	// Move decoding of compressed sounds out of the audio callback. The
+	// worker installs a timer, which must not happen with _mutex held since
+	// timer callbacks may call into the mixer themselves.
+	const bool decodeAhead = ConfMan.hasKey("audio_decode_ahead") && ConfMan.getBool("audio_decode_ahead") &&
+	                         DecodeAheadWorker::canDecodeAhead(stream, autofreeStream);
+	if (decodeAhead && Common::atomicCompareAndSwap(&_decodeAheadState, 0, 1)) {
+		_decodeAheadWorker = new DecodeAheadWorker();
+		Common::memoryBarrier();
+		_decodeAheadState = 2;
+	}
+
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	if (stream == 0) {
 		warning("stream is 0");
@@ -259,6 +535,12 @@ void MixerImpl::playStream(
 	reverseStereo = !reverseStereo;
 #endif
 
+	// If another thread is still creating the worker, play this one as is
+	if (decodeAhead && _decodeAheadState == 2) {
+		Common::memoryBarrier();
+		stream = _decodeAheadWorker->wrapStream(stream, autofreeStream);
+	}
+
 	// Create the channel
 	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
 	chan->setVolume(volume);
@@ -269,8 +551,6 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -282,63 +562,169 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
+	const bool statsEnabled = _statsEnabled;
+	const uint64 start = statsEnabled ? g_system->getMicros() : 0;
+
+	// Another thread is applying our commands because we were not called
+	// for a long time. Simply output silence this once.
+	if (!Common::atomicCompareAndSwap(&_mixLock, 0, 1)) {
+		if (statsEnabled) {
+			beginStatisticsUpdate();
+			_stats.skippedCallbacks++;
+			endStatisticsUpdate();
+		}
+		return 0;
+	}
+
+	// Odd while the callback runs, see destroyChannels()
+	_callbackEpoch = _callbackEpoch + 1;
+	Common::memoryBarrier();
+
+	MixerImpl *const previousMixer = s_callbackMixer;
+	s_callbackMixer = this;
+
+	processCommands();
+
+	if (_statsResetPending) {
+		beginStatisticsUpdate();
+		applyStatisticsReset();
+		endStatisticsUpdate();
+	}
+
+	// The counters of the channels are only updated at the end, together
+	// with the mixer ones
+	Channel *mixed[NUM_CHANNELS];
+	uint32 mixedFrames[NUM_CHANNELS], mixedMicros[NUM_CHANNELS];
+
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Channel *chan = _mixChannels[i];
+		mixed[i] = 0;
+
+		// Skip channels which are being stopped, their kStop or kDetach
+		// command is about to arrive.
+		if (!chan || chan->isStopped())
+			continue;
+
+		if (chan->isFinished()) {
+			if (chan->claim())
+				retireChannel(i);
+		} else {
+			if (!chan->isMixPaused()) {
+				_mixingIndex = i;
+				if (statsEnabled) {
+					const uint64 mixStart = g_system->getMicros();
+					tmp = chan->mix(buf, len);
+					mixed[i] = chan;
+					mixedFrames[i] = tmp;
+					mixedMicros[i] = (uint32)(g_system->getMicros() - mixStart);
+				} else {
+					tmp = chan->mix(buf, len);
+				}
+				_mixingIndex = -1;
+
+				if (_mixingStopped) {
+					_mixingStopped = false;
+					_deadChannels.push(chan);
+				}
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
+	}
+
+	if (statsEnabled) {
+		const uint64 end = g_system->getMicros();
+
+		beginStatisticsUpdate();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			// Skip channels which were stopped by a stream in the meantime
+			if (mixed[i] && _mixChannels[i] == mixed[i] && mixed[i]->updateStatistics(mixedFrames[i], len, mixedMicros[i]))
+				_stats.channelUnderruns++;
+		}
+		updateCallbackStatistics(start, end, len);
+		endStatisticsUpdate();
+	} else {
+		_lastCallbackStart = 0;
+	}
+
+	s_callbackMixer = previousMixer;
+
+	Common::memoryBarrier();
+	_callbackEpoch = _callbackEpoch + 1;
+	_mixLock = 0;
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+	const bool fromMixerThread = isMixerThread();
+	StoppedChannels stopped;
+
+	{
+		Common::StackLock lock(_mutex);
+		reclaimChannels();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != 0 && !_channels[i]->isPermanent())
+				removeChannel(i, fromMixerThread, stopped);
 		}
 	}
+
+	destroyChannels(stopped);
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+	const bool fromMixerThread = isMixerThread();
+	StoppedChannels stopped;
+
+	{
+		Common::StackLock lock(_mutex);
+		reclaimChannels();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != 0 && _channels[i]->getId() == id)
+				removeChannel(i, fromMixerThread, stopped);
 		}
 	}
+
+	destroyChannels(stopped);
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	const bool fromMixerThread = isMixerThread();
+	StoppedChannels stopped;
 
-	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_mutex);
+		reclaimChannels();
 
-	delete _channels[index];
-	_channels[index] = 0;
+		// Simply ignore stop requests for handles of sounds that already terminated
+		const int index = handle._val % NUM_CHANNELS;
+		if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+			return;
+
+		removeChannel(index, fromMixerThread, stopped);
+	}
+
+	destroyChannels(stopped);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channels[i] && _channels[i]->getType() == type) {
 			_channels[i]->notifyGlobalVolChange();
+			pushCommand(Command::kSetVolume, i, _channels[i]);
+		}
 	}
 }
 
@@ -349,12 +735,14 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
 	_channels[index]->setVolume(volume);
+	pushCommand(Command::kSetVolume, index, _channels[index]);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
@@ -367,12 +755,14 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
 	_channels[index]->setBalance(balance);
+	pushCommand(Command::kSetVolume, index, _channels[index]);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
@@ -389,6 +779,7 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -399,18 +790,24 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0) {
 			_channels[i]->pause(paused);
+			pushCommand(Command::kPause, i, _channels[i]);
 		}
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
+			pushCommand(Command::kPause, i, _channels[i]);
 			return;
 		}
 	}
@@ -418,6 +815,7 @@ void MixerImpl::pauseID(int id, bool paused) {
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 	// Simply ignore (un)pause requests for sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
@@ -425,10 +823,12 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 		return;
 
 	_channels[index]->pause(paused);
+	pushCommand(Command::kPause, index, _channels[index]);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
@@ -442,6 +842,8 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
 		return _channels[index]->getId();
@@ -450,6 +852,7 @@ int MixerImpl::getSoundID(SoundHandle handle) {
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
@@ -461,12 +864,99 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
 	return false;
 }
 
+void MixerImpl::enableStatistics(bool enable) {
+	_statsEnabled = enable;
+}
+
+void MixerImpl::getStatistics(MixerStatistics &stats) {
+	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
+	// Copy the counters again if the callback updated them in the meantime,
+	// to get a snapshot taken between two callbacks.
+	uint32 seq;
+	do {
+		seq = _statsSeq;
+		Common::memoryBarrier();
+
+		stats = _stats;
+		stats.channels.clear();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (!_channels[i])
+				continue;
+
+			MixerStatistics::Channel chan;
+			chan.index = i;
+			_channels[i]->getStatistics(chan);
+			chan.queuedFrames = DecodeAheadWorker::getQueuedFrames(_channels[i]->getStream());
+			stats.channels.push_back(chan);
+		}
+
+		Common::memoryBarrier();
+	} while ((seq & 1) || seq != _statsSeq);
+
+	stats.enabled = _statsEnabled;
+	stats.outputRate = _sampleRate;
+}
+
+void MixerImpl::resetStatistics() {
+	_statsResetPending = true;
+}
+
+void MixerImpl::applyStatisticsReset() {
+	_statsResetPending = false;
+
+	_stats.resetCounters();
+	_lastCallbackStart = 0;
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_mixChannels[i])
+			_mixChannels[i]->resetStatistics();
+	}
+}
+
+void MixerImpl::beginStatisticsUpdate() {
+	_statsSeq = _statsSeq + 1;
+	Common::memoryBarrier();
+}
+
+void MixerImpl::endStatisticsUpdate() {
+	Common::memoryBarrier();
+	_statsSeq = _statsSeq + 1;
+}
+
+void MixerImpl::updateCallbackStatistics(uint64 start, uint64 end, uint len) {
+	const uint32 duration = (uint32)(end - start);
+
+	_stats.bufferFrames = len;
+	_stats.callbacks++;
+	_stats.totalCallbackMicros += duration;
+	_stats.maxCallbackMicros = MAX(_stats.maxCallbackMicros, duration);
+
+	if (_lastCallbackStart)
+		_stats.maxCallbackIntervalMicros = MAX(_stats.maxCallbackIntervalMicros, (uint32)(start - _lastCallbackStart));
+	_lastCallbackStart = start;
+
+	int bucket = 0;
+	while (bucket < MixerStatistics::kHistogramBuckets - 1 && duration >= (uint32)MixerStatistics::kHistogramBase << bucket)
+		bucket++;
+	_stats.callbackHistogram[bucket]++;
+
+	// The backend needs the samples before the ones it is playing right now
+	// run out, so taking longer than they last means audible gaps.
+	if ((uint64)duration * _sampleRate > (uint64)len * 1000000)
+		_stats.lateCallbacks++;
+}
+
 void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 
@@ -477,11 +967,15 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// scaling? See also Player_V2::setMasterVolume
 
 	Common::StackLock lock(_mutex);
+	reclaimChannels();
+
 	_soundTypeSettings[type].volume = volume;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channels[i] && _channels[i]->getType() == type) {
 			_channels[i]->notifyGlobalVolChange();
+			pushCommand(Command::kSetVolume, i, _channels[i]);
+		}
 	}
 }
 
@@ -499,9 +993,10 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
+      _balance(0), _pauseLevel(0), _stopped(0), _mixPaused(false), _mixVolL(0), _mixVolR(0), _mixStateSeq(0),
+      _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0), _pauseStartTime(0), _pauseTime(0),
+      _pauseTimeBase(0), _converter(0), _volL(0), _volR(0), _stream(stream, autofreeStream),
+      _statFrames(0), _statMixMicros(0), _statUnderruns(0), _statStarved(false) {
 	assert(mixer);
 	assert(stream);
 
@@ -570,29 +1065,49 @@ void Channel::pause(bool paused) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
+			// The pause only matters for getElapsedTime() until the
+			// channel is mixed again, i.e. the mixer time stamp changes.
+			uint32 samplesConsumed;
+			getMixState(samplesConsumed, _pauseTimeBase);
 			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
 			_pauseStartTime = 0;
 		}
 	}
 }
 
+void Channel::getMixState(uint32 &samplesConsumed, uint32 &mixerTimeStamp) const {
+	uint32 seq;
+	do {
+		seq = _mixStateSeq;
+		Common::memoryBarrier();
+		samplesConsumed = _samplesConsumed;
+		mixerTimeStamp = _mixerTimeStamp;
+		Common::memoryBarrier();
+	} while ((seq & 1) || seq != _mixStateSeq);
+}
+
 Timestamp Channel::getElapsedTime() {
 	const uint32 rate = _mixer->getOutputRate();
 	uint32 delta = 0;
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	uint32 samplesConsumed, mixerTimeStamp;
+	getMixState(samplesConsumed, mixerTimeStamp);
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
 	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+		delta = _pauseStartTime - mixerTimeStamp;
+	else if (_pauseTimeBase == mixerTimeStamp)
+		delta = g_system->getMillis(true) - mixerTimeStamp - _pauseTime;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -604,6 +1119,37 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
+bool Channel::updateStatistics(uint frames, uint requested, uint32 micros) {
+	_statFrames += frames;
+	_statMixMicros += micros;
+
+	// The stream did not end but had no data, e.g. a queuing stream which
+	// was not refilled in time. Only count the start of each underrun.
+	const bool starved = frames < requested && !_stream->endOfStream();
+	const bool underrun = starved && !_statStarved;
+	_statStarved = starved;
+
+	if (underrun)
+		_statUnderruns++;
+	return underrun;
+}
+
+void Channel::resetStatistics() {
+	_statFrames = 0;
+	_statMixMicros = 0;
+	_statUnderruns = 0;
+	_statStarved = false;
+}
+
+void Channel::getStatistics(MixerStatistics::Channel &stats) const {
+	stats.id = _id;
+	stats.type = _type;
+	stats.paused = isPaused();
+	stats.frames = _statFrames;
+	stats.mixMicros = _statMixMicros;
+	stats.underruns = _statUnderruns;
+}
+
 int Channel::mix(int16 *data, uint len) {
 	assert(_stream);
 
@@ -612,10 +1158,13 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
+		_mixStateSeq = _mixStateSeq + 1;
+		Common::memoryBarrier();
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		Common::memoryBarrier();
+		_mixStateSeq = _mixStateSeq + 1;
+		res = _converter->flow(*_stream, data, len, _mixVolL, _mixVolR);
 		_samplesDecoded += res;
 	}
 
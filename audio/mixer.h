@@ -30,6 +30,7 @@ namespace Audio {
 
 class AudioStream;
 class Channel;
+struct MixerStatistics;
 class Timestamp;
 
 /**
@@ -110,7 +111,9 @@ public:
 	 * @param volume    Volume with which to play the sound, ranging from 0 to 255.
 	 * @param balance	Balance with which to play the sound, ranging from -127 to 127 (full left to full right).
 	 *                  0 is balanced, -128 is invalid.
-	 * @param autofreeStream  If set, the stream will be freed after the playback is finished.                  
+	 * @param autofreeStream  If set, the stream will be freed after the playback is finished.
+	 *                        A stream which ends on its own is freed by the next call
+	 *                        to a Mixer method after that.
 	 * @param permanent       If set, a plain stopAll call will not stop this particular stream.          
 	 * @param reverseStereo   If set, left and right channels will be swapped.
 	 */
@@ -127,6 +130,12 @@ public:
 
 	/**
 	 * Stop all currently playing sounds.
+	 *
+	 * Like all stop methods, this destroys the channels of the sounds
+	 * before returning. Their streams are deleted if they were played with
+	 * DisposeAfterUse::YES, and are not accessed anymore otherwise. When
+	 * called from a stream read by the mixer itself, the channels are
+	 * instead released once the mixer finished the current buffer.
 	 */
 	virtual void stopAll() = 0;
 
@@ -295,6 +304,30 @@ public:
 	 * @return The output sample rate in Hz.
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Enable or disable collecting performance counters.
+	 *
+	 * The counters are disabled by default, unless the audio_statistics
+	 * configuration option is set.
+	 */
+	virtual void enableStatistics(bool enable) = 0;
+
+	/**
+	 * Get a snapshot of the performance counters.
+	 *
+	 * This waits for a running audio callback to finish, so that all
+	 * counters are from the same point in time.
+	 *
+	 * @param stats  Filled with the current counters.
+	 */
+	virtual void getStatistics(MixerStatistics &stats) = 0;
+
+	/**
+	 * Set all performance counters back to zero. This takes effect with the
+	 * next audio callback.
+	 */
+	virtual void resetStatistics() = 0;
 };
 
 /** @} */
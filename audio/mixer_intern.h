@@ -24,11 +24,16 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
+#include "common/lockfree-queue.h"
 #include "audio/mixer.h"
+#include "audio/mixer_stats.h"
 
 namespace Audio {
 
+class DecodeAheadWorker;
+
 /**
  * @defgroup audio_mixer_intern Mixer implementation
  * @ingroup audio
@@ -50,6 +55,15 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * The audio thread never blocks on the mixer mutex: all requests which
+ * modify the set of playing channels or their parameters are recorded in a
+ * lock-free command queue, which mixCallback() drains at the start of each
+ * buffer. Channels which finished are handed back the same way and
+ * destroyed by the next public Mixer method called. Stopped channels are
+ * destroyed before the stop method returns, unless it is called from a
+ * stream read by mixCallback() itself. The mutex is only used to serialize
+ * the threads calling the public Mixer methods.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -59,13 +73,14 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
-	bool _mixerReady;
+	volatile bool _mixerReady;
 	uint32 _handleSeed;
 
 	struct SoundTypeSettings {
@@ -76,15 +91,101 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** Channels as seen by the public Mixer methods; guarded by _mutex. */
 	Channel *_channels[NUM_CHANNELS];
 
+	/** Channels as seen by mixCallback(); only accessed with _mixLock held. */
+	Channel *_mixChannels[NUM_CHANNELS];
+
+	struct Command {
+		enum Type {
+			kPlay,
+			/** Stop the channel and hand it back through _deadChannels. */
+			kStop,
+			/** Forget the channel, which the sender destroys itself. */
+			kDetach,
+			kSetVolume,
+			kPause
+		};
+
+		Type type;
+		int index;
+		Channel *channel;
+		uint16 volL, volR;
+		bool paused;
+	};
+
+	/** Requests from the public Mixer methods to mixCallback(). */
+	Common::LockFreeQueue<Command> _commands;
+	/** Stopped and finished channels, returned by mixCallback() for deletion. */
+	Common::LockFreeQueue<Channel *> _deadChannels;
+	/** Set while _mixChannels is being updated or mixed. */
+	volatile int32 _mixLock;
+	/**
+	 * Incremented by mixCallback() after taking _mixLock and before
+	 * releasing it, so that it is odd while the callback runs. Stopping a
+	 * channel polls it to tell when the callback let go of the channel.
+	 */
+	volatile uint32 _callbackEpoch;
+	/** The channel being mixed by mixCallback(), or -1. */
+	int _mixingIndex;
+	/** Set when the channel being mixed was stopped by its own stream. */
+	bool _mixingStopped;
+
+	/** Created on demand if the audio_decode_ahead option is set. */
+	DecodeAheadWorker *_decodeAheadWorker;
+	/** 0 before, 1 while and 2 after creating _decodeAheadWorker. */
+	volatile int32 _decodeAheadState;
+
+	/**
+	 * Counters updated by mixCallback(), between beginStatisticsUpdate()
+	 * and endStatisticsUpdate(); the channel list is unused.
+	 */
+	MixerStatistics _stats;
+	volatile bool _statsEnabled;
+	/** Set by resetStatistics(), cleared by mixCallback(). */
+	volatile bool _statsResetPending;
+	/**
+	 * Incremented before and after mixCallback() updates the counters of
+	 * the mixer and of the channels, so that getStatistics() can tell
+	 * whether its copy is consistent without blocking the callback.
+	 */
+	volatile uint32 _statsSeq;
+	/** Start time of the previous callback, 0 if none was measured. */
+	uint64 _lastCallbackStart;
+
+	/** Zero all counters. Only called from mixCallback(). */
+	void applyStatisticsReset();
+	void beginStatisticsUpdate();
+	void endStatisticsUpdate();
+	/** Account for a callback which took from @p start to @p end. */
+	void updateCallbackStatistics(uint64 start, uint64 end, uint len);
+
+	typedef Common::Array<Channel *> StoppedChannels;
+
+	void pushCommand(Command::Type type, int index, Channel *chan);
+	void processCommands();
+	void reclaimChannels();
+	/** Whether the caller is running inside mixCallback() of this mixer. */
+	bool isMixerThread();
+	/**
+	 * Take a channel away from the public Mixer methods. Unless called
+	 * from inside mixCallback(), the channel is added to @p stopped, to be
+	 * passed to destroyChannels() once _mutex is released.
+	 */
+	void removeChannel(int index, bool fromMixerThread, StoppedChannels &stopped);
+	/** Wait until the mixer side lets go of the channels, and delete them. */
+	void destroyChannels(const StoppedChannels &stopped);
+	void retireChannel(int index);
+
 
 public:
 
 	MixerImpl(uint sampleRate);
 	~MixerImpl();
 
-	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
+	virtual bool isReady() const { return _mixerReady; }
 
 	virtual void playStream(
 		SoundType type,
@@ -126,6 +227,10 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	virtual void enableStatistics(bool enable);
+	virtual void getStatistics(MixerStatistics &stats);
+	virtual void resetStatistics();
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
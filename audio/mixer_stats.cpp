@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/util.h"
+
+#include "audio/mixer.h"
+#include "audio/mixer_stats.h"
+
+namespace Audio {
+
+static const char *const soundTypeNames[] = { "plain", "music", "sfx", "speech" };
+
+static const char *getSoundTypeName(int type) {
+	if (type < 0 || type >= (int)ARRAYSIZE(soundTypeNames))
+		return "unknown";
+	return soundTypeNames[type];
+}
+
+MixerStatistics::MixerStatistics() : enabled(false), outputRate(0) {
+	resetCounters();
+}
+
+void MixerStatistics::resetCounters() {
+	bufferFrames = 0;
+	callbacks = 0;
+	totalCallbackMicros = 0;
+	maxCallbackMicros = 0;
+	maxCallbackIntervalMicros = 0;
+	for (int i = 0; i < kHistogramBuckets; i++)
+		callbackHistogram[i] = 0;
+	lateCallbacks = 0;
+	skippedCallbacks = 0;
+	channelUnderruns = 0;
+}
+
+uint32 MixerStatistics::getBufferMicros() const {
+	if (!outputRate)
+		return 0;
+	return (uint32)((uint64)bufferFrames * 1000000 / outputRate);
+}
+
+Common::String MixerStatistics::toString() const {
+	Common::String result;
+
+	if (!enabled)
+		result += "Statistics are disabled\n";
+
+	result += Common::String::format("Output: %u Hz, %u sample pairs per callback (%.1f ms)\n",
+	                                 outputRate, bufferFrames, getBufferMicros() / 1000.0);
+	result += Common::String::format("Callbacks: %u, average %.1f us, worst %u us, longest interval %u us\n",
+	                                 callbacks, callbacks ? (double)totalCallbackMicros / callbacks : 0.0,
+	                                 maxCallbackMicros, maxCallbackIntervalMicros);
+	result += Common::String::format("Late callbacks: %u, skipped callbacks: %u, channel underruns: %u\n",
+	                                 lateCallbacks, skippedCallbacks, channelUnderruns);
+
+	result += "Callback durations:\n";
+	for (int i = 0; i < kHistogramBuckets; i++) {
+		if (i < kHistogramBuckets - 1)
+			result += Common::String::format("  < %6d us: %u\n", kHistogramBase << i, callbackHistogram[i]);
+		else
+			result += Common::String::format("  >= %5d us: %u\n", kHistogramBase << (i - 1), callbackHistogram[i]);
+	}
+
+	result += Common::String::format("Channels: %u\n", channels.size());
+	for (uint i = 0; i < channels.size(); i++) {
+		const Channel &chan = channels[i];
+		result += Common::String::format("  %2d: id %d, %s%s, %.0f sample pairs, %.3f us per sample pair, %u queued frames, %u underruns\n",
+		                                 chan.index, chan.id, getSoundTypeName(chan.type), chan.paused ? " (paused)" : "",
+		                                 (double)chan.frames, chan.frames ? (double)chan.mixMicros / chan.frames : 0.0,
+		                                 chan.queuedFrames, chan.underruns);
+	}
+
+	return result;
+}
+
+Common::String MixerStatistics::toJSON() const {
+	Common::String result = "{";
+
+	result += Common::String::format("\"enabled\": %s, \"outputRate\": %u, \"bufferFrames\": %u, \"bufferMicros\": %u, ",
+	                                 enabled ? "true" : "false", outputRate, bufferFrames, getBufferMicros());
+	result += Common::String::format("\"callbacks\": %u, \"totalCallbackMicros\": %.0f, \"maxCallbackMicros\": %u, \"maxCallbackIntervalMicros\": %u, ",
+	                                 callbacks, (double)totalCallbackMicros, maxCallbackMicros, maxCallbackIntervalMicros);
+	result += Common::String::format("\"lateCallbacks\": %u, \"skippedCallbacks\": %u, \"channelUnderruns\": %u, ",
+	                                 lateCallbacks, skippedCallbacks, channelUnderruns);
+
+	result += Common::String::format("\"histogramBaseMicros\": %d, \"callbackHistogram\": [", kHistogramBase);
+	for (int i = 0; i < kHistogramBuckets; i++)
+		result += Common::String::format(i ? ", %u" : "%u", callbackHistogram[i]);
+	result += "], ";
+
+	result += "\"channels\": [";
+	for (uint i = 0; i < channels.size(); i++) {
+		const Channel &chan = channels[i];
+		if (i)
+			result += ", ";
+		result += Common::String::format("{\"index\": %d, \"id\": %d, \"type\": \"%s\", \"paused\": %s, \"frames\": %.0f, \"mixMicros\": %.0f, \"queuedFrames\": %u, \"underruns\": %u}",
+		                                 chan.index, chan.id, getSoundTypeName(chan.type), chan.paused ? "true" : "false",
+		                                 (double)chan.frames, (double)chan.mixMicros, chan.queuedFrames, chan.underruns);
+	}
+	result += "]}";
+
+	return result;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_MIXER_STATS_H
+#define AUDIO_MIXER_STATS_H
+
+#include "common/array.h"
+#include "common/str.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_mixer_stats Mixer statistics
+ * @ingroup audio
+ *
+ * @brief Performance counters of the mixer, see Mixer::getStatistics().
+ * @{
+ */
+
+/**
+ * A snapshot of the performance counters of a mixer.
+ *
+ * All durations are in microseconds, as measured by OSystem::getMicros().
+ * A snapshot is taken between two audio callbacks, so its values are
+ * consistent with each other.
+ */
+struct MixerStatistics {
+	enum {
+		/**
+		 * Number of buckets of the callback duration histogram. Bucket i
+		 * counts the callbacks which took less than kHistogramBase << i
+		 * microseconds, and more than the ones in bucket i - 1. The last
+		 * bucket counts all slower callbacks.
+		 */
+		kHistogramBuckets = 12,
+		kHistogramBase = 64
+	};
+
+	/** Counters of a single playing sound. */
+	struct Channel {
+		/** Slot of the channel in the mixer. */
+		int index;
+		/** The id passed to Mixer::playStream(). */
+		int id;
+		/** The Mixer::SoundType of the channel. */
+		int type;
+		bool paused;
+
+		/** Number of sample pairs mixed. */
+		uint64 frames;
+		/**
+		 * Time spent in the mixer on the channel: reading its stream,
+		 * which includes decoding unless it is decoded ahead, resampling
+		 * and mixing.
+		 */
+		uint64 mixMicros;
+		/**
+		 * Number of frames, at the rate of the stream, which were decoded
+		 * ahead but not mixed yet. Always 0 unless the stream is decoded
+		 * ahead, see the audio_decode_ahead option.
+		 */
+		uint32 queuedFrames;
+		/** Number of times the stream ran out of data before its end. */
+		uint32 underruns;
+	};
+
+	/** Whether the counters are being updated. */
+	bool enabled;
+	/** The output sample rate, in Hz. */
+	uint outputRate;
+	/** Number of sample pairs requested by the last callback. */
+	uint bufferFrames;
+
+	/** Number of callbacks since the counters were reset. */
+	uint32 callbacks;
+	uint64 totalCallbackMicros;
+	uint32 maxCallbackMicros;
+	/** Longest time between the start of two callbacks. */
+	uint32 maxCallbackIntervalMicros;
+	uint32 callbackHistogram[kHistogramBuckets];
+
+	/** Callbacks which took longer than the audio they produced lasts. */
+	uint32 lateCallbacks;
+	/** Callbacks which output silence because the mixer was busy. */
+	uint32 skippedCallbacks;
+	/** Channel underruns, including the ones of channels which are gone. */
+	uint32 channelUnderruns;
+
+	/** The channels which are currently playing. */
+	Common::Array<Channel> channels;
+
+	MixerStatistics();
+
+	/** Zero all counters, leaving the channel list alone. */
+	void resetCounters();
+
+	/** Output latency caused by the buffer size, in microseconds. */
+	uint32 getBufferMicros() const;
+
+	/** Return a human readable summary, one line per item. */
+	Common::String toString() const;
+
+	/** Return all counters as a JSON object. */
+	Common::String toJSON() const;
+};
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
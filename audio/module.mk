@@ -3,6 +3,7 @@ MODULE := audio
 MODULE_OBJS := \
 	adlib.o \
 	audiostream.o \
+	decode_ahead.o \
 	fmopl.o \
 	mididrv.o \
 	midiparser_qt.o \
@@ -13,6 +14,7 @@ MODULE_OBJS := \
 	miles_adlib.o \
 	miles_midi.o \
 	mixer.o \
+	mixer_stats.o \
 	mpu401.o \
 	mt32gm.o \
 	musicplugin.o \
@@ -23,6 +25,7 @@ MODULE_OBJS := \
 	decoders/adpcm.o \
 	decoders/aiff.o \
 	decoders/asf.o \
+	decoders/decoded_cache.o \
 	decoders/flac.o \
 	decoders/iff_sound.o \
 	decoders/mac_snd.o \
@@ -80,6 +83,17 @@ MODULE_OBJS += \
 	softsynth/opl/nuked.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	softsynth/opl/dbopl_sse2.o
+$(MODULE)/softsynth/opl/dbopl_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	softsynth/opl/dbopl_neon.o
+endif
+
 ifdef USE_A52
 MODULE_OBJS += \
 	decoders/ac3.o
@@ -97,7 +111,25 @@ endif
 
 ifndef USE_ARM_SOUND_ASM
 MODULE_OBJS += \
-	rate.o
+	rate.o \
+	rate_sinc.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+$(MODULE)/rate_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_avx2.o
+$(MODULE)/rate_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+endif
 else
 MODULE_OBJS += \
 	rate_arm.o \
@@ -30,8 +30,11 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/config-manager.h"
 #include "common/frac.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -57,6 +60,43 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+void mixBuffer(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo) {
+	for (; len > 0; len--) {
+		st_sample_t out0, out1;
+		out0 = *ibuf++;
+		out1 = (stereo ? *ibuf++ : out0);
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+RateMixFunc getRateMixFunc() {
+	// The SIMD versions only implement signed output
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return mixBufferAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return mixBufferSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return mixBufferNEON;
+#endif
+#endif
+	return mixBuffer;
+}
+
+#pragma mark -
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -70,6 +110,10 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** resampled data, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	RateMixFunc mix;
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -78,7 +122,7 @@ protected:
 	long opos_inc;
 
 public:
-	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
+	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate, RateMixFunc mixFunc);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
@@ -90,7 +134,7 @@ public:
  * Prepare processing.
  */
 template<bool stereo, bool reverseStereo>
-SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate) {
+SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate, RateMixFunc mixFunc) : mix(mixFunc) {
 	if ((inrate % outrate) != 0) {
 		error("Input rate must be a multiple of output rate to use rate effect");
 	}
@@ -119,37 +163,47 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
+		st_sample_t *tmp = outBuf;
+		st_sample_t *tmpEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / 2) * (stereo ? 2 : 1);
+		bool endOfInput = false;
+
+		while (tmp < tmpEnd) {
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
+
+			*tmp++ = *inPtr++;
+			if (stereo)
+				*tmp++ = *inPtr++;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
-
-		// Increment output position
-		opos += opos_inc;
-
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
+		}
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		// Mix the resampled data into the output buffer
+		const st_size_t len = (tmp - outBuf) / (stereo ? 2 : 1);
+		mix(obuf, outBuf, len, vol_l, vol_r, stereo, reverseStereo);
+		obuf += len * 2;
 
-		obuf += 2;
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -172,6 +226,10 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** resampled data, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	RateMixFunc mix;
+
 	/** fractional position of the output stream in input stream unit */
 	frac_t opos;
 
@@ -184,7 +242,7 @@ protected:
 	st_sample_t icur0, icur1;
 
 public:
-	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
+	LinearRateConverter(st_rate_t inrate, st_rate_t outrate, RateMixFunc mixFunc);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
@@ -196,7 +254,7 @@ public:
  * Prepare processing.
  */
 template<bool stereo, bool reverseStereo>
-LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate) {
+LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate, RateMixFunc mixFunc) : mix(mixFunc) {
 	if (inrate >= 131072 || outrate >= 131072) {
 		error("rate effect can only handle rates < 131072");
 	}
@@ -228,47 +286,55 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+		st_sample_t *tmp = outBuf;
+		st_sample_t *tmpEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / 2) * (stereo ? 2 : 1);
+		bool endOfInput = false;
+
+		while (tmp < tmpEnd) {
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
-			}
-			opos -= FRAC_ONE_LOW;
-		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
+			if (endOfInput)
+				break;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the output buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && tmp < tmpEnd) {
+				// interpolate
+				*tmp++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				if (stereo)
+					*tmp++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+				// Increment output position
+				opos += opos_inc;
+			}
+		}
 
-			obuf += 2;
+		// Mix the resampled data into the output buffer
+		const st_size_t len = (tmp - outBuf) / (stereo ? 2 : 1);
+		mix(obuf, outBuf, len, vol_l, vol_r, stereo, reverseStereo);
+		obuf += len * 2;
 
-			// Increment output position
-			opos += opos_inc;
-		}
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -284,8 +350,9 @@ template<bool stereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
+	RateMixFunc _mix;
 public:
-	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
+	CopyRateConverter(RateMixFunc mixFunc) : _buffer(0), _bufferSize(0), _mix(mixFunc) {}
 	~CopyRateConverter() {
 		free(_buffer);
 	}
@@ -293,7 +360,6 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
 		st_sample_t *ostart = obuf;
@@ -315,20 +381,11 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		if (stereo)
+			len /= 2;
+		_mix(obuf, _buffer, len, vol_l, vol_r, stereo, reverseStereo);
+		obuf += len * 2;
 
-			obuf += 2;
-		}
 		return (obuf - ostart) / 2;
 	}
 
@@ -342,14 +399,16 @@ public:
 
 template<bool stereo, bool reverseStereo>
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	RateMixFunc mixFunc = getRateMixFunc();
+
 	if (inrate != outrate) {
 		if ((inrate % outrate) == 0 && (inrate < 65536)) {
-			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
+			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate, mixFunc);
 		} else {
-			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
+			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate, mixFunc);
 		}
 	} else {
-		return new CopyRateConverter<stereo, reverseStereo>();
+		return new CopyRateConverter<stereo, reverseStereo>(mixFunc);
 	}
 }
 
@@ -357,6 +416,15 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
  * Create and return a RateConverter object for the specified input and output rates.
  */
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+	// Use band-limited resampling if the user asked for it, and the
+	// conversion ratio can be handled by it
+	const int quality = ConfMan.getInt("resampler_quality");
+	if (quality > 0 && inrate != outrate) {
+		RateConverter *converter = makeSincRateConverter(inrate, outrate, stereo, reverseStereo, quality, getRateMixFunc());
+		if (converter)
+			return converter;
+	}
+
 	if (stereo) {
 		if (reverseStereo)
 			return makeRateConverter<true, true>(inrate, outrate);
@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+namespace Audio {
+
+/**
+ * Multiply sixteen samples with their volumes and divide the result by
+ * Mixer::kMaxMixerVolume, rounding towards zero just like the C code does.
+ *
+ * Unpacking and packing both work on the two 128-bit lanes separately, so
+ * the samples stay in order.
+ */
+static inline __m256i scaleSamples(__m256i samples, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(samples, vol);
+	const __m256i hi = _mm256_mulhi_epi16(samples, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+
+	// Add 255 to negative values before shifting
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_srli_epi32(_mm256_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_srli_epi32(_mm256_srai_epi32(p1, 31), 24)), 8);
+
+	return _mm256_packs_epi32(p0, p1);
+}
+
+static inline void mixSamples(st_sample_t *obuf, __m256i samples, __m256i vol) {
+	const __m256i out = _mm256_loadu_si256((const __m256i *)obuf);
+	_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out, scaleSamples(samples, vol)));
+}
+
+void mixBufferAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo) {
+	if (stereo) {
+		// See mixBufferSSE2 for how reversed stereo is handled
+		const __m256i vol = reverseStereo ? _mm256_set1_epi32((vol_l << 16) | vol_r)
+		                                  : _mm256_set1_epi32((vol_r << 16) | vol_l);
+
+		for (; len >= 8; len -= 8) {
+			__m256i samples = _mm256_loadu_si256((const __m256i *)ibuf);
+			if (reverseStereo)
+				samples = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+
+			mixSamples(obuf, samples, vol);
+			ibuf += 16;
+			obuf += 16;
+		}
+	} else {
+		const __m256i vol = _mm256_set1_epi32((vol_r << 16) | vol_l);
+
+		for (; len >= 8; len -= 8) {
+			const __m128i samples = _mm_loadu_si128((const __m128i *)ibuf);
+			const __m128i lo = _mm_unpacklo_epi16(samples, samples);
+			const __m128i hi = _mm_unpackhi_epi16(samples, samples);
+
+			mixSamples(obuf, _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), vol);
+			ibuf += 8;
+			obuf += 16;
+		}
+	}
+
+	mixBuffer(obuf, ibuf, len, vol_l, vol_r, stereo, reverseStereo);
+}
+
+int32 convolveAVX2(const st_sample_t *samples, const int16 *coeffs, uint taps) {
+	__m256i sum = _mm256_setzero_si256();
+
+	for (uint i = 0; i < taps; i += 16) {
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(samples + i));
+		const __m256i c = _mm256_load_si256((const __m256i *)(coeffs + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(s, c));
+	}
+
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum128);
+}
+
+} // End of namespace Audio
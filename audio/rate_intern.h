@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Scale the samples in @p ibuf by the given volumes and mix them into the
+ * stereo output buffer @p obuf, clamping the result.
+ *
+ * This is the accumulation step shared by all rate converters. The
+ * converters first resample the input into an intermediate buffer, which
+ * is then passed to one of these functions.
+ *
+ * @param obuf          output buffer holding 2 * len samples
+ * @param ibuf          input buffer holding len (mono) or 2 * len (stereo) samples
+ * @param len           number of sample pairs to produce
+ * @param vol_l         volume for the left channel, 0 - Mixer::kMaxMixerVolume
+ * @param vol_r         volume for the right channel, 0 - Mixer::kMaxMixerVolume
+ * @param stereo        whether the input is stereo
+ * @param reverseStereo whether the left and right channel should be swapped
+ */
+typedef void (*RateMixFunc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo);
+
+void mixBuffer(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo);
+
+#ifdef SCUMMVM_SSE2
+void mixBufferSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void mixBufferAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mixBufferNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo);
+#endif
+
+/**
+ * Return the fastest mixing function supported by the CPU we are running on.
+ */
+RateMixFunc getRateMixFunc();
+
+/**
+ * Compute the dot product of @p taps samples and filter coefficients.
+ *
+ * Used by the polyphase resampler. The number of taps must be a multiple
+ * of 16, and the coefficients must be 32 byte aligned.
+ */
+typedef int32 (*RateConvolveFunc)(const st_sample_t *samples, const int16 *coeffs, uint taps);
+
+int32 convolve(const st_sample_t *samples, const int16 *coeffs, uint taps);
+
+#ifdef SCUMMVM_SSE2
+int32 convolveSSE2(const st_sample_t *samples, const int16 *coeffs, uint taps);
+#endif
+
+#ifdef SCUMMVM_AVX2
+int32 convolveAVX2(const st_sample_t *samples, const int16 *coeffs, uint taps);
+#endif
+
+#ifdef SCUMMVM_NEON
+int32 convolveNEON(const st_sample_t *samples, const int16 *coeffs, uint taps);
+#endif
+
+/**
+ * Return the fastest convolution function supported by the CPU we are running on.
+ */
+RateConvolveFunc getRateConvolveFunc();
+
+/**
+ * Create a polyphase windowed-sinc rate converter.
+ *
+ * @param quality  1 (fastest) to 3 (best quality)
+ * @return the new converter, or 0 if the conversion ratio is not supported
+ */
+RateConverter *makeSincRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, int quality, RateMixFunc mixFunc);
+
+} // End of namespace Audio
+
+#endif
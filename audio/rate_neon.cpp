@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+namespace Audio {
+
+/**
+ * Multiply four samples with their volumes and divide the result by
+ * Mixer::kMaxMixerVolume, rounding towards zero just like the C code does.
+ */
+static inline int16x4_t scaleSamples(int16x4_t samples, int16x4_t vol) {
+	int32x4_t p = vmull_s16(samples, vol);
+
+	// Add 255 to negative values before shifting
+	p = vaddq_s32(p, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24)));
+	return vqmovn_s32(vshrq_n_s32(p, 8));
+}
+
+static inline void mixSamples(st_sample_t *obuf, int16x8_t samples, int16x4_t vol) {
+	const int16x8_t scaled = vcombine_s16(scaleSamples(vget_low_s16(samples), vol),
+	                                      scaleSamples(vget_high_s16(samples), vol));
+	vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+}
+
+void mixBufferNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo) {
+	if (stereo) {
+		// See mixBufferSSE2 for how reversed stereo is handled
+		const int16x4_t vol = reverseStereo ? vreinterpret_s16_s32(vdup_n_s32((vol_l << 16) | vol_r))
+		                                    : vreinterpret_s16_s32(vdup_n_s32((vol_r << 16) | vol_l));
+
+		for (; len >= 4; len -= 4) {
+			int16x8_t samples = vld1q_s16(ibuf);
+			if (reverseStereo)
+				samples = vrev32q_s16(samples);
+
+			mixSamples(obuf, samples, vol);
+			ibuf += 8;
+			obuf += 8;
+		}
+	} else {
+		const int16x4_t vol = vreinterpret_s16_s32(vdup_n_s32((vol_r << 16) | vol_l));
+
+		for (; len >= 8; len -= 8) {
+			const int16x8_t samples = vld1q_s16(ibuf);
+
+			mixSamples(obuf,     vzip1q_s16(samples, samples), vol);
+			mixSamples(obuf + 8, vzip2q_s16(samples, samples), vol);
+			ibuf += 8;
+			obuf += 16;
+		}
+	}
+
+	mixBuffer(obuf, ibuf, len, vol_l, vol_r, stereo, reverseStereo);
+}
+
+int32 convolveNEON(const st_sample_t *samples, const int16 *coeffs, uint taps) {
+	int32x4_t sum = vdupq_n_s32(0);
+
+	for (uint i = 0; i < taps; i += 8) {
+		const int16x8_t s = vld1q_s16(samples + i);
+		const int16x8_t c = vld1q_s16(coeffs + i);
+		sum = vmlal_s16(sum, vget_low_s16(s), vget_low_s16(c));
+		sum = vmlal_s16(sum, vget_high_s16(s), vget_high_s16(c));
+	}
+
+	return vaddvq_s32(sum);
+}
+
+} // End of namespace Audio
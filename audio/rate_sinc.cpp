@@ -0,0 +1,420 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Band-limited rate conversion using a polyphase windowed-sinc FIR filter.
+ *
+ * For an input rate I and an output rate O, we compute L = O / gcd(I, O)
+ * and M = I / gcd(I, O). Output sample n is located at input position
+ * n * M / L, so only L distinct fractional positions ("phases") ever occur.
+ * The filter coefficients for each of them are computed once and shared
+ * between all channels using the same conversion.
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/math.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+/**
+ * The size of the intermediate input cache, see rate.cpp.
+ */
+#define INTERMEDIATE_BUFFER_SIZE 512
+
+enum {
+	/**
+	 * Conversions needing more phases than this fall back to linear
+	 * interpolation. All common conversions (11025, 22050, 44100 and their
+	 * multiples to 48000 or vice versa) need 640 phases at most.
+	 */
+	kSincMaxPhases = 1024,
+
+	/** Fixed point precision of the filter coefficients. */
+	kSincCoeffBits = 14,
+
+	/** Alignment of the coefficient tables, in bytes. */
+	kSincCoeffAlignment = 64
+};
+
+/**
+ * Coefficient table of a polyphase filter. The coefficients for each phase
+ * are stored consecutively, and each phase starts on a 32 byte boundary.
+ */
+struct SincFilter {
+	uint phases;
+	uint step;
+	uint taps;
+
+	int refCount;
+	byte *storage;
+	const int16 *coeffs;
+};
+
+/**
+ * Keeps track of the coefficient tables in use, so that they are only
+ * computed once for all channels using the same conversion.
+ */
+class SincFilterManager : public Common::Singleton<SincFilterManager> {
+public:
+	const SincFilter *acquire(uint phases, uint step, uint taps);
+	void release(const SincFilter *filter);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SincFilterManager() {}
+	~SincFilterManager();
+
+	static SincFilter *createFilter(uint phases, uint step, uint taps);
+	static void destroyFilter(SincFilter *filter);
+
+	Common::Mutex _mutex;
+	Common::Array<SincFilter *> _filters;
+};
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SincFilterManager);
+}
+
+namespace Audio {
+
+/** Zeroth order modified Bessel function of the first kind. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+SincFilterManager::~SincFilterManager() {
+	for (uint i = 0; i < _filters.size(); i++)
+		destroyFilter(_filters[i]);
+}
+
+const SincFilter *SincFilterManager::acquire(uint phases, uint step, uint taps) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _filters.size(); i++) {
+		SincFilter *filter = _filters[i];
+		if (filter->phases == phases && filter->step == step && filter->taps == taps) {
+			filter->refCount++;
+			return filter;
+		}
+	}
+
+	SincFilter *filter = createFilter(phases, step, taps);
+	filter->refCount = 1;
+	_filters.push_back(filter);
+	return filter;
+}
+
+void SincFilterManager::release(const SincFilter *filter) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _filters.size(); i++) {
+		if (_filters[i] == filter) {
+			if (--_filters[i]->refCount == 0) {
+				destroyFilter(_filters[i]);
+				_filters.remove_at(i);
+			}
+			return;
+		}
+	}
+}
+
+SincFilter *SincFilterManager::createFilter(uint phases, uint step, uint taps) {
+	SincFilter *filter = new SincFilter();
+	filter->phases = phases;
+	filter->step = step;
+	filter->taps = taps;
+	filter->refCount = 0;
+
+	filter->storage = (byte *)malloc(phases * taps * sizeof(int16) + kSincCoeffAlignment);
+	if (!filter->storage)
+		error("[SincFilterManager::createFilter] Cannot allocate memory for filter coefficients");
+
+	int16 *coeffs = (int16 *)(filter->storage + kSincCoeffAlignment - ((uintptr)filter->storage % kSincCoeffAlignment));
+	filter->coeffs = coeffs;
+
+	// When downsampling, the cutoff has to be lowered to the output Nyquist
+	// frequency. Leave some room for the transition band in either case.
+	const double rolloff = (taps >= 64) ? 0.95 : (taps >= 32) ? 0.92 : 0.85;
+	const double cutoff = MIN(1.0, (double)phases / step) * rolloff;
+	const double beta = (taps >= 64) ? 9.0 : (taps >= 32) ? 8.0 : 6.0;
+	const double halfLength = taps / 2;
+	const double norm = besselI0(beta);
+
+	double *kernel = new double[taps];
+	for (uint phase = 0; phase < phases; phase++) {
+		double sum = 0.0;
+		for (uint tap = 0; tap < taps; tap++) {
+			// Distance between the output position and the input sample
+			const double d = (double)tap - (halfLength - 1) - (double)phase / phases;
+			const double x = d / halfLength;
+
+			double value = cutoff;
+			if (d != 0.0)
+				value = sin(M_PI * cutoff * d) / (M_PI * d);
+			if (x <= -1.0 || x >= 1.0)
+				value = 0.0;
+			else
+				value *= besselI0(beta * sqrt(1.0 - x * x)) / norm;
+
+			kernel[tap] = value;
+			sum += value;
+		}
+
+		// Normalize every phase to unity gain, so a constant input signal
+		// produces a constant output.
+		for (uint tap = 0; tap < taps; tap++)
+			coeffs[phase * taps + tap] = (int16)floor(kernel[tap] / sum * (1 << kSincCoeffBits) + 0.5);
+	}
+	delete[] kernel;
+
+	return filter;
+}
+
+void SincFilterManager::destroyFilter(SincFilter *filter) {
+	free(filter->storage);
+	delete filter;
+}
+
+int32 convolve(const st_sample_t *samples, const int16 *coeffs, uint taps) {
+	int32 sum = 0;
+	for (uint i = 0; i < taps; i++)
+		sum += samples[i] * coeffs[i];
+	return sum;
+}
+
+RateConvolveFunc getRateConvolveFunc() {
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return convolveAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return convolveSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return convolveNEON;
+#endif
+	return convolve;
+}
+
+#pragma mark -
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc filter.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** deinterleaved input samples (left/right channel) */
+	st_sample_t *chan[2];
+	/** number of samples in chan */
+	uint chanLen;
+	/** position of the first filter tap of the next output sample in chan */
+	uint chanPos;
+	/** number of input samples still to skip after chan has been consumed */
+	uint skip;
+
+	const SincFilter *filter;
+	/** current phase, in the range 0 to filter->phases - 1 */
+	uint phase;
+	/** whole and fractional part of the position increment */
+	uint posInc, phaseInc;
+
+	/** resampled data, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	RateMixFunc mix;
+	RateConvolveFunc convolveFunc;
+
+	bool refill(AudioStream &input);
+
+	inline st_sample_t filterSample(const st_sample_t *samples, const int16 *coeffs) const {
+		const int32 sum = convolveFunc(samples, coeffs, filter->taps);
+		return (st_sample_t)CLIP<int32>((sum + (1 << (kSincCoeffBits - 1))) >> kSincCoeffBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+public:
+	SincRateConverter(const SincFilter *sincFilter, RateMixFunc mixFunc);
+	~SincRateConverter();
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(const SincFilter *sincFilter, RateMixFunc mixFunc)
+	: skip(0), filter(sincFilter), phase(0), mix(mixFunc), convolveFunc(getRateConvolveFunc()) {
+	posInc = filter->step / filter->phases;
+	phaseInc = filter->step % filter->phases;
+
+	// Samples left over from the previous read are always fewer than the
+	// number of taps, so this is enough room for one more read.
+	const uint chanSize = filter->taps + INTERMEDIATE_BUFFER_SIZE;
+	chan[0] = new st_sample_t[chanSize];
+	chan[1] = stereo ? new st_sample_t[chanSize] : 0;
+
+	// Prefill with silence, so that the first output sample is centered on
+	// the first input sample.
+	chanLen = filter->taps / 2 - 1;
+	chanPos = 0;
+	memset(chan[0], 0, chanLen * sizeof(st_sample_t));
+	if (stereo)
+		memset(chan[1], 0, chanLen * sizeof(st_sample_t));
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	delete[] chan[0];
+	delete[] chan[1];
+	SincFilterManager::instance().release(filter);
+}
+
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	// Move the samples which are still needed to the start of the buffer
+	if (chanPos < chanLen) {
+		const uint keep = chanLen - chanPos;
+		memmove(chan[0], chan[0] + chanPos, keep * sizeof(st_sample_t));
+		if (stereo)
+			memmove(chan[1], chan[1] + chanPos, keep * sizeof(st_sample_t));
+		chanLen = keep;
+	} else {
+		// When downsampling we might have to skip input samples we never read
+		skip += chanPos - chanLen;
+		chanLen = 0;
+	}
+	chanPos = 0;
+
+	const int len = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+	if (len <= 0)
+		return false;
+
+	const st_sample_t *ptr = inBuf;
+	const st_sample_t *end = inBuf + len;
+	for (; skip > 0 && ptr < end; skip--)
+		ptr += (stereo ? 2 : 1);
+
+	while (ptr < end) {
+		chan[0][chanLen] = *ptr++;
+		if (stereo)
+			chan[1][chanLen] = *ptr++;
+		chanLen++;
+	}
+
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	const uint taps = filter->taps;
+
+	while (obuf < oend) {
+		st_sample_t *tmp = outBuf;
+		st_sample_t *tmpEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / 2) * (stereo ? 2 : 1);
+		bool endOfInput = false;
+
+		while (tmp < tmpEnd) {
+			// Make sure all input samples covered by the filter are available
+			if (chanPos + taps > chanLen) {
+				if (!refill(input)) {
+					endOfInput = true;
+					break;
+				}
+				continue;
+			}
+
+			const int16 *coeffs = filter->coeffs + phase * taps;
+			*tmp++ = filterSample(chan[0] + chanPos, coeffs);
+			if (stereo)
+				*tmp++ = filterSample(chan[1] + chanPos, coeffs);
+
+			// Increment input position
+			chanPos += posInc;
+			phase += phaseInc;
+			if (phase >= filter->phases) {
+				phase -= filter->phases;
+				chanPos++;
+			}
+		}
+
+		// Mix the resampled data into the output buffer
+		const st_size_t len = (tmp - outBuf) / (stereo ? 2 : 1);
+		mix(obuf, outBuf, len, vol_l, vol_r, stereo, reverseStereo);
+		obuf += len * 2;
+
+		if (endOfInput)
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
+
+#pragma mark -
+
+RateConverter *makeSincRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, int quality, RateMixFunc mixFunc) {
+	const st_rate_t divisor = Common::gcd(inrate, outrate);
+	const uint phases = outrate / divisor;
+	const uint step = inrate / divisor;
+
+	if (phases > kSincMaxPhases)
+		return 0;
+
+	// The SIMD convolution functions process up to 16 taps at once
+	const uint taps = 16 << (CLIP(quality, 1, 3) - 1);
+	const SincFilter *filter = SincFilterManager::instance().acquire(phases, step, taps);
+
+	if (stereo) {
+		if (reverseStereo)
+			return new SincRateConverter<true, true>(filter, mixFunc);
+		else
+			return new SincRateConverter<true, false>(filter, mixFunc);
+	} else
+		return new SincRateConverter<false, false>(filter, mixFunc);
+}
+
+} // End of namespace Audio
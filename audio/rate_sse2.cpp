@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+namespace Audio {
+
+/**
+ * Multiply eight samples with their volumes and divide the result by
+ * Mixer::kMaxMixerVolume, rounding towards zero just like the C code does.
+ */
+static inline __m128i scaleSamples(__m128i samples, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(samples, vol);
+	const __m128i hi = _mm_mulhi_epi16(samples, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Add 255 to negative values before shifting
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24)), 8);
+
+	return _mm_packs_epi32(p0, p1);
+}
+
+static inline void mixSamples(st_sample_t *obuf, __m128i samples, __m128i vol) {
+	const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+	_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaleSamples(samples, vol)));
+}
+
+void mixBufferSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t len, st_volume_t vol_l, st_volume_t vol_r, bool stereo, bool reverseStereo) {
+	if (stereo) {
+		// With reversed stereo the left input channel is scaled with the left
+		// volume but ends up in the right output channel. Swap the input
+		// channels, and scale them with the swapped volumes instead.
+		const __m128i vol = reverseStereo ? _mm_set_epi16(vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r)
+		                                  : _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+		for (; len >= 4; len -= 4) {
+			__m128i samples = _mm_loadu_si128((const __m128i *)ibuf);
+			if (reverseStereo)
+				samples = _mm_shufflehi_epi16(_mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+
+			mixSamples(obuf, samples, vol);
+			ibuf += 8;
+			obuf += 8;
+		}
+	} else {
+		const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+		for (; len >= 8; len -= 8) {
+			const __m128i samples = _mm_loadu_si128((const __m128i *)ibuf);
+
+			mixSamples(obuf,     _mm_unpacklo_epi16(samples, samples), vol);
+			mixSamples(obuf + 8, _mm_unpackhi_epi16(samples, samples), vol);
+			ibuf += 8;
+			obuf += 16;
+		}
+	}
+
+	mixBuffer(obuf, ibuf, len, vol_l, vol_r, stereo, reverseStereo);
+}
+
+int32 convolveSSE2(const st_sample_t *samples, const int16 *coeffs, uint taps) {
+	__m128i sum = _mm_setzero_si128();
+
+	for (uint i = 0; i < taps; i += 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+		const __m128i c = _mm_load_si128((const __m128i *)(coeffs + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(s, c));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+} // End of namespace Audio
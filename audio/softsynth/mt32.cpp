@@ -37,7 +37,10 @@
 #include "common/system.h"
 #include "common/util.h"
 #include "common/archive.h"
+#include "common/atomic.h"
+#include "common/lockfree-queue.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/translation.h"
 #include "common/osd_message_queue.h"
 
@@ -113,6 +116,78 @@ private:
 
 	int _outputRate;
 
+	// Rendering ahead of the mixer, enabled by the mt32_render_ahead option.
+	//
+	// The synth is then rendered into _ring from a timer callback, for a
+	// limited time per call, and the mixer only copies the finished
+	// samples. MIDI events are time stamped with the output position they
+	// are sent at plus the latency, and played when rendering reaches that
+	// position. This delays the output by a fixed amount, but keeps the
+	// timing between events intact.
+	//
+	// All access to _service goes through whoever holds _renderLock. The
+	// event queue is filled by the senders, serialized through _mutex.
+	enum {
+		/** Interval of the render timer callback, in microseconds. */
+		kRenderAheadInterval = 5000,
+		/** Time the render timer callback may spend per call, in microseconds. */
+		kRenderAheadBudget = 2000,
+		/**
+		 * Frames the render timer callback renders at once before releasing
+		 * _renderLock, which bounds the time the mixer may wait for it.
+		 */
+		kRenderAheadChunk = 256,
+		kRenderAheadQueueSize = 1024,
+		/** Limits of the mt32_render_ahead option, in milliseconds. */
+		kRenderAheadMinLatency = 20,
+		kRenderAheadMaxLatency = 1000
+	};
+
+	struct Event {
+		enum Type {
+			kShortMessage,
+			kSysEx,
+			kWriteSysEx
+		};
+
+		Type type;
+		uint32 timestamp;
+		uint32 msg;
+		byte *data;
+		uint16 length;
+		byte channel;
+	};
+
+	Common::LockFreeQueue<Event> *_events;
+	Event _pendingEvent;
+	bool _hasPendingEvent;
+
+	int16 *_ring;
+	uint32 _ringMask;
+	uint32 _latency;
+	uint32 _renderPos;
+	volatile uint32 _readPos;
+	volatile uint32 _writePos;
+	volatile int32 _renderLock;
+	/** Set while the mixer waits for _renderLock, so that the timer lets go. */
+	volatile bool _mixerWaiting;
+
+	bool tryLockRender() { return Common::atomicCompareAndSwap(&_renderLock, 0, 1); }
+	void unlockRender() { Common::memoryBarrier(); _renderLock = 0; }
+
+	void openRenderAhead(int milliseconds);
+	void closeRenderAhead();
+	void pushEvent(Event::Type type, uint32 msg, const byte *data, uint16 length, byte channel = 0);
+	void playEvent(const Event &event);
+	/** Render @p len frames at _renderPos, playing the events due. Needs _renderLock. */
+	void render(int16 *data, uint32 len);
+	/** Render the next part of the ring buffer. Needs _renderLock. */
+	bool renderAhead();
+	uint32 readFromRing(int16 *data, uint32 len);
+	void generateSamplesAhead(int16 *data, int len);
+
+	static void renderTimerProc(void *refCon);
+
 protected:
 	void generateSamples(int16 *buf, int len) override;
 
@@ -150,6 +225,15 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+
+	_events = nullptr;
+	_hasPendingEvent = false;
+	_ring = nullptr;
+	_ringMask = 0;
+	_latency = 0;
+	_renderPos = _readPos = _writePos = 0;
+	_renderLock = 0;
+	_mixerWaiting = false;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -207,6 +291,9 @@ int MidiDriver_MT32::open() {
 	// AudioStream.
 	_outputRate = _service.getActualStereoOutputSamplerate();
 
+	if (ConfMan.hasKey("mt32_render_ahead") && ConfMan.getInt("mt32_render_ahead") > 0)
+		openRenderAhead(ConfMan.getInt("mt32_render_ahead"));
+
 	MidiDriver_Emulated::open();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
@@ -218,6 +305,10 @@ void MidiDriver_MT32::send(uint32 b) {
 	midiDriverCommonSend(b);
 
 	Common::StackLock lock(_mutex);
+	if (_events) {
+		pushEvent(Event::kShortMessage, b, nullptr, 0);
+		return;
+	}
 	_service.playMsg(b);
 }
 
@@ -229,6 +320,10 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	}
 	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
 	Common::StackLock lock(_mutex);
+	if (_events) {
+		pushEvent(Event::kWriteSysEx, 0, benderRangeSysex, 4, channel);
+		return;
+	}
 	_service.writeSysex(channel, benderRangeSysex, 4);
 }
 
@@ -236,6 +331,10 @@ void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 	midiDriverCommonSysEx(msg, length);
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
+		if (_events) {
+			pushEvent(Event::kSysEx, 0, msg, length);
+			return;
+		}
 		_service.playSysex(msg, length);
 	} else {
 		enum {
@@ -245,6 +344,10 @@ void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 
 		if (msg[3] == SYSEX_CMD_DT1 || msg[3] == SYSEX_CMD_DAT) {
 			Common::StackLock lock(_mutex);
+			if (_events) {
+				pushEvent(Event::kWriteSysEx, 0, msg + 4, length - 5, msg[1]);
+				return;
+			}
 			_service.writeSysex(msg[1], msg + 4, length - 5);
 		} else {
 			warning("Unused sysEx command %d", msg[3]);
@@ -262,6 +365,8 @@ void MidiDriver_MT32::close() {
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
 
+	closeRenderAhead();
+
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
@@ -272,154 +377,224 @@ void MidiDriver_MT32::close() {
 }
 
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+	if (_ring) {
+		generateSamplesAhead(data, len);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	_service.renderBit16s(data, len);
 }
 
-uint32 MidiDriver_MT32::property(int prop, uint32 param) {
-	switch (prop) {
-	case PROP_CHANNEL_MASK:
-		_channelMask = param & 0xFFFF;
-		return 1;
-	default:
-		break;
-	}
+void MidiDriver_MT32::openRenderAhead(int milliseconds) {
+	milliseconds = CLIP(milliseconds, (int)kRenderAheadMinLatency, (int)kRenderAheadMaxLatency);
+	_latency = _outputRate * milliseconds / 1000;
 
-	return 0;
+	uint32 size = 1;
+	while (size < _latency)
+		size <<= 1;
+	_ring = new int16[size * 2];
+	_ringMask = size - 1;
+
+	_events = new Common::LockFreeQueue<Event>(kRenderAheadQueueSize);
+	_hasPendingEvent = false;
+	_renderPos = _readPos = _writePos = 0;
+	_renderLock = 0;
+	_mixerWaiting = false;
+
+	g_system->getTimerManager()->installTimerProc(&renderTimerProc, kRenderAheadInterval, this, "MT32RenderAhead");
 }
 
-MidiChannel *MidiDriver_MT32::allocateChannel() {
-	MidiChannel_MT32 *chan;
-	uint i;
+void MidiDriver_MT32::closeRenderAhead() {
+	if (!_ring)
+		return;
 
-	for (i = 0; i < ARRAYSIZE(_midiChannels); ++i) {
-		if (i == 9 || !(_channelMask & (1 << i)))
-			continue;
-		chan = &_midiChannels[i];
-		if (chan->allocate()) {
-			return chan;
-		}
+	// Waits for a running callback to finish
+	g_system->getTimerManager()->removeTimerProc(&renderTimerProc);
+
+	Common::StackLock lock(_mutex);
+
+	if (_hasPendingEvent)
+		delete[] _pendingEvent.data;
+	_hasPendingEvent = false;
+
+	Event event;
+	while (_events->pop(event))
+		delete[] event.data;
+
+	delete _events;
+	_events = nullptr;
+	delete[] _ring;
+	_ring = nullptr;
+}
+
+void MidiDriver_MT32::pushEvent(Event::Type type, uint32 msg, const byte *data, uint16 length, byte channel) {
+	Event event;
+	event.type = type;
+	event.timestamp = _readPos + _latency;
+	event.msg = msg;
+	event.data = nullptr;
+	event.length = length;
+	event.channel = channel;
+	if (length) {
+		event.data = new byte[length];
+		memcpy(event.data, data, length);
+	}
+
+	if (!_events->push(event)) {
+		warning("MT-32 emulator event queue overflow, dropping event");
+		delete[] event.data;
 	}
-	return NULL;
 }
 
-MidiChannel *MidiDriver_MT32::getPercussionChannel() {
-	return &_midiChannels[9];
+void MidiDriver_MT32::playEvent(const Event &event) {
+	switch (event.type) {
+	case Event::kShortMessage:
+		_service.playMsg(event.msg);
+		break;
+	case Event::kSysEx:
+		_service.playSysex(event.data, event.length);
+		break;
+	case Event::kWriteSysEx:
+		_service.writeSysex(event.channel, event.data, event.length);
+		break;
+	default:
+		break;
+	}
+	delete[] event.data;
 }
 
-// This code should be used when calling the timer callback from the mixer thread is undesirable.
-// Note that it results in less accurate timing.
-#if 0
-class MidiEvent_MT32 {
-public:
-	MidiEvent_MT32 *_next;
-	uint32 _msg; // 0xFFFFFFFF indicates a sysex message
-	byte *_data;
-	uint32 _len;
-
-	MidiEvent_MT32(uint32 msg, byte *data, uint32 len) {
-		_msg = msg;
-		if (len > 0) {
-			_data = new byte[len];
-			memcpy(_data, data, len);
+void MidiDriver_MT32::render(int16 *data, uint32 len) {
+	while (len) {
+		if (!_hasPendingEvent)
+			_hasPendingEvent = _events->pop(_pendingEvent);
+
+		uint32 step = len;
+		if (_hasPendingEvent) {
+			const int32 due = (int32)(_pendingEvent.timestamp - _renderPos);
+			if (due <= 0) {
+				// The synth plays messages immediately, so this takes effect
+				// with the next rendered sample.
+				playEvent(_pendingEvent);
+				_hasPendingEvent = false;
+				continue;
+			}
+			step = MIN<uint32>(step, due);
 		}
-		_len = len;
-		_next = NULL;
-	}
 
-	MidiEvent_MT32() {
-		if (_len > 0)
-			delete _data;
+		_service.renderBit16s(data, step);
+		data += step * 2;
+		len -= step;
+		_renderPos += step;
 	}
-};
+}
 
-class MidiDriver_ThreadedMT32 : public MidiDriver_MT32 {
-private:
-	OSystem::Mutex _eventMutex;
-	MidiEvent_MT32 *_events;
-	TimerManager::TimerProc _timer_proc;
+bool MidiDriver_MT32::renderAhead() {
+	const uint32 buffered = _renderPos - _readPos;
+	if (buffered >= _latency)
+		return false;
 
-	void pushMidiEvent(MidiEvent_MT32 *event);
-	MidiEvent_MT32 *popMidiEvent();
+	// Do not overwrite samples the mixer has not finished copying yet
+	Common::memoryBarrier();
 
-protected:
-	void send(uint32 b);
-	void sysEx(const byte *msg, uint16 length);
+	const uint32 offset = _renderPos & _ringMask;
+	const uint32 len = MIN<uint32>(MIN<uint32>(_latency - buffered, kRenderAheadChunk), _ringMask + 1 - offset);
+	render(_ring + offset * 2, len);
 
-public:
-	MidiDriver_ThreadedMT32(Audio::Mixer *mixer);
+	Common::memoryBarrier();
+	_writePos = _renderPos;
+	return true;
+}
 
-	void onTimer();
-	void close();
-	void setTimerCallback(void *timer_param, TimerManager::TimerProc timer_proc);
-};
+uint32 MidiDriver_MT32::readFromRing(int16 *data, uint32 len) {
+	const uint32 readPos = _readPos;
+	const uint32 available = _writePos - readPos;
+	Common::memoryBarrier();
 
+	const uint32 frames = MIN(len, available);
+	const uint32 offset = readPos & _ringMask;
+	const uint32 firstPart = MIN(frames, _ringMask + 1 - offset);
+	memcpy(data, _ring + offset * 2, firstPart * 2 * sizeof(int16));
+	memcpy(data + firstPart * 2, _ring, (frames - firstPart) * 2 * sizeof(int16));
 
-MidiDriver_ThreadedMT32::MidiDriver_ThreadedMT32(Audio::Mixer *mixer) : MidiDriver_MT32(mixer) {
-	_events = NULL;
-	_timer_proc = NULL;
+	Common::memoryBarrier();
+	_readPos = readPos + frames;
+	return frames;
 }
 
-void MidiDriver_ThreadedMT32::close() {
-	MidiDriver_MT32::close();
-	while ((popMidiEvent() != NULL)) {
-		// Just eat any leftover events
-	}
-}
+void MidiDriver_MT32::generateSamplesAhead(int16 *data, int len) {
+	uint32 done = readFromRing(data, len);
+	if (done == (uint32)len)
+		return;
 
-void MidiDriver_ThreadedMT32::setTimerCallback(void *timer_param, TimerManager::TimerProc timer_proc) {
-	if (!_timer_proc || !timer_proc) {
-		if (_timer_proc)
-			_vm->_timer->removeTimerProc(_timer_proc);
-		_timer_proc = timer_proc;
-		if (timer_proc)
-			_vm->_timer->installTimerProc(timer_proc, getBaseTempo(), timer_param, "MT32tempo");
-	}
+	// The timer did not keep up. It only holds the lock while rendering a
+	// single slice of kRenderAheadChunk frames, so wait for it without
+	// sleeping, then render the rest ourselves.
+	_mixerWaiting = true;
+	while (!tryLockRender())
+		;
+	_mixerWaiting = false;
+
+	done += readFromRing(data + done * 2, len - done);
+
+	// The ring buffer is empty now, so the next samples to render are the
+	// ones the mixer needs right now.
+	const uint32 missing = len - done;
+	render(data + done * 2, missing);
+	Common::memoryBarrier();
+	_writePos = _renderPos;
+	_readPos += missing;
+
+	unlockRender();
 }
 
-void MidiDriver_ThreadedMT32::pushMidiEvent(MidiEvent_MT32 *event) {
-	Common::StackLock lock(_eventMutex);
-	if (_events == NULL) {
-		_events = event;
-	} else {
-		MidiEvent_MT32 *last = _events;
-		while (last->_next != NULL)
-			last = last->_next;
-		last->_next = event;
+void MidiDriver_MT32::renderTimerProc(void *refCon) {
+	MidiDriver_MT32 *driver = (MidiDriver_MT32 *)refCon;
+
+	// The timer thread also runs the engine and MIDI tempo timer callbacks,
+	// so only render for a limited time per call. If this does not keep
+	// up, the mixer renders the missing samples itself.
+	const uint64 deadline = g_system->getMicros() + kRenderAheadBudget;
+	bool more = true;
+	while (more && !driver->_mixerWaiting && driver->tryLockRender()) {
+		more = driver->renderAhead();
+		driver->unlockRender();
+
+		if (g_system->getMicros() >= deadline)
+			break;
 	}
 }
 
-MidiEvent_MT32 *MidiDriver_ThreadedMT32::popMidiEvent() {
-	Common::StackLock lock(_eventMutex);
-	MidiEvent_MT32 *event;
-	event = _events;
-	if (event != NULL)
-		_events = event->_next;
-	return event;
-}
+uint32 MidiDriver_MT32::property(int prop, uint32 param) {
+	switch (prop) {
+	case PROP_CHANNEL_MASK:
+		_channelMask = param & 0xFFFF;
+		return 1;
+	default:
+		break;
+	}
 
-void MidiDriver_ThreadedMT32::send(uint32 b) {
-	MidiEvent_MT32 *event = new MidiEvent_MT32(b, NULL, 0);
-	pushMidiEvent(event);
+	return 0;
 }
 
-void MidiDriver_ThreadedMT32::sysEx(const byte *msg, uint16 length) {
-	MidiEvent_MT32 *event = new MidiEvent_MT32(0xFFFFFFFF, msg, length);
-	pushMidiEvent(event);
-}
+MidiChannel *MidiDriver_MT32::allocateChannel() {
+	MidiChannel_MT32 *chan;
+	uint i;
 
-void MidiDriver_ThreadedMT32::onTimer() {
-	MidiEvent_MT32 *event;
-	while ((event = popMidiEvent()) != NULL) {
-		if (event->_msg == 0xFFFFFFFF) {
-			MidiDriver_MT32::sysEx(event->_data, event->_len);
-		} else {
-			MidiDriver_MT32::send(event->_msg);
+	for (i = 0; i < ARRAYSIZE(_midiChannels); ++i) {
+		if (i == 9 || !(_channelMask & (1 << i)))
+			continue;
+		chan = &_midiChannels[i];
+		if (chan->allocate()) {
+			return chan;
 		}
-		delete event;
 	}
+	return NULL;
+}
+
+MidiChannel *MidiDriver_MT32::getPercussionChannel() {
+	return &_midiChannels[9];
 }
-#endif
 
 
 // Plugin interface
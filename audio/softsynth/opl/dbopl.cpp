@@ -35,6 +35,7 @@
 // Last synch with DOSBox SVN trunk r3752
 
 #include "dbopl.h"
+#include "common/system.h"
 
 #ifndef DISABLE_DOSBOX_OPL
 
@@ -598,6 +599,77 @@ INLINE Bits Operator::GetSample( Bits modulation ) {
 	}
 }
 
+/*
+	Batched generation: every operator generates BATCH_SIZE samples at once,
+	which needs the exact same operations as the per sample code, just in
+	a different order. Operators don't depend on each other's state, only on
+	the output of the operators before them.
+*/
+
+//Forward the envelope for count samples, returns true if they're all silent
+bool Operator::ForwardVolumes( Bitu count, Bit32u* vols ) {
+	Bitu i = 0;
+	Bit32u silent = ~0;
+	while ( i < count ) {
+		//These states can't change during a block, no need to run the handler
+		if ( state == OFF || ( state == SUSTAIN && ( reg20 & MASK_SUSTAIN ) ) ) {
+			Bit32u vol = currentLevel + ( state == OFF ? ENV_MAX : volume );
+			for ( ; i < count; i++ ) {
+				vols[ i ] = vol;
+			}
+			return silent && ENV_SILENT( vol );
+		}
+		Bit32u vol = ForwardVolume();
+		vols[ i++ ] = vol;
+		if ( !ENV_SILENT( vol ) )
+			silent = 0;
+	}
+	return silent != 0;
+}
+
+INLINE Bits Operator::GetSampleVolume( Bits modulation, Bitu vol ) {
+	if ( ENV_SILENT( vol ) ) {
+		waveIndex += waveCurrent;
+		return 0;
+	} else {
+		Bitu index = ForwardWave();
+		index += modulation;
+		return GetWave( index, vol );
+	}
+}
+
+void Operator::GenerateWave( const Chip* chip, Bitu count, const Bit32s* modulation, Bit32s* output ) {
+	Bit32u vols[ BATCH_SIZE ];
+	if ( ForwardVolumes( count, vols ) ) {
+		waveIndex += waveCurrent * count;
+		memset( output, 0, sizeof( Bit32s ) * count );
+		return;
+	}
+#if ( DBOPL_WAVE == WAVE_TABLEMUL )
+	//Gather the table entries, silent samples get multiplied by 0
+	Bit16s wave[ BATCH_SIZE ];
+	Bit16u mul[ BATCH_SIZE ];
+	for ( Bitu i = 0; i < count; i++ ) {
+		Bitu index = ForwardWave();
+		if ( modulation )
+			index += modulation[ i ];
+		wave[ i ] = waveBase[ index & waveMask ];
+		mul[ i ] = ENV_SILENT( vols[ i ] ) ? 0 : MulTable[ vols[ i ] >> ENV_EXTRA ];
+	}
+	chip->waveMul( wave, mul, output, count );
+#else
+	for ( Bitu i = 0; i < count; i++ ) {
+		output[ i ] = GetSampleVolume( modulation ? modulation[ i ] : 0, vols[ i ] );
+	}
+#endif
+}
+
+void WaveMul( const Bit16s* wave, const Bit16u* mul, Bit32s* output, Bitu count ) {
+	for ( Bitu i = 0; i < count; i++ ) {
+		output[ i ] = ( wave[ i ] * mul[ i ] ) >> MUL_SH;
+	}
+}
+
 Operator::Operator() {
 	chanData = 0;
 	freqMul = 0;
@@ -843,6 +915,67 @@ INLINE void Channel::GeneratePercussion( Chip* chip, Bit32s* output ) {
 	}
 }
 
+template<SynthMode mode>
+void Channel::GenerateBatched( Chip* chip, Bit32u samples, Bit32s* output ) {
+	Bit32u vols[ BATCH_SIZE ];
+	Bit32s out0[ BATCH_SIZE ];
+	Bit32s next[ BATCH_SIZE ];
+	Bit32s sample[ BATCH_SIZE ];
+	while ( samples > 0 ) {
+		const Bitu count = MIN<Bitu>( samples, BATCH_SIZE );
+		//The feedback of the first operator needs to be done sample by sample
+		Op(0)->ForwardVolumes( count, vols );
+		for ( Bitu i = 0; i < count; i++ ) {
+			Bit32s mod = (Bit32u)((old[0] + old[1])) >> feedback;
+			old[0] = old[1];
+			old[1] = Op(0)->GetSampleVolume( mod, vols[ i ] );
+			out0[ i ] = old[0];
+		}
+		//The others only modulate each other within the same sample
+		if ( mode == sm2AM || mode == sm3AM ) {
+			Op(1)->GenerateWave( chip, count, 0, sample );
+			for ( Bitu i = 0; i < count; i++ )
+				sample[ i ] += out0[ i ];
+		} else if ( mode == sm2FM || mode == sm3FM ) {
+			Op(1)->GenerateWave( chip, count, out0, sample );
+		} else if ( mode == sm3FMFM ) {
+			Op(1)->GenerateWave( chip, count, out0, sample );
+			Op(2)->GenerateWave( chip, count, sample, next );
+			Op(3)->GenerateWave( chip, count, next, sample );
+		} else if ( mode == sm3AMFM ) {
+			Op(1)->GenerateWave( chip, count, 0, sample );
+			Op(2)->GenerateWave( chip, count, sample, next );
+			Op(3)->GenerateWave( chip, count, next, sample );
+			for ( Bitu i = 0; i < count; i++ )
+				sample[ i ] += out0[ i ];
+		} else if ( mode == sm3FMAM ) {
+			Op(1)->GenerateWave( chip, count, out0, out0 );
+			Op(2)->GenerateWave( chip, count, 0, next );
+			Op(3)->GenerateWave( chip, count, next, sample );
+			for ( Bitu i = 0; i < count; i++ )
+				sample[ i ] += out0[ i ];
+		} else if ( mode == sm3AMAM ) {
+			Op(1)->GenerateWave( chip, count, 0, next );
+			Op(2)->GenerateWave( chip, count, next, sample );
+			Op(3)->GenerateWave( chip, count, 0, next );
+			for ( Bitu i = 0; i < count; i++ )
+				sample[ i ] += out0[ i ] + next[ i ];
+		}
+		if ( mode == sm2AM || mode == sm2FM ) {
+			for ( Bitu i = 0; i < count; i++ )
+				output[ i ] += sample[ i ];
+			output += count;
+		} else {
+			for ( Bitu i = 0; i < count; i++ ) {
+				output[ i * 2 + 0 ] += sample[ i ] & maskLeft;
+				output[ i * 2 + 1 ] += sample[ i ] & maskRight;
+			}
+			output += count * 2;
+		}
+		samples -= count;
+	}
+}
+
 template<SynthMode mode>
 Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 	switch( mode ) {
@@ -918,6 +1051,10 @@ Channel* Channel::BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output ) {
 		Op( 4 )->Prepare( chip );
 		Op( 5 )->Prepare( chip );
 	}
+	if ( mode != sm2Percussion && mode != sm3Percussion && !chip->perSample ) {
+		GenerateBatched< mode >( chip, samples, output );
+		samples = 0;
+	}
 	for ( Bitu i = 0; i < samples; i++ ) {
 		//Early out for percussion handlers
 		if ( mode == sm2Percussion ) {
@@ -1035,6 +1172,8 @@ Chip::Chip() {
 	regBD = 0;
 	reg104 = 0;
 	opl3Active = 0;
+	perSample = false;
+	waveMul = &WaveMul;
 }
 
 INLINE Bit32u Chip::ForwardNoise() {
@@ -1266,6 +1405,16 @@ void Chip::GenerateBlock3( Bitu total, Bit32s* output  ) {
 void Chip::Setup( Bit32u rate ) {
 	double scale = OPLRATE / (double)rate;
 
+	waveMul = &WaveMul;
+#ifdef SCUMMVM_SSE2
+	if ( g_system->hasFeature( OSystem::kFeatureCpuSSE2 ) )
+		waveMul = &WaveMulSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if ( g_system->hasFeature( OSystem::kFeatureCpuNEON ) )
+		waveMul = &WaveMulNEON;
+#endif
+
 	//Noise counter is run at the same precision as general waves
 	noiseAdd = (Bit32u)( 0.5 + scale * ( 1 << LFO_SH ) );
 	noiseCounter = 0;
@@ -68,6 +68,11 @@ typedef Bits ( DB_FASTCALL *WaveHandler) ( Bitu i, Bitu volume );
 
 typedef Bits ( DBOPL::Operator::*VolumeHandler) ( );
 typedef Channel* ( DBOPL::Channel::*SynthHandler) ( Chip* chip, Bit32u samples, Bit32s* output );
+//Multiply a block of wave samples with their volume multipliers, see Operator::GenerateWave
+typedef void ( *WaveMulHandler) ( const Bit16s* wave, const Bit16u* mul, Bit32s* output, Bitu count );
+
+//Amount of samples the operators generate at once in the batched synth mode
+#define BATCH_SIZE 64
 
 //Different synth modes that can generate blocks of data
 typedef enum {
@@ -178,6 +183,11 @@ public:
 
 	Bits GetSample( Bits modulation );
 	Bits GetWave( Bitu index, Bitu vol );
+
+	//Batched versions of the above, generating count samples at once
+	bool ForwardVolumes( Bitu count, Bit32u* vols );
+	Bits GetSampleVolume( Bits modulation, Bitu vol );
+	void GenerateWave( const Chip* chip, Bitu count, const Bit32s* modulation, Bit32s* output );
 public:
 	Operator();
 };
@@ -215,6 +225,9 @@ struct Channel {
 	//Generate blocks of data in specific modes
 	template<SynthMode mode>
 	Channel* BlockTemplate( Chip* chip, Bit32u samples, Bit32s* output );
+	//Generate the block one operator at a time instead of one sample at a time
+	template<SynthMode mode>
+	void GenerateBatched( Chip* chip, Bit32u samples, Bit32s* output );
 	Channel();
 };
 
@@ -254,6 +267,11 @@ struct Chip {
 	//0 or -1 when enabled
 	Bit8s opl3Active;
 
+	//Use the original sample by sample generation instead of the batched one
+	bool perSample;
+	//Routine used for the batched wave generation, selected in Setup
+	WaveMulHandler waveMul;
+
 	//Return the maximum amount of samples before and LFO change
 	Bit32u ForwardLFO( Bit32u samples );
 	Bit32u ForwardNoise();
@@ -274,6 +292,14 @@ struct Chip {
 
 void InitTables();
 
+void WaveMul( const Bit16s* wave, const Bit16u* mul, Bit32s* output, Bitu count );
+#ifdef SCUMMVM_SSE2
+void WaveMulSSE2( const Bit16s* wave, const Bit16u* mul, Bit32s* output, Bitu count );
+#endif
+#ifdef SCUMMVM_NEON
+void WaveMulNEON( const Bit16s* wave, const Bit16u* mul, Bit32s* output, Bitu count );
+#endif
+
 }		//Namespace
 } // End of namespace DOSBox
 } // End of namespace OPL
@@ -0,0 +1,50 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/softsynth/opl/dbopl.h"
+
+#ifndef DISABLE_DOSBOX_OPL
+
+#include <arm_neon.h>
+
+namespace OPL {
+namespace DOSBox {
+namespace DBOPL {
+
+void WaveMulNEON(const Bit16s *wave, const Bit16u *mul, Bit32s *output, Bitu count) {
+	Bitu i = 0;
+	for (; i + 4 <= count; i += 4) {
+		// The multipliers use all 16 bits, so widen both before multiplying
+		const int32x4_t w = vmovl_s16(vld1_s16(wave + i));
+		const int32x4_t m = vreinterpretq_s32_u32(vmovl_u16(vld1_u16(mul + i)));
+		vst1q_s32(output + i, vshrq_n_s32(vmulq_s32(w, m), 16));
+	}
+
+	for (; i < count; i++)
+		output[i] = (wave[i] * mul[i]) >> 16;
+}
+
+} // End of namespace DBOPL
+} // End of namespace DOSBox
+} // End of namespace OPL
+
+#endif // !DISABLE_DOSBOX_OPL
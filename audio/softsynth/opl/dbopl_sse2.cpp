@@ -0,0 +1,57 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/softsynth/opl/dbopl.h"
+
+#ifndef DISABLE_DOSBOX_OPL
+
+#include <emmintrin.h>
+
+namespace OPL {
+namespace DOSBox {
+namespace DBOPL {
+
+void WaveMulSSE2(const Bit16s *wave, const Bit16u *mul, Bit32s *output, Bitu count) {
+	Bitu i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i w = _mm_loadu_si128((const __m128i *)(wave + i));
+		const __m128i m = _mm_loadu_si128((const __m128i *)(mul + i));
+
+		// The product shifted down by 16 is just its high half. Take the
+		// unsigned one and correct it for the negative wave samples.
+		__m128i hi = _mm_mulhi_epu16(w, m);
+		hi = _mm_sub_epi16(hi, _mm_and_si128(m, _mm_srai_epi16(w, 15)));
+
+		const __m128i sign = _mm_srai_epi16(hi, 15);
+		_mm_storeu_si128((__m128i *)(output + i), _mm_unpacklo_epi16(hi, sign));
+		_mm_storeu_si128((__m128i *)(output + i + 4), _mm_unpackhi_epi16(hi, sign));
+	}
+
+	for (; i < count; i++)
+		output[i] = (wave[i] * mul[i]) >> 16;
+}
+
+} // End of namespace DBOPL
+} // End of namespace DOSBox
+} // End of namespace OPL
+
+#endif // !DISABLE_DOSBOX_OPL
@@ -684,6 +684,16 @@ void multiplyColorWithAlpha(const byte *src, byte *dst, const uint w, const uint
 		dst += dstPitch - w * dstFmt.bytesPerPixel;
 	}
 }
+
+/**
+ * The parameters of the cursor conversion, which are part of the key of the
+ * cursor cache. Value-initialize it to get the padding cleared.
+ */
+struct CursorCacheParams {
+	uint32 keyColor;
+	uint16 w, h;
+	Graphics::PixelFormat inputFormat, textureFormat;
+};
 } // End of anonymous namespace
 
 void OpenGLGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {
@@ -746,6 +756,23 @@ void OpenGLGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int
 		Graphics::Surface *dst = _cursor->getSurface();
 		const uint srcPitch = w * inputFormat.bytesPerPixel;
 
+		// Cursor animations keep setting the same few cursors, so reuse the
+		// converted images of the cursors seen before.
+		CursorCacheParams params = CursorCacheParams();
+		params.keyColor = keycolor;
+		params.w = w;
+		params.h = h;
+		params.inputFormat = inputFormat;
+		params.textureFormat = dst->format;
+
+		const Graphics::Surface *cachedImage = _cursorCache.find(buf, h * srcPitch, &params, sizeof(params));
+		if (cachedImage) {
+			dst->copyRectToSurface(*cachedImage, 0, 0, Common::Rect(w, h));
+			_cursor->flagDirty();
+			recalculateCursorScaling();
+			return;
+		}
+
 		// Copy the cursor data to the actual texture surface. This will make
 		// sure that the data is also converted to the expected format.
 
@@ -771,6 +798,8 @@ void OpenGLGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int
 			}
 		}
 
+		_cursorCache.insert(buf, h * srcPitch, &params, sizeof(params), *dst);
+
 		// Flag the texture as dirty.
 		_cursor->flagDirty();
 	}
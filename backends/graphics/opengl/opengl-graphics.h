@@ -31,6 +31,7 @@
 #include "common/mutex.h"
 #include "common/ustr.h"
 
+#include "graphics/cursor_cache.h"
 #include "graphics/surface.h"
 
 namespace Graphics {
@@ -353,6 +354,11 @@ protected:
 	 */
 	Surface *_cursor;
 
+	/**
+	 * The converted images of the high color cursors set so far.
+	 */
+	Graphics::CursorCache _cursorCache;
+
 	/**
 	 * The X offset for the cursor hotspot in unscaled game coordinates.
 	 */
@@ -24,6 +24,7 @@
 
 #if defined(SDL_BACKEND)
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
+#include "backends/graphics/surfacesdl/tiled-scaler.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
 #include "common/mutex.h"
@@ -156,7 +157,9 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenFormat(Graphics::PixelFormat::createFormatCLUT8()),
 	_cursorFormat(Graphics::PixelFormat::createFormatCLUT8()),
 	_overlayscreen(0), _tmpscreen2(0),
-	_scalerProc(0), _screenChangeCount(0),
+	_scalerProc(0), _tiledScaler(nullptr), _screenChangeCount(0), _numDirtyRects(0),
+	// Heights of multiples of five keep rects aligned for aspect ratio correction
+	_dirtyRegion(16, 20),
 	_mouseData(nullptr), _mouseSurface(nullptr),
 	_mouseOrigSurface(nullptr), _cursorDontScale(false), _cursorPaletteDisabled(true),
 	_currentShakeXOffset(0), _currentShakeYOffset(0),
@@ -198,6 +201,17 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	_videoMode.stretchMode = STRETCH_FIT;
 #endif
+
+#ifdef USE_SCALERS
+	int scalerThreads = 0;
+	if (ConfMan.hasKey("scaler_threads"))
+		scalerThreads = ConfMan.getInt("scaler_threads");
+	_tiledScaler = new TiledScaler(scalerThreads);
+	if (_tiledScaler->getThreadCount() == 1) {
+		delete _tiledScaler;
+		_tiledScaler = nullptr;
+	}
+#endif
 }
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
@@ -214,6 +228,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	free(_currentPalette);
 	free(_cursorPalette);
 	delete[] _mouseData;
+	delete _tiledScaler;
 }
 
 bool SurfaceSdlGraphicsManager::hasFeature(OSystem::Feature f) const {
@@ -1219,6 +1234,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	updateOSD();
 #endif
 
+	updateDirtyRectList();
+
 	// Force a full redraw if requested
 	if (_forceRedraw) {
 		_numDirtyRects = 1;
@@ -1278,8 +1295,12 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
-					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, dst_w, dst_h);
+				const byte *srcPtr = (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch;
+				byte *dstPtr = (byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch;
+				if (_tiledScaler && scale1 > 1)
+					_tiledScaler->scale(scalerProc, srcPtr, srcPitch, dstPtr, dstPitch, dst_w, dst_h, scale1);
+				else
+					scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, dst_w, dst_h);
 			}
 
 			r->x = dst_x;
@@ -1554,7 +1575,9 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
+	// Rects in hardware coordinates are added after scaling, directly to
+	// the list which is passed to SDL
+	if (realCoordinates && _numDirtyRects == NUM_DIRTY_RECT) {
 		_forceRedraw = true;
 		return;
 	}
@@ -1607,13 +1630,48 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		return;
 	}
 
-	if (w > 0 && h > 0) {
+	if (w <= 0 || h <= 0)
+		return;
+
+	if (realCoordinates) {
 		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
 
 		r->x = x;
 		r->y = y;
 		r->w = w;
 		r->h = h;
+	} else {
+		_dirtyRegion.setSize(MAX(_videoMode.screenWidth, _videoMode.overlayWidth),
+		                     MAX(_videoMode.screenHeight, _videoMode.overlayHeight));
+		_dirtyRegion.addRect(Common::Rect(x, y, x + w, y + h));
+	}
+}
+
+void SurfaceSdlGraphicsManager::updateDirtyRectList() {
+	if (_forceRedraw || _dirtyRegion.isEmpty()) {
+		_dirtyRegion.clear();
+		return;
+	}
+
+	const int maxRects = NUM_DIRTY_RECT - NUM_DIRTY_RECT_RESERVED - _numDirtyRects;
+	if (maxRects <= 0) {
+		_forceRedraw = true;
+		_dirtyRegion.clear();
+		return;
+	}
+
+	_dirtyRegionRects.resize(0);
+	_dirtyRegion.getRects(_dirtyRegionRects, maxRects);
+	_dirtyRegion.clear();
+
+	for (uint i = 0; i < _dirtyRegionRects.size(); i++) {
+		const Common::Rect &rect = _dirtyRegionRects[i];
+		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+
+		r->x = rect.left;
+		r->y = rect.top;
+		r->w = rect.width();
+		r->h = rect.height();
 	}
 }
 
@@ -1747,8 +1805,13 @@ void SurfaceSdlGraphicsManager::clearOverlay() {
 
 	SDL_LockSurface(_tmpscreen);
 	SDL_LockSurface(_overlayscreen);
-	_scalerProc((byte *)(_tmpscreen->pixels) + _tmpscreen->pitch + 2, _tmpscreen->pitch,
-	(byte *)_overlayscreen->pixels, _overlayscreen->pitch, _videoMode.screenWidth, _videoMode.screenHeight);
+	const byte *srcPtr = (byte *)(_tmpscreen->pixels) + _tmpscreen->pitch + 2;
+	if (_tiledScaler && _videoMode.scaleFactor > 1)
+		_tiledScaler->scale(_scalerProc, srcPtr, _tmpscreen->pitch, (byte *)_overlayscreen->pixels, _overlayscreen->pitch,
+		                    _videoMode.screenWidth, _videoMode.screenHeight, _videoMode.scaleFactor);
+	else
+		_scalerProc(srcPtr, _tmpscreen->pitch, (byte *)_overlayscreen->pixels, _overlayscreen->pitch,
+		            _videoMode.screenWidth, _videoMode.screenHeight);
 
 #ifdef USE_SCALERS
 	if (_videoMode.aspectRatioCorrection)
@@ -1934,6 +1997,41 @@ void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h,
 	blitCursor();
 }
 
+namespace {
+
+/**
+ * Everything besides the cursor data which the scaled cursor image depends
+ * on, used as part of the key of the cursor cache. This is compared byte by
+ * byte, so it has to be value-initialized to clear the padding.
+ */
+struct CursorCacheParams {
+	uint32 keyColor;
+	uint32 rMask, gMask, bMask, aMask;
+	int32 mode;
+	int32 scale;
+	uint16 w, h;
+	Graphics::PixelFormat format;
+	byte aspectRatioCorrection;
+	byte palette[256 * 3];
+};
+
+} // End of anonymous namespace
+
+void SurfaceSdlGraphicsManager::copyCachedCursor(const Graphics::Surface &image) {
+	SDL_LockSurface(_mouseSurface);
+
+	const byte *src = (const byte *)image.getPixels();
+	byte *dst = (byte *)_mouseSurface->pixels;
+	const int rowSize = MIN<int>(image.pitch, _mouseSurface->pitch);
+	for (int y = 0; y < MIN<int>(image.h, _mouseSurface->h); ++y) {
+		memcpy(dst, src, rowSize);
+		src += image.pitch;
+		dst += _mouseSurface->pitch;
+	}
+
+	SDL_UnlockSurface(_mouseSurface);
+}
+
 void SurfaceSdlGraphicsManager::blitCursor() {
 	const int w = _mouseCurState.w;
 	const int h = _mouseCurState.h;
@@ -1987,27 +2085,83 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		sizeChanged = true;
 	}
 
-	if (_cursorFormat.bytesPerPixel == 4) {
-		if (_mouseSurface != _mouseOrigSurface) {
-			SDL_FreeSurface(_mouseSurface);
+	// Cursor animations keep setting the same few cursors, so reuse the
+	// scaled images of the cursors seen before.
+	CursorCacheParams params = CursorCacheParams();
+	params.keyColor = _mouseKeyColor;
+	params.mode = _cursorDontScale ? -1 : _videoMode.mode;
+	params.scale = cursorScale;
+	params.w = w;
+	params.h = h;
+	params.format = _cursorFormat;
+	params.aspectRatioCorrection = !_cursorDontScale && _videoMode.aspectRatioCorrection;
+
+	if (_cursorFormat.bytesPerPixel != 4) {
+		params.rMask = _hwScreen->format->Rmask;
+		params.gMask = _hwScreen->format->Gmask;
+		params.bMask = _hwScreen->format->Bmask;
+		params.aMask = _hwScreen->format->Amask;
+	}
+
+	if (_cursorFormat.bytesPerPixel == 1) {
+		const SDL_Color *palette = _cursorPaletteDisabled ? _currentPalette : _cursorPalette;
+		for (int i = 0; i < 256; i++) {
+			params.palette[i * 3 + 0] = palette[i].r;
+			params.palette[i * 3 + 1] = palette[i].g;
+			params.palette[i * 3 + 2] = palette[i].b;
 		}
+	}
+
+	const void *cursorData;
+	uint cursorDataSize;
+	if (_cursorFormat.bytesPerPixel == 4) {
+		cursorData = _mouseOrigSurface->pixels;
+		cursorDataSize = _mouseOrigSurface->h * _mouseOrigSurface->pitch;
+	} else {
+		cursorData = _mouseData;
+		cursorDataSize = w * h * _cursorFormat.bytesPerPixel;
+	}
 
+	if (_cursorFormat.bytesPerPixel == 4) {
 		if (cursorScale == 1) {
+			if (_mouseSurface != _mouseOrigSurface) {
+				SDL_FreeSurface(_mouseSurface);
+			}
 			_mouseSurface = _mouseOrigSurface;
 			return;
 		}
 
+		// Keep the scaled surface as long as the cursor size and format do
+		// not change
 		SDL_PixelFormat *format = _mouseOrigSurface->format;
-		_mouseSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_SRCCOLORKEY | SDL_SRCALPHA,
-											 rW, rH,
-											 format->BitsPerPixel,
-											 format->Rmask,
-											 format->Gmask,
-											 format->Bmask,
-											 format->Amask);
+		if (!_mouseSurface || _mouseSurface == _mouseOrigSurface ||
+		    _mouseSurface->w != rW || _mouseSurface->h != rH ||
+		    _mouseSurface->format->Rmask != format->Rmask || _mouseSurface->format->Gmask != format->Gmask ||
+		    _mouseSurface->format->Bmask != format->Bmask || _mouseSurface->format->Amask != format->Amask) {
+			if (_mouseSurface != _mouseOrigSurface) {
+				SDL_FreeSurface(_mouseSurface);
+			}
+
+			_mouseSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_SRCCOLORKEY | SDL_SRCALPHA,
+												 rW, rH,
+												 format->BitsPerPixel,
+												 format->Rmask,
+												 format->Gmask,
+												 format->Bmask,
+												 format->Amask);
+
+			if (_mouseSurface == nullptr)
+				error("Allocating _mouseSurface failed");
+		}
 
 		SDL_SetColorKey(_mouseSurface, SDL_SRCCOLORKEY | SDL_SRCALPHA, _mouseKeyColor);
 
+		const Graphics::Surface *cachedImage = _cursorCache.find(cursorData, cursorDataSize, &params, sizeof(params));
+		if (cachedImage) {
+			copyCachedCursor(*cachedImage);
+			return;
+		}
+
 		// At least SDL 2.0.4 on Windows apparently has a broken SDL_BlitScaled
 		// implementation, and SDL 1 has no such API at all, and our other
 		// scalers operate exclusively at 16bpp, so here is a scrappy 32bpp
@@ -2034,11 +2188,47 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 			src += _mouseOrigSurface->pitch;
 		}
 
+		// Aspect ratio correction makes the surface taller than the scaled
+		// image, clear the rows left over from the previous cursor
+		const int extraRows = _mouseSurface->h - _mouseOrigSurface->h * cursorScale;
+		if (extraRows > 0) {
+			memset(dst, 0, extraRows * _mouseSurface->pitch);
+		}
+
+		Graphics::Surface image;
+		image.init(_mouseSurface->w, _mouseSurface->h, _mouseSurface->pitch, _mouseSurface->pixels, convertSDLPixelFormat(_mouseSurface->format));
+		_cursorCache.insert(cursorData, cursorDataSize, &params, sizeof(params), image);
+
 		SDL_UnlockSurface(_mouseSurface);
 		SDL_UnlockSurface(_mouseOrigSurface);
 		return;
 	}
 
+	if (sizeChanged || !_mouseSurface) {
+		if (_mouseSurface)
+			SDL_FreeSurface(_mouseSurface);
+
+		_mouseSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA,
+						_mouseCurState.rW,
+						_mouseCurState.rH,
+						16,
+						_hwScreen->format->Rmask,
+						_hwScreen->format->Gmask,
+						_hwScreen->format->Bmask,
+						_hwScreen->format->Amask);
+
+		if (_mouseSurface == nullptr)
+			error("Allocating _mouseSurface failed");
+
+		SDL_SetColorKey(_mouseSurface, SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA, kMouseColorKey);
+	}
+
+	const Graphics::Surface *cachedImage = _cursorCache.find(cursorData, cursorDataSize, &params, sizeof(params));
+	if (cachedImage) {
+		copyCachedCursor(*cachedImage);
+		return;
+	}
+
 	SDL_LockSurface(_mouseOrigSurface);
 
 	byte *dstPtr;
@@ -2088,25 +2278,6 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		dstPtr += _mouseOrigSurface->pitch - w * 2;
 	}
 
-	if (sizeChanged || !_mouseSurface) {
-		if (_mouseSurface)
-			SDL_FreeSurface(_mouseSurface);
-
-		_mouseSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA,
-						_mouseCurState.rW,
-						_mouseCurState.rH,
-						16,
-						_hwScreen->format->Rmask,
-						_hwScreen->format->Gmask,
-						_hwScreen->format->Bmask,
-						_hwScreen->format->Amask);
-
-		if (_mouseSurface == nullptr)
-			error("Allocating _mouseSurface failed");
-
-		SDL_SetColorKey(_mouseSurface, SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA, kMouseColorKey);
-	}
-
 	SDL_LockSurface(_mouseSurface);
 
 	ScalerProc *scalerProc;
@@ -2133,6 +2304,10 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		stretch200To240Nearest((uint8 *)_mouseSurface->pixels, _mouseSurface->pitch, rW, rH1, 0, 0, 0);
 #endif
 
+	Graphics::Surface image;
+	image.init(_mouseSurface->w, _mouseSurface->h, _mouseSurface->pitch, _mouseSurface->pixels, convertSDLPixelFormat(_mouseSurface->format));
+	_cursorCache.insert(cursorData, cursorDataSize, &params, sizeof(params), image);
+
 	SDL_UnlockSurface(_mouseSurface);
 	SDL_UnlockSurface(_mouseOrigSurface);
 }
@@ -25,6 +25,8 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/cursor_cache.h"
+#include "graphics/dirty_region.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -34,6 +36,8 @@
 
 #include "backends/platform/sdl/sdl-sys.h"
 
+class TiledScaler;
+
 #ifndef RELEASE_BUILD
 // Define this to allow for focus rectangle debugging
 #define USE_SDL_DEBUG_FOCUSRECT
@@ -324,6 +328,8 @@ protected:
 
 	ScalerProc *_scalerProc;
 	int _scalerType;
+	/** Scales the dirty rects using multiple threads, when enabled. */
+	TiledScaler *_tiledScaler;
 	int _transactionMode;
 
 	// Indicates whether it is needed to free _hwSurface in destructor
@@ -336,12 +342,19 @@ protected:
 
 	enum {
 		NUM_DIRTY_RECT = 100,
+		// Entries of _dirtyRectList kept free for the rects added after
+		// scaling, like the one of the mouse cursor
+		NUM_DIRTY_RECT_RESERVED = 4,
 		MAX_SCALING = 3
 	};
 
 	// Dirty rect management
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
+	// Dirty areas in game or overlay coordinates, moved to _dirtyRectList
+	// by updateDirtyRectList()
+	Graphics::DirtyRegion _dirtyRegion;
+	Common::Array<Common::Rect> _dirtyRegionRects;
 
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
@@ -376,6 +389,8 @@ protected:
 	bool _cursorPaletteDisabled;
 	SDL_Surface *_mouseOrigSurface;
 	SDL_Surface *_mouseSurface;
+	/** Scaled cursor images of the cursors set so far. */
+	Graphics::CursorCache _cursorCache;
 	enum {
 		kMouseColorKey = 1
 	};
@@ -405,10 +420,16 @@ protected:
 #endif
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
+	/**
+	 * Append the dirty areas collected since the last update to
+	 * _dirtyRectList, unless a full redraw is forced anyway.
+	 */
+	void updateDirtyRectList();
 
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
+	void copyCachedCursor(const Graphics::Surface &image);
 
 	virtual void internUpdateScreen();
 
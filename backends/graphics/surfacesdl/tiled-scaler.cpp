@@ -0,0 +1,177 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/tiled-scaler.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+TiledScaler::TiledScaler(int numThreads)
+	: _numWorkers(0), _mutex(0), _jobCond(0), _doneCond(0),
+	  _jobGeneration(0), _nextBand(0), _bandsDone(0), _quit(false) {
+	memset(&_job, 0, sizeof(_job));
+
+	if (numThreads <= 0) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		numThreads = SDL_GetCPUCount();
+#else
+		numThreads = 1;
+#endif
+	}
+	numThreads = CLIP<int>(numThreads, 1, kMaxThreads);
+
+	if (numThreads == 1)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_jobCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+	if (!_mutex || !_jobCond || !_doneCond) {
+		warning("Could not create the scaler threads: %s", SDL_GetError());
+		return;
+	}
+
+	for (int i = 0; i < numThreads - 1; ++i) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_workers[_numWorkers] = SDL_CreateThread(&workerThread, "ScummVMScaler", this);
+#else
+		_workers[_numWorkers] = SDL_CreateThread(&workerThread, this);
+#endif
+		if (!_workers[_numWorkers]) {
+			warning("Could not create a scaler thread: %s", SDL_GetError());
+			break;
+		}
+		++_numWorkers;
+	}
+}
+
+TiledScaler::~TiledScaler() {
+	if (_numWorkers) {
+		SDL_LockMutex(_mutex);
+		_quit = true;
+		SDL_CondBroadcast(_jobCond);
+		SDL_UnlockMutex(_mutex);
+
+		for (int i = 0; i < _numWorkers; ++i)
+			SDL_WaitThread(_workers[i], nullptr);
+	}
+
+	if (_doneCond)
+		SDL_DestroyCond(_doneCond);
+	if (_jobCond)
+		SDL_DestroyCond(_jobCond);
+	if (_mutex)
+		SDL_DestroyMutex(_mutex);
+}
+
+void TiledScaler::scale(ScalerProc *scalerProc, const uint8 *srcPtr, uint32 srcPitch,
+                        uint8 *dstPtr, uint32 dstPitch, int width, int height, int scaleFactor) {
+	const int threads = getThreadCount();
+
+	// Aim for two bands per thread, so that a slow thread does not hold up
+	// the others for long
+	int bandHeight = (height + threads * 2 - 1) / (threads * 2);
+	bandHeight = MAX<int>((bandHeight + 3) & ~3, kMinBandHeight);
+
+	if (threads == 1 || width * height < kMinParallelArea || height <= bandHeight) {
+		scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+	_job.scalerProc = scalerProc;
+	_job.srcPtr = srcPtr;
+	_job.srcPitch = srcPitch;
+	_job.dstPtr = dstPtr;
+	_job.dstPitch = dstPitch;
+	_job.width = width;
+	_job.height = height;
+	_job.scaleFactor = scaleFactor;
+	_job.bandHeight = bandHeight;
+	// The last band takes the remaining rows, as some scalers cannot handle
+	// very short regions
+	_job.numBands = height / bandHeight;
+	_nextBand = 0;
+	_bandsDone = 0;
+	++_jobGeneration;
+	SDL_CondBroadcast(_jobCond);
+	SDL_UnlockMutex(_mutex);
+
+	scaleBands();
+
+	SDL_LockMutex(_mutex);
+	while (_bandsDone < _job.numBands)
+		SDL_CondWait(_doneCond, _mutex);
+	SDL_UnlockMutex(_mutex);
+}
+
+void TiledScaler::scaleBands() {
+	while (true) {
+		// Take the job together with the band, so that a worker waking up
+		// late cannot mix up a finished job and the next one
+		SDL_LockMutex(_mutex);
+		const Job job = _job;
+		const int band = _nextBand < job.numBands ? _nextBand++ : -1;
+		SDL_UnlockMutex(_mutex);
+
+		if (band < 0)
+			return;
+
+		const int y = band * job.bandHeight;
+		const int h = band == job.numBands - 1 ? job.height - y : job.bandHeight;
+		job.scalerProc(job.srcPtr + y * job.srcPitch, job.srcPitch,
+		               job.dstPtr + y * job.scaleFactor * job.dstPitch, job.dstPitch, job.width, h);
+
+		SDL_LockMutex(_mutex);
+		if (++_bandsDone == job.numBands)
+			SDL_CondSignal(_doneCond);
+		SDL_UnlockMutex(_mutex);
+	}
+}
+
+int SDLCALL TiledScaler::workerThread(void *data) {
+	((TiledScaler *)data)->workerLoop();
+	return 0;
+}
+
+void TiledScaler::workerLoop() {
+	uint32 generation = 0;
+
+	SDL_LockMutex(_mutex);
+	while (true) {
+		while (!_quit && generation == _jobGeneration)
+			SDL_CondWait(_jobCond, _mutex);
+		if (_quit)
+			break;
+		generation = _jobGeneration;
+
+		SDL_UnlockMutex(_mutex);
+		scaleBands();
+		SDL_LockMutex(_mutex);
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+#endif
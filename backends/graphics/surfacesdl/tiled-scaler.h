@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_TILED_SCALER_H
+#define BACKENDS_GRAPHICS_SURFACESDL_TILED_SCALER_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "graphics/scaler.h"
+
+/**
+ * Runs a scaler over a region split into horizontal bands, which are
+ * scaled in parallel by a pool of worker threads and the calling thread.
+ *
+ * The scalers only read the source, including the rows and columns around
+ * a band which their kernels need, and every band writes its own rows of
+ * the destination. So the bands can be scaled independently, and produce
+ * the same output as scaling the whole region at once.
+ */
+class TiledScaler {
+public:
+	/**
+	 * Create a pool of @p numThreads - 1 worker threads. If @p numThreads
+	 * is 0, use one thread per CPU core, up to kMaxThreads.
+	 */
+	TiledScaler(int numThreads);
+	~TiledScaler();
+
+	/** Return the number of threads scaling, including the caller. */
+	int getThreadCount() const { return _numWorkers + 1; }
+
+	/**
+	 * Scale a region, like calling @p scalerProc with the same arguments
+	 * would. Returns once the whole region has been scaled.
+	 */
+	void scale(ScalerProc *scalerProc, const uint8 *srcPtr, uint32 srcPitch,
+	           uint8 *dstPtr, uint32 dstPitch, int width, int height, int scaleFactor);
+
+private:
+	enum {
+		kMaxThreads = 8,
+		/**
+		 * Minimum height of a band. Band heights are a multiple of 4 rows,
+		 * as the DotMatrix scaler repeats its pattern every two source rows.
+		 */
+		kMinBandHeight = 16,
+		/** Regions with fewer pixels are not worth waking up the workers. */
+		kMinParallelArea = 64 * 64
+	};
+
+	struct Job {
+		ScalerProc *scalerProc;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width;
+		int height;
+		int scaleFactor;
+		int bandHeight;
+		int numBands;
+	};
+
+	static int SDLCALL workerThread(void *data);
+	void workerLoop();
+
+	/** Scale the bands of the current job until none are left. */
+	void scaleBands();
+
+	SDL_Thread *_workers[kMaxThreads];
+	int _numWorkers;
+
+	SDL_mutex *_mutex;
+	/** Signalled when a new job is started, or the workers should quit. */
+	SDL_cond *_jobCond;
+	/** Signalled when the last band of a job is done. */
+	SDL_cond *_doneCond;
+
+	// Guarded by _mutex
+	Job _job;
+	uint32 _jobGeneration;
+	int _nextBand;
+	int _bandsDone;
+	bool _quit;
+};
+
+#endif
@@ -10,7 +10,7 @@ echo and let all the build work be done from the backend/build folder.
 cd ../../../..
 ./configure --backend=caanoo --disable-mt32emu --host=caanoo \
   --disable-alsa --disable-flac \
-  --disable-nasm --disable-vorbis --disable-hq-scalers \
+  --disable-vorbis --disable-hq-scalers \
   --with-sdl-prefix=/opt/arm-caanoo/arm-none-linux-gnueabi/usr/bin \
   --enable-tremor --with-tremor-prefix=/opt/arm-caanoo/arm-none-linux-gnueabi/usr \
   --enable-zlib --with-zlib-prefix=/opt/arm-caanoo/arm-none-linux-gnueabi/usr \
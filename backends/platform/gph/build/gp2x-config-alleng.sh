@@ -18,7 +18,7 @@ export DEFINES=-DNDEBUG
 # Edit the configure line to suit.
 cd ../../../..
 ./configure --backend=gp2x --disable-mt32emu --host=gp2x \
-  --disable-flac --disable-nasm --disable-hq-scalers \
+  --disable-flac --disable-hq-scalers \
   --with-sdl-prefix=/opt/open2x/gcc-4.1.1-glibc-2.3.6/bin \
   --enable-tremor --with-tremor-prefix=/opt/open2x/gcc-4.1.1-glibc-2.3.6 \
   --enable-zlib --with-zlib-prefix=/opt/open2x/gcc-4.1.1-glibc-2.3.6 \
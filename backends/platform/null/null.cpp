@@ -51,13 +51,14 @@ typedef void (*sighandler_t)(int);
 #include "backends/modular-backend.h"
 #include "base/main.h"
 
+#include "backends/mutex/null/null-mutex.h"
+#include "backends/graphics/null/null-graphics.h"
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/mutex/null/null-mutex.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -83,9 +84,12 @@ public:
 
 	virtual void initBackend();
 
+	virtual bool hasFeature(Feature f);
+
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual uint32 getMillis(bool skipRecord = false);
+	virtual uint64 getMicros();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const;
 
@@ -117,6 +121,13 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// The tests do not call initBackend(), but the code they exercise may
+	// still create mutexes or query backend features.
+	_mutexManager = new NullMutexManager();
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -158,6 +169,22 @@ void OSystem_NULL::initBackend() {
 	BaseBackend::initBackend();
 }
 
+bool OSystem_NULL::hasFeature(Feature f) {
+	// Report the CPU features, so that the SIMD code paths are used (and
+	// benchmarked) like with the real backends
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	if (f == kFeatureCpuSSE2)
+		return __builtin_cpu_supports("sse2");
+	if (f == kFeatureCpuAVX2)
+		return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__)
+	if (f == kFeatureCpuNEON)
+		return true;
+#endif
+	return ModularGraphicsBackend::hasFeature(f);
+}
+
 bool OSystem_NULL::pollEvent(Common::Event &event) {
 #ifndef NULL_DRIVER_USE_FOR_TEST
 	((DefaultTimerManager *)getTimerManager())->checkTimers();
@@ -200,6 +227,18 @@ uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #endif
 }
 
+uint64 OSystem_NULL::getMicros() {
+#ifdef POSIX
+	timeval curTime;
+
+	gettimeofday(&curTime, 0);
+
+	return (uint64)(curTime.tv_sec - _startTime.tv_sec) * 1000000 + (curTime.tv_usec - _startTime.tv_usec);
+#else
+	return OSystem::getMicros();
+#endif
+}
+
 void OSystem_NULL::delayMillis(uint msecs) {
 #ifdef POSIX
 	usleep(msecs * 1000);
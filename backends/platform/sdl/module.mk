@@ -2,6 +2,7 @@ MODULE := backends/platform/sdl
 
 MODULE_OBJS := \
 	sdl.o \
+	sdl-job-pool.o \
 	sdl-window.o
 
 ifdef POSIX
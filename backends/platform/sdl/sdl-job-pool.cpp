@@ -0,0 +1,161 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/platform/sdl/sdl-job-pool.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+SdlJobPool::SdlJobPool(int numThreads)
+	: _numWorkers(0), _mutex(0), _batchCond(0), _doneCond(0),
+	  _batchGeneration(0), _nextJob(0), _jobsDone(0), _quit(false) {
+	memset(&_batch, 0, sizeof(_batch));
+
+	if (numThreads <= 0) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		numThreads = SDL_GetCPUCount();
+#else
+		numThreads = 1;
+#endif
+	}
+	numThreads = CLIP<int>(numThreads, 1, kMaxThreads);
+
+	if (numThreads == 1)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_batchCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+	if (!_mutex || !_batchCond || !_doneCond) {
+		warning("Could not create the job threads: %s", SDL_GetError());
+		return;
+	}
+
+	for (int i = 0; i < numThreads - 1; ++i) {
+		_workers[_numWorkers].pool = this;
+		_workers[_numWorkers].thread = _numWorkers + 1;
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_threads[_numWorkers] = SDL_CreateThread(&workerThread, "ScummVMJobs", &_workers[_numWorkers]);
+#else
+		_threads[_numWorkers] = SDL_CreateThread(&workerThread, &_workers[_numWorkers]);
+#endif
+		if (!_threads[_numWorkers]) {
+			warning("Could not create a job thread: %s", SDL_GetError());
+			break;
+		}
+		++_numWorkers;
+	}
+}
+
+SdlJobPool::~SdlJobPool() {
+	if (_numWorkers) {
+		SDL_LockMutex(_mutex);
+		_quit = true;
+		SDL_CondBroadcast(_batchCond);
+		SDL_UnlockMutex(_mutex);
+
+		for (int i = 0; i < _numWorkers; ++i)
+			SDL_WaitThread(_threads[i], nullptr);
+	}
+
+	if (_doneCond)
+		SDL_DestroyCond(_doneCond);
+	if (_batchCond)
+		SDL_DestroyCond(_batchCond);
+	if (_mutex)
+		SDL_DestroyMutex(_mutex);
+}
+
+void SdlJobPool::run(OSystem::ParallelJobProc proc, void *param, int numJobs) {
+	if (_numWorkers == 0 || numJobs <= 1) {
+		for (int i = 0; i < numJobs; ++i)
+			proc(param, i, 0);
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+	_batch.proc = proc;
+	_batch.param = param;
+	_batch.numJobs = numJobs;
+	_nextJob = 0;
+	_jobsDone = 0;
+	++_batchGeneration;
+	SDL_CondBroadcast(_batchCond);
+	SDL_UnlockMutex(_mutex);
+
+	runJobs(0);
+
+	SDL_LockMutex(_mutex);
+	while (_jobsDone < _batch.numJobs)
+		SDL_CondWait(_doneCond, _mutex);
+	SDL_UnlockMutex(_mutex);
+}
+
+void SdlJobPool::runJobs(int thread) {
+	while (true) {
+		// Take the batch together with the job, so that a worker waking up
+		// late cannot mix up a finished batch and the next one
+		SDL_LockMutex(_mutex);
+		const Batch batch = _batch;
+		const int job = _nextJob < batch.numJobs ? _nextJob++ : -1;
+		SDL_UnlockMutex(_mutex);
+
+		if (job < 0)
+			return;
+
+		batch.proc(batch.param, job, thread);
+
+		SDL_LockMutex(_mutex);
+		if (++_jobsDone == batch.numJobs)
+			SDL_CondSignal(_doneCond);
+		SDL_UnlockMutex(_mutex);
+	}
+}
+
+int SDLCALL SdlJobPool::workerThread(void *data) {
+	Worker *worker = (Worker *)data;
+	worker->pool->workerLoop(worker->thread);
+	return 0;
+}
+
+void SdlJobPool::workerLoop(int thread) {
+	uint32 generation = 0;
+
+	SDL_LockMutex(_mutex);
+	while (true) {
+		while (!_quit && generation == _batchGeneration)
+			SDL_CondWait(_batchCond, _mutex);
+		if (_quit)
+			break;
+		generation = _batchGeneration;
+
+		SDL_UnlockMutex(_mutex);
+		runJobs(thread);
+		SDL_LockMutex(_mutex);
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+#endif
@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_PLATFORM_SDL_JOB_POOL_H
+#define BACKENDS_PLATFORM_SDL_JOB_POOL_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/system.h"
+
+/**
+ * A pool of worker threads running the jobs of OSystem::runParallelJobs()
+ * together with the calling thread.
+ */
+class SdlJobPool {
+public:
+	/**
+	 * Create a pool of @p numThreads - 1 worker threads. If @p numThreads
+	 * is 0, use one thread per CPU core, up to kMaxThreads.
+	 */
+	SdlJobPool(int numThreads);
+	~SdlJobPool();
+
+	/** Return the number of threads running jobs, including the caller. */
+	int getThreadCount() const { return _numWorkers + 1; }
+
+	/** Run the jobs, see OSystem::runParallelJobs(). */
+	void run(OSystem::ParallelJobProc proc, void *param, int numJobs);
+
+private:
+	enum {
+		kMaxThreads = 16
+	};
+
+	struct Batch {
+		OSystem::ParallelJobProc proc;
+		void *param;
+		int numJobs;
+	};
+
+	struct Worker {
+		SdlJobPool *pool;
+		/** The index passed to the jobs, the calling thread has 0. */
+		int thread;
+	};
+
+	static int SDLCALL workerThread(void *data);
+	void workerLoop(int thread);
+
+	/** Run the jobs of the current batch until none are left. */
+	void runJobs(int thread);
+
+	SDL_Thread *_threads[kMaxThreads];
+	Worker _workers[kMaxThreads];
+	int _numWorkers;
+
+	SDL_mutex *_mutex;
+	/** Signalled when a new batch is started, or the workers should quit. */
+	SDL_cond *_batchCond;
+	/** Signalled when the last job of a batch is done. */
+	SDL_cond *_doneCond;
+
+	// Guarded by _mutex
+	Batch _batch;
+	uint32 _batchGeneration;
+	int _nextJob;
+	int _jobsDone;
+	bool _quit;
+};
+
+#endif
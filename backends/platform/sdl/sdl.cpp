@@ -23,6 +23,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "backends/platform/sdl/sdl.h"
+#include "backends/platform/sdl/sdl-job-pool.h"
 #include "common/config-manager.h"
 #include "gui/EventRecorder.h"
 #include "common/taskbar.h"
@@ -91,7 +92,8 @@ OSystem_SDL::OSystem_SDL()
 	_logger(0),
 	_eventSource(0),
 	_eventSourceWrapper(nullptr),
-	_window(0) {
+	_window(0),
+	_jobPool(nullptr) {
 }
 
 OSystem_SDL::~OSystem_SDL() {
@@ -124,6 +126,8 @@ OSystem_SDL::~OSystem_SDL() {
 	_audiocdManager = 0;
 	delete _mixerManager;
 	_mixerManager = 0;
+	delete _jobPool;
+	_jobPool = nullptr;
 
 #ifdef ENABLE_EVENTRECORDER
 	// HACK HACK HACK
@@ -186,6 +190,16 @@ bool OSystem_SDL::hasFeature(Feature f) {
 	if (f == kFeatureJoystickDeadzone || f == kFeatureKbdMouseSpeed) {
 		return _eventSource->isJoystickConnected();
 	}
+#if SDL_VERSION_ATLEAST(1, 2, 7)
+	if (f == kFeatureCpuSSE2) return SDL_HasSSE2();
+#endif
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+	if (f == kFeatureCpuAVX2) return SDL_HasAVX2();
+#endif
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+	if (f == kFeatureCpuNEON) return SDL_HasNEON();
+#endif
+	if (f == kFeatureParallelJobs) return _jobPool != nullptr;
 	return ModularGraphicsBackend::hasFeature(f);
 }
 
@@ -282,6 +296,17 @@ void OSystem_SDL::initBackend() {
 
 	_audiocdManager = createAudioCDManager();
 
+	if (!_jobPool) {
+		int renderThreads = 0;
+		if (ConfMan.hasKey("render_threads"))
+			renderThreads = ConfMan.getInt("render_threads");
+		_jobPool = new SdlJobPool(renderThreads);
+		if (_jobPool->getThreadCount() == 1) {
+			delete _jobPool;
+			_jobPool = nullptr;
+		}
+	}
+
 	// Setup a custom program icon.
 	_window->setupIcon();
 
@@ -624,6 +649,16 @@ uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	return millis;
 }
 
+uint64 OSystem_SDL::getMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	static const uint64 frequency = SDL_GetPerformanceFrequency();
+	const uint64 counter = SDL_GetPerformanceCounter();
+	return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+#else
+	return OSystem::getMicros();
+#endif
+}
+
 void OSystem_SDL::delayMillis(uint msecs) {
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processDelayMillis())
@@ -678,6 +713,17 @@ Common::SaveFileManager *OSystem_SDL::getSavefileManager() {
 #endif
 }
 
+int OSystem_SDL::getParallelJobThreads() {
+	return _jobPool ? _jobPool->getThreadCount() : 1;
+}
+
+void OSystem_SDL::runParallelJobs(ParallelJobProc proc, void *param, int numJobs) {
+	if (_jobPool)
+		_jobPool->run(proc, param, numJobs);
+	else
+		OSystem::runParallelJobs(proc, param, numJobs);
+}
+
 //Not specified in base class
 Common::String OSystem_SDL::getScreenshotsPath() {
 	Common::String path = ConfMan.get("screenshotpath");
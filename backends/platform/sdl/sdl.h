@@ -37,6 +37,8 @@
 class DiscordPresence;
 #endif
 
+class SdlJobPool;
+
 /**
  * Base OSystem class for all SDL ports.
  */
@@ -78,12 +80,17 @@ public:
 	virtual void setWindowCaption(const Common::U32String &caption) override;
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	virtual uint32 getMillis(bool skipRecord = false) override;
+	virtual uint64 getMicros() override;
 	virtual void delayMillis(uint msecs) override;
 	virtual void getTimeAndDate(TimeDate &td) const override;
 	virtual MixerManager *getMixerManager() override;
 	virtual Common::TimerManager *getTimerManager() override;
 	virtual Common::SaveFileManager *getSavefileManager() override;
 
+	// Parallel jobs
+	virtual int getParallelJobThreads() override;
+	virtual void runParallelJobs(ParallelJobProc proc, void *param, int numJobs) override;
+
 	//Screenshots
 	virtual Common::String getScreenshotsPath();
 
@@ -123,6 +130,11 @@ protected:
 	 */
 	SdlWindow *_window;
 
+	/**
+	 * The worker threads running parallel jobs, if there are any.
+	 */
+	SdlJobPool *_jobPool;
+
 	SdlGraphicsManager::State _gfxManagerState;
 
 #if defined(USE_OPENGL_GAME) || defined(USE_OPENGL_SHADERS) || defined(USE_GLES2)
@@ -140,6 +140,8 @@ static const char HELP_STRING[] =
 	"                           (if file already exists, it will be overwritten)\n"
 	"  --enable-gs              Enable Roland GS mode for MIDI playback\n"
 	"  --output-rate=RATE       Select output sample rate in Hz (e.g. 22050)\n"
+	"  --resampler-quality=NUM  Select the sample rate conversion quality, 0-3\n"
+	"                           (0 = linear interpolation, 1-3 = band-limited)\n"
 	"  --opl-driver=DRIVER      Select AdLib (OPL) emulator (db, mame"
 #ifndef DISABLE_NUKED_OPL
                                                                      ", nuked"
@@ -241,6 +243,8 @@ void registerDefaults() {
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("dirtyrects", true);
 	ConfMan.registerDefault("vsync", true);
+	ConfMan.registerDefault("scaler_threads", 0);
+	ConfMan.registerDefault("render_threads", 0);
 
 	// Sound & Music
 	ConfMan.registerDefault("music_volume", 192);
@@ -257,6 +261,11 @@ void registerDefaults() {
 	ConfMan.registerDefault("dump_midi", false);
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
+	ConfMan.registerDefault("resampler_quality", 0);
+	ConfMan.registerDefault("audio_decode_ahead", false);
+	ConfMan.registerDefault("audio_cache_size", 4096);
+	ConfMan.registerDefault("audio_statistics", false);
+	ConfMan.registerDefault("mt32_render_ahead", 0);
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
@@ -593,6 +602,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_INT("output-rate")
 			END_OPTION
 
+			DO_LONG_OPTION_INT("resampler-quality")
+			END_OPTION
+
 			DO_OPTION_BOOL('f', "fullscreen")
 			END_OPTION
 
@@ -57,6 +57,7 @@
 #include "gui/gui-manager.h"
 #include "gui/error.h"
 
+#include "audio/decoders/decoded_cache.h"
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
 
@@ -318,6 +319,7 @@ static Common::Error runGame(const Plugin *plugin, OSystem &system, const Common
 
 	// Free up memory
 	delete engine;
+	Audio::purgeDecodedAudioCache();
 
 	// We clear all debug levels again even though the engine should do it
 	DebugMan.clearAllDebugChannels();
@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal set of atomic operations for lock-free data exchange.
+ *
+ * These are meant for the few places where data is handed between the
+ * main thread and a backend thread (e.g. the audio callback) that must not
+ * block on a mutex. Everywhere else, Common::Mutex should be used.
+ * @{
+ */
+
+/**
+ * Full memory barrier: no load or store is reordered across it, neither
+ * by the compiler nor by the CPU.
+ */
+inline void memoryBarrier() {
+#if defined(__GNUC__) || defined(__clang__)
+	__sync_synchronize();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+	__dmb(0xB); // ISH
+#elif defined(_MSC_VER)
+	_ReadWriteBarrier();
+	_mm_mfence();
+	_ReadWriteBarrier();
+#else
+#error "Common::memoryBarrier() is not implemented for this compiler"
+#endif
+}
+
+/**
+ * Atomically replace the value at @p ptr with @p newValue if it currently
+ * equals @p oldValue. This implies a full memory barrier.
+ *
+ * @return true if the value was replaced.
+ */
+inline bool atomicCompareAndSwap(volatile int32 *ptr, int32 oldValue, int32 newValue) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __sync_bool_compare_and_swap(ptr, oldValue, newValue);
+#elif defined(_MSC_VER)
+	return _InterlockedCompareExchange((volatile long *)ptr, newValue, oldValue) == oldValue;
+#else
+#error "Common::atomicCompareAndSwap() is not implemented for this compiler"
+#endif
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_LOCKFREE_QUEUE_H
+#define COMMON_LOCKFREE_QUEUE_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_lockfree_queue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Fixed size single-producer, single-consumer queue.
+ * @{
+ */
+
+/**
+ * Fixed size ring buffer which one thread can push to while another
+ * thread pops from it, without either of them ever blocking.
+ *
+ * At any time there must be at most one thread calling push() and at most
+ * one (other) thread calling pop(). If several threads need to push, they
+ * have to serialize among themselves, e.g. with a Common::Mutex.
+ */
+template<class T>
+class LockFreeQueue : NonCopyable {
+public:
+	/**
+	 * Create a queue which can hold at least @p capacity elements.
+	 */
+	explicit LockFreeQueue(uint capacity) : _readPos(0), _writePos(0) {
+		uint size = 1;
+		while (size < capacity)
+			size <<= 1;
+		_items = new T[size];
+		_mask = size - 1;
+	}
+
+	~LockFreeQueue() {
+		delete[] _items;
+	}
+
+	/** Return the number of elements the queue can hold. */
+	uint capacity() const {
+		return _mask + 1;
+	}
+
+	/** Return whether the queue is empty. Only reliable on the consumer side. */
+	bool empty() const {
+		return _readPos == _writePos;
+	}
+
+	/**
+	 * Append an element to the queue. Must only be called by the producer.
+	 *
+	 * @return false if the queue is full.
+	 */
+	bool push(const T &item) {
+		const uint32 writePos = _writePos;
+		if (writePos - _readPos > _mask)
+			return false;
+
+		_items[writePos & _mask] = item;
+		// Make the element visible before publishing the new write position
+		memoryBarrier();
+		_writePos = writePos + 1;
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element from the queue. Must only be called by the
+	 * consumer.
+	 *
+	 * @return false if the queue is empty.
+	 */
+	bool pop(T &item) {
+		const uint32 readPos = _readPos;
+		if (readPos == _writePos)
+			return false;
+
+		memoryBarrier();
+		item = _items[readPos & _mask];
+		// Finish reading the element before handing its slot back
+		memoryBarrier();
+		_readPos = readPos + 1;
+		return true;
+	}
+
+private:
+	T *_items;
+	uint32 _mask;
+	volatile uint32 _readPos;
+	volatile uint32 _writePos;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -186,6 +186,15 @@ bool OSystem::setStretchMode(const char *name) {
 	return false;
 }
 
+uint64 OSystem::getMicros() {
+	return (uint64)getMillis(true) * 1000;
+}
+
+void OSystem::runParallelJobs(ParallelJobProc proc, void *param, int numJobs) {
+	for (int i = 0; i < numJobs; i++)
+		proc(param, i, 0);
+}
+
 void OSystem::fatalError() {
 	quit();
 	exit(1);
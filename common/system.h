@@ -499,7 +499,31 @@ public:
 		/**
 		* For platforms that should not have a Quit button.
 		*/
-		kFeatureNoQuit
+		kFeatureNoQuit,
+
+		/**
+		* The CPU supports the SSE2 instruction set.
+		*
+		* Used to select SIMD optimized code paths at runtime. These are
+		* only available if they were enabled at configure time.
+		*/
+		kFeatureCpuSSE2,
+
+		/**
+		* The CPU supports the AVX2 instruction set.
+		*/
+		kFeatureCpuAVX2,
+
+		/**
+		* The CPU supports the NEON instruction set.
+		*/
+		kFeatureCpuNEON,
+
+		/**
+		* The backend can run jobs on several threads at once, see
+		* runParallelJobs().
+		*/
+		kFeatureParallelJobs
 	};
 
 	/**
@@ -1298,6 +1322,17 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get the number of microseconds since an arbitrary point in time,
+	 * with the best precision the system offers.
+	 *
+	 * This is meant for measuring durations, e.g. for profiling. The value
+	 * is not recorded by the event recorder and is not related to the
+	 * value of getMillis(). The default implementation is based on
+	 * getMillis(), so backends should override it if they can do better.
+	 */
+	virtual uint64 getMicros();
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1419,6 +1454,47 @@ public:
 
 
 
+	/**
+	 * @defgroup common_system_jobs Parallel jobs
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Backends with kFeatureParallelJobs keep a pool of threads which CPU
+	 * intensive work, like software rendering, can be split across. This
+	 * is not a threading API: runParallelJobs() only returns once all of
+	 * its jobs are done.
+	 */
+
+	/**
+	 * A job run by runParallelJobs(). @p job is the index of the job, and
+	 * @p thread the index of the thread running it.
+	 */
+	typedef void (*ParallelJobProc)(void *param, int job, int thread);
+
+	/**
+	 * Return the number of threads runParallelJobs() runs jobs on,
+	 * including the calling thread.
+	 */
+	virtual int getParallelJobThreads() { return 1; }
+
+	/**
+	 * Run @p numJobs jobs, and return once all of them are done.
+	 *
+	 * The jobs may run in any order and at the same time, so they must not
+	 * depend on each other. The thread index passed to @p proc is below
+	 * getParallelJobThreads(), and jobs running at the same time always
+	 * get different ones, so that they can use separate scratch data.
+	 *
+	 * This must not be called from several threads at once, nor from a
+	 * job. The default implementation runs the jobs one after the other
+	 * on the calling thread.
+	 */
+	virtual void runParallelJobs(ParallelJobProc proc, void *param, int numJobs);
+
+	/** @} */
+
+
+
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
 	 *  @{
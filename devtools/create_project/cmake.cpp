@@ -393,8 +393,7 @@ void CMakeProvider::writeEngineDefinitions(std::ofstream &workspace) const {
 }
 
 bool CMakeProvider::featureExcluded(const char *name) const {
-	return std::strcmp(name, "nasm") == 0 ||
-			std::strcmp(name, "updates") == 0 ; // NASM is not supported for now
+	return std::strcmp(name, "updates") == 0;
 }
 
 const EngineDesc &CMakeProvider::findEngineDesc(const std::string &name, const EngineDescList &engines) const {
@@ -257,10 +257,6 @@ void CodeBlocksProvider::writeFileListToProject(const FileNode &dir, std::ofstre
 				projectFile << "\t\t<Unit filename=\"" << convertPathToWin(filePrefix + node->name) << "\">\n"
 				               "\t\t\t<Option compilerVar=\"WINDRES\" />\n"
 				               "\t\t</Unit>\n";
-			} else if (ext == "asm") {
-				projectFile << "\t\t<Unit filename=\"" << convertPathToWin(filePrefix + node->name) << "\">\n"
-				               "\t\t\t<Option compiler=\"gcc\" use=\"1\" buildCommand=\"$(" << LIBS_DEFINE << ")bin/nasm.exe -f win32 -g $file -o $object\" />"
-				               "\t\t</Unit>\n";
 			} else {
 				projectFile << "\t\t<Unit filename=\"" << convertPathToWin(filePrefix + node->name) << "\" />\n";
 			}
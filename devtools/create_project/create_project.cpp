@@ -1059,7 +1059,6 @@ const Feature s_features[] = {
 	{          "highres",                   "USE_HIGHRES", false, true,  "high resolution" },
 	{          "mt32emu",                   "USE_MT32EMU", false, true,  "integrated MT-32 emulator" },
 	{              "lua",                       "USE_LUA", false, true,  "lua" },
-	{             "nasm",                      "USE_NASM", false, true,  "IA-32 assembly support" }, // This feature is special in the regard, that it needs additional handling.
 	{           "tinygl",                    "USE_TINYGL", false, true,  "TinyGL support" },
 	{           "opengl",                    "USE_OPENGL", false, true,  "OpenGL support" },
 	{      "opengl_game",               "USE_OPENGL_GAME", false, true,  "OpenGL support in 3d games" },
@@ -1280,7 +1279,7 @@ std::string basename(const std::string &fileName) {
 }
 
 bool producesObjectExtension(const std::string &ext) {
-	return (ext == "cpp" || ext == "c" || ext == "asm" || ext == "m" || ext == "mm");
+	return (ext == "cpp" || ext == "c" || ext == "m" || ext == "mm");
 }
 
 bool producesObjectFile(const std::string &fileName) {
@@ -1302,7 +1301,7 @@ std::string toString(int num) {
  * This function does as special match against the file list.
  * By default object files (.o) are excluded, header files (.h) are included,
  * and it will not take file extensions into consideration, when the extension
- * of a file in the specified directory is one of "m", "cpp", "c" or "asm".
+ * of a file in the specified directory is one of "m", "cpp" or "c".
  *
  * @param dir Parent directory of the file.
  * @param fileName File name to match.
@@ -205,7 +205,6 @@ void MSBuildProvider::createFiltersFile(const BuildSetup &setup, const std::stri
 	_includeFiles.sort();
 	_otherFiles.sort();
 	_resourceFiles.sort();
-	_asmFiles.sort();
 
 	const std::string filtersFile = setup.outputDir + '/' + name + getProjectExtension() + ".filters";
 	std::ofstream filters(filtersFile.c_str());
@@ -231,7 +230,6 @@ void MSBuildProvider::createFiltersFile(const BuildSetup &setup, const std::stri
 	outputFilter(filters, _includeFiles, "ClInclude");
 	outputFilter(filters, _otherFiles, "None");
 	outputFilter(filters, _resourceFiles, "ResourceCompile");
-	outputFilter(filters, _asmFiles, "CustomBuild");
 
 	filters << "</Project>";
 }
@@ -483,15 +481,6 @@ bool hasEnding(std::string const &fullString, std::string const &ending) {
 	}
 }
 
-void MSBuildProvider::outputNasmCommand(std::ostream &projectFile, const std::string &config, const std::string &prefix) {
-	projectFile << "\t\t\t<Command Condition=\"'$(Configuration)|$(Platform)'=='" << config << "|Win32'\">nasm.exe -f win32 -g -o \"$(IntDir)" << prefix << "%(Filename).obj\" \"%(FullPath)\"</Command>\n"
-	            << "\t\t\t<Outputs Condition=\"'$(Configuration)|$(Platform)'=='" << config << "|Win32'\">$(IntDir)" << prefix << "%(Filename).obj;%(Outputs)</Outputs>\n";
-	if (_version >= 15) {
-		projectFile << "\t\t\t<OutputItemType Condition=\"'$(Configuration)|$(Platform)'=='" << config << "|Win32'\">Object</OutputItemType>\n"
-		            << "\t\t\t<BuildInParallel Condition=\"'$(Configuration)|$(Platform)'=='" << config << "|Win32'\">true</BuildInParallel>\n";
-	}
-}
-
 void MSBuildProvider::writeFileListToProject(const FileNode &dir, std::ofstream &projectFile, const int,
                                              const std::string &objPrefix, const std::string &filePrefix) {
 	// Reset lists
@@ -500,7 +489,6 @@ void MSBuildProvider::writeFileListToProject(const FileNode &dir, std::ofstream
 	_includeFiles.clear();
 	_otherFiles.clear();
 	_resourceFiles.clear();
-	_asmFiles.clear();
 
 	// Compute the list of files
 	_filters.push_back(""); // init filters
@@ -512,24 +500,6 @@ void MSBuildProvider::writeFileListToProject(const FileNode &dir, std::ofstream
 	outputFiles(projectFile, _includeFiles, "ClInclude");
 	outputFiles(projectFile, _otherFiles, "None");
 	outputFiles(projectFile, _resourceFiles, "ResourceCompile");
-
-	// Output asm files
-	if (!_asmFiles.empty()) {
-		projectFile << "\t<ItemGroup>\n";
-		for (std::list<FileEntry>::const_iterator entry = _asmFiles.begin(); entry != _asmFiles.end(); ++entry) {
-
-			projectFile << "\t\t<CustomBuild Include=\"" << (*entry).path << "\">\n"
-			            << "\t\t\t<FileType>Document</FileType>\n";
-
-			outputNasmCommand(projectFile, "Debug", (*entry).prefix);
-			outputNasmCommand(projectFile, "Analysis", (*entry).prefix);
-			outputNasmCommand(projectFile, "Release", (*entry).prefix);
-			outputNasmCommand(projectFile, "LLVM", (*entry).prefix);
-
-			projectFile << "\t\t</CustomBuild>\n";
-		}
-		projectFile << "\t</ItemGroup>\n";
-	}
 }
 
 void MSBuildProvider::outputFiles(std::ostream &projectFile, const FileEntries &files, const std::string &action) {
@@ -572,8 +542,6 @@ void MSBuildProvider::computeFileList(const FileNode &dir, const std::string &ob
 				_includeFiles.push_back(entry);
 			else if (ext == "rc")
 				_resourceFiles.push_back(entry);
-			else if (ext == "asm")
-				_asmFiles.push_back(entry);
 			else
 				_otherFiles.push_back(entry);
 		}
@@ -66,7 +66,6 @@ private:
 	FileEntries _compileFiles;
 	FileEntries _includeFiles;
 	FileEntries _otherFiles;
-	FileEntries _asmFiles;
 	FileEntries _resourceFiles;
 
 	void computeFileList(const FileNode &dir, const std::string &objPrefix, const std::string &filePrefix);
@@ -74,8 +73,6 @@ private:
 
 	void outputFilter(std::ostream &filters, const FileEntries &files, const std::string &action);
 	void outputFiles(std::ostream &projectFile, const FileEntries &files, const std::string &action);
-
-	void outputNasmCommand(std::ostream &projectFile, const std::string &config, const std::string &prefix);
 };
 
 } // namespace CreateProjectTool
@@ -327,25 +327,7 @@ void VisualStudioProvider::writeFileListToProject(const FileNode &dir, std::ofst
 			writeFileListToProject(*node, projectFile, indentation + 1, objPrefix + node->name + '_', filePrefix + node->name + '/');
 		} else {
 			std::string filePath = convertPathToWin(filePrefix + node->name);
-			if (producesObjectFile(node->name)) {
-				std::string name, ext;
-				splitFilename(node->name, name, ext);
-
-				if (ext == "asm") {
-					std::string objFileName = "$(IntDir)\\";
-					objFileName += objPrefix;
-					objFileName += "$(InputName).obj";
-
-					const std::string toolLine = indentString + "\t\t<Tool Name=\"VCCustomBuildTool\" CommandLine=\"nasm.exe -f win32 -g -o &quot;" + objFileName + "&quot; &quot;$(InputPath)&quot;&#x0D;&#x0A;\" Outputs=\"" + objFileName + "\" />\n";
-
-					// NASM is not supported for x64, thus we do not need to add additional entries here :-).
-					writeFileToProject(projectFile, filePath, ARCH_X86, indentString, toolLine);
-				} else {
-					projectFile << indentString << "<File RelativePath=\"" << filePath << "\" />\n";
-				}
-			} else {
-				projectFile << indentString << "<File RelativePath=\"" << filePath << "\" />\n";
-			}
+			projectFile << indentString << "<File RelativePath=\"" << filePath << "\" />\n";
 		}
 	}
 
@@ -353,22 +335,4 @@ void VisualStudioProvider::writeFileListToProject(const FileNode &dir, std::ofst
 		projectFile << getIndent(indentation + 1) << "</Filter>\n";
 }
 
-void VisualStudioProvider::writeFileToProject(std::ofstream &projectFile, const std::string &filePath, MSVC_Architecture arch,
-                                              const std::string &indentString, const std::string &toolLine) {
-	projectFile << indentString << "<File RelativePath=\"" << filePath << "\">\n"
-	            << indentString << "\t<FileConfiguration Name=\"Debug|" << getMSVCConfigName(arch) << "\">\n"
-	            << toolLine
-	            << indentString << "\t</FileConfiguration>\n"
-	            << indentString << "\t<FileConfiguration Name=\"Analysis|" << getMSVCConfigName(arch) << "\">\n"
-	            << toolLine
-	            << indentString << "\t</FileConfiguration>\n"
-	            << indentString << "\t<FileConfiguration Name=\"LLVM|" << getMSVCConfigName(arch) << "\">\n"
-	            << toolLine
-	            << indentString << "\t</FileConfiguration>\n"
-	            << indentString << "\t<FileConfiguration Name=\"Release|" << getMSVCConfigName(arch) << "\">\n"
-	            << toolLine
-	            << indentString << "\t</FileConfiguration>\n"
-	            << indentString << "</File>\n";
-}
-
 } // namespace CreateProjectTool
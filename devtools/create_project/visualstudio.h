@@ -38,9 +38,6 @@ protected:
 	void writeFileListToProject(const FileNode &dir, std::ofstream &projectFile, const int indentation,
 	                            const std::string &objPrefix, const std::string &filePrefix);
 
-	void writeFileToProject(std::ofstream &projectFile, const std::string &filePath, MSVC_Architecture arch,
-	                        const std::string &indentString, const std::string &toolLine);
-
 	void writeReferences(const BuildSetup &setup, std::ofstream &output);
 
 	void outputGlobalPropFile(const BuildSetup &setup, std::ofstream &properties, MSVC_Architecture arch, const StringList &defines, const std::string &prefix, bool runBuildEvents);
@@ -1223,9 +1223,6 @@ void XcodeProvider::setupAdditionalSources(std::string targetName, Property &fil
 void XcodeProvider::setupDefines(const BuildSetup &setup) {
 
 	for (StringList::const_iterator i = setup.defines.begin(); i != setup.defines.end(); ++i) {
-		if (*i == "USE_NASM")  // Not supported on Mac
-			continue;
-
 		ADD_DEFINE(_defines, *i);
 	}
 	// Add special defines for Mac support
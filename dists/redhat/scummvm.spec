@@ -25,7 +25,6 @@ BuildRequires: libogg-devel
 BuildRequires: libvorbis-devel
 BuildRequires: flac-devel
 BuildRequires: zlib-devel
-BuildRequires: nasm
 BuildRequires: SDL2-devel
 BuildRequires: freetype-devel
 BuildRequires: fluidsynth-devel
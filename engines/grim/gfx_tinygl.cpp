@@ -1176,7 +1176,14 @@ void GfxTinyGL::createTexture(Texture *texture, const uint8 *data, const CMap *c
 	tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_T, TGL_REPEAT);
 
 	tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_LINEAR);
-	tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_LINEAR);
+	// EMI draws its large model textures far away, which mipmaps make faster
+	if (g_grim->getGameType() == GType_MONKEY4) {
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_LINEAR_MIPMAP_NEAREST);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_GENERATE_MIPMAP, TGL_TRUE);
+	} else {
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_LINEAR);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_GENERATE_MIPMAP, TGL_FALSE);
+	}
 	tglTexImage2D(TGL_TEXTURE_2D, 0, 3, texture->_width, texture->_height, 0, format, TGL_UNSIGNED_BYTE, texdata);
 	delete[] texdata;
 }
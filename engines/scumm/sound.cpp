@@ -38,6 +38,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
+#include "audio/decoders/decoded_cache.h"
 #include "audio/decoders/flac.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
@@ -639,7 +640,9 @@ void Sound::startTalkSound(uint32 offset, uint32 b, int mode, Audio::SoundHandle
 #ifdef USE_MAD
 			{
 			assert(size > 0);
-			input = Audio::makeMP3Stream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = Audio::makeCachedAudioStream(_sfxFilename, offset,
+				new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES),
+				DisposeAfterUse::YES, &Audio::makeMP3Stream);
 			}
 #endif
 			break;
@@ -647,7 +650,9 @@ void Sound::startTalkSound(uint32 offset, uint32 b, int mode, Audio::SoundHandle
 #ifdef USE_VORBIS
 			{
 			assert(size > 0);
-			input = Audio::makeVorbisStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = Audio::makeCachedAudioStream(_sfxFilename, offset,
+				new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES),
+				DisposeAfterUse::YES, &Audio::makeVorbisStream);
 			}
 #endif
 			break;
@@ -655,7 +660,9 @@ void Sound::startTalkSound(uint32 offset, uint32 b, int mode, Audio::SoundHandle
 #ifdef USE_FLAC
 			{
 			assert(size > 0);
-			input = Audio::makeFLACStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = Audio::makeCachedAudioStream(_sfxFilename, offset,
+				new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES),
+				DisposeAfterUse::YES, &Audio::makeFLACStream);
 			}
 #endif
 			break;
@@ -33,6 +33,7 @@
 #include "sword1/sword1.h"
 
 #include "audio/audiostream.h"
+#include "audio/decoders/decoded_cache.h"
 #include "audio/decoders/flac.h"
 #include "audio/decoders/mp3.h"
 #include "audio/decoders/raw.h"
@@ -410,7 +411,7 @@ bool Sound::startSpeech(uint16 roomNo, uint16 localNo) {
 			_cowFile.seek(index);
 			Common::SeekableReadStream *tmp = _cowFile.readStream(sampleSize);
 			assert(tmp);
-			stream = Audio::makeFLACStream(tmp, DisposeAfterUse::YES);
+			stream = Audio::makeCachedAudioStream(_cowFile.getName(), index, tmp, DisposeAfterUse::YES, &Audio::makeFLACStream);
 			_mixer->playStream(Audio::Mixer::kSpeechSoundType, &_speechHandle, stream, SOUND_SPEECH_ID, speechVol, speechPan);
 			// with compressed audio, we can't calculate the wave volume.
 			// so default to talking.
@@ -424,7 +425,7 @@ bool Sound::startSpeech(uint16 roomNo, uint16 localNo) {
 			_cowFile.seek(index);
 			Common::SeekableReadStream *tmp = _cowFile.readStream(sampleSize);
 			assert(tmp);
-			stream = Audio::makeVorbisStream(tmp, DisposeAfterUse::YES);
+			stream = Audio::makeCachedAudioStream(_cowFile.getName(), index, tmp, DisposeAfterUse::YES, &Audio::makeVorbisStream);
 			_mixer->playStream(Audio::Mixer::kSpeechSoundType, &_speechHandle, stream, SOUND_SPEECH_ID, speechVol, speechPan);
 			// with compressed audio, we can't calculate the wave volume.
 			// so default to talking.
@@ -438,7 +439,7 @@ bool Sound::startSpeech(uint16 roomNo, uint16 localNo) {
 			_cowFile.seek(index);
 			Common::SeekableReadStream *tmp = _cowFile.readStream(sampleSize);
 			assert(tmp);
-			stream = Audio::makeMP3Stream(tmp, DisposeAfterUse::YES);
+			stream = Audio::makeCachedAudioStream(_cowFile.getName(), index, tmp, DisposeAfterUse::YES, &Audio::makeMP3Stream);
 			_mixer->playStream(Audio::Mixer::kSpeechSoundType, &_speechHandle, stream, SOUND_SPEECH_ID, speechVol, speechPan);
 			// with compressed audio, we can't calculate the wave volume.
 			// so default to talking.
@@ -37,6 +37,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/mixer.h"
+#include "audio/decoders/decoded_cache.h"
 #include "audio/decoders/mp3.h"
 #include "audio/decoders/vorbis.h"
 #include "audio/decoders/flac.h"
@@ -162,19 +163,19 @@ static Audio::AudioStream *getAudioStream(SoundFileHandle *fh, const char *base,
 #ifdef USE_MAD
 	case kMP3Mode: {
 		Common::SafeSeekableSubReadStream *tmp = new Common::SafeSeekableSubReadStream(&fh->file, pos, pos + enc_len);
-		return Audio::makeMP3Stream(tmp, DisposeAfterUse::YES);
+		return Audio::makeCachedAudioStream(fh->file.getName(), pos, tmp, DisposeAfterUse::YES, &Audio::makeMP3Stream);
 		}
 #endif
 #ifdef USE_VORBIS
 	case kVorbisMode: {
 		Common::SafeSeekableSubReadStream *tmp = new Common::SafeSeekableSubReadStream(&fh->file, pos, pos + enc_len);
-		return Audio::makeVorbisStream(tmp, DisposeAfterUse::YES);
+		return Audio::makeCachedAudioStream(fh->file.getName(), pos, tmp, DisposeAfterUse::YES, &Audio::makeVorbisStream);
 		}
 #endif
 #ifdef USE_FLAC
 	case kFLACMode: {
 		Common::SafeSeekableSubReadStream *tmp = new Common::SafeSeekableSubReadStream(&fh->file, pos, pos + enc_len);
-		return Audio::makeFLACStream(tmp, DisposeAfterUse::YES);
+		return Audio::makeCachedAudioStream(fh->file.getName(), pos, tmp, DisposeAfterUse::YES, &Audio::makeFLACStream);
 		}
 #endif
 	default:
@@ -179,4 +179,20 @@ void VectorRenderer::stepGetPositions(const DrawStep &step, const Common::Rect &
 	}
 }
 
+Common::Rect VectorRenderer::stepGetBounds(const DrawStep &step, const Common::Rect &area) {
+	uint16 x, y, w, h;
+	stepGetPositions(step, area, x, y, w, h);
+
+	// Lines include their end point
+	Common::Rect bounds(x, y, x + w + 1, y + h + 1);
+	if (step.drawingCall == &VectorRenderer::drawCallback_CIRCLE) {
+		int radius = stepGetRadius(step, area);
+		bounds = Common::Rect(x, y, x + 2 * radius + 1, y + 2 * radius + 1);
+	}
+
+	// Strokes, bevels, shadows and antialiasing may reach beyond the shape
+	bounds.grow(MAX<int>(step.stroke, step.bevel) + step.shadow + 2);
+	return bounds;
+}
+
 } // End of namespace Graphics
@@ -294,6 +294,22 @@ public:
 	 */
 	virtual void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) = 0;
 
+	/**
+	 * The colors set with the functions above, in the format of the renderer.
+	 * Drawing steps which do not set a color use the one of the steps drawn
+	 * before them.
+	 */
+	struct ColorState {
+		uint32 fg, bg, bevel, gradientStart, gradientEnd;
+
+		bool operator==(const ColorState &state) const {
+			return fg == state.fg && bg == state.bg && bevel == state.bevel &&
+			       gradientStart == state.gradientStart && gradientEnd == state.gradientEnd;
+		}
+	};
+
+	virtual ColorState getColorState() const = 0;
+
 	/**
 	 * Sets the active drawing surface. All drawing from this
 	 * point on will be done on that surface.
@@ -400,6 +416,12 @@ public:
 	 */
 	int stepGetRadius(const DrawStep &step, const Common::Rect &area);
 
+	/**
+	 * Returns a rectangle containing all the pixels the drawstep may modify
+	 * when drawn in the given area. The estimate is conservative.
+	 */
+	Common::Rect stepGetBounds(const DrawStep &step, const Common::Rect &area);
+
 	/**
 	 * Restrict a draw call clipping rect with a step specific clipping rect
 	 */
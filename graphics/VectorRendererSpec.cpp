@@ -27,6 +27,7 @@
 #include "graphics/surface.h"
 #include "graphics/transparent_surface.h"
 #include "graphics/nine_patch.h"
+#include "graphics/span_intern.h"
 
 #include "gui/ThemeEngine.h"
 #include "graphics/VectorRenderer.h"
@@ -424,17 +425,52 @@ inline frac_t fp_sqroot(uint32 x) {
 
 namespace Graphics {
 
+/** Spans shorter than this are not worth calling the span kernels for. */
+static const int kSpanKernelMinWidth = 16;
+
+/** Span kernels for the CPU we are running on, picked by createRenderer(). */
+static const SpanKernels *g_spanKernels = nullptr;
+
+const SpanKernels *getSpanKernels() {
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return &spanKernelsAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &spanKernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &spanKernelsNEON;
+#endif
+	return nullptr;
+}
+
+static inline int spanFill(uint16 *dst, int width, uint16 even, uint16 odd) {
+	return g_spanKernels->fill16(dst, width, even, odd);
+}
+
+static inline int spanFill(uint32 *dst, int width, uint32 even, uint32 odd) {
+	return g_spanKernels->fill32(dst, width, even, odd);
+}
+
+static inline int spanBlend(uint16 *dst, int width, const SpanBlend &blend) {
+	return g_spanKernels->blend16(dst, width, blend);
+}
+
+static inline int spanBlend(uint32 *dst, int width, const SpanBlend &blend) {
+	return g_spanKernels->blend32(dst, width, blend);
+}
+
 /**
  * Fills several pixels in a row with a given color.
  *
- * This is a replacement function for Common::fill, using an unrolled
- * loop to maximize performance on most architectures.
- * This function may (and should) be overloaded in any child renderers
- * for portable platforms with platform-specific assembly code.
+ * This is a replacement function for Common::fill, using the SIMD span
+ * kernels for long rows and an unrolled loop for the rest.
  *
  * This fill operation is extensively used throughout the renderer, so this
- * counts as one of the main bottlenecks. Please replace it with assembly
- * when possible!
+ * counts as one of the main bottlenecks.
  *
  * @param first Pointer to the first pixel to fill.
  * @param last Pointer to the last pixel to fill.
@@ -445,6 +481,15 @@ void colorFill(PixelType *first, PixelType *last, PixelType color) {
 	int count = (last - first);
 	if (!count)
 		return;
+
+	if (g_spanKernels && count >= kSpanKernelMinWidth) {
+		const int filled = spanFill(first, count, color, color);
+		first += filled;
+		count -= filled;
+		if (!count)
+			return;
+	}
+
 	int n = (count + 7) >> 3;
 	switch (count % 8) {
 	default:
@@ -483,23 +528,31 @@ void colorFillClip(PixelType *first, PixelType *last, PixelType color, int realX
 		count -= diff;
 	}
 
-	if (!count)
-		return;
+	colorFill<PixelType>(first, first + count, color);
+}
 
-	int n = (count + 7) >> 3;
-	switch (count % 8) {
-	default:
-	case 0:	do {
-	       		*first++ = color; // fall through
-	case 7:		*first++ = color; // fall through
-	case 6:		*first++ = color; // fall through
-	case 5:		*first++ = color; // fall through
-	case 4:		*first++ = color; // fall through
-	case 3:		*first++ = color; // fall through
-	case 2:		*first++ = color; // fall through
-	case 1:		*first++ = color;
-	       	} while (--n > 0);
+/**
+ * Fills several pixels in a row with two colors alternately, as used for
+ * dithering gradients.
+ *
+ * @param first Pointer to the first pixel to fill.
+ * @param last Pointer to the last pixel to fill.
+ * @param even Color of the first pixel, and every other one after it
+ * @param odd Color of the remaining pixels
+ */
+template<typename PixelType>
+void colorFillAlternate(PixelType *first, PixelType *last, PixelType even, PixelType odd) {
+	// The kernels always fill an even number of pixels
+	if (g_spanKernels && last - first >= kSpanKernelMinWidth)
+		first += spanFill(first, last - first, even, odd);
+
+	while (last - first >= 2) {
+		*first++ = even;
+		*first++ = odd;
 	}
+
+	if (first != last)
+		*first = even;
 }
 
 
@@ -508,6 +561,8 @@ VectorRenderer *createRenderer(int mode) {
 	assert(mode == GUI::ThemeEngine::kGfxStandard);
 #endif
 
+	g_spanKernels = getSpanKernels();
+
 	PixelFormat format = g_system->getOverlayFormat();
 	switch (mode) {
 	case GUI::ThemeEngine::kGfxStandard:
@@ -545,6 +600,12 @@ VectorRendererSpec(PixelFormat format) :
 
 	_fgColor = _bgColor = _bevelColor = 0;
 	_gradientStart = _gradientEnd = 0;
+
+	// The 32bpp span kernels blend whole bytes
+	_spanBlend = sizeof(PixelType) == 2 ||
+		(format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 &&
+		 format.rShift % 8 == 0 && format.gShift % 8 == 0 && format.bShift % 8 == 0 &&
+		 (format.aLoss == 8 || (format.aLoss == 0 && format.aShift % 8 == 0)));
 }
 
 /****************************
@@ -634,16 +695,14 @@ gradientFill(PixelType *ptr, int width, int x, int y) {
 	} else if (grad == 3 && ox) {
 		colorFill<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1]);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			bool oy = ((j & 1) == 1);
+		// Pixels in even and in odd columns get the same color each
+		const PixelType even = (ox && grad >= 2) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		const PixelType odd = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
 
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		if (x & 1)
+			colorFillAlternate<PixelType>(ptr, ptr + width, odd, even);
+		else
+			colorFillAlternate<PixelType>(ptr, ptr + width, even, odd);
 	}
 }
 
@@ -676,17 +735,17 @@ gradientFillClip(PixelType *ptr, int width, int x, int y, int realX, int realY)
 	} else if (grad == 3 && ox) {
 		colorFillClip<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1], realX, realY, _clippingArea);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			if (realX + j - x < _clippingArea.left || realX + j - x >= _clippingArea.right) continue;
-			bool oy = ((j & 1) == 1);
-
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		// Pixels in even and in odd columns get the same color each
+		const PixelType even = (ox && grad >= 2) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		const PixelType odd = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+
+		const int left = CLIP<int>(_clippingArea.left - realX, 0, width);
+		const int right = CLIP<int>(_clippingArea.right - realX, left, width);
+
+		if ((x + left) & 1)
+			colorFillAlternate<PixelType>(ptr + left, ptr + right, odd, even);
+		else
+			colorFillAlternate<PixelType>(ptr + left, ptr + right, even, odd);
 	}
 }
 
@@ -935,6 +994,38 @@ blendPixelPtr(PixelType *ptr, PixelType color, uint8 alpha) {
 	}
 }
 
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
+	if (alpha == 0xff) {
+		// fully opaque pixels, don't blend
+		colorFill<PixelType>(first, last, color | _alphaMask);
+		return;
+	}
+
+	if (g_spanKernels && _spanBlend && last - first >= kSpanKernelMinWidth) {
+		const PixelType masks[4] = { _redMask, _greenMask, _blueMask, _alphaMask };
+		const uint8 shifts[4] = { _format.rShift, _format.gShift, _format.bShift, _format.aShift };
+
+		SpanBlend blend;
+		blend.invAlpha = 256 - alpha;
+		for (int c = 0; c < 4; c++) {
+			// The alpha channel is blended towards opaque
+			const PixelType source = (c == 3 ? masks[c] : color & masks[c]) >> shifts[c];
+			blend.shift[c] = shifts[c];
+			blend.max[c] = masks[c] >> shifts[c];
+			blend.source[c] = source * alpha;
+		}
+		blend.color = (color & (_redMask | _greenMask | _blueMask)) | _alphaMask;
+		blend.mask = _redMask | _greenMask | _blueMask | _alphaMask;
+
+		first += spanBlend(first, last - first, blend);
+	}
+
+	while (first != last)
+		blendPixelPtr(first++, color, alpha);
+}
+
 template<typename PixelType>
 inline void VectorRendererSpec<PixelType>::
 blendPixelPtrClip(PixelType *ptr, PixelType color, uint8 alpha, int x, int y) {
@@ -2062,7 +2153,7 @@ drawBevelSquareAlgClip(int x, int y, int w, int h, int bevel, PixelType top_colo
 		}
 	} else {
 		while (i-- ) {
-			blendFillClip(ptr_left, ptr_left + w, ptr_x, ptr_y, _bgColor, 200);
+			blendFillClip(ptr_left, ptr_left + w, _bgColor, 200, ptr_x, ptr_y);
 			ptr_left += pitch;
 		}
 	}
@@ -82,6 +82,10 @@ public:
 	void setBgColor(uint8 r, uint8 g, uint8 b) override { _bgColor = _format.RGBToColor(r, g, b); }
 	void setBevelColor(uint8 r, uint8 g, uint8 b) override { _bevelColor = _format.RGBToColor(r, g, b); }
 	void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) override;
+	ColorState getColorState() const override {
+		ColorState state = { _fgColor, _bgColor, _bevelColor, _gradientStart, _gradientEnd };
+		return state;
+	}
 	void setClippingRect(const Common::Rect &clippingArea) override { _clippingArea = clippingArea; }
 
 	void copyFrame(OSystem *sys, const Common::Rect &r) override;
@@ -284,20 +288,14 @@ protected:
 	 * @param color Color of the pixel
 	 * @param alpha Alpha intensity of the pixel (0-255)
 	 */
-	inline void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
-		while (first != last)
-			blendPixelPtr(first++, color, alpha);
-	}
+	void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha);
 
 	inline void blendFillClip(PixelType *first, PixelType *last, PixelType color, uint8 alpha, int realX, int realY) {
 		if (_clippingArea.top <= realY && realY < _clippingArea.bottom) {
-			while (first != last) {
-				if (_clippingArea.left <= realX && realX < _clippingArea.right)
-					blendPixelPtr(first++, color, alpha);
-				else
-					++first;
-				++realX;
-			}
+			const int count = last - first;
+			const int left = CLIP<int>(_clippingArea.left - realX, 0, count);
+			const int right = CLIP<int>(_clippingArea.right - realX, left, count);
+			blendFill(first + left, first + right, color, alpha);
 		}
 	}
 
@@ -320,6 +318,9 @@ protected:
 
 	PixelType _bevelColor;
 	PixelType _bitmapAlphaColor;
+
+	/** Whether the span kernels can blend pixels of this format. */
+	bool _spanBlend;
 };
 
 
@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/blend_intern.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+const int kStep = 8;
+
+/** Load the next eight pixels, in output order. */
+inline __m256i loadPixels(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return _mm256_loadu_si256((const __m256i *)in);
+
+	// The source is flipped, so the pixels are stored right to left
+	const __m256i pixels = _mm256_loadu_si256((const __m256i *)(in + 7 * inStep));
+	return _mm256_permutevar8x32_epi32(pixels, _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+/** Broadcast the alpha value of each pixel to all of its 16-bit channels. */
+inline __m256i broadcastAlpha(__m256i channels) {
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(channels, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+inline void storeSelected(byte *out, __m256i pixels, __m256i keepOut) {
+	const __m256i old = _mm256_loadu_si256((const __m256i *)out);
+	_mm256_storeu_si256((__m256i *)out, _mm256_blendv_epi8(pixels, old, keepOut));
+}
+
+uint32 blitOpaque(byte *out, const byte *in, uint32 width) {
+	const __m256i alpha = _mm256_set1_epi32(0xFF);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		_mm256_storeu_si256((__m256i *)out, _mm256_or_si256(_mm256_loadu_si256((const __m256i *)in), alpha));
+		in += 32;
+		out += 32;
+	}
+
+	return j;
+}
+
+uint32 blitBinary(byte *out, const byte *in, int32 inStep, uint32 width) {
+	const __m256i alpha = _mm256_set1_epi32(0xFF);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		const __m256i pixels = loadPixels(in, inStep);
+		const __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(pixels, alpha), _mm256_setzero_si256());
+		storeSelected(out, _mm256_or_si256(pixels, alpha), transparent);
+		in += kStep * inStep;
+		out += 32;
+	}
+
+	return j;
+}
+
+uint32 blitAlphaBlend(byte *out, const byte *in, int32 inStep, uint32 width, uint32 color) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alpha = _mm256_set1_epi32(0xFF);
+	const __m256i max = _mm256_set1_epi16(255);
+	const bool colorMod = color != 0xFFFFFFFF;
+
+	// Color modulation per 16-bit channel, in the A B G R order of the pixels
+	const __m256i ca = _mm256_set1_epi16((color >> 24) & 0xFF);
+	const __m256i cbgr = _mm256_set1_epi64x(((uint64)((color >> 16) & 0xFF) << 48) | ((uint64)((color >> 8) & 0xFF) << 32) |
+	                                        ((uint64)(color & 0xFF) << 16));
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		const __m256i pixels = loadPixels(in, inStep);
+		const __m256i old = _mm256_loadu_si256((const __m256i *)out);
+
+		// The unpacking and packing both work within 128-bit lanes, so the
+		// pixels end up back in their original order
+		__m256i in16[2] = { _mm256_unpacklo_epi8(pixels, zero), _mm256_unpackhi_epi8(pixels, zero) };
+		const __m256i out16[2] = { _mm256_unpacklo_epi8(old, zero), _mm256_unpackhi_epi8(old, zero) };
+		__m256i a16[2], res16[2];
+
+		for (int k = 0; k < 2; k++) {
+			a16[k] = broadcastAlpha(in16[k]);
+
+			if (colorMod) {
+				// out = (out * (255 - a) >> 8) + (in * a * c >> 16), with a = in.a * ca >> 8
+				a16[k] = _mm256_srli_epi16(_mm256_mullo_epi16(a16[k], ca), 8);
+				const __m256i dst = _mm256_srli_epi16(_mm256_mullo_epi16(out16[k], _mm256_sub_epi16(max, a16[k])), 8);
+				const __m256i src = _mm256_mulhi_epu16(_mm256_mullo_epi16(in16[k], a16[k]), cbgr);
+				res16[k] = _mm256_add_epi16(dst, src);
+			} else {
+				// out = (in * a + out * (255 - a)) >> 8
+				const __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(in16[k], a16[k]),
+				                                     _mm256_mullo_epi16(out16[k], _mm256_sub_epi16(max, a16[k])));
+				res16[k] = _mm256_srli_epi16(sum, 8);
+			}
+		}
+
+		// Every byte of a pixel holds its alpha value after packing
+		const __m256i a8 = _mm256_packus_epi16(a16[0], a16[1]);
+		const __m256i transparent = _mm256_cmpeq_epi32(a8, zero);
+		storeSelected(out, _mm256_or_si256(_mm256_packus_epi16(res16[0], res16[1]), alpha), transparent);
+
+		in += kStep * inStep;
+		out += 32;
+	}
+
+	return j;
+}
+
+uint32 transCopy16(uint16 *dst, const uint16 *src, uint32 width, uint16 transColor, uint16 compareMask) {
+	const __m256i mask = _mm256_set1_epi16(compareMask);
+	const __m256i trans = _mm256_set1_epi16(transColor & compareMask);
+	uint32 j = 0;
+
+	for (; j + 16 <= width; j += 16) {
+		const __m256i pixels = _mm256_loadu_si256((const __m256i *)(src + j));
+		const __m256i transparent = _mm256_cmpeq_epi16(_mm256_and_si256(pixels, mask), trans);
+		storeSelected((byte *)(dst + j), pixels, transparent);
+	}
+
+	return j;
+}
+
+uint32 transCopy32(uint32 *dst, const uint32 *src, uint32 width, uint32 transColor, uint32 compareMask) {
+	const __m256i mask = _mm256_set1_epi32(compareMask);
+	const __m256i trans = _mm256_set1_epi32(transColor & compareMask);
+	uint32 j = 0;
+
+	for (; j + 8 <= width; j += 8) {
+		const __m256i pixels = _mm256_loadu_si256((const __m256i *)(src + j));
+		const __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(pixels, mask), trans);
+		storeSelected((byte *)(dst + j), pixels, transparent);
+	}
+
+	return j;
+}
+
+} // End of anonymous namespace
+
+const BlendKernels blendKernelsAVX2 = {
+	blitOpaque,
+	blitBinary,
+	blitAlphaBlend,
+	transCopy16,
+	transCopy32
+};
+
+} // End of namespace Graphics
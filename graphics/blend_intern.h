@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_BLEND_INTERN_H
+#define GRAPHICS_BLEND_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * SIMD versions of the inner loops of TransparentSurface::blit() and
+ * ManagedSurface::transBlitFrom().
+ *
+ * Each function handles a single row and produces the same result as the
+ * scalar code. They may leave some pixels at the end of the row, and
+ * return the number of pixels they handled.
+ *
+ * The TransparentSurface functions work on its 32bpp format, with alpha in
+ * the lowest byte. @p inStep is 4, or -4 for a horizontally flipped source.
+ */
+struct BlendKernels {
+	/** Copy the pixels, making them opaque. */
+	uint32 (*blitOpaque)(byte *out, const byte *in, uint32 width);
+	/** Copy the pixels with non-zero alpha, making them opaque. */
+	uint32 (*blitBinary)(byte *out, const byte *in, int32 inStep, uint32 width);
+	/** Alpha blend the pixels, with @p color as 0xAARRGGBB color modulation. */
+	uint32 (*blitAlphaBlend)(byte *out, const byte *in, int32 inStep, uint32 width, uint32 color);
+
+	/** Copy the pixels for which (pixel & compareMask) != (transColor & compareMask). */
+	uint32 (*transCopy16)(uint16 *dst, const uint16 *src, uint32 width, uint16 transColor, uint16 compareMask);
+	uint32 (*transCopy32)(uint32 *dst, const uint32 *src, uint32 width, uint32 transColor, uint32 compareMask);
+};
+
+/** Return the kernels for the CPU we are running on, or 0 if there are none. */
+const BlendKernels *getBlendKernels();
+
+#ifdef SCUMMVM_SSE2
+extern const BlendKernels blendKernelsSSE2;
+#endif
+
+#ifdef SCUMMVM_AVX2
+extern const BlendKernels blendKernelsAVX2;
+#endif
+
+#ifdef SCUMMVM_NEON
+extern const BlendKernels blendKernelsNEON;
+#endif
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,172 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/blend_intern.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+const int kStep = 4;
+
+/** Load the next four pixels, in output order. */
+inline uint8x16_t loadPixels(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return vld1q_u8(in);
+
+	// The source is flipped, so the pixels are stored right to left
+	const uint32x4_t pixels = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(in + 3 * inStep)));
+	return vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(pixels), vget_low_u32(pixels)));
+}
+
+/** Return the alpha value of each pixel in all of its bytes. */
+inline uint8x16_t broadcastAlpha(uint8x16_t pixels) {
+	const uint32x4_t a = vandq_u32(vreinterpretq_u32_u8(pixels), vdupq_n_u32(0xFF));
+	return vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101));
+}
+
+inline void storeSelected(byte *out, uint8x16_t pixels, uint8x16_t keepOut) {
+	vst1q_u8(out, vbslq_u8(keepOut, vld1q_u8(out), pixels));
+}
+
+inline uint8x16_t isTransparent(uint8x16_t alpha) {
+	return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(alpha), vdupq_n_u32(0)));
+}
+
+uint32 blitOpaque(byte *out, const byte *in, uint32 width) {
+	const uint32x4_t alpha = vdupq_n_u32(0xFF);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		vst1q_u8(out, vreinterpretq_u8_u32(vorrq_u32(vreinterpretq_u32_u8(vld1q_u8(in)), alpha)));
+		in += 16;
+		out += 16;
+	}
+
+	return j;
+}
+
+uint32 blitBinary(byte *out, const byte *in, int32 inStep, uint32 width) {
+	const uint8x16_t alpha = vreinterpretq_u8_u32(vdupq_n_u32(0xFF));
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		const uint8x16_t pixels = loadPixels(in, inStep);
+		storeSelected(out, vorrq_u8(pixels, alpha), isTransparent(vandq_u8(pixels, alpha)));
+		in += kStep * inStep;
+		out += 16;
+	}
+
+	return j;
+}
+
+/** Compute (in * a * c) >> 16 for four pixels, with 16-bit @p in times @p a. */
+inline uint8x8_t modulate(uint16x8_t ina, uint16x4_t c) {
+	const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(ina), c), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(ina), c), 16);
+	return vmovn_u16(vcombine_u16(lo, hi));
+}
+
+uint32 blitAlphaBlend(byte *out, const byte *in, int32 inStep, uint32 width, uint32 color) {
+	const uint8x16_t alpha = vreinterpretq_u8_u32(vdupq_n_u32(0xFF));
+	const uint8x8_t max = vdup_n_u8(255);
+	const bool colorMod = color != 0xFFFFFFFF;
+
+	// Color modulation per 16-bit channel, in the A B G R order of the pixels
+	const uint8x8_t ca = vdup_n_u8((color >> 24) & 0xFF);
+	const uint16_t cbgrValues[4] = { 0, (uint16_t)(color & 0xFF), (uint16_t)((color >> 8) & 0xFF), (uint16_t)((color >> 16) & 0xFF) };
+	const uint16x4_t cbgr = vld1_u16(cbgrValues);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		const uint8x16_t pixels = loadPixels(in, inStep);
+		const uint8x16_t old = vld1q_u8(out);
+		const uint8x8_t in8[2] = { vget_low_u8(pixels), vget_high_u8(pixels) };
+		const uint8x8_t out8[2] = { vget_low_u8(old), vget_high_u8(old) };
+		const uint8x16_t a = broadcastAlpha(pixels);
+		uint8x8_t a8[2] = { vget_low_u8(a), vget_high_u8(a) };
+		uint8x8_t res8[2];
+
+		for (int k = 0; k < 2; k++) {
+			if (colorMod) {
+				// out = (out * (255 - a) >> 8) + (in * a * c >> 16), with a = in.a * ca >> 8
+				a8[k] = vshrn_n_u16(vmull_u8(a8[k], ca), 8);
+				const uint8x8_t dst = vshrn_n_u16(vmull_u8(out8[k], vsub_u8(max, a8[k])), 8);
+				res8[k] = vadd_u8(dst, modulate(vmull_u8(in8[k], a8[k]), cbgr));
+			} else {
+				// out = (in * a + out * (255 - a)) >> 8
+				const uint16x8_t sum = vmlal_u8(vmull_u8(in8[k], a8[k]), out8[k], vsub_u8(max, a8[k]));
+				res8[k] = vshrn_n_u16(sum, 8);
+			}
+		}
+
+		const uint8x16_t transparent = isTransparent(vcombine_u8(a8[0], a8[1]));
+		storeSelected(out, vorrq_u8(vcombine_u8(res8[0], res8[1]), alpha), transparent);
+
+		in += kStep * inStep;
+		out += 16;
+	}
+
+	return j;
+}
+
+uint32 transCopy16(uint16 *dst, const uint16 *src, uint32 width, uint16 transColor, uint16 compareMask) {
+	const uint16x8_t mask = vdupq_n_u16(compareMask);
+	const uint16x8_t trans = vdupq_n_u16(transColor & compareMask);
+	uint32 j = 0;
+
+	for (; j + 8 <= width; j += 8) {
+		const uint16x8_t pixels = vld1q_u16(src + j);
+		const uint16x8_t transparent = vceqq_u16(vandq_u16(pixels, mask), trans);
+		vst1q_u16(dst + j, vbslq_u16(transparent, vld1q_u16(dst + j), pixels));
+	}
+
+	return j;
+}
+
+uint32 transCopy32(uint32 *dst, const uint32 *src, uint32 width, uint32 transColor, uint32 compareMask) {
+	const uint32x4_t mask = vdupq_n_u32(compareMask);
+	const uint32x4_t trans = vdupq_n_u32(transColor & compareMask);
+	uint32 j = 0;
+
+	for (; j + 4 <= width; j += 4) {
+		const uint32x4_t pixels = vld1q_u32(src + j);
+		const uint32x4_t transparent = vceqq_u32(vandq_u32(pixels, mask), trans);
+		vst1q_u32(dst + j, vbslq_u32(transparent, vld1q_u32(dst + j), pixels));
+	}
+
+	return j;
+}
+
+} // End of anonymous namespace
+
+const BlendKernels blendKernelsNEON = {
+	blitOpaque,
+	blitBinary,
+	blitAlphaBlend,
+	transCopy16,
+	transCopy32
+};
+
+} // End of namespace Graphics
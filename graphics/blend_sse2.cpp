@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/blend_intern.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+const int kStep = 4;
+
+/** Load the next four pixels, in output order. */
+inline __m128i loadPixels(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return _mm_loadu_si128((const __m128i *)in);
+
+	// The source is flipped, so the pixels are stored right to left
+	const __m128i pixels = _mm_loadu_si128((const __m128i *)(in + 3 * inStep));
+	return _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+/** Broadcast the alpha value of each pixel to all of its 16-bit channels. */
+inline __m128i broadcastAlpha(__m128i channels) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(channels, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+inline void storeSelected(byte *out, __m128i pixels, __m128i keepOut) {
+	const __m128i old = _mm_loadu_si128((const __m128i *)out);
+	_mm_storeu_si128((__m128i *)out, _mm_or_si128(_mm_and_si128(keepOut, old), _mm_andnot_si128(keepOut, pixels)));
+}
+
+uint32 blitOpaque(byte *out, const byte *in, uint32 width) {
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		_mm_storeu_si128((__m128i *)out, _mm_or_si128(_mm_loadu_si128((const __m128i *)in), alpha));
+		in += 16;
+		out += 16;
+	}
+
+	return j;
+}
+
+uint32 blitBinary(byte *out, const byte *in, int32 inStep, uint32 width) {
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		const __m128i pixels = loadPixels(in, inStep);
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(pixels, alpha), _mm_setzero_si128());
+		storeSelected(out, _mm_or_si128(pixels, alpha), transparent);
+		in += kStep * inStep;
+		out += 16;
+	}
+
+	return j;
+}
+
+uint32 blitAlphaBlend(byte *out, const byte *in, int32 inStep, uint32 width, uint32 color) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha = _mm_set1_epi32(0xFF);
+	const __m128i max = _mm_set1_epi16(255);
+	const bool colorMod = color != 0xFFFFFFFF;
+
+	// Color modulation per 16-bit channel, in the A B G R order of the pixels
+	const __m128i ca = _mm_set1_epi16((color >> 24) & 0xFF);
+	const __m128i cbgr = _mm_set_epi16((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, 0,
+	                                   (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, 0);
+	uint32 j = 0;
+
+	for (; j + kStep <= width; j += kStep) {
+		const __m128i pixels = loadPixels(in, inStep);
+		const __m128i old = _mm_loadu_si128((const __m128i *)out);
+
+		__m128i in16[2] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+		const __m128i out16[2] = { _mm_unpacklo_epi8(old, zero), _mm_unpackhi_epi8(old, zero) };
+		__m128i a16[2], res16[2];
+
+		for (int k = 0; k < 2; k++) {
+			a16[k] = broadcastAlpha(in16[k]);
+
+			if (colorMod) {
+				// out = (out * (255 - a) >> 8) + (in * a * c >> 16), with a = in.a * ca >> 8
+				a16[k] = _mm_srli_epi16(_mm_mullo_epi16(a16[k], ca), 8);
+				const __m128i dst = _mm_srli_epi16(_mm_mullo_epi16(out16[k], _mm_sub_epi16(max, a16[k])), 8);
+				const __m128i src = _mm_mulhi_epu16(_mm_mullo_epi16(in16[k], a16[k]), cbgr);
+				res16[k] = _mm_add_epi16(dst, src);
+			} else {
+				// out = (in * a + out * (255 - a)) >> 8
+				const __m128i sum = _mm_add_epi16(_mm_mullo_epi16(in16[k], a16[k]),
+				                                  _mm_mullo_epi16(out16[k], _mm_sub_epi16(max, a16[k])));
+				res16[k] = _mm_srli_epi16(sum, 8);
+			}
+		}
+
+		// Every byte of a pixel holds its alpha value after packing
+		const __m128i a8 = _mm_packus_epi16(a16[0], a16[1]);
+		const __m128i transparent = _mm_cmpeq_epi32(a8, zero);
+		storeSelected(out, _mm_or_si128(_mm_packus_epi16(res16[0], res16[1]), alpha), transparent);
+
+		in += kStep * inStep;
+		out += 16;
+	}
+
+	return j;
+}
+
+uint32 transCopy16(uint16 *dst, const uint16 *src, uint32 width, uint16 transColor, uint16 compareMask) {
+	const __m128i mask = _mm_set1_epi16(compareMask);
+	const __m128i trans = _mm_set1_epi16(transColor & compareMask);
+	uint32 j = 0;
+
+	for (; j + 8 <= width; j += 8) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + j));
+		const __m128i transparent = _mm_cmpeq_epi16(_mm_and_si128(pixels, mask), trans);
+		storeSelected((byte *)(dst + j), pixels, transparent);
+	}
+
+	return j;
+}
+
+uint32 transCopy32(uint32 *dst, const uint32 *src, uint32 width, uint32 transColor, uint32 compareMask) {
+	const __m128i mask = _mm_set1_epi32(compareMask);
+	const __m128i trans = _mm_set1_epi32(transColor & compareMask);
+	uint32 j = 0;
+
+	for (; j + 4 <= width; j += 4) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + j));
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(pixels, mask), trans);
+		storeSelected((byte *)(dst + j), pixels, transparent);
+	}
+
+	return j;
+}
+
+} // End of anonymous namespace
+
+const BlendKernels blendKernelsSSE2 = {
+	blitOpaque,
+	blitBinary,
+	blitAlphaBlend,
+	transCopy16,
+	transCopy32
+};
+
+} // End of namespace Graphics
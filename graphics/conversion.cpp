@@ -21,9 +21,11 @@
  */
 
 #include "graphics/conversion.h"
+#include "graphics/conversion_intern.h"
 #include "graphics/pixelformat.h"
 
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -115,8 +117,128 @@ inline void crossBlitLogic3BppSource(byte *dst, const byte *src, const uint w, c
 	}
 }
 
+CrossBlitRowFunc getCrossBlitRowFunc() {
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return crossBlitRowAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return crossBlitRowSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return crossBlitRowNEON;
+#endif
+	return 0;
+}
+
+bool crossBlitSIMD(byte *dst, const byte *src,
+                   const uint dstPitch, const uint srcPitch,
+                   const uint w, const uint h,
+                   const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	const uint srcBpp = srcFmt.bytesPerPixel;
+	const uint dstBpp = dstFmt.bytesPerPixel;
+	if ((srcBpp != 2 && srcBpp != 4) || (dstBpp != 2 && dstBpp != 4) || !w || !h)
+		return false;
+
+	// The kernels convert rows front to back. When converting in place,
+	// this only works if every pixel stays where it is.
+	const byte *srcEnd = src + (h - 1) * srcPitch + w * srcBpp;
+	const byte *dstEnd = dst + (h - 1) * dstPitch + w * dstBpp;
+	if (dst < srcEnd && src < dstEnd && (dst != src || dstPitch != srcPitch || dstBpp != srcBpp))
+		return false;
+
+	const CrossBlitRowFunc rowFunc = getCrossBlitRowFunc();
+	if (!rowFunc)
+		return false;
+
+	CrossBlitPlan plan;
+	if (!plan.init(srcFmt, dstFmt))
+		return false;
+
+	for (uint y = 0; y < h; ++y) {
+		const uint done = rowFunc(dst, src, w, plan);
+
+		// Convert what the kernel left over at the end of the row
+		byte *dstTail = dst + done * dstBpp;
+		const byte *srcTail = src + done * srcBpp;
+		if (done < w) {
+			if (srcBpp == 2 && dstBpp == 2)
+				crossBlitLogic<uint16, uint16, false>(dstTail, srcTail, w - done, 1, srcFmt, dstFmt, 0, 0);
+			else if (srcBpp == 2)
+				crossBlitLogic<uint16, uint32, false>(dstTail, srcTail, w - done, 1, srcFmt, dstFmt, 0, 0);
+			else if (dstBpp == 2)
+				crossBlitLogic<uint32, uint16, false>(dstTail, srcTail, w - done, 1, srcFmt, dstFmt, 0, 0);
+			else
+				crossBlitLogic<uint32, uint32, false>(dstTail, srcTail, w - done, 1, srcFmt, dstFmt, 0, 0);
+		}
+
+		dst += dstPitch;
+		src += srcPitch;
+	}
+
+	return true;
+}
+
 } // End of anonymous namespace
 
+bool CrossBlitPlan::init(const PixelFormat &srcFmt, const PixelFormat &dstFmt) {
+	const uint8 srcLoss[4] = { srcFmt.aLoss, srcFmt.rLoss, srcFmt.gLoss, srcFmt.bLoss };
+	const uint8 srcShift[4] = { srcFmt.aShift, srcFmt.rShift, srcFmt.gShift, srcFmt.bShift };
+	const uint8 dstLoss[4] = { dstFmt.aLoss, dstFmt.rLoss, dstFmt.gLoss, dstFmt.bLoss };
+	const uint8 dstShift[4] = { dstFmt.aShift, dstFmt.rShift, dstFmt.gShift, dstFmt.bShift };
+
+	srcBytesPerPixel = srcFmt.bytesPerPixel;
+	dstBytesPerPixel = dstFmt.bytesPerPixel;
+	numChannels = 0;
+	dstConstant = 0;
+
+	for (int i = 0; i < 4; i++) {
+		const uint srcBits = 8 - srcLoss[i];
+		const uint dstBits = 8 - dstLoss[i];
+
+		if (dstBits == 0)
+			continue;
+
+		if (srcBits == 0) {
+			// Missing color channels are black, a missing alpha channel is opaque
+			if (i == 0)
+				dstConstant |= (0xFF >> dstLoss[i]) << dstShift[i];
+			continue;
+		}
+
+		Channel &channel = channels[numChannels++];
+		channel.dstShift = dstShift[i];
+		channel.expandLeft = channel.expandRight = 0;
+
+		if (srcBits >= dstBits) {
+			// Only the topmost bits are kept, so no need to expand them first
+			channel.expand = kExpandNone;
+			channel.srcShift = srcShift[i] + srcBits - dstBits;
+			channel.srcMask = (1 << dstBits) - 1;
+			channel.dstLoss = 0;
+		} else {
+			channel.srcShift = srcShift[i];
+			channel.srcMask = (1 << srcBits) - 1;
+			channel.dstLoss = dstLoss[i];
+
+			if (srcBits == 1) {
+				channel.expand = kExpandOneBit;
+			} else if (srcBits >= 4) {
+				// Repeat the topmost bits, like ColorComponent<>::expand
+				channel.expand = kExpandShift;
+				channel.expandLeft = 8 - srcBits;
+				channel.expandRight = 2 * srcBits - 8;
+			} else {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src,
                const uint dstPitch, const uint srcPitch,
@@ -134,6 +256,9 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	if (crossBlitSIMD(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -300,13 +425,28 @@ Size scaleBlitBilinearInterpolate(Size c01, Size c00, Size c11, Size c10, int ex
 	return fmt.ARGBToColor(dp_a, dp_r, dp_g, dp_b);
 }
 
-template <typename Size, bool flipx, bool flipy> // TODO: See mirroring comment in RenderTicket ctor
+/**
+ * Interpolate 32-bit colors with 8-bit channels at byte boundaries, which
+ * need no conversion to and from ARGB. The channels which are not part of
+ * the format are cleared with @p keepMask, like ARGBToColor() would.
+ */
+inline uint32 scaleBlitBilinearInterpolateBytes(uint32 c01, uint32 c00, uint32 c11, uint32 c10, int ex, int ey, uint32 keepMask) {
+	uint32 result = 0;
+	for (int shift = 0; shift < 32; shift += 8) {
+		const byte dp = scaleBlitBilinearInterpolate((byte)(c01 >> shift), (byte)(c00 >> shift), (byte)(c11 >> shift), (byte)(c10 >> shift), ex, ey);
+		result |= (uint32)dp << shift;
+	}
+	return result & keepMask;
+}
+
+template <typename Size, bool flipx, bool flipy, bool byteChannels> // TODO: See mirroring comment in RenderTicket ctor
 void scaleBlitBilinearLogic(byte *dst, const byte *src,
                             const uint dstPitch, const uint srcPitch,
                             const uint dstW, const uint dstH,
 							const uint srcW, const uint srcH,
                             const Graphics::PixelFormat &fmt,
                             int *sax, int *say) {
+	const uint32 keepMask = fmt.ARGBToColor(255, 255, 255, 255);
 
 	int spixelw = (srcW - 1);
 	int spixelh = (srcH - 1);
@@ -357,7 +497,10 @@ void scaleBlitBilinearLogic(byte *dst, const byte *src,
 			/*
 			* Draw and interpolate colors
 			*/
-			*dp = scaleBlitBilinearInterpolate(*(const Size *)c01, *(const Size *)c00, *(const Size *)c11, *(const Size *)c10, ex, ey, fmt);
+			if (byteChannels)
+				*dp = scaleBlitBilinearInterpolateBytes(*(const Size *)c01, *(const Size *)c00, *(const Size *)c11, *(const Size *)c10, ex, ey, keepMask);
+			else
+				*dp = scaleBlitBilinearInterpolate(*(const Size *)c01, *(const Size *)c00, *(const Size *)c11, *(const Size *)c10, ex, ey, fmt);
 			/*
 			* Advance source pointer x
 			*/
@@ -444,10 +587,16 @@ bool scaleBlitBilinear(byte *dst, const byte *src,
 		}
 	}
 
-	if (fmt.bytesPerPixel == 4) {
-		scaleBlitBilinearLogic<uint32, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
+	// The common 32-bit formats can be interpolated byte by byte
+	const bool byteChannels = fmt.rLoss == 0 && fmt.gLoss == 0 && fmt.bLoss == 0 && (fmt.aLoss == 0 || fmt.aLoss == 8)
+		&& fmt.rShift % 8 == 0 && fmt.gShift % 8 == 0 && fmt.bShift % 8 == 0 && fmt.aShift % 8 == 0;
+
+	if (fmt.bytesPerPixel == 4 && byteChannels) {
+		scaleBlitBilinearLogic<uint32, false, false, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
+	} else if (fmt.bytesPerPixel == 4) {
+		scaleBlitBilinearLogic<uint32, false, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 	} else if (fmt.bytesPerPixel == 2) {
-		scaleBlitBilinearLogic<uint16, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
+		scaleBlitBilinearLogic<uint16, false, false, false>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say);
 	} else {
 		delete[] sax;
 		delete[] say;
@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/conversion_intern.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+struct ChannelVectors {
+	CrossBlitPlan::Expand expand;
+	__m128i srcShift, expandLeft, expandRight, dstLoss, dstShift;
+	__m256i srcMask;
+};
+
+struct PlanVectors {
+	uint numChannels;
+	ChannelVectors channels[4];
+	__m256i dstConstant;
+
+	PlanVectors(const CrossBlitPlan &plan) : numChannels(plan.numChannels) {
+		for (uint i = 0; i < numChannels; i++) {
+			const CrossBlitPlan::Channel &c = plan.channels[i];
+			channels[i].expand = c.expand;
+			channels[i].srcShift = _mm_cvtsi32_si128(c.srcShift);
+			channels[i].srcMask = _mm256_set1_epi32(c.srcMask);
+			channels[i].expandLeft = _mm_cvtsi32_si128(c.expandLeft);
+			channels[i].expandRight = _mm_cvtsi32_si128(c.expandRight);
+			channels[i].dstLoss = _mm_cvtsi32_si128(c.dstLoss);
+			channels[i].dstShift = _mm_cvtsi32_si128(c.dstShift);
+		}
+		dstConstant = _mm256_set1_epi32(plan.dstConstant);
+	}
+};
+
+/** Convert eight pixels held in 32-bit lanes, see the SSE2 version. */
+inline __m256i convertPixels(__m256i in, const PlanVectors &plan) {
+	__m256i out = plan.dstConstant;
+
+	for (uint i = 0; i < plan.numChannels; i++) {
+		const ChannelVectors &c = plan.channels[i];
+		__m256i v = _mm256_and_si256(_mm256_srl_epi32(in, c.srcShift), c.srcMask);
+
+		if (c.expand == CrossBlitPlan::kExpandShift) {
+			v = _mm256_or_si256(_mm256_sll_epi32(v, c.expandLeft), _mm256_srl_epi32(v, c.expandRight));
+			v = _mm256_srl_epi32(v, c.dstLoss);
+		} else if (c.expand == CrossBlitPlan::kExpandOneBit) {
+			v = _mm256_and_si256(_mm256_sub_epi32(_mm256_setzero_si256(), v), _mm256_set1_epi32(0xFF));
+			v = _mm256_srl_epi32(v, c.dstLoss);
+		}
+
+		out = _mm256_or_si256(out, _mm256_sll_epi32(v, c.dstShift));
+	}
+
+	return out;
+}
+
+/**
+ * Pack sixteen pixels in 32-bit lanes into 16-bit ones, without saturating.
+ * Packing works on the two 128-bit lanes separately, so the result needs
+ * to be put back in order.
+ */
+inline __m256i packPixels(__m256i lo, __m256i hi) {
+	lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 16), 16);
+	hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 16), 16);
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+template<int srcBpp, int dstBpp>
+uint crossBlitRow(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan) {
+	const PlanVectors vectors(plan);
+	uint x = 0;
+
+	for (; x + 16 <= w; x += 16) {
+		__m256i lo, hi;
+		if (srcBpp == 2) {
+			lo = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+			hi = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + 16)));
+		} else {
+			lo = _mm256_loadu_si256((const __m256i *)src);
+			hi = _mm256_loadu_si256((const __m256i *)(src + 32));
+		}
+
+		lo = convertPixels(lo, vectors);
+		hi = convertPixels(hi, vectors);
+
+		if (dstBpp == 2) {
+			_mm256_storeu_si256((__m256i *)dst, packPixels(lo, hi));
+		} else {
+			_mm256_storeu_si256((__m256i *)dst, lo);
+			_mm256_storeu_si256((__m256i *)(dst + 32), hi);
+		}
+
+		src += 16 * srcBpp;
+		dst += 16 * dstBpp;
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+uint crossBlitRowAVX2(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan) {
+	if (plan.srcBytesPerPixel == 2)
+		return plan.dstBytesPerPixel == 2 ? crossBlitRow<2, 2>(dst, src, w, plan) : crossBlitRow<2, 4>(dst, src, w, plan);
+	else
+		return plan.dstBytesPerPixel == 2 ? crossBlitRow<4, 2>(dst, src, w, plan) : crossBlitRow<4, 4>(dst, src, w, plan);
+}
+
+} // End of namespace Graphics
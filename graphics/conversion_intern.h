@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_CONVERSION_INTERN_H
+#define GRAPHICS_CONVERSION_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+struct PixelFormat;
+
+/**
+ * Describes how crossBlit() turns one source pixel into a destination pixel
+ * with a fixed sequence of shifts and masks, which is what the SIMD kernels
+ * implement.
+ *
+ * Each destination channel is computed as:
+ *
+ *   v = (src >> srcShift) & srcMask
+ *   v = (v << expandLeft) | (v >> expandRight)    if expand == kExpandShift
+ *   v = (0 - v) & 0xFF                            if expand == kExpandOneBit
+ *   v = v >> dstLoss                              if expand != kExpandNone
+ *   dst |= v << dstShift
+ *
+ * which gives the same result as PixelFormat::colorToARGB() followed by
+ * PixelFormat::ARGBToColor(). Destination channels which do not need any
+ * source bits, like the alpha channel of a source without alpha, are
+ * folded into dstConstant.
+ */
+struct CrossBlitPlan {
+	enum Expand {
+		kExpandNone,
+		kExpandShift,
+		kExpandOneBit
+	};
+
+	struct Channel {
+		Expand expand;
+		uint32 srcShift;
+		uint32 srcMask;
+		uint32 expandLeft;
+		uint32 expandRight;
+		uint32 dstLoss;
+		uint32 dstShift;
+	};
+
+	uint srcBytesPerPixel;
+	uint dstBytesPerPixel;
+
+	uint numChannels;
+	Channel channels[4];
+	uint32 dstConstant;
+
+	/**
+	 * Set up the plan for converting from @p srcFmt to @p dstFmt.
+	 *
+	 * @return false if the formats are not supported by the kernels.
+	 */
+	bool init(const PixelFormat &srcFmt, const PixelFormat &dstFmt);
+};
+
+/**
+ * Convert the pixels of a row from one format to another. The kernels only
+ * handle 2 and 4 bytes per pixel, and may leave some pixels at the end of
+ * the row for the caller to convert.
+ *
+ * @return the number of pixels converted.
+ */
+typedef uint (*CrossBlitRowFunc)(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan);
+
+#ifdef SCUMMVM_SSE2
+uint crossBlitRowSSE2(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan);
+#endif
+
+#ifdef SCUMMVM_AVX2
+uint crossBlitRowAVX2(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan);
+#endif
+
+#ifdef SCUMMVM_NEON
+uint crossBlitRowNEON(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan);
+#endif
+
+} // End of namespace Graphics
+
+#endif
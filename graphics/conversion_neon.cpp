@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/conversion_intern.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+// NEON shifts by a vector of signed counts; negative counts shift right.
+struct ChannelVectors {
+	CrossBlitPlan::Expand expand;
+	int32x4_t srcShift, expandLeft, expandRight, dstLoss, dstShift;
+	uint32x4_t srcMask;
+};
+
+struct PlanVectors {
+	uint numChannels;
+	ChannelVectors channels[4];
+	uint32x4_t dstConstant;
+
+	PlanVectors(const CrossBlitPlan &plan) : numChannels(plan.numChannels) {
+		for (uint i = 0; i < numChannels; i++) {
+			const CrossBlitPlan::Channel &c = plan.channels[i];
+			channels[i].expand = c.expand;
+			channels[i].srcShift = vdupq_n_s32(-(int32)c.srcShift);
+			channels[i].srcMask = vdupq_n_u32(c.srcMask);
+			channels[i].expandLeft = vdupq_n_s32(c.expandLeft);
+			channels[i].expandRight = vdupq_n_s32(-(int32)c.expandRight);
+			channels[i].dstLoss = vdupq_n_s32(-(int32)c.dstLoss);
+			channels[i].dstShift = vdupq_n_s32(c.dstShift);
+		}
+		dstConstant = vdupq_n_u32(plan.dstConstant);
+	}
+};
+
+/** Convert four pixels held in 32-bit lanes, see the SSE2 version. */
+inline uint32x4_t convertPixels(uint32x4_t in, const PlanVectors &plan) {
+	uint32x4_t out = plan.dstConstant;
+
+	for (uint i = 0; i < plan.numChannels; i++) {
+		const ChannelVectors &c = plan.channels[i];
+		uint32x4_t v = vandq_u32(vshlq_u32(in, c.srcShift), c.srcMask);
+
+		if (c.expand == CrossBlitPlan::kExpandShift) {
+			v = vorrq_u32(vshlq_u32(v, c.expandLeft), vshlq_u32(v, c.expandRight));
+			v = vshlq_u32(v, c.dstLoss);
+		} else if (c.expand == CrossBlitPlan::kExpandOneBit) {
+			v = vandq_u32(vsubq_u32(vdupq_n_u32(0), v), vdupq_n_u32(0xFF));
+			v = vshlq_u32(v, c.dstLoss);
+		}
+
+		out = vorrq_u32(out, vshlq_u32(v, c.dstShift));
+	}
+
+	return out;
+}
+
+template<int srcBpp, int dstBpp>
+uint crossBlitRow(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan) {
+	const PlanVectors vectors(plan);
+	uint x = 0;
+
+	for (; x + 8 <= w; x += 8) {
+		uint32x4_t lo, hi;
+		if (srcBpp == 2) {
+			const uint16x8_t in = vld1q_u16((const uint16 *)src);
+			lo = vmovl_u16(vget_low_u16(in));
+			hi = vmovl_u16(vget_high_u16(in));
+		} else {
+			lo = vld1q_u32((const uint32 *)src);
+			hi = vld1q_u32((const uint32 *)(src + 16));
+		}
+
+		lo = convertPixels(lo, vectors);
+		hi = convertPixels(hi, vectors);
+
+		if (dstBpp == 2) {
+			vst1q_u16((uint16 *)dst, vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+		} else {
+			vst1q_u32((uint32 *)dst, lo);
+			vst1q_u32((uint32 *)(dst + 16), hi);
+		}
+
+		src += 8 * srcBpp;
+		dst += 8 * dstBpp;
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+uint crossBlitRowNEON(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan) {
+	if (plan.srcBytesPerPixel == 2)
+		return plan.dstBytesPerPixel == 2 ? crossBlitRow<2, 2>(dst, src, w, plan) : crossBlitRow<2, 4>(dst, src, w, plan);
+	else
+		return plan.dstBytesPerPixel == 2 ? crossBlitRow<4, 2>(dst, src, w, plan) : crossBlitRow<4, 4>(dst, src, w, plan);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/conversion_intern.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+struct ChannelVectors {
+	CrossBlitPlan::Expand expand;
+	__m128i srcShift, srcMask, expandLeft, expandRight, dstLoss, dstShift;
+};
+
+struct PlanVectors {
+	uint numChannels;
+	ChannelVectors channels[4];
+	__m128i dstConstant;
+
+	PlanVectors(const CrossBlitPlan &plan) : numChannels(plan.numChannels) {
+		for (uint i = 0; i < numChannels; i++) {
+			const CrossBlitPlan::Channel &c = plan.channels[i];
+			channels[i].expand = c.expand;
+			channels[i].srcShift = _mm_cvtsi32_si128(c.srcShift);
+			channels[i].srcMask = _mm_set1_epi32(c.srcMask);
+			channels[i].expandLeft = _mm_cvtsi32_si128(c.expandLeft);
+			channels[i].expandRight = _mm_cvtsi32_si128(c.expandRight);
+			channels[i].dstLoss = _mm_cvtsi32_si128(c.dstLoss);
+			channels[i].dstShift = _mm_cvtsi32_si128(c.dstShift);
+		}
+		dstConstant = _mm_set1_epi32(plan.dstConstant);
+	}
+};
+
+/** Convert four pixels held in 32-bit lanes. */
+inline __m128i convertPixels(__m128i in, const PlanVectors &plan) {
+	__m128i out = plan.dstConstant;
+
+	for (uint i = 0; i < plan.numChannels; i++) {
+		const ChannelVectors &c = plan.channels[i];
+		__m128i v = _mm_and_si128(_mm_srl_epi32(in, c.srcShift), c.srcMask);
+
+		if (c.expand == CrossBlitPlan::kExpandShift) {
+			v = _mm_or_si128(_mm_sll_epi32(v, c.expandLeft), _mm_srl_epi32(v, c.expandRight));
+			v = _mm_srl_epi32(v, c.dstLoss);
+		} else if (c.expand == CrossBlitPlan::kExpandOneBit) {
+			v = _mm_and_si128(_mm_sub_epi32(_mm_setzero_si128(), v), _mm_set1_epi32(0xFF));
+			v = _mm_srl_epi32(v, c.dstLoss);
+		}
+
+		out = _mm_or_si128(out, _mm_sll_epi32(v, c.dstShift));
+	}
+
+	return out;
+}
+
+/** Pack eight pixels in 32-bit lanes into 16-bit ones, without saturating. */
+inline __m128i packPixels(__m128i lo, __m128i hi) {
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+template<int srcBpp, int dstBpp>
+uint crossBlitRow(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan) {
+	const PlanVectors vectors(plan);
+	uint x = 0;
+
+	for (; x + 8 <= w; x += 8) {
+		__m128i lo, hi;
+		if (srcBpp == 2) {
+			const __m128i in = _mm_loadu_si128((const __m128i *)src);
+			lo = _mm_unpacklo_epi16(in, _mm_setzero_si128());
+			hi = _mm_unpackhi_epi16(in, _mm_setzero_si128());
+		} else {
+			lo = _mm_loadu_si128((const __m128i *)src);
+			hi = _mm_loadu_si128((const __m128i *)(src + 16));
+		}
+
+		lo = convertPixels(lo, vectors);
+		hi = convertPixels(hi, vectors);
+
+		if (dstBpp == 2) {
+			_mm_storeu_si128((__m128i *)dst, packPixels(lo, hi));
+		} else {
+			_mm_storeu_si128((__m128i *)dst, lo);
+			_mm_storeu_si128((__m128i *)(dst + 16), hi);
+		}
+
+		src += 8 * srcBpp;
+		dst += 8 * dstBpp;
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+uint crossBlitRowSSE2(byte *dst, const byte *src, uint w, const CrossBlitPlan &plan) {
+	if (plan.srcBytesPerPixel == 2)
+		return plan.dstBytesPerPixel == 2 ? crossBlitRow<2, 2>(dst, src, w, plan) : crossBlitRow<2, 4>(dst, src, w, plan);
+	else
+		return plan.dstBytesPerPixel == 2 ? crossBlitRow<4, 2>(dst, src, w, plan) : crossBlitRow<4, 4>(dst, src, w, plan);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/cursor_cache.h"
+
+namespace Graphics {
+
+static uint32 hashBytes(uint32 hash, const void *ptr, uint size) {
+	// FNV-1a
+	const byte *bytes = (const byte *)ptr;
+	for (uint i = 0; i < size; ++i)
+		hash = (hash ^ bytes[i]) * 16777619;
+	return hash;
+}
+
+static uint32 hashKey(const void *data, uint dataSize, const void *params, uint paramsSize) {
+	return hashBytes(hashBytes(2166136261U, params, paramsSize), data, dataSize);
+}
+
+CursorCache::CursorCache(uint maxEntries) : _maxEntries(MAX<uint>(maxEntries, 1)), _useCounter(0) {
+}
+
+CursorCache::~CursorCache() {
+	clear();
+}
+
+CursorCache::Entry *CursorCache::findEntry(uint32 hash, const void *data, uint dataSize, const void *params, uint paramsSize) {
+	for (uint i = 0; i < _entries.size(); ++i) {
+		Entry *entry = _entries[i];
+		if (entry->hash != hash || entry->dataSize != dataSize || entry->paramsSize != paramsSize)
+			continue;
+		if (memcmp(entry->key, params, paramsSize) || memcmp(entry->key + paramsSize, data, dataSize))
+			continue;
+		return entry;
+	}
+
+	return nullptr;
+}
+
+const Surface *CursorCache::find(const void *data, uint dataSize, const void *params, uint paramsSize) {
+	Entry *entry = findEntry(hashKey(data, dataSize, params, paramsSize), data, dataSize, params, paramsSize);
+	if (!entry)
+		return nullptr;
+
+	entry->lastUse = ++_useCounter;
+	return &entry->image;
+}
+
+const Surface *CursorCache::insert(const void *data, uint dataSize, const void *params, uint paramsSize, const Surface &image) {
+	const uint32 hash = hashKey(data, dataSize, params, paramsSize);
+
+	Entry *entry = findEntry(hash, data, dataSize, params, paramsSize);
+	if (!entry) {
+		if (_entries.size() < _maxEntries) {
+			entry = new Entry();
+			_entries.push_back(entry);
+		} else {
+			entry = _entries[0];
+			for (uint i = 1; i < _entries.size(); ++i) {
+				if (_entries[i]->lastUse < entry->lastUse)
+					entry = _entries[i];
+			}
+			delete[] entry->key;
+		}
+
+		entry->hash = hash;
+		entry->dataSize = dataSize;
+		entry->paramsSize = paramsSize;
+		entry->key = new byte[paramsSize + dataSize];
+		memcpy(entry->key, params, paramsSize);
+		memcpy(entry->key + paramsSize, data, dataSize);
+	}
+
+	entry->image.copyFrom(image);
+	entry->lastUse = ++_useCounter;
+	return &entry->image;
+}
+
+void CursorCache::clear() {
+	for (uint i = 0; i < _entries.size(); ++i) {
+		delete[] _entries[i]->key;
+		_entries[i]->image.free();
+		delete _entries[i];
+	}
+	_entries.clear();
+}
+
+} // End of namespace Graphics
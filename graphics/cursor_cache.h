@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_CURSOR_CACHE_H
+#define GRAPHICS_CURSOR_CACHE_H
+
+#include "common/array.h"
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_cursor_cache Cursor cache
+ * @ingroup graphics
+ *
+ * @brief CursorCache class for reusing converted cursor images.
+ *
+ * @{
+ */
+
+/**
+ * Keeps the cursor images a backend made out of the cursors it was given,
+ * after converting them to the screen format and scaling them.
+ *
+ * Engines which animate the cursor keep setting the same few cursors over
+ * and over again. The images are looked up by the cursor data together with
+ * the backend specific parameters of the conversion, such as the palette and
+ * the scale factor, so only cursors which were never seen before with the
+ * current parameters need to be converted. The least recently used images
+ * are dropped once the cache is full.
+ */
+class CursorCache {
+public:
+	CursorCache(uint maxEntries = 32);
+	~CursorCache();
+
+	/**
+	 * Look up the image made from the cursor data @p data with the
+	 * conversion parameters @p params.
+	 *
+	 * The parameters are compared byte by byte, so any padding in them has
+	 * to be initialized.
+	 *
+	 * @return The cached image, or 0 if there is none.
+	 */
+	const Surface *find(const void *data, uint dataSize, const void *params, uint paramsSize);
+
+	/**
+	 * Store a copy of the image made from the cursor data @p data with the
+	 * conversion parameters @p params.
+	 *
+	 * @return The cached copy of the image.
+	 */
+	const Surface *insert(const void *data, uint dataSize, const void *params, uint paramsSize, const Surface &image);
+
+	/**
+	 * Drop all cached images.
+	 */
+	void clear();
+
+private:
+	struct Entry {
+		uint32 hash;
+		byte *key;
+		uint dataSize;
+		uint paramsSize;
+		Surface image;
+		uint32 lastUse;
+	};
+
+	Entry *findEntry(uint32 hash, const void *data, uint dataSize, const void *params, uint paramsSize);
+
+	Common::Array<Entry *> _entries;
+	uint _maxEntries;
+	uint32 _useCounter;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,221 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#include "graphics/dirty_region.h"
+
+namespace Graphics {
+
+DirtyRegion::DirtyRegion(int tileWidth, int tileHeight)
+	: _tileW(tileWidth), _tileH(tileHeight), _width(0), _height(0), _tilesW(0), _tilesH(0) {
+	assert(tileWidth > 0 && tileWidth <= 255);
+	assert(tileHeight > 0 && tileHeight <= 255);
+}
+
+void DirtyRegion::setSize(int width, int height) {
+	if (width == _width && height == _height)
+		return;
+
+	Common::Array<Common::Rect> rects;
+	if (!isEmpty())
+		getRects(rects, _tilesW * _tilesH);
+
+	_width = width;
+	_height = height;
+	_tilesW = (width + _tileW - 1) / _tileW;
+	_tilesH = (height + _tileH - 1) / _tileH;
+
+	const Tile empty = { 0, 0, 0, 0 };
+	_tiles.clear();
+	_tiles.resize(_tilesW * _tilesH);
+	Common::fill(_tiles.begin(), _tiles.end(), empty);
+	_bounds = Common::Rect();
+
+	for (uint i = 0; i < rects.size(); i++)
+		addRect(rects[i]);
+}
+
+void DirtyRegion::addRect(const Common::Rect &rect) {
+	Common::Rect r = rect;
+	r.clip(Common::Rect(_width, _height));
+	if (r.isEmpty())
+		return;
+
+	if (_bounds.isEmpty())
+		_bounds = r;
+	else
+		_bounds.extend(r);
+
+	const int tx0 = r.left / _tileW, tx1 = (r.right - 1) / _tileW;
+	const int ty0 = r.top / _tileH, ty1 = (r.bottom - 1) / _tileH;
+
+	for (int ty = ty0; ty <= ty1; ty++) {
+		const int y = ty * _tileH;
+		const uint8 top = MAX(r.top - y, 0);
+		const uint8 bottom = MIN<int>(r.bottom - y, _tileH);
+
+		for (int tx = tx0; tx <= tx1; tx++) {
+			const int x = tx * _tileW;
+			const uint8 left = MAX(r.left - x, 0);
+			const uint8 right = MIN<int>(r.right - x, _tileW);
+
+			Tile &t = tileAt(tx, ty);
+			if (t.isEmpty()) {
+				t.left = left;
+				t.top = top;
+				t.right = right;
+				t.bottom = bottom;
+			} else {
+				t.left = MIN(t.left, left);
+				t.top = MIN(t.top, top);
+				t.right = MAX(t.right, right);
+				t.bottom = MAX(t.bottom, bottom);
+			}
+		}
+	}
+}
+
+void DirtyRegion::clear() {
+	if (isEmpty())
+		return;
+
+	// Only the tiles inside the bounding box can be dirty
+	const int tx0 = _bounds.left / _tileW, tx1 = (_bounds.right - 1) / _tileW;
+	const int ty0 = _bounds.top / _tileH, ty1 = (_bounds.bottom - 1) / _tileH;
+	const Tile empty = { 0, 0, 0, 0 };
+	for (int ty = ty0; ty <= ty1; ty++)
+		Common::fill(&tileAt(tx0, ty), &tileAt(tx1, ty) + 1, empty);
+
+	_bounds = Common::Rect();
+}
+
+void DirtyRegion::getRects(Common::Array<Common::Rect> &rects, uint maxRects) const {
+	assert(maxRects > 0);
+	if (isEmpty())
+		return;
+
+	const uint start = rects.size();
+	const int tx0 = _bounds.left / _tileW, tx1 = (_bounds.right - 1) / _tileW;
+	const int ty0 = _bounds.top / _tileH, ty1 = (_bounds.bottom - 1) / _tileH;
+
+	// Indices of the rectangles reaching the bottom of the previous row of
+	// tiles, and of those reaching the bottom of the current one. Both are
+	// sorted from left to right.
+	Common::Array<uint> openRects[2];
+	Common::Array<uint> *open = &openRects[0], *nextOpen = &openRects[1];
+
+	for (int ty = ty0; ty <= ty1; ty++) {
+		uint openPos = 0;
+		nextOpen->resize(0);
+
+		int tx = tx0;
+		while (tx <= tx1) {
+			const Tile *t = &tileAt(tx, ty);
+			if (t->isEmpty()) {
+				tx++;
+				continue;
+			}
+
+			// Join horizontally neighbouring tiles, as long as their dirty
+			// areas touch at the tile border
+			Common::Rect span(tx * _tileW + t->left, ty * _tileH + t->top,
+			                  tx * _tileW + t->right, ty * _tileH + t->bottom);
+			while (t->right == _tileW && tx < tx1) {
+				const Tile *next = t + 1;
+				if (next->isEmpty() || next->left != 0)
+					break;
+
+				tx++;
+				t = next;
+				span.right = tx * _tileW + t->right;
+				span.top = MIN<int16>(span.top, ty * _tileH + t->top);
+				span.bottom = MAX<int16>(span.bottom, ty * _tileH + t->bottom);
+			}
+			tx++;
+
+			// Extend a rectangle from the row above if this span continues it
+			while (openPos < open->size() && rects[(*open)[openPos]].left < span.left)
+				openPos++;
+			if (openPos < open->size()) {
+				Common::Rect &above = rects[(*open)[openPos]];
+				if (above.left == span.left && above.right == span.right && above.bottom == span.top) {
+					above.bottom = span.bottom;
+					if (span.bottom == (ty + 1) * _tileH)
+						nextOpen->push_back((*open)[openPos]);
+					continue;
+				}
+			}
+
+			if (span.bottom == (ty + 1) * _tileH)
+				nextOpen->push_back(rects.size());
+			rects.push_back(span);
+		}
+
+		SWAP(open, nextOpen);
+	}
+
+	if (rects.size() - start > maxRects)
+		getCoarseRects(rects, start, maxRects);
+}
+
+void DirtyRegion::getCoarseRects(Common::Array<Common::Rect> &rects, uint start, uint maxRects) const {
+	rects.resize(start);
+
+	const int tx0 = _bounds.left / _tileW, tx1 = (_bounds.right - 1) / _tileW;
+	const int ty0 = _bounds.top / _tileH, ty1 = (_bounds.bottom - 1) / _tileH;
+
+	for (int ty = ty0; ty <= ty1; ty++) {
+		Common::Rect row;
+		for (int tx = tx0; tx <= tx1; tx++) {
+			const Tile &t = tileAt(tx, ty);
+			if (t.isEmpty())
+				continue;
+
+			const Common::Rect r(tx * _tileW + t.left, ty * _tileH + t.top,
+			                     tx * _tileW + t.right, ty * _tileH + t.bottom);
+			if (row.isEmpty())
+				row = r;
+			else
+				row.extend(r);
+		}
+
+		if (!row.isEmpty())
+			rects.push_back(row);
+	}
+
+	// Still too many, so join neighbouring rows until they fit. The rows do
+	// not overlap, and neither do the unions of neighbouring ones.
+	while (rects.size() - start > maxRects) {
+		uint count = start;
+		for (uint i = start; i < rects.size(); i += 2) {
+			Common::Rect r = rects[i];
+			if (i + 1 < rects.size())
+				r.extend(rects[i + 1]);
+			rects[count++] = r;
+		}
+		rects.resize(count);
+	}
+}
+
+} // End of namespace Graphics
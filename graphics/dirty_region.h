@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTY_REGION_H
+#define GRAPHICS_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirty_region Dirty region
+ * @ingroup graphics
+ *
+ * @brief DirtyRegion class for tracking modified areas of a surface.
+ *
+ * @{
+ */
+
+/**
+ * Keeps track of the modified areas of a surface.
+ *
+ * The area is split into fixed size tiles, and each tile remembers the
+ * bounding box of the pixels marked dirty in it. Adding a rectangle thus
+ * only costs a visit of the tiles it touches, no matter how many rectangles
+ * were added before. getRects() then coalesces the dirty tiles into a
+ * bounded number of rectangles covering all dirty pixels.
+ */
+class DirtyRegion {
+public:
+	DirtyRegion(int tileWidth = 16, int tileHeight = 16);
+
+	/**
+	 * Set the size of the tracked area. Any dirty areas are kept, as far as
+	 * they are still inside the new size.
+	 */
+	void setSize(int width, int height);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+
+	/**
+	 * Mark an area as dirty. The rectangle is clipped to the tracked area.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Returns true if nothing is marked as dirty.
+	 */
+	bool isEmpty() const { return _bounds.isEmpty(); }
+
+	/**
+	 * Returns the bounding box of all dirty areas.
+	 */
+	const Common::Rect &getBounds() const { return _bounds; }
+
+	/**
+	 * Mark everything as clean.
+	 */
+	void clear();
+
+	/**
+	 * Append non-overlapping rectangles covering all dirty areas to
+	 * @p rects. At most @p maxRects rectangles are appended; if the dirty
+	 * areas are too scattered for this, the rectangles cover some clean
+	 * pixels as well.
+	 */
+	void getRects(Common::Array<Common::Rect> &rects, uint maxRects) const;
+
+private:
+	/** Dirty pixels of a tile, relative to its top left corner. */
+	struct Tile {
+		uint8 left, top, right, bottom;
+
+		bool isEmpty() const { return right == 0; }
+	};
+
+	Tile &tileAt(int tx, int ty) { return _tiles[ty * _tilesW + tx]; }
+	const Tile &tileAt(int tx, int ty) const { return _tiles[ty * _tilesW + tx]; }
+
+	/** Replace the rectangles from @p start on by one per row of tiles, or less. */
+	void getCoarseRects(Common::Array<Common::Rect> &rects, uint start, uint maxRects) const;
+
+	const int _tileW, _tileH;
+	int _width, _height;
+	int _tilesW, _tilesH;
+	Common::Array<Tile> _tiles;
+	/** Bounding box of all dirty areas, empty if there are none. */
+	Common::Rect _bounds;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
@@ -36,6 +36,11 @@ Common::Rect Font::getBoundingBox(uint32 chr) const {
 	return Common::Rect(getCharWidth(chr), getFontHeight());
 }
 
+void Font::drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const {
+	for (uint i = 0; i < count; ++i)
+		drawChar(dst, chrs[i], xs[i], y, color);
+}
+
 namespace {
 
 template<class StringType>
@@ -109,6 +114,11 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		x = x + w - width;
 	x += deltax;
 
+	// Characters are passed to the font in runs
+	uint32 chrs[64];
+	int xs[64];
+	uint count = 0;
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -118,11 +128,20 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		Common::Rect charBox = font.getBoundingBox(cur);
 		if (x + charBox.right > rightX)
 			break;
-		if (x + charBox.right >= leftX)
-			font.drawChar(dst, cur, x, y, color);
+		if (x + charBox.right >= leftX) {
+			chrs[count] = cur;
+			xs[count] = x;
+			if (++count == ARRAYSIZE(chrs)) {
+				font.drawChars(dst, chrs, xs, count, y, color);
+				count = 0;
+			}
+		}
 
 		x += font.getCharWidth(cur);
 	}
+
+	if (count)
+		font.drawChars(dst, chrs, xs, count, y, color);
 }
 
 template<class StringType>
@@ -183,6 +183,21 @@ public:
 	/** @overload */
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+	/**
+	 * Draw a run of characters on a single line.
+	 *
+	 * This is used by drawString. The default implementation calls drawChar
+	 * for each character; fonts can override it to draw the run at once.
+	 *
+	 * @param dst   The surface to draw on.
+	 * @param chrs  The characters to draw.
+	 * @param xs    The x coordinate where to draw each character.
+	 * @param count The number of characters.
+	 * @param y     The y coordinate where to draw the characters.
+	 * @param color The color of the characters.
+	 */
+	virtual void drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const;
+
 	/**
 	 * Draw the given @p str string to the given @p dst surface.
 	 *
@@ -31,6 +31,7 @@
 #include "graphics/font.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/ustr.h"
 #include "common/file.h"
 #include "common/config-manager.h"
@@ -40,6 +41,7 @@
 #include "common/hashmap.h"
 #include "common/ptr.h"
 #include "common/unzip.h"
+#include "common/util.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -89,6 +91,166 @@ inline int divRoundToNearest(int dividend, int divisor) {
 
 } // End of anonymous namespace
 
+/**
+ * Glyph images of all TTF fonts, of any size, packed into a few pages.
+ *
+ * Each page is filled shelf by shelf. Once all pages are full, the least
+ * recently used page is emptied again. Fonts notice this by the changed
+ * generation of the page and render their glyphs on it again when they are
+ * drawn the next time.
+ */
+class TTFGlyphAtlas {
+public:
+	enum {
+		kPageSize = 512,
+		kMaxPages = 8
+	};
+
+	struct Location {
+		Location() : page(0), x(0), y(0), generation(0) {}
+
+		uint16 page;
+		uint16 x, y;
+		uint32 generation;
+	};
+
+	TTFGlyphAtlas() : _useCount(0), _nextGeneration(0) {}
+	~TTFGlyphAtlas();
+
+	/**
+	 * Start drawing a run of glyphs. Pages used by the run are not emptied
+	 * before the next run starts.
+	 */
+	void beginUse() { _useCount++; }
+
+	/**
+	 * Reserve a @p w x @p h area. Returns false if the area does not fit on
+	 * a page.
+	 */
+	bool allocate(int w, int h, Location &location);
+
+	/**
+	 * Return the pixels at @p location, or nullptr if its page has been
+	 * emptied since the area was allocated.
+	 */
+	uint8 *getPixels(const Location &location);
+
+	int getPitch() const { return kPageSize; }
+
+private:
+	struct Shelf {
+		int y, height;
+		int x;
+	};
+
+	struct Page {
+		uint8 *pixels;
+		Common::Array<Shelf> shelves;
+		int nextY;
+		uint32 generation;
+		uint32 lastUse;
+	};
+
+	bool allocateOnPage(uint page, int w, int h, Location &location);
+	void resetPage(Page &page);
+
+	Common::Array<Page> _pages;
+	uint32 _useCount;
+	uint32 _nextGeneration;
+};
+
+TTFGlyphAtlas::~TTFGlyphAtlas() {
+	for (uint i = 0; i < _pages.size(); ++i)
+		delete[] _pages[i].pixels;
+}
+
+bool TTFGlyphAtlas::allocate(int w, int h, Location &location) {
+	if (w > kPageSize || h > kPageSize)
+		return false;
+
+	for (uint i = 0; i < _pages.size(); ++i) {
+		if (allocateOnPage(i, w, h, location))
+			return true;
+	}
+
+	// Empty the least recently used page, unless all pages are needed by
+	// the current run
+	uint page = _pages.size();
+	if (_pages.size() >= kMaxPages) {
+		for (uint i = 0; i < _pages.size(); ++i) {
+			if (_pages[i].lastUse == _useCount)
+				continue;
+			if (page == _pages.size() || _pages[i].lastUse < _pages[page].lastUse)
+				page = i;
+		}
+	}
+
+	if (page == _pages.size()) {
+		Page newPage;
+		newPage.pixels = new uint8[kPageSize * kPageSize];
+		_pages.push_back(newPage);
+	}
+
+	resetPage(_pages[page]);
+	return allocateOnPage(page, w, h, location);
+}
+
+bool TTFGlyphAtlas::allocateOnPage(uint pageIndex, int w, int h, Location &location) {
+	Page &page = _pages[pageIndex];
+
+	// Use the first shelf which has room left and is not much higher than
+	// needed, or start a new one
+	Shelf *shelf = nullptr;
+	for (uint i = 0; i < page.shelves.size(); ++i) {
+		Shelf &s = page.shelves[i];
+		if (s.height >= h && s.height <= h + h / 4 + 2 && s.x + w <= kPageSize) {
+			shelf = &s;
+			break;
+		}
+	}
+
+	if (!shelf) {
+		if (page.nextY + h > kPageSize)
+			return false;
+
+		Shelf s;
+		s.y = page.nextY;
+		s.height = h;
+		s.x = 0;
+		page.shelves.push_back(s);
+		page.nextY += h;
+		shelf = &page.shelves.back();
+	}
+
+	location.page = pageIndex;
+	location.x = shelf->x;
+	location.y = shelf->y;
+	location.generation = page.generation;
+
+	shelf->x += w;
+	page.lastUse = _useCount;
+	return true;
+}
+
+void TTFGlyphAtlas::resetPage(Page &page) {
+	page.shelves.clear();
+	page.nextY = 0;
+	page.generation = ++_nextGeneration;
+	page.lastUse = _useCount;
+}
+
+uint8 *TTFGlyphAtlas::getPixels(const Location &location) {
+	if (location.page >= _pages.size())
+		return nullptr;
+
+	Page &page = _pages[location.page];
+	if (page.generation != location.generation)
+		return nullptr;
+
+	page.lastUse = _useCount;
+	return page.pixels + location.y * kPageSize + location.x;
+}
+
 class TTFLibrary : public Common::Singleton<TTFLibrary> {
 public:
 	TTFLibrary();
@@ -101,9 +263,12 @@ public:
 
 	bool loadFont(const uint8 *file, const int32 face_index, const uint32 size, FT_Face &face);
 	void closeFont(FT_Face &face);
+
+	TTFGlyphAtlas &getAtlas() { return _atlas; }
 private:
 	FT_Library _library;
 	bool _initialized;
+	TTFGlyphAtlas _atlas;
 };
 
 void shutdownTTF() {
@@ -157,6 +322,8 @@ public:
 	virtual Common::Rect getBoundingBox(uint32 chr) const;
 
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
+
+	virtual void drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const;
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -168,13 +335,19 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
+		/** The image, if it is too large for the atlas. */
 		Surface image;
+		TTFGlyphAtlas::Location location;
+		int width, height;
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
+		uint32 unicode;
 	};
 
 	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
+	/** Return the image of a glyph, rendering it again if it was evicted from the atlas. */
+	const uint8 *getGlyphPixels(Glyph &glyph, int &pitch) const;
 	typedef Common::HashMap<uint32, Glyph> GlyphCache;
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
@@ -182,6 +355,17 @@ private:
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
+	enum {
+		kKerningFirstChar = 0x20,
+		kKerningLastChar = 0x7E,
+		kKerningChars = kKerningLastChar - kKerningFirstChar + 1
+	};
+
+	/** Kerning offsets between printable ASCII characters, if the font has kerning. */
+	Common::Array<int16> _kerningPairs;
+	int computeKerningOffset(uint32 left, uint32 right) const;
+	void computeKerningPairs();
+
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
 	int readPointSizeFromVDMXTable(int height) const;
 	int computePointSizeFromHeaders(int height) const;
@@ -389,6 +573,9 @@ bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold,
 
 		return false;
 	} else {
+		if (_hasKerning)
+			computeKerningPairs();
+
 		_initialized = true;
 		// At this point we get ownership of _ttfFile
 		return true;
@@ -538,9 +725,15 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
+	if (left >= kKerningFirstChar && left <= kKerningLastChar && right >= kKerningFirstChar && right <= kKerningLastChar)
+		return _kerningPairs[(left - kKerningFirstChar) * kKerningChars + right - kKerningFirstChar];
+
 	assureCached(left);
 	assureCached(right);
+	return computeKerningOffset(left, right);
+}
 
+int TTFFont::computeKerningOffset(uint32 left, uint32 right) const {
 	FT_UInt leftGlyph, rightGlyph;
 	GlyphCache::const_iterator glyphEntry;
 
@@ -566,128 +759,197 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	return (kerningVector.x / 64);
 }
 
+void TTFFont::computeKerningPairs() {
+	// All glyphs of this range are cached while loading, either because they
+	// are ISO-8859-1 or because they are part of the mapping
+	_kerningPairs.resize(kKerningChars * kKerningChars);
+	for (uint left = 0; left < kKerningChars; ++left) {
+		for (uint right = 0; right < kKerningChars; ++right)
+			_kerningPairs[left * kKerningChars + right] = computeKerningOffset(left + kKerningFirstChar, right + kKerningFirstChar);
+	}
+}
+
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
 	assureCached(chr);
 	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
 	if (glyphEntry == _glyphs.end()) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		const Glyph &glyph = glyphEntry->_value;
+		return Common::Rect(glyph.xOffset, glyph.yOffset, glyph.xOffset + glyph.width, glyph.yOffset + glyph.height);
 	}
 }
 
 namespace {
 
 template<typename ColorType>
-static void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
+static void renderGlyphRow(uint8 *dstPos, const uint8 *src, const int w, ColorType color, const PixelFormat &dstFormat) {
 	uint8 sR, sG, sB;
 	dstFormat.colorToRGB(color, sR, sG, sB);
 
-	for (int y = 0; y < h; ++y) {
-		ColorType *rDst = (ColorType *)dstPos;
-		const uint8 *src = srcPos;
-
-		for (int x = 0; x < w; ++x) {
-			if (*src == 255) {
-				*rDst = color;
-			} else if (*src) {
-				const uint8 a = *src;
+	ColorType *rDst = (ColorType *)dstPos;
+	for (int x = 0; x < w; ++x) {
+		if (*src == 255) {
+			*rDst = color;
+		} else if (*src) {
+			const uint8 a = *src;
 
-				uint8 dR, dG, dB;
-				dstFormat.colorToRGB(*rDst, dR, dG, dB);
+			uint8 dR, dG, dB;
+			dstFormat.colorToRGB(*rDst, dR, dG, dB);
 
-				dR = ((255 - a) * dR + a * sR) / 255;
-				dG = ((255 - a) * dG + a * sG) / 255;
-				dB = ((255 - a) * dB + a * sB) / 255;
-
-				*rDst = dstFormat.RGBToColor(dR, dG, dB);
-			}
+			dR = ((255 - a) * dR + a * sR) / 255;
+			dG = ((255 - a) * dG + a * sG) / 255;
+			dB = ((255 - a) * dB + a * sB) / 255;
 
-			++rDst;
-			++src;
+			*rDst = dstFormat.RGBToColor(dR, dG, dB);
 		}
 
-		dstPos += dstPitch;
-		srcPos += srcPitch;
+		++rDst;
+		++src;
 	}
 }
 
+/** A glyph of a run, clipped to the destination surface. */
+struct GlyphBlit {
+	const uint8 *src;
+	int srcPitch;
+	int x, y;
+	int w, h;
+};
+
 } // End of anonymous namespace
 
 void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
+	drawChars(dst, &chr, &x, 1, y, color);
+}
 
-	const Glyph &glyph = glyphEntry->_value;
+void TTFFont::drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const {
+	GlyphBlit blits[64];
 
-	x += glyph.xOffset;
-	y += glyph.yOffset;
+	while (count) {
+		const uint runCount = MIN<uint>(count, ARRAYSIZE(blits));
+		uint numBlits = 0;
+		int top = dst->h, bottom = 0;
 
-	if (x > dst->w)
-		return;
-	if (y > dst->h)
-		return;
+		// Look up the glyphs of the run first. The atlas pages they are on
+		// are not evicted until the next run.
+		g_ttf.getAtlas().beginUse();
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+		for (uint i = 0; i < runCount; ++i) {
+			assureCached(chrs[i]);
+			GlyphCache::iterator glyphEntry = _glyphs.find(chrs[i]);
+			if (glyphEntry == _glyphs.end())
+				continue;
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+			Glyph &glyph = glyphEntry->_value;
 
-	// Make sure we are not drawing outside the screen bounds
-	if (x < 0) {
-		srcPos -= x;
-		w += x;
-		x = 0;
-	}
+			int x = xs[i] + glyph.xOffset;
+			int gy = y + glyph.yOffset;
 
-	if (x + w > dst->w)
-		w = dst->w - x;
+			if (x > dst->w)
+				continue;
+			if (gy > dst->h)
+				continue;
 
-	if (w <= 0)
-		return;
+			int w = glyph.width;
+			int h = glyph.height;
+			if (w <= 0 || h <= 0)
+				continue;
 
-	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
-		h += y;
-		y = 0;
-	}
+			int srcPitch;
+			const uint8 *srcPos = getGlyphPixels(glyph, srcPitch);
+			if (!srcPos)
+				continue;
 
-	if (y + h > dst->h)
-		h = dst->h - y;
+			// Make sure we are not drawing outside the screen bounds
+			if (x < 0) {
+				srcPos -= x;
+				w += x;
+				x = 0;
+			}
 
-	if (h <= 0)
-		return;
+			if (x + w > dst->w)
+				w = dst->w - x;
 
-	uint8 *dstPos = (uint8 *)dst->getBasePtr(x, y);
+			if (w <= 0)
+				continue;
 
-	if (dst->format.bytesPerPixel == 1) {
-		for (int cy = 0; cy < h; ++cy) {
-			uint8 *rDst = dstPos;
-			const uint8 *src = srcPos;
+			if (gy < 0) {
+				srcPos -= gy * srcPitch;
+				h += gy;
+				gy = 0;
+			}
 
-			for (int cx = 0; cx < w; ++cx) {
-				// We assume a 1Bpp mode is a color indexed mode, thus we can
-				// not take advantage of anti-aliasing here.
-				if (*src >= 0x80)
-					*rDst = color;
+			if (gy + h > dst->h)
+				h = dst->h - gy;
 
-				++rDst;
-				++src;
-			}
+			if (h <= 0)
+				continue;
+
+			GlyphBlit &blit = blits[numBlits++];
+			blit.src = srcPos;
+			blit.srcPitch = srcPitch;
+			blit.x = x;
+			blit.y = gy;
+			blit.w = w;
+			blit.h = h;
 
-			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			top = MIN(top, gy);
+			bottom = MAX(bottom, gy + h);
 		}
-	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
-	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+
+		// Blend the run row by row. Overlapping glyphs are still blended in
+		// the order of the characters.
+		for (int row = top; row < bottom; ++row) {
+			uint8 *dstRow = (uint8 *)dst->getBasePtr(0, row);
+
+			for (uint i = 0; i < numBlits; ++i) {
+				const GlyphBlit &blit = blits[i];
+				if (row < blit.y || row >= blit.y + blit.h)
+					continue;
+
+				uint8 *dstPos = dstRow + blit.x * dst->format.bytesPerPixel;
+				const uint8 *src = blit.src + (row - blit.y) * blit.srcPitch;
+
+				if (dst->format.bytesPerPixel == 1) {
+					for (int cx = 0; cx < blit.w; ++cx) {
+						// We assume a 1Bpp mode is a color indexed mode, thus we can
+						// not take advantage of anti-aliasing here.
+						if (src[cx] >= 0x80)
+							dstPos[cx] = color;
+					}
+				} else if (dst->format.bytesPerPixel == 2) {
+					renderGlyphRow<uint16>(dstPos, src, blit.w, color, dst->format);
+				} else if (dst->format.bytesPerPixel == 4) {
+					renderGlyphRow<uint32>(dstPos, src, blit.w, color, dst->format);
+				}
+			}
+		}
+
+		chrs += runCount;
+		xs += runCount;
+		count -= runCount;
+	}
+}
+
+const uint8 *TTFFont::getGlyphPixels(Glyph &glyph, int &pitch) const {
+	if (glyph.image.getPixels()) {
+		pitch = glyph.image.pitch;
+		return (const uint8 *)glyph.image.getPixels();
+	}
+
+	TTFGlyphAtlas &atlas = g_ttf.getAtlas();
+	pitch = atlas.getPitch();
+
+	const uint8 *pixels = atlas.getPixels(glyph.location);
+	if (!pixels) {
+		// The atlas page has been reused in the meantime
+		if (!cacheGlyph(glyph, glyph.unicode))
+			return nullptr;
+		pixels = atlas.getPixels(glyph.location);
 	}
+
+	return pixels;
 }
 
 bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
@@ -696,6 +958,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		return false;
 
 	glyph.slot = slot;
+	glyph.unicode = chr;
 
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticable in FreeSansBold.ttf, where otherwise the
@@ -755,7 +1018,25 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	glyph.width = bitmap->width;
+	glyph.height = bitmap->rows;
+
+	// Glyphs go into the shared atlas, unless they are too large for it
+	uint8 *dst;
+	int dstPitch;
+	glyph.image.free();
+	TTFGlyphAtlas &atlas = g_ttf.getAtlas();
+	if (!glyph.width || !glyph.height) {
+		dst = nullptr;
+		dstPitch = 0;
+	} else if (atlas.allocate(glyph.width, glyph.height, glyph.location)) {
+		dst = atlas.getPixels(glyph.location);
+		dstPitch = atlas.getPitch();
+	} else {
+		glyph.image.create(glyph.width, glyph.height, PixelFormat::createFormatCLUT8());
+		dst = (uint8 *)glyph.image.getPixels();
+		dstPitch = glyph.image.pitch;
+	}
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -764,8 +1045,8 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
-	memset(dst, 0, glyph.image.h * glyph.image.pitch);
+	for (int y = 0; y < glyph.height; ++y)
+		memset(dst + y * dstPitch, 0, glyph.width);
 
 	switch (bitmap->pixel_mode) {
 	case FT_PIXEL_MODE_MONO:
@@ -778,12 +1059,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					dst[x] = 255;
 
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += dstPitch;
 			src += srcPitch;
 		}
 		break;
@@ -791,7 +1072,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_GRAY:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+			dst += dstPitch;
 			src += srcPitch;
 		}
 		break;
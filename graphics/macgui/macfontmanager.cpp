@@ -109,7 +109,7 @@ Common::String cleanFontName(const Common::String fontname) {
 	return f;
 }
 
-MacFontManager::MacFontManager(uint32 mode) : _mode(mode) {
+MacFontManager::MacFontManager(uint32 mode) : _mode(mode), _generation(0) {
 	for (uint i = 0; i < ARRAYSIZE(fontNames); i++)
 		if (fontNames[i])
 			_fontIds.setVal(fontNames[i], i);
@@ -231,6 +231,8 @@ void MacFontManager::loadFonts(const Common::String &fileName) {
 }
 
 void MacFontManager::loadFonts(Common::MacResManager *fontFile) {
+	_generation++;
+
 	Common::MacResIDArray fonds = fontFile->getResIDArray(MKTAG('F','O','N','D'));
 	if (fonds.size() > 0) {
 		for (Common::Array<uint16>::iterator iterator = fonds.begin(); iterator != fonds.end(); ++iterator) {
@@ -378,11 +380,13 @@ int MacFontManager::parseFontSlant(Common::String slant) {
 void MacFontManager::registerFontMapping(uint16 id, Common::String name) {
 	_extraFontNames[id] = name;
 	_extraFontIds[name] = id;
+	_generation++;
 }
 
 void MacFontManager::clearFontMapping() {
 	_extraFontNames.clear();
 	_extraFontIds.clear();
+	_generation++;
 }
 
 void MacFont::setName(const char *name) {
@@ -138,7 +138,13 @@ public:
 	void registerFontMapping(uint16 id, Common::String name);
 	void clearFontMapping();
 
-	void forceBuiltinFonts() { _builtInFonts = true; }
+	void forceBuiltinFonts() { _builtInFonts = true; _generation++; }
+
+	/**
+	 * Return a number which changes whenever fonts get loaded or the font
+	 * mapping changes, so fonts looked up earlier may be different now.
+	 */
+	uint32 getGeneration() const { return _generation; }
 
 private:
 	void loadFontsBDF();
@@ -154,6 +160,7 @@ private:
 private:
 	bool _builtInFonts;
 	uint32 _mode;
+	uint32 _generation;
 	Common::HashMap<Common::String, MacFont *> _fontRegistry;
 
 	Common::HashMap<Common::String, int> _fontIds;
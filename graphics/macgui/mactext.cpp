@@ -214,8 +214,7 @@ void MacText::init() {
 	_currentFormatting = _defaultFormatting;
 	_composeSurface->clear(_bgcolor);
 
-	splitString(_str);
-	recalcDims();
+	layoutString();
 
 	_fullRefresh = true;
 	_inTextSelection = false;
@@ -263,9 +262,7 @@ void MacText::setMaxWidth(int maxWidth) {
 
 	_textLines.clear();
 
-	splitString(_str);
-
-	recalcDims();
+	layoutString();
 
 	_fullRefresh = true;
 }
@@ -503,6 +500,26 @@ void MacText::splitString(const Common::U32String &str, int curLine) {
 #endif
 }
 
+void MacText::layoutString() {
+	// The default formatting holds the font id, size and slant. The window
+	// manager drops the layouts when fonts get loaded.
+	Common::U32String key(Common::String::format("%d %d ", _maxWidth, _interLinear));
+	key += _defaultFormatting.toString();
+	key += _str;
+
+	const MacTextLayout *layout = _wm->getTextLayout(key);
+	if (layout) {
+		_textLines = layout->lines;
+		_textMaxWidth = layout->textMaxWidth;
+		_textMaxHeight = layout->textMaxHeight;
+		return;
+	}
+
+	splitString(_str);
+	recalcDims();
+
+	_wm->addTextLayout(key, _textLines, _textMaxWidth, _textMaxHeight);
+}
 
 void MacText::reallocSurface() {
 	// round to closest 10
@@ -114,6 +114,17 @@ struct MacTextLine {
 	uint getChunkNum(int *col);
 };
 
+/**
+ * Lines of a text laid out for a given width, which the window manager keeps
+ * for reuse by texts with the same contents.
+ */
+struct MacTextLayout {
+	Common::Array<MacTextLine> lines;
+	int textMaxWidth;
+	int textMaxHeight;
+	uint32 lastUse;
+};
+
 struct SelectedText {
 	int startX, startY;
 	int endX, endY;
@@ -223,6 +234,13 @@ private:
 
 	void chopChunk(const Common::U32String &str, int *curLine);
 	void splitString(const Common::U32String &s, int curLine = -1);
+
+	/**
+	 * Lays out the whole text from scratch. The lines are shared through the
+	 * window manager, so texts which get recreated with the same contents,
+	 * width and formatting are not wrapped again.
+	 */
+	void layoutString();
 	void render(int from, int to);
 	void recalcDims();
 	void reallocSurface();
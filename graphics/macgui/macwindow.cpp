@@ -43,7 +43,11 @@ BaseMacWindow::BaseMacWindow(int id, bool editable, MacWindowManager *wm) :
 	_visible = true;
 }
 
-void BaseMacWindow::setVisible(bool visible, bool silent) { _visible = visible; _wm->setFullRefresh(true); }
+void BaseMacWindow::setVisible(bool visible, bool silent) {
+	_visible = visible;
+	_contentIsDirty = true;
+	_wm->addDirtyRect(_dims);
+}
 
 bool BaseMacWindow::isVisible() { return _visible; }
 
@@ -109,6 +113,8 @@ void MacWindow::resize(int w, int h, bool inner) {
 	if (_composeSurface->w == w && _composeSurface->h == h)
 		return;
 
+	_wm->addDirtyRect(_dims);
+
 	if (inner) {
 		_innerDims.setWidth(w);
 		_innerDims.setHeight(h);
@@ -130,27 +136,28 @@ void MacWindow::resize(int w, int h, bool inner) {
 
 	_contentIsDirty = true;
 	_borderIsDirty = true;
-	_wm->setFullRefresh(true);
 }
 
 void MacWindow::move(int x, int y) {
 	if (_dims.left == x && _dims.top == y)
 		return;
 
+	_wm->addDirtyRect(_dims);
+
 	_dims.moveTo(x, y);
 	updateInnerDims();
 
 	_contentIsDirty = true;
-	_wm->setFullRefresh(true);
 }
 
 void MacWindow::setDimensions(const Common::Rect &r) {
+	_wm->addDirtyRect(_dims);
+
 	resize(r.width(), r.height());
 	_dims.moveTo(r.left, r.top);
 	updateInnerDims();
 
 	_contentIsDirty = true;
-	_wm->setFullRefresh(true);
 }
 
 void MacWindow::setBackgroundPattern(int pattern) {
@@ -589,13 +596,15 @@ bool MacWindow::processEvent(Common::Event &event) {
 		}
 
 		if (_beingDragged) {
+			_wm->addDirtyRect(_dims);
+
 			_dims.translate(event.mouse.x - _draggedX, event.mouse.y - _draggedY);
 			updateInnerDims();
 
 			_draggedX = event.mouse.x;
 			_draggedY = event.mouse.y;
 
-			_wm->setFullRefresh(true);
+			_contentIsDirty = true;
 		}
 
 		if (_beingResized) {
@@ -605,8 +614,6 @@ bool MacWindow::processEvent(Common::Event &event) {
 			_draggedX = event.mouse.x;
 			_draggedY = event.mouse.y;
 
-			_wm->setFullRefresh(true);
-
 			if (_callback)
 				(*_callback)(click, event, _dataPtr);
 		}
@@ -31,6 +31,7 @@
 #include "graphics/macgui/macwindowmanager.h"
 #include "graphics/macgui/macfontmanager.h"
 #include "graphics/macgui/macwindow.h"
+#include "graphics/macgui/mactext.h"
 #include "graphics/macgui/mactextwindow.h"
 #include "graphics/macgui/macmenu.h"
 
@@ -155,6 +156,9 @@ static const byte macCursorCrossBar[] = {
 
 static void menuTimerHandler(void *refCon);
 
+/** Maximum number of text layouts kept for reuse by MacText. */
+static const uint kTextLayoutCacheSize = 256;
+
 MacWindowManager::MacWindowManager(uint32 mode, MacPatterns *patterns) {
 	_screen = nullptr;
 	_screenCopy = nullptr;
@@ -192,6 +196,9 @@ MacWindowManager::MacWindowManager(uint32 mode, MacPatterns *patterns) {
 	_palette = nullptr;
 	_paletteSize = 0;
 
+	_textLayoutTime = 0;
+	_textLayoutFontGeneration = 0;
+
 	if (mode & kWMMode32bpp)
 		_pixelformat = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
 	else
@@ -225,6 +232,8 @@ MacWindowManager::~MacWindowManager() {
 	if (_palette)
 		free(_palette);
 
+	clearTextLayouts();
+
 	delete _fontMan;
 	delete _screenCopy;
 
@@ -396,7 +405,7 @@ void MacWindowManager::setActiveWindow(int id) {
 	_windowStack.remove(_windows[id]);
 	_windowStack.push_back(_windows[id]);
 
-	_fullRefresh = true;
+	addDirtyRect(_windows[id]->getDimensions());
 }
 
 void MacWindowManager::removeWindow(MacWindow *target) {
@@ -500,11 +509,23 @@ void MacWindowManager::drawDesktop() {
 	}
 }
 
+void MacWindowManager::addDirtyRect(const Common::Rect &r) {
+	if (!r.isEmpty())
+		_dirtyRects.push_back(r);
+}
+
 void MacWindowManager::draw() {
 	removeMarked();
 
 	Common::Rect bounds = getScreenBounds();
 
+	// Engines drawing below the windows can only redraw everything, and so
+	// does a desktop which does not match the screen size anymore
+	if (!_dirtyRects.empty() && (_redrawEngineCallback || _desktop->w != bounds.width() || _desktop->h != bounds.height()))
+		_fullRefresh = true;
+
+	bool redrawMenu = _fullRefresh || !_dirtyRects.empty();
+
 	if (_fullRefresh) {
 		Common::Rect screen = getScreenBounds();
 		if (_desktop->w != screen.width() || _desktop->h != screen.height()) {
@@ -526,6 +547,27 @@ void MacWindowManager::draw() {
 	}
 
 	Common::Array<Common::Rect> dirtyRects;
+	if (!_fullRefresh) {
+		// Restore the desktop below the damaged areas. The windows on top of
+		// them get composited again below.
+		for (uint i = 0; i < _dirtyRects.size(); i++) {
+			Common::Rect r = _dirtyRects[i];
+			r.clip(bounds);
+
+			if (r.isEmpty())
+				continue;
+
+			if (_screen) {
+				_screen->blitFrom(*_desktop, r, Common::Point(r.left, r.top));
+				g_system->copyRectToScreen(_screen->getBasePtr(r.left, r.top), _screen->pitch, r.left, r.top, r.width(), r.height());
+			} else {
+				g_system->copyRectToScreen(_desktop->getBasePtr(r.left, r.top), _desktop->pitch, r.left, r.top, r.width(), r.height());
+			}
+			dirtyRects.push_back(r);
+		}
+	}
+	_dirtyRects.clear();
+
 	for (Common::List<BaseMacWindow *>::const_iterator it = _windowStack.begin(); it != _windowStack.end(); it++) {
 		BaseMacWindow *w = *it;
 		if (!w->isVisible())
@@ -604,7 +646,7 @@ void MacWindowManager::draw() {
 
 	// Menu is drawn on top of everything and always
 	if (_menu && !(_mode & kWMModeFullscreen)) {
-		_menu->draw(_screen, _fullRefresh);
+		_menu->draw(_screen, redrawMenu);
 	}
 
 	_fullRefresh = false;
@@ -709,11 +751,11 @@ void MacWindowManager::removeMarked() {
 
 	Common::List<BaseMacWindow *>::const_iterator it;
 	for (it = _windowsToRemove.begin(); it != _windowsToRemove.end(); it++) {
+		addDirtyRect((*it)->getDimensions());
 		removeFromStack(*it);
 		removeFromWindowList(*it);
 		delete *it;
 		_activeWindow = -1;
-		_fullRefresh = true;
 	}
 	_windowsToRemove.clear();
 	_needsRemoval = false;
@@ -961,6 +1003,9 @@ void MacWindowManager::passPalette(const byte *pal, uint size) {
 	LOOKUPCOLOR(Green);
 	LOOKUPCOLOR(Green2);
 
+	// Text colors are looked up in the palette while laying out
+	clearTextLayouts();
+
 	drawDesktop();
 	setFullRefresh(true);
 }
@@ -995,6 +1040,51 @@ uint MacWindowManager::findBestColor(byte cr, byte cg, byte cb) {
 	return bestColor;
 }
 
+const MacTextLayout *MacWindowManager::getTextLayout(const Common::U32String &key) {
+	// The lines refer to the fonts they were laid out with
+	if (_textLayoutFontGeneration != _fontMan->getGeneration()) {
+		clearTextLayouts();
+		_textLayoutFontGeneration = _fontMan->getGeneration();
+	}
+
+	MacTextLayout *layout = _textLayouts.getValOrDefault(key, nullptr);
+	if (layout)
+		layout->lastUse = ++_textLayoutTime;
+
+	return layout;
+}
+
+void MacWindowManager::addTextLayout(const Common::U32String &key, const Common::Array<MacTextLine> &lines, int textMaxWidth, int textMaxHeight) {
+	if (_textLayouts.contains(key))
+		return;
+
+	// Make room by dropping the layout which was not used for the longest time
+	if (_textLayouts.size() >= kTextLayoutCacheSize) {
+		Common::HashMap<Common::U32String, MacTextLayout *>::iterator oldest = _textLayouts.begin();
+		for (Common::HashMap<Common::U32String, MacTextLayout *>::iterator it = _textLayouts.begin(); it != _textLayouts.end(); ++it) {
+			if (it->_value->lastUse < oldest->_value->lastUse)
+				oldest = it;
+		}
+
+		delete oldest->_value;
+		_textLayouts.erase(oldest);
+	}
+
+	MacTextLayout *layout = new MacTextLayout;
+	layout->lines = lines;
+	layout->textMaxWidth = textMaxWidth;
+	layout->textMaxHeight = textMaxHeight;
+	layout->lastUse = ++_textLayoutTime;
+	_textLayouts[key] = layout;
+}
+
+void MacWindowManager::clearTextLayouts() {
+	for (Common::HashMap<Common::U32String, MacTextLayout *>::iterator it = _textLayouts.begin(); it != _textLayouts.end(); ++it)
+		delete it->_value;
+
+	_textLayouts.clear();
+}
+
 void MacWindowManager::decomposeColor(uint32 color, byte &r, byte &g, byte &b) {
 	if (_pixelformat.bytesPerPixel == 1 || color <= 0xff) {
 		r = *(_palette + 3 * color + 0);
@@ -24,6 +24,7 @@
 #define GRAPHICS_MACGUI_MACWINDOWMANAGER_H
 
 #include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/list.h"
 #include "common/events.h"
 
@@ -103,6 +104,9 @@ class MacFont;
 
 class MacFontManager;
 
+struct MacTextLayout;
+struct MacTextLine;
+
 typedef Common::Array<byte *> MacPatterns;
 
 struct MacPlotData {
@@ -230,6 +234,14 @@ public:
 	 */
 	void setFullRefresh(bool redraw) { _fullRefresh = redraw; }
 
+	/**
+	 * Marks an area of the screen to be composited again on the next draw(),
+	 * for example the one a window was moved away from. Windows which are
+	 * not dirty and do not overlap with such areas are left alone.
+	 * @param r The area, in screen coordinates.
+	 */
+	void addDirtyRect(const Common::Rect &r);
+
 	/**
 	 * Method to draw the desktop into the screen,
 	 * It will take into accout the contents set as dirty.
@@ -297,6 +309,14 @@ public:
 	uint findBestColor(byte cr, byte cg, byte cb);
 	void decomposeColor(uint32 color, byte &r, byte &g, byte &b);
 
+	/**
+	 * Retrieves the lines of a text laid out earlier with the same key.
+	 * @see MacText::layoutString()
+	 * @return The layout, or nullptr if there is none.
+	 */
+	const MacTextLayout *getTextLayout(const Common::U32String &key);
+	void addTextLayout(const Common::U32String &key, const Common::Array<MacTextLine> &lines, int textMaxWidth, int textMaxHeight);
+
 	void renderZoomBox(bool redraw = false);
 	void addZoomBox(ZoomBox *box);
 
@@ -334,6 +354,8 @@ private:
 
 	void adjustDimensions(const Common::Rect &clip, const Common::Rect &dims, int &adjWidth, int &adjHeight);
 
+	void clearTextLayouts();
+
 public:
 	TransparentSurface *_desktopBmp;
 	ManagedSurface *_desktop;
@@ -354,6 +376,7 @@ private:
 	int _activeWindow;
 
 	bool _fullRefresh;
+	Common::Array<Common::Rect> _dirtyRects;
 
 	MacPatterns _patterns;
 	byte *_palette;
@@ -377,6 +400,11 @@ private:
 	Common::Array<ZoomBox *> _zoomBoxes;
 	Common::HashMap<uint32, uint> _colorHash;
 
+	Common::HashMap<Common::U32String, MacTextLayout *> _textLayouts;
+	uint32 _textLayoutTime;
+	/** Font manager generation the cached text layouts were made with. */
+	uint32 _textLayoutFontGeneration;
+
 	Common::Archive *_dataBundle;
 };
 
@@ -21,6 +21,7 @@
  */
 
 #include "graphics/managed_surface.h"
+#include "graphics/blend_intern.h"
 #include "common/algorithm.h"
 #include "common/textconsole.h"
 
@@ -512,6 +513,24 @@ void transBlitPixel<byte, byte>(byte srcVal, byte &destVal, const Graphics::Pixe
 		destVal = lookup[destVal];
 }
 
+/**
+ * Copy the non transparent pixels of a row with the SIMD kernels, when the
+ * source and destination pixels are of the same size. Returns the number of
+ * pixels copied, the caller has to take care of the rest.
+ */
+template<typename TSRC, typename TDEST>
+uint32 transCopyRow(const BlendKernels *kernels, TDEST *dst, const TSRC *src, uint32 width, TSRC transColor, uint32 compareMask) {
+	return 0;
+}
+
+uint32 transCopyRow(const BlendKernels *kernels, uint16 *dst, const uint16 *src, uint32 width, uint16 transColor, uint32 compareMask) {
+	return kernels->transCopy16(dst, src, width, transColor, compareMask);
+}
+
+uint32 transCopyRow(const BlendKernels *kernels, uint32 *dst, const uint32 *src, uint32 width, uint32 transColor, uint32 compareMask) {
+	return kernels->transCopy32(dst, src, width, transColor, compareMask);
+}
+
 template<typename TSRC, typename TDEST>
 void transBlit(const Surface &src, const Common::Rect &srcRect, Surface &dest, const Common::Rect &destRect,
 		TSRC transColor, bool flipped, uint overrideColor, uint srcAlpha, const uint32 *srcPalette,
@@ -531,6 +550,21 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, Surface &dest, c
 		src.format.colorToRGB(transColor, rt1, gt1, bt1);
 	}
 
+	// Unscaled copies between surfaces of the same format boil down to
+	// comparing each pixel against the transparent color, which the SIMD
+	// kernels do for a whole row at once. In 32bpp, only RGB is compared.
+	const BlendKernels *kernels = nullptr;
+	uint32 compareMask = 0xFFFFFFFF;
+	if (sizeof(TSRC) == sizeof(TDEST) && sizeof(TSRC) > 1 && src.format == dest.format &&
+			scaleX == SCALE_THRESHOLD && scaleY == SCALE_THRESHOLD && !flipped && !mask && !maskOnly &&
+			!overrideColor && srcAlpha == 0xff) {
+		kernels = getBlendKernels();
+		if (isTrans32)
+			compareMask = src.format.ARGBToColor(0, 255, 255, 255);
+	}
+	const int fastLeft = MAX<int>(destRect.left, 0);
+	const int fastRight = MIN<int>(destRect.right, dest.w);
+
 	// Loop through drawing output lines
 	for (int destY = destRect.top, scaleYCtr = 0; destY < destRect.bottom; ++destY, scaleYCtr += scaleY) {
 		if (destY < 0 || destY >= dest.h)
@@ -543,8 +577,14 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, Surface &dest, c
 
 		TDEST *destLine = (TDEST *)dest.getBasePtr(destRect.left, destY);
 
+		int destX = destRect.left;
+		if (kernels && fastLeft < fastRight) {
+			const int offset = fastLeft - destRect.left;
+			destX = fastLeft + transCopyRow(kernels, destLine + offset, srcLine + offset, fastRight - fastLeft, transColor, compareMask);
+		}
+
 		// Loop through drawing the pixels of the row
-		for (int destX = destRect.left, xCtr = 0, scaleXCtr = 0; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
+		for (int xCtr = destX - destRect.left, scaleXCtr = xCtr * scaleX; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
 			if (destX < 0 || destX >= dest.w)
 				continue;
 
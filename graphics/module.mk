@@ -2,7 +2,9 @@ MODULE := graphics
 
 MODULE_OBJS := \
 	conversion.o \
+	cursor_cache.o \
 	cursorman.o \
+	dirty_region.o \
 	font.o \
 	fontman.o \
 	fonts/bdf.o \
@@ -54,6 +56,38 @@ MODULE_OBJS := \
 	opengl/control_shaders.o \
 	opengl/compat_shaders.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	blend_sse2.o \
+	conversion_sse2.o \
+	span_sse2.o \
+	yuv_to_rgb_sse2.o
+$(MODULE)/blend_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/conversion_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/span_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/yuv_to_rgb_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	blend_avx2.o \
+	conversion_avx2.o \
+	span_avx2.o \
+	yuv_to_rgb_avx2.o
+$(MODULE)/blend_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/conversion_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/span_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/yuv_to_rgb_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	blend_neon.o \
+	conversion_neon.o \
+	span_neon.o \
+	yuv_to_rgb_neon.o
+endif
+
 ifdef USE_TINYGL
 MODULE_OBJS += \
 	tinygl/api.o \
@@ -79,6 +113,20 @@ MODULE_OBJS += \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zmath_sse2.o \
+	tinygl/zspan_sse2.o
+$(MODULE)/tinygl/zmath_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/tinygl/zspan_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zmath_neon.o \
+	tinygl/zspan_neon.o
+endif
 endif
 
 ifdef USE_SCALERS
@@ -102,10 +150,15 @@ MODULE_OBJS += \
 	scaler/hq2x.o \
 	scaler/hq3x.o
 
-ifdef USE_NASM
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/hq_sse2.o
+$(MODULE)/scaler/hq_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	scaler/hq2x_i386.o \
-	scaler/hq3x_i386.o
+	scaler/hq_neon.o
 endif
 
 endif
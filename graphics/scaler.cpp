@@ -21,6 +21,7 @@
  */
 
 #include "graphics/scaler/intern.h"
+#include "graphics/scaler/hq_intern.h"
 #include "graphics/scaler/scalebit.h"
 #include "common/util.h"
 #include "common/system.h"
@@ -32,31 +33,6 @@ int gBitFormat = 565;
 // RGB-to-YUV lookup table
 extern "C" {
 
-#ifdef USE_NASM
-// NOTE: if your compiler uses different mangled names, add another
-//       condition here
-
-#if !defined(_WIN32) && !defined(MACOSX) && !defined(__OS2__)
-#define RGBtoYUV _RGBtoYUV
-#define hqx_highbits _hqx_highbits
-#define hqx_lowbits _hqx_lowbits
-#define hqx_low2bits _hqx_low2bits
-#define hqx_low3bits _hqx_low3bits
-#define hqx_greenMask _hqx_greenMask
-#define hqx_redBlueMask _hqx_redBlueMask
-#define hqx_green_redBlue_Mask _hqx_green_redBlue_Mask
-#endif
-
-uint32 hqx_highbits = 0xF7DEF7DE;
-uint32 hqx_lowbits = 0x0821;
-uint32 hqx_low2bits = 0x0C63;
-uint32 hqx_low3bits = 0x1CE7;
-uint32 hqx_greenMask = 0;
-uint32 hqx_redBlueMask = 0;
-uint32 hqx_green_redBlue_Mask = 0;
-
-#endif
-
 /**
  * 16bit RGB to YUV conversion table. This table is setup by InitLUT().
  * Used by the hq scaler family.
@@ -81,6 +57,9 @@ uint32 hqx_green_redBlue_Mask = 0;
 uint32 *RGBtoYUV = 0;
 }
 
+/** SIMD version of computeHQPatterns() for the format of RGBtoYUV, if any. */
+static HQPatternProc *s_hqPatternProc = 0;
+
 void InitLUT(Graphics::PixelFormat format) {
 	uint8 r, g, b;
 	int Y, u, v;
@@ -102,20 +81,27 @@ void InitLUT(Graphics::PixelFormat format) {
 		RGBtoYUV[color] = (Y << 16) | (u << 8) | v;
 	}
 
-#ifdef USE_NASM
-	hqx_lowbits  = (1 << format.rShift) | (1 << format.gShift) | (1 << format.bShift),
-	hqx_low2bits = (3 << format.rShift) | (3 << format.gShift) | (3 << format.bShift),
-	hqx_low3bits = (7 << format.rShift) | (7 << format.gShift) | (7 << format.bShift),
-
-	hqx_highbits = format.RGBToColor(255, 255, 255) ^ hqx_lowbits;
-
-	// FIXME: The following code only does the right thing
-	// if the color order is RGB or BGR, i.e., green is in the middle.
-	hqx_greenMask   = format.RGBToColor(  0, 255,   0);
-	hqx_redBlueMask = format.RGBToColor(255,   0, 255);
-
-	hqx_green_redBlue_Mask = (hqx_greenMask << 16) | hqx_redBlueMask;
+	s_hqPatternProc = 0;
+#ifdef SCUMMVM_SSE2
+	if (g_system && g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		if (format == Graphics::createPixelFormat<565>())
+			s_hqPatternProc = computeHQPatterns565SSE2;
+		else if (format == Graphics::createPixelFormat<555>())
+			s_hqPatternProc = computeHQPatterns555SSE2;
+	}
 #endif
+#ifdef SCUMMVM_NEON
+	if (g_system && g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		if (format == Graphics::createPixelFormat<565>())
+			s_hqPatternProc = computeHQPatterns565NEON;
+		else if (format == Graphics::createPixelFormat<555>())
+			s_hqPatternProc = computeHQPatterns555NEON;
+	}
+#endif
+}
+
+HQPatternProc *getHQPatternProc() {
+	return s_hqPatternProc;
 }
 #endif
 
@@ -21,25 +21,8 @@
  */
 
 #include "graphics/scaler/intern.h"
-
-#ifdef USE_NASM
-// Assembly version of HQ2x
-
-extern "C" {
-
-#if !defined(_WIN32) && !defined(MACOSX) && !defined(__OS2__)
-#define hq2x_16 _hq2x_16
-#endif
-
-void hq2x_16(const byte *, byte *, uint32, uint32, uint32, uint32);
-
-}
-
-void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	hq2x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch);
-}
-
-#else
+#include "graphics/scaler/hq_intern.h"
+#include "common/util.h"
 
 #define PIXEL00_0	*(q) = w5;
 #define PIXEL00_10	*(q) = interpolate16_3_1<ColorMask >(w5, w1);
@@ -104,6 +87,8 @@ extern "C" uint32   *RGBtoYUV;
 template<typename ColorMask>
 static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
+	HQPatternProc *patternProc = getHQPatternProc();
+	uint8 patterns[kHQPatternChunk];
 
 	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
 	const uint16 *p = (const uint16 *)srcPtr;
@@ -131,24 +116,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
-		int tmpWidth = width;
-		while (tmpWidth--) {
+		int patternsEnd = 0;
+		for (int x = 0; x < width; x++) {
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			if (patternProc && x % kHQPatternChunk == 0)
+				patternsEnd = x + patternProc(p - 1, nextlineSrc, MIN<int>(width - x, kHQPatternChunk), patterns);
+			const int pattern = x < patternsEnd ? patterns[x % kHQPatternChunk] : computeHQPattern(w1, w2, w3, w4, w5, w6, w7, w8, w9);
 
 			switch (pattern) {
 			case 0:
@@ -1966,5 +1944,3 @@ void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
-
-#endif // Assembly version
@@ -0,0 +1,79 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQ_INTERN_H
+#define GRAPHICS_SCALER_HQ_INTERN_H
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/intern.h"
+
+extern "C" uint32 *RGBtoYUV;
+
+enum {
+	/** Number of pixels the hq scalers compute the patterns for at once. */
+	kHQPatternChunk = 256
+};
+
+/**
+ * Compute the pattern the hq scalers pick their interpolation by. Bit n is
+ * set if the n-th of the eight neighbors (in reading order) of @p w5 differs
+ * noticeably from it in YUV space.
+ */
+static inline int computeHQPattern(int w1, int w2, int w3, int w4, int w5, int w6, int w7, int w8, int w9) {
+	int pattern = 0;
+	const int yuv5 = RGBtoYUV[w5];
+	if (w5 != w1 && diffYUV(yuv5, RGBtoYUV[w1])) pattern |= 0x0001;
+	if (w5 != w2 && diffYUV(yuv5, RGBtoYUV[w2])) pattern |= 0x0002;
+	if (w5 != w3 && diffYUV(yuv5, RGBtoYUV[w3])) pattern |= 0x0004;
+	if (w5 != w4 && diffYUV(yuv5, RGBtoYUV[w4])) pattern |= 0x0008;
+	if (w5 != w6 && diffYUV(yuv5, RGBtoYUV[w6])) pattern |= 0x0010;
+	if (w5 != w7 && diffYUV(yuv5, RGBtoYUV[w7])) pattern |= 0x0020;
+	if (w5 != w8 && diffYUV(yuv5, RGBtoYUV[w8])) pattern |= 0x0040;
+	if (w5 != w9 && diffYUV(yuv5, RGBtoYUV[w9])) pattern |= 0x0080;
+	return pattern;
+}
+
+/**
+ * SIMD version of computeHQPattern(), for @p width pixels of the row at
+ * @p p at once. It may leave some pixels at the end of the row, and returns
+ * the number of patterns it stored.
+ */
+typedef int HQPatternProc(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns);
+
+/**
+ * Return the SIMD version of computeHQPattern() for the current CPU and
+ * the format RGBtoYUV was set up for, or 0 if there is none.
+ */
+HQPatternProc *getHQPatternProc();
+
+#ifdef SCUMMVM_SSE2
+HQPatternProc computeHQPatterns565SSE2;
+HQPatternProc computeHQPatterns555SSE2;
+#endif
+
+#ifdef SCUMMVM_NEON
+HQPatternProc computeHQPatterns565NEON;
+HQPatternProc computeHQPatterns555NEON;
+#endif
+
+#endif
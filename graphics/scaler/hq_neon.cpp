@@ -0,0 +1,109 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/hq_intern.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+struct YUV {
+	int16x8_t y, u, v;
+};
+
+inline uint16x8_t expand5(uint16x8_t c) {
+	return vorrq_u16(vshlq_n_u16(c, 3), vshrq_n_u16(c, 2));
+}
+
+/**
+ * Convert eight pixels to YUV like InitLUT() does. The constant offsets of
+ * U and V are left out, as only differences are compared.
+ */
+template<bool is565>
+inline YUV toYUV(uint16x8_t c) {
+	const uint16x8_t mask5 = vdupq_n_u16(31);
+	uint16x8_t r, g;
+	const uint16x8_t b = expand5(vandq_u16(c, mask5));
+
+	if (is565) {
+		r = expand5(vshrq_n_u16(c, 11));
+		g = vandq_u16(vshrq_n_u16(c, 5), vdupq_n_u16(63));
+		g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+	} else {
+		r = expand5(vandq_u16(vshrq_n_u16(c, 10), mask5));
+		g = expand5(vandq_u16(vshrq_n_u16(c, 5), mask5));
+	}
+
+	const int16x8_t rs = vreinterpretq_s16_u16(r);
+	const int16x8_t gs = vreinterpretq_s16_u16(g);
+	const int16x8_t bs = vreinterpretq_s16_u16(b);
+
+	YUV yuv;
+	yuv.y = vshrq_n_s16(vaddq_s16(vaddq_s16(rs, gs), bs), 2);
+	yuv.u = vshrq_n_s16(vsubq_s16(rs, bs), 2);
+	yuv.v = vshrq_n_s16(vsubq_s16(vsubq_s16(vaddq_s16(gs, gs), rs), bs), 3);
+	return yuv;
+}
+
+/** The vector version of diffYUV(). */
+inline uint16x8_t diffYUV(const YUV &a, const YUV &b) {
+	const uint16x8_t y = vcgtq_s16(vabdq_s16(a.y, b.y), vdupq_n_s16(0x30));
+	const uint16x8_t u = vcgtq_s16(vabdq_s16(a.u, b.u), vdupq_n_s16(0x07));
+	const uint16x8_t v = vcgtq_s16(vabdq_s16(a.v, b.v), vdupq_n_s16(0x06));
+	return vorrq_u16(vorrq_u16(y, u), v);
+}
+
+template<bool is565>
+int computeHQPatterns(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	const int nextline = nextlineSrc;
+	const int neighbors[8] = {
+		-1 - nextline, -nextline, 1 - nextline,
+		-1,                       1,
+		-1 + nextline,  nextline, 1 + nextline
+	};
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8) {
+		const uint16 *c = p + x;
+		const YUV yuv5 = toYUV<is565>(vld1q_u16(c));
+		uint16x8_t pattern = vdupq_n_u16(0);
+
+		for (int i = 0; i < 8; i++) {
+			const YUV yuv = toYUV<is565>(vld1q_u16(c + neighbors[i]));
+			pattern = vorrq_u16(pattern, vandq_u16(diffYUV(yuv5, yuv), vdupq_n_u16(1 << i)));
+		}
+
+		vst1_u8(patterns + x, vmovn_u16(pattern));
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+int computeHQPatterns565NEON(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	return computeHQPatterns<true>(p, nextlineSrc, width, patterns);
+}
+
+int computeHQPatterns555NEON(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	return computeHQPatterns<false>(p, nextlineSrc, width, patterns);
+}
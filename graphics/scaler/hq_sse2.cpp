@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/hq_intern.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+struct YUV {
+	__m128i y, u, v;
+};
+
+inline __m128i expand5(__m128i c) {
+	return _mm_or_si128(_mm_slli_epi16(c, 3), _mm_srli_epi16(c, 2));
+}
+
+/**
+ * Convert eight pixels to YUV like InitLUT() does. The constant offsets of
+ * U and V are left out, as only differences are compared.
+ */
+template<bool is565>
+inline YUV toYUV(__m128i c) {
+	const __m128i mask5 = _mm_set1_epi16(31);
+	__m128i r, g;
+	const __m128i b = expand5(_mm_and_si128(c, mask5));
+
+	if (is565) {
+		r = expand5(_mm_srli_epi16(c, 11));
+		g = _mm_and_si128(_mm_srli_epi16(c, 5), _mm_set1_epi16(63));
+		g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+	} else {
+		r = expand5(_mm_and_si128(_mm_srli_epi16(c, 10), mask5));
+		g = expand5(_mm_and_si128(_mm_srli_epi16(c, 5), mask5));
+	}
+
+	YUV yuv;
+	yuv.y = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(r, g), b), 2);
+	yuv.u = _mm_srai_epi16(_mm_sub_epi16(r, b), 2);
+	yuv.v = _mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(_mm_add_epi16(g, g), r), b), 3);
+	return yuv;
+}
+
+inline __m128i absDiff(__m128i a, __m128i b) {
+	const __m128i diff = _mm_sub_epi16(a, b);
+	return _mm_max_epi16(diff, _mm_sub_epi16(_mm_setzero_si128(), diff));
+}
+
+/** The vector version of diffYUV(). */
+inline __m128i diffYUV(const YUV &a, const YUV &b) {
+	const __m128i y = _mm_cmpgt_epi16(absDiff(a.y, b.y), _mm_set1_epi16(0x30));
+	const __m128i u = _mm_cmpgt_epi16(absDiff(a.u, b.u), _mm_set1_epi16(0x07));
+	const __m128i v = _mm_cmpgt_epi16(absDiff(a.v, b.v), _mm_set1_epi16(0x06));
+	return _mm_or_si128(_mm_or_si128(y, u), v);
+}
+
+template<bool is565>
+int computeHQPatterns(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	const int nextline = nextlineSrc;
+	const int neighbors[8] = {
+		-1 - nextline, -nextline, 1 - nextline,
+		-1,                       1,
+		-1 + nextline,  nextline, 1 + nextline
+	};
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8) {
+		const uint16 *c = p + x;
+		const YUV yuv5 = toYUV<is565>(_mm_loadu_si128((const __m128i *)c));
+		__m128i pattern = _mm_setzero_si128();
+
+		for (int i = 0; i < 8; i++) {
+			const YUV yuv = toYUV<is565>(_mm_loadu_si128((const __m128i *)(c + neighbors[i])));
+			pattern = _mm_or_si128(pattern, _mm_and_si128(diffYUV(yuv5, yuv), _mm_set1_epi16(1 << i)));
+		}
+
+		_mm_storel_epi64((__m128i *)(patterns + x), _mm_packus_epi16(pattern, pattern));
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+int computeHQPatterns565SSE2(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	return computeHQPatterns<true>(p, nextlineSrc, width, patterns);
+}
+
+int computeHQPatterns555SSE2(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	return computeHQPatterns<false>(p, nextlineSrc, width, patterns);
+}
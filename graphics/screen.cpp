@@ -27,6 +27,11 @@
 
 namespace Graphics {
 
+enum {
+	/** Upper limit of rects passed to the backend per update. */
+	kMaxDirtyRects = 64
+};
+
 Screen::Screen(): ManagedSurface() {
 	create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 }
@@ -67,8 +72,13 @@ void Screen::addDirtyRect(const Common::Rect &r) {
 	bounds.clip(getBounds());
 	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
 
-	if (bounds.width() > 0 && bounds.height() > 0)
-		_dirtyRects.push_back(bounds);
+	if (bounds.width() > 0 && bounds.height() > 0) {
+		// The region has to cover the owner, in case this is a sub-surface
+		const Common::Point offset = getOffsetFromOwner();
+		_dirtyRegion.setSize(MAX<int>(_dirtyRegion.getWidth(), offset.x + this->w),
+		                     MAX<int>(_dirtyRegion.getHeight(), offset.y + this->h));
+		_dirtyRegion.addRect(bounds);
+	}
 }
 
 void Screen::makeAllDirty() {
@@ -76,25 +86,21 @@ void Screen::makeAllDirty() {
 }
 
 void Screen::mergeDirtyRects() {
-	Common::List<Common::Rect>::iterator rOuter, rInner;
-
-	// Process the dirty rect list to find any rects to merge
-	for (rOuter = _dirtyRects.begin(); rOuter != _dirtyRects.end(); ++rOuter) {
-		rInner = rOuter;
-		while (++rInner != _dirtyRects.end()) {
-
-			if ((*rOuter).intersects(*rInner)) {
-				// These two rectangles overlap, so merge them
-				unionRectangle(*rOuter, *rOuter, *rInner);
+	// Rects added to the list directly, or left over from a previous merge
+	Common::List<Common::Rect>::iterator i;
+	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
+		_dirtyRegion.setSize(MAX<int>(_dirtyRegion.getWidth(), i->right),
+		                     MAX<int>(_dirtyRegion.getHeight(), i->bottom));
+		_dirtyRegion.addRect(*i);
+	}
+	_dirtyRects.clear();
 
-				// remove the inner rect from the list
-				_dirtyRects.erase(rInner);
+	Common::Array<Common::Rect> rects;
+	_dirtyRegion.getRects(rects, kMaxDirtyRects);
+	_dirtyRegion.clear();
 
-				// move back to beginning of list
-				rInner = rOuter;
-			}
-		}
-	}
+	for (uint j = 0; j < rects.size(); j++)
+		_dirtyRects.push_back(rects[j]);
 }
 
 bool Screen::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
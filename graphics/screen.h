@@ -23,6 +23,7 @@
 #ifndef GRAPHICS_SCREEN_H
 #define GRAPHICS_SCREEN_H
 
+#include "graphics/dirty_region.h"
 #include "graphics/managed_surface.h"
 #include "graphics/pixelformat.h"
 #include "common/list.h"
@@ -51,12 +52,19 @@ namespace Graphics {
 class Screen : public ManagedSurface {
 protected:
 	/**
-	 * List of affected areas of the screen
+	 * List of affected areas of the screen. It is filled from the dirty
+	 * region by mergeDirtyRects()
 	 */
 	Common::List<Common::Rect> _dirtyRects;
+
+	/**
+	 * Affected areas of the screen added since the last merge
+	 */
+	DirtyRegion _dirtyRegion;
 protected:
 	/**
-	 * Merges together overlapping dirty areas of the screen
+	 * Merges the affected areas of the screen, including any rects added
+	 * to _dirtyRects directly, into a small list of non-overlapping rects
 	 */
 	void mergeDirtyRects();
 
@@ -78,7 +86,7 @@ public:
 	/**
 	 * Returns true if there are any pending screen updates (dirty areas)
 	 */
-	bool isDirty() const { return !_dirtyRects.empty(); }
+	bool isDirty() const { return !_dirtyRects.empty() || !_dirtyRegion.isEmpty(); }
 
 	/**
 	 * Marks the whole screen as dirty. This forces the next call to update
@@ -89,7 +97,7 @@ public:
 	/**
 	 * Clear the current dirty rects list
 	 */
-	virtual void clearDirtyRects() { _dirtyRects.clear(); }
+	virtual void clearDirtyRects() { _dirtyRects.clear(); _dirtyRegion.clear(); }
 
 	/**
 	 * Updates the screen by copying any affected areas to the system
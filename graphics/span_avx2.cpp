@@ -0,0 +1,109 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/span_intern.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+uint32 fill16(uint16 *dst, uint32 width, uint16 even, uint16 odd) {
+	const __m256i pattern = _mm256_set1_epi32(even | (odd << 16));
+	uint32 j = 0;
+
+	for (; j + 16 <= width; j += 16)
+		_mm256_storeu_si256((__m256i *)(dst + j), pattern);
+
+	return j;
+}
+
+uint32 fill32(uint32 *dst, uint32 width, uint32 even, uint32 odd) {
+	const __m256i pattern = _mm256_set_epi32(odd, even, odd, even, odd, even, odd, even);
+	uint32 j = 0;
+
+	for (; j + 8 <= width; j += 8)
+		_mm256_storeu_si256((__m256i *)(dst + j), pattern);
+
+	return j;
+}
+
+uint32 blend16(uint16 *dst, uint32 width, const SpanBlend &blend) {
+	const __m256i invAlpha = _mm256_set1_epi16(blend.invAlpha);
+	__m128i shift[4];
+	__m256i max[4], source[4];
+	for (int c = 0; c < 4; c++) {
+		shift[c] = _mm_cvtsi32_si128(blend.shift[c]);
+		max[c] = _mm256_set1_epi16(blend.max[c]);
+		source[c] = _mm256_set1_epi16(blend.source[c]);
+	}
+
+	uint32 j = 0;
+	for (; j + 16 <= width; j += 16) {
+		const __m256i pixels = _mm256_loadu_si256((const __m256i *)(dst + j));
+		__m256i result = _mm256_setzero_si256();
+
+		for (int c = 0; c < 4; c++) {
+			const __m256i channel = _mm256_and_si256(_mm256_srl_epi16(pixels, shift[c]), max[c]);
+			const __m256i blended = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(channel, invAlpha), source[c]), 8);
+			result = _mm256_or_si256(result, _mm256_sll_epi16(blended, shift[c]));
+		}
+
+		_mm256_storeu_si256((__m256i *)(dst + j), result);
+	}
+
+	return j;
+}
+
+uint32 blend32(uint32 *dst, uint32 width, const SpanBlend &blend) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i invAlpha = _mm256_set1_epi16(blend.invAlpha);
+	const __m256i alpha = _mm256_set1_epi16(256 - blend.invAlpha);
+	const __m256i source = _mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32(blend.color), zero), alpha);
+	const __m256i mask = _mm256_set1_epi32(blend.mask);
+
+	// Unpacking and packing work within each 128-bit lane, so the pixels
+	// stay in order
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8) {
+		const __m256i pixels = _mm256_loadu_si256((const __m256i *)(dst + j));
+		__m256i lo = _mm256_unpacklo_epi8(pixels, zero);
+		__m256i hi = _mm256_unpackhi_epi8(pixels, zero);
+		lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(lo, invAlpha), source), 8);
+		hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(hi, invAlpha), source), 8);
+		_mm256_storeu_si256((__m256i *)(dst + j), _mm256_and_si256(_mm256_packus_epi16(lo, hi), mask));
+	}
+
+	return j;
+}
+
+} // End of anonymous namespace
+
+const SpanKernels spanKernelsAVX2 = {
+	fill16,
+	fill32,
+	blend16,
+	blend32
+};
+
+} // End of namespace Graphics
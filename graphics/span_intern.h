@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SPAN_INTERN_H
+#define GRAPHICS_SPAN_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * Parameters for blending a color onto a span of pixels, as done by
+ * VectorRendererSpec::blendPixelPtr(). Each channel c of the pixel is
+ * replaced by (c * invAlpha + source) >> 8.
+ */
+struct SpanBlend {
+	/** 256 minus the alpha value of the color. */
+	uint16 invAlpha;
+
+	/**
+	 * Channels of 16-bit pixels: the shift, the maximum value and the value of
+	 * the color multiplied with its alpha value. Missing channels have a
+	 * maximum value of 0.
+	 */
+	uint16 shift[4];
+	uint16 max[4];
+	uint16 source[4];
+
+	/**
+	 * 32-bit pixels must have all their channels in whole bytes. This is the
+	 * color, with the alpha channel set to the maximum, and the mask of the
+	 * bytes to keep.
+	 */
+	uint32 color;
+	uint32 mask;
+};
+
+/**
+ * SIMD versions of the span functions of VectorRendererSpec.
+ *
+ * Each function handles a single span and produces the same result as the
+ * scalar code. They may leave some pixels at the end of the span, and return
+ * the number of pixels they handled, which is always even.
+ */
+struct SpanKernels {
+	/** Fill the span with @p even and @p odd alternately, starting with @p even. */
+	uint32 (*fill16)(uint16 *dst, uint32 width, uint16 even, uint16 odd);
+	uint32 (*fill32)(uint32 *dst, uint32 width, uint32 even, uint32 odd);
+
+	/** Blend a color onto the span. */
+	uint32 (*blend16)(uint16 *dst, uint32 width, const SpanBlend &blend);
+	uint32 (*blend32)(uint32 *dst, uint32 width, const SpanBlend &blend);
+};
+
+/** Return the kernels for the CPU we are running on, or 0 if there are none. */
+const SpanKernels *getSpanKernels();
+
+#ifdef SCUMMVM_SSE2
+extern const SpanKernels spanKernelsSSE2;
+#endif
+
+#ifdef SCUMMVM_AVX2
+extern const SpanKernels spanKernelsAVX2;
+#endif
+
+#ifdef SCUMMVM_NEON
+extern const SpanKernels spanKernelsNEON;
+#endif
+
+} // End of namespace Graphics
+
+#endif
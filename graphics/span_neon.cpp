@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/span_intern.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+uint32 fill16(uint16 *dst, uint32 width, uint16 even, uint16 odd) {
+	const uint16 colors[8] = { even, odd, even, odd, even, odd, even, odd };
+	const uint16x8_t pattern = vld1q_u16(colors);
+	uint32 j = 0;
+
+	for (; j + 8 <= width; j += 8)
+		vst1q_u16(dst + j, pattern);
+
+	return j;
+}
+
+uint32 fill32(uint32 *dst, uint32 width, uint32 even, uint32 odd) {
+	const uint32 colors[4] = { even, odd, even, odd };
+	const uint32x4_t pattern = vld1q_u32(colors);
+	uint32 j = 0;
+
+	for (; j + 4 <= width; j += 4)
+		vst1q_u32(dst + j, pattern);
+
+	return j;
+}
+
+uint32 blend16(uint16 *dst, uint32 width, const SpanBlend &blend) {
+	const uint16x8_t invAlpha = vdupq_n_u16(blend.invAlpha);
+	int16x8_t shiftLeft[4], shiftRight[4];
+	uint16x8_t max[4], source[4];
+	for (int c = 0; c < 4; c++) {
+		shiftLeft[c] = vdupq_n_s16(blend.shift[c]);
+		shiftRight[c] = vdupq_n_s16(-(int16)blend.shift[c]);
+		max[c] = vdupq_n_u16(blend.max[c]);
+		source[c] = vdupq_n_u16(blend.source[c]);
+	}
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8) {
+		const uint16x8_t pixels = vld1q_u16(dst + j);
+		uint16x8_t result = vdupq_n_u16(0);
+
+		for (int c = 0; c < 4; c++) {
+			const uint16x8_t channel = vandq_u16(vshlq_u16(pixels, shiftRight[c]), max[c]);
+			const uint16x8_t blended = vshrq_n_u16(vmlaq_u16(source[c], channel, invAlpha), 8);
+			result = vorrq_u16(result, vshlq_u16(blended, shiftLeft[c]));
+		}
+
+		vst1q_u16(dst + j, result);
+	}
+
+	return j;
+}
+
+uint32 blend32(uint32 *dst, uint32 width, const SpanBlend &blend) {
+	const uint16x8_t invAlpha = vdupq_n_u16(blend.invAlpha);
+	const uint16x8_t source = vmulq_n_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(blend.color))), 256 - blend.invAlpha);
+	const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(blend.mask));
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4) {
+		const uint8x16_t pixels = vreinterpretq_u8_u32(vld1q_u32(dst + j));
+		const uint8x8_t lo = vshrn_n_u16(vmlaq_u16(source, vmovl_u8(vget_low_u8(pixels)), invAlpha), 8);
+		const uint8x8_t hi = vshrn_n_u16(vmlaq_u16(source, vmovl_u8(vget_high_u8(pixels)), invAlpha), 8);
+		vst1q_u32(dst + j, vreinterpretq_u32_u8(vandq_u8(vcombine_u8(lo, hi), mask)));
+	}
+
+	return j;
+}
+
+} // End of anonymous namespace
+
+const SpanKernels spanKernelsNEON = {
+	fill16,
+	fill32,
+	blend16,
+	blend32
+};
+
+} // End of namespace Graphics
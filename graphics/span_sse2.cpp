@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/span_intern.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+uint32 fill16(uint16 *dst, uint32 width, uint16 even, uint16 odd) {
+	const __m128i pattern = _mm_set1_epi32(even | (odd << 16));
+	uint32 j = 0;
+
+	for (; j + 8 <= width; j += 8)
+		_mm_storeu_si128((__m128i *)(dst + j), pattern);
+
+	return j;
+}
+
+uint32 fill32(uint32 *dst, uint32 width, uint32 even, uint32 odd) {
+	const __m128i pattern = _mm_set_epi32(odd, even, odd, even);
+	uint32 j = 0;
+
+	for (; j + 4 <= width; j += 4)
+		_mm_storeu_si128((__m128i *)(dst + j), pattern);
+
+	return j;
+}
+
+uint32 blend16(uint16 *dst, uint32 width, const SpanBlend &blend) {
+	const __m128i invAlpha = _mm_set1_epi16(blend.invAlpha);
+	__m128i shift[4], max[4], source[4];
+	for (int c = 0; c < 4; c++) {
+		shift[c] = _mm_cvtsi32_si128(blend.shift[c]);
+		max[c] = _mm_set1_epi16(blend.max[c]);
+		source[c] = _mm_set1_epi16(blend.source[c]);
+	}
+
+	uint32 j = 0;
+	for (; j + 8 <= width; j += 8) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(dst + j));
+		__m128i result = _mm_setzero_si128();
+
+		for (int c = 0; c < 4; c++) {
+			const __m128i channel = _mm_and_si128(_mm_srl_epi16(pixels, shift[c]), max[c]);
+			const __m128i blended = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(channel, invAlpha), source[c]), 8);
+			result = _mm_or_si128(result, _mm_sll_epi16(blended, shift[c]));
+		}
+
+		_mm_storeu_si128((__m128i *)(dst + j), result);
+	}
+
+	return j;
+}
+
+uint32 blend32(uint32 *dst, uint32 width, const SpanBlend &blend) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i invAlpha = _mm_set1_epi16(blend.invAlpha);
+	const __m128i alpha = _mm_set1_epi16(256 - blend.invAlpha);
+	const __m128i source = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(blend.color), zero), alpha);
+	const __m128i mask = _mm_set1_epi32(blend.mask);
+
+	uint32 j = 0;
+	for (; j + 4 <= width; j += 4) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(dst + j));
+		__m128i lo = _mm_unpacklo_epi8(pixels, zero);
+		__m128i hi = _mm_unpackhi_epi8(pixels, zero);
+		lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, invAlpha), source), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, invAlpha), source), 8);
+		_mm_storeu_si128((__m128i *)(dst + j), _mm_and_si128(_mm_packus_epi16(lo, hi), mask));
+	}
+
+	return j;
+}
+
+} // End of anonymous namespace
+
+const SpanKernels spanKernelsSSE2 = {
+	fill16,
+	fill32,
+	blend16,
+	blend32
+};
+
+} // End of namespace Graphics
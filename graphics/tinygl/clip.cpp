@@ -379,6 +379,34 @@ void gl_draw_triangle_select(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex
 int count_triangles, count_triangles_textured, count_pixels;
 #endif
 
+// Pick the mipmap level whose texels are closest in size to the pixels the
+// triangle covers. The level is the same for the whole triangle. Levels are
+// only picked from mipmaps generated by TinyGL.
+static const Graphics::TexelBuffer *gl_select_texture_level(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2) {
+	const GLImage *images = c->current_texture->images;
+	if (!c->current_texture->mipmapsGenerated || !images[0].pixmap)
+		return images[0].pixmap;
+
+	// Both areas are doubled, which cancels out.
+	float screenArea = fabs((float)(p1->zp.x - p0->zp.x) * (p2->zp.y - p0->zp.y) -
+	                        (float)(p2->zp.x - p0->zp.x) * (p1->zp.y - p0->zp.y));
+	float texelArea = fabs((float)(p1->zp.s - p0->zp.s) * (p2->zp.t - p0->zp.t) -
+	                       (float)(p2->zp.s - p0->zp.s) * (p1->zp.t - p0->zp.t));
+	if (screenArea == 0)
+		return images[0].pixmap;
+
+	// Convert the texture coordinates to texels of the first level. Each
+	// following level has a quarter of the texels of the previous one.
+	const float unit = (float)(c->_textureSize << ZB_POINT_ST_FRAC_BITS);
+	float ratio = texelArea / screenArea * images[0].pixmap->getWidth() * images[0].pixmap->getHeight() / (unit * unit);
+	int level = 0;
+	while (ratio > 2.0f && level + 1 < MAX_TEXTURE_LEVELS && images[level + 1].pixmap) {
+		ratio /= 4.0f;
+		level++;
+	}
+	return images[level].pixmap;
+}
+
 void gl_draw_triangle_fill(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2) {
 #ifdef TINYGL_PROFILE
 	{
@@ -411,7 +439,7 @@ void gl_draw_triangle_fill(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p
 #ifdef TINYGL_PROFILE
 		count_triangles_textured++;
 #endif
-		c->fb->setTexture(c->current_texture->images[0].pixmap, c->texture_wrap_s, c->texture_wrap_t);
+		c->fb->setTexture(gl_select_texture_level(c, p0, p1, p2), c->texture_wrap_s, c->texture_wrap_t);
 		if (c->current_shade_model == TGL_SMOOTH) {
 			c->fb->fillTriangleTextureMappingPerspectiveSmooth(&p0->zp, &p1->zp, &p2->zp);
 		} else {
@@ -552,6 +552,7 @@ enum {
 	TGL_TEXTURE_RESIDENT            = 0x8067,
 	TGL_TEXTURE_1D_BINDING          = 0x8068,
 	TGL_TEXTURE_2D_BINDING          = 0x8069,
+	TGL_GENERATE_MIPMAP             = 0x8191,
 
 	// Internal texture formats
 	TGL_ALPHA4                      = 0x803B,
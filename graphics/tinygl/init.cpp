@@ -27,8 +27,10 @@
  */
 
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zmath_intern.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
+#include "common/system.h"
 
 namespace TinyGL {
 
@@ -77,6 +79,7 @@ void glInit(void *zbuffer1, int textureSize) {
 	// allocate GLVertex array
 	c->vertex_max = POLYGON_MAX_VERTEX;
 	c->vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+	c->transform_kernels = getTransformKernels();
 
 	// viewport
 	v = &c->viewport;
@@ -235,6 +238,12 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = true;
 
+	c->_rasterizerThreads = 1;
+#ifdef TINYGL_THREAD_LOCAL
+	if (g_system->hasFeature(OSystem::kFeatureParallelJobs))
+		c->_rasterizerThreads = g_system->getParallelJobThreads();
+#endif
+
 	Graphics::Internal::tglBlitResetScissorRect();
 }
 
@@ -243,6 +252,7 @@ void glClose() {
 
 	tglDisposeDrawCallLists(c);
 	tglDisposeResources(c);
+	tglDisposeWorkerContexts(c);
 
 	specbuf_cleanup(c);
 	for (int i = 0; i < 3; i++)
@@ -36,6 +36,10 @@ void glopMaterial(GLContext *c, GLParam *p) {
 	Vector4 v(p[3].f, p[4].f, p[5].f, p[6].f);
 	GLMaterial *m;
 
+	// the vertices given so far must be lit with the previous material
+	if (c->in_begin && c->lighting_enabled)
+		gl_flush_vertices(c);
+
 	if (mode == TGL_FRONT_AND_BACK) {
 		p[1].i = TGL_FRONT;
 		glopMaterial(c, p);
@@ -319,10 +323,11 @@ void gl_shade_vertex(GLContext *c, GLVertex *v) {
 		B += att * lB;
 	}
 
-	v->color.X = clampf(c->current_color.X * R, 0, 1);
-	v->color.Y = clampf(c->current_color.Y * G, 0, 1);
-	v->color.Z = clampf(c->current_color.Z * B, 0, 1);
-	v->color.W = c->current_color.W * A;
+	// the color is the one which was current when the vertex was specified
+	v->color.X = clampf(v->color.X * R, 0, 1);
+	v->color.Y = clampf(v->color.Y * G, 0, 1);
+	v->color.Z = clampf(v->color.Z * B, 0, 1);
+	v->color.W = v->color.W * A;
 }
 
 } // end of namespace TinyGL
@@ -53,9 +53,23 @@ static int op_table_size[] = {
 #include "graphics/tinygl/opinfo.h"
 };
 
+#ifdef TINYGL_THREAD_LOCAL
+// The context of the worker thread executing draw calls, if any.
+static TINYGL_THREAD_LOCAL GLContext *gl_thread_ctx = nullptr;
+
+GLContext *gl_get_context() {
+	GLContext *c = gl_thread_ctx;
+	return c ? c : gl_ctx;
+}
+
+void gl_set_thread_context(GLContext *c) {
+	gl_thread_ctx = c;
+}
+#else
 GLContext *gl_get_context() {
 	return gl_ctx;
 }
+#endif
 
 static GLList *find_list(GLContext *c, unsigned int list) {
 	return c->shared_state.lists[list];
@@ -38,6 +38,9 @@ public:
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const;
 
+	unsigned int getWidth() const { return _width; }
+	unsigned int getHeight() const { return _height; }
+
 protected:
 	virtual void getARGBAt(
 		unsigned int pixel,
@@ -131,6 +131,7 @@ GLTexture *alloc_texture(GLContext *c, int h) {
 	t->handle = h;
 	t->disposed = false;
 	t->versionNumber = 0;
+	t->mipmapsGenerated = false;
 
 	return t;
 }
@@ -141,6 +142,7 @@ void glInitTextures(GLContext *c) {
 	c->current_texture = find_texture(c, 0);
 	c->texture_mag_filter = TGL_LINEAR;
 	c->texture_min_filter = TGL_NEAREST_MIPMAP_LINEAR;
+	c->texture_generate_mipmap = 0;
 }
 
 void glopBindTexture(GLContext *c, GLParam *p) {
@@ -166,6 +168,71 @@ static inline const Graphics::PixelFormat formatType2PixelFormat(TGLuint format,
 	error("TinyGL texture: format 0x%04x and type 0x%04x combination not supported", format, type);
 }
 
+static Graphics::TexelBuffer *createTexelBuffer(GLContext *c, const Graphics::PixelBuffer &src, int width, int height, unsigned int filter) {
+	switch (filter) {
+	case TGL_LINEAR_MIPMAP_NEAREST:
+	case TGL_LINEAR_MIPMAP_LINEAR:
+	case TGL_LINEAR:
+		return new Graphics::BilinearTexelBuffer(
+			src,
+			width, height,
+			c->_textureSize
+		);
+	default:
+		return new Graphics::NearestTexelBuffer(
+			src,
+			width, height,
+			c->_textureSize
+		);
+	}
+}
+
+// Fill the levels after the first one, each being half the size of the
+// previous one, with the texels averaged by groups of 2x2.
+static void generateMipmaps(GLContext *c, GLTexture *t, const Graphics::PixelBuffer &src, int width, int height, unsigned int filter) {
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+	Graphics::PixelBuffer prev = src;
+	byte *prevPixels = nullptr;
+
+	for (int level = 1; level < MAX_TEXTURE_LEVELS && (width > 1 || height > 1); level++) {
+		const int prevWidth = width, prevHeight = height;
+		width = MAX(width / 2, 1);
+		height = MAX(height / 2, 1);
+
+		byte *pixels = new byte[width * height * format.bytesPerPixel];
+		Graphics::PixelBuffer dst(format, pixels);
+		for (int y = 0; y < height; y++) {
+			const int y0 = MIN(y * 2, prevHeight - 1), y1 = MIN(y * 2 + 1, prevHeight - 1);
+			for (int x = 0; x < width; x++) {
+				const int x0 = MIN(x * 2, prevWidth - 1), x1 = MIN(x * 2 + 1, prevWidth - 1);
+				const int offsets[4] = { x0 + y0 * prevWidth, x1 + y0 * prevWidth, x0 + y1 * prevWidth, x1 + y1 * prevWidth };
+				unsigned int sa = 0, sr = 0, sg = 0, sb = 0;
+				for (int i = 0; i < 4; i++) {
+					uint8 a, r, g, b;
+					prev.getARGBAt(offsets[i], a, r, g, b);
+					sa += a;
+					sr += r;
+					sg += g;
+					sb += b;
+				}
+				dst.setPixelAt(x + y * width, (sa + 2) / 4, (sr + 2) / 4, (sg + 2) / 4, (sb + 2) / 4);
+			}
+		}
+
+		GLImage *im = &t->images[level];
+		im->xsize = c->_textureSize;
+		im->ysize = c->_textureSize;
+		im->pixmap = createTexelBuffer(c, dst, width, height, filter);
+
+		delete[] prevPixels;
+		prevPixels = pixels;
+		prev = dst;
+	}
+	delete[] prevPixels;
+
+	t->mipmapsGenerated = true;
+}
+
 void glopTexImage2D(GLContext *c, GLParam *p) {
 	int target = p[1].i;
 	int level = p[2].i;
@@ -187,6 +254,16 @@ void glopTexImage2D(GLContext *c, GLParam *p) {
 		error("tglTexImage2D: invalid border");
 
 	c->current_texture->versionNumber++;
+	c->current_texture->mipmapsGenerated = false;
+	if (level == 0) {
+		// The other levels belong to the previous image, which may have had
+		// a different size.
+		for (int i = 1; i < MAX_TEXTURE_LEVELS; i++) {
+			im = &c->current_texture->images[i];
+			delete im->pixmap;
+			im->pixmap = nullptr;
+		}
+	}
 	im = &c->current_texture->images[level];
 	im->xsize = c->_textureSize;
 	im->ysize = c->_textureSize;
@@ -201,22 +278,18 @@ void glopTexImage2D(GLContext *c, GLParam *p) {
 			filter = c->texture_mag_filter;
 		else
 			filter = c->texture_min_filter;
-		switch (filter) {
+		im->pixmap = createTexelBuffer(c, src, width, height, filter);
+
+		// Mipmaps are only generated when they are going to be sampled.
+		switch (c->texture_min_filter) {
 		case TGL_LINEAR_MIPMAP_NEAREST:
 		case TGL_LINEAR_MIPMAP_LINEAR:
-		case TGL_LINEAR:
-			im->pixmap = new Graphics::BilinearTexelBuffer(
-				src,
-				width, height,
-				c->_textureSize
-			);
+		case TGL_NEAREST_MIPMAP_NEAREST:
+		case TGL_NEAREST_MIPMAP_LINEAR:
+			if (level == 0 && c->texture_generate_mipmap)
+				generateMipmaps(c, c->current_texture, src, width, height, c->texture_min_filter);
 			break;
 		default:
-			im->pixmap = new Graphics::NearestTexelBuffer(
-				src,
-				width, height,
-				c->_textureSize
-			);
 			break;
 		}
 	}
@@ -282,6 +355,9 @@ error:
 			goto error;
 		}
 		break;
+	case TGL_GENERATE_MIPMAP:
+		c->texture_generate_mipmap = param;
+		break;
 	default:
 		;
 	}
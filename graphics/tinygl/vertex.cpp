@@ -28,6 +28,7 @@
 
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/zdirtyrect.h"
+#include "graphics/tinygl/zmath_intern.h"
 
 namespace TinyGL {
 
@@ -93,6 +94,7 @@ void glopBegin(GLContext *c, GLParam *p) {
 	c->in_begin = 1;
 	c->vertex_n = 0;
 	c->vertex_cnt = 0;
+	c->vertex_processed = 0;
 
 	if (c->matrix_model_projection_updated) {
 		if (c->lighting_enabled) {
@@ -150,42 +152,100 @@ void glopBegin(GLContext *c, GLParam *p) {
 	}
 }
 
-// coords, tranformation, clip code and projection
-// TODO : handle all cases
-static inline void gl_vertex_transform(GLContext *c, GLVertex *v) {
-	Matrix4 *m;
+// transform one of the vectors of a batch of vertices, with the SIMD kernels if there are some
+static inline void gl_transform3x4_array(GLContext *c, const Matrix4 &m, const Vector4 *in, Vector4 *out, int count) {
+	if (c->transform_kernels) {
+		c->transform_kernels->transform3x4(m, in, out, count, sizeof(GLVertex));
+	} else {
+		for (int i = 0; i < count; i++) {
+			m.transform3x4(*in, *out);
+			in = (const Vector4 *)((const byte *)in + sizeof(GLVertex));
+			out = (Vector4 *)((byte *)out + sizeof(GLVertex));
+		}
+	}
+}
+
+static inline void gl_transform_array(GLContext *c, const Matrix4 &m, const Vector4 *in, Vector4 *out, int count) {
+	if (c->transform_kernels) {
+		c->transform_kernels->transform(m, in, out, count, sizeof(GLVertex));
+	} else {
+		for (int i = 0; i < count; i++) {
+			m.transform(*in, *out);
+			in = (const Vector4 *)((const byte *)in + sizeof(GLVertex));
+			out = (Vector4 *)((byte *)out + sizeof(GLVertex));
+		}
+	}
+}
 
+// coords, tranformation and clip code of a batch of vertices
+// TODO : handle all cases
+static void gl_vertex_transform(GLContext *c, GLVertex *vertex, int count) {
 	if (c->lighting_enabled) {
 		// eye coordinates needed for lighting
-
-		m = c->matrix_stack_ptr[0];
-		m->transform3x4(v->coord,v->ec);
+		gl_transform3x4_array(c, *c->matrix_stack_ptr[0], &vertex->coord, &vertex->ec, count);
 
 		// projection coordinates
-		m = c->matrix_stack_ptr[1];
-		m->transform(v->ec, v->pc);
+		gl_transform_array(c, *c->matrix_stack_ptr[1], &vertex->ec, &vertex->pc, count);
 
-		m = &c->matrix_model_view_inv;
+		const Matrix4 &m = c->matrix_model_view_inv;
+		for (int i = 0; i < count; i++) {
+			GLVertex *v = &vertex[i];
+			const Vector3 normal = v->normal;
+			m.transform3x3(normal, v->normal);
 
-		m->transform3x3(c->current_normal, v->normal);
-
-		if (c->normalize_enabled) {
-			v->normal.normalize();
+			if (c->normalize_enabled) {
+				v->normal.normalize();
+			}
 		}
 	} else {
 		// no eye coordinates needed, no normal
 		// NOTE: W = 1 is assumed
-		m = &c->matrix_model_projection;
+		const Matrix4 &m = c->matrix_model_projection;
+		gl_transform3x4_array(c, m, &vertex->coord, &vertex->pc, count);
+
+		for (int i = 0; i < count; i++) {
+			GLVertex *v = &vertex[i];
+			if (c->matrix_model_projection_no_w_transform) {
+				v->pc.W = (m._m[3][3]);
+			}
+			v->normal.X = v->normal.Y = v->normal.Z = 0;
+			v->ec.X = v->ec.Y = v->ec.Z = v->ec.W = 0;
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		GLVertex *v = &vertex[i];
+		v->clip_code = gl_clipcode(v->pc.X, v->pc.Y, v->pc.Z, v->pc.W);
+	}
+}
 
-		m->transform3x4(v->coord, v->pc);
-		if (c->matrix_model_projection_no_w_transform) {
-			v->pc.W = (m->_m[3][3]);
+// color, tex coords and projection of a batch of transformed vertices
+static void gl_vertex_shade(GLContext *c, GLVertex *vertex, int count) {
+	for (int i = 0; i < count; i++) {
+		GLVertex *v = &vertex[i];
+
+		if (c->lighting_enabled) {
+			gl_shade_vertex(c, v);
 		}
-		v->normal.X = v->normal.Y = v->normal.Z = 0;
-		v->ec.X = v->ec.Y = v->ec.Z = v->ec.W = 0;
+
+		if (c->texture_2d_enabled && c->apply_texture_matrix) {
+			const Vector4 tex_coord = v->tex_coord;
+			c->matrix_stack_ptr[2]->transform(tex_coord, v->tex_coord);
+		}
+
+		// precompute the mapping to the viewport
+		if (v->clip_code == 0)
+			gl_transform_to_viewport(c, v);
 	}
+}
+
+void gl_flush_vertices(GLContext *c) {
+	GLVertex *vertex = &c->vertex[c->vertex_processed];
+	int count = c->vertex_n - c->vertex_processed;
 
-	v->clip_code = gl_clipcode(v->pc.X, v->pc.Y, v->pc.Z, v->pc.W);
+	gl_vertex_transform(c, vertex, count);
+	gl_vertex_shade(c, vertex, count);
+	c->vertex_processed = c->vertex_n;
 }
 
 void glopVertex(GLContext *c, GLParam *p) {
@@ -215,33 +275,22 @@ void glopVertex(GLContext *c, GLParam *p) {
 	v = &c->vertex[n];
 	n++;
 
+	// Only the current state is recorded here, the vertices are transformed
+	// and lit together in glopEnd().
 	v->coord.X = p[1].f;
 	v->coord.Y = p[2].f;
 	v->coord.Z = p[3].f;
 	v->coord.W = p[4].f;
 
-	gl_vertex_transform(c, v);
-
-	// color
-
-	if (c->lighting_enabled) {
-		gl_shade_vertex(c, v);
-	} else {
-		v->color = c->current_color;
-	}
+	v->normal.X = c->current_normal.X;
+	v->normal.Y = c->current_normal.Y;
+	v->normal.Z = c->current_normal.Z;
 
-	// tex coords
+	v->color = c->current_color;
 
 	if (c->texture_2d_enabled) {
-		if (c->apply_texture_matrix) {
-			c->matrix_stack_ptr[2]->transform(c->current_tex_coord, v->tex_coord);
-		} else {
-			v->tex_coord = c->current_tex_coord;
-		}
+		v->tex_coord = c->current_tex_coord;
 	}
-	// precompute the mapping to the viewport
-	if (v->clip_code == 0)
-		gl_transform_to_viewport(c, v);
 
 	// edge flag
 
@@ -252,9 +301,23 @@ void glopVertex(GLContext *c, GLParam *p) {
 
 void glopEnd(GLContext *c, GLParam *) {
 	assert(c->in_begin == 1);
-	
+
 	if (c->vertex_cnt > 0) {
-		tglIssueDrawCall(new Graphics::RasterizationDrawCall());
+		GLVertex *vertex = &c->vertex[c->vertex_processed];
+		int count = c->vertex_n - c->vertex_processed;
+		gl_vertex_transform(c, vertex, count);
+
+		// If all the vertices are on the outer side of one of the clipping
+		// planes, so are all the primitives, and nothing needs to be drawn.
+		int clip_code = 0x3f;
+		for (int i = 0; i < c->vertex_n; i++) {
+			clip_code &= c->vertex[i].clip_code;
+		}
+
+		if (!clip_code) {
+			gl_vertex_shade(c, vertex, count);
+			tglIssueDrawCall(new Graphics::RasterizationDrawCall());
+		}
 	}
 
 	c->in_begin = 0;
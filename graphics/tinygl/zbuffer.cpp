@@ -30,9 +30,11 @@
 
 #include "common/scummsys.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan_intern.h"
 
 namespace TinyGL {
 
@@ -91,6 +93,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 
 	this->_zbuf = (unsigned int *)gl_malloc(size);
 	memset(this->_zbuf, 0, size);
+	_zbufAllocated = true;
 
 	this->frame_buffer_allocated = 0;
 	this->pbuf = frame_buffer;
@@ -104,6 +107,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	initSpanKernels();
 }
 
 FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _depthWrite(true), _enableScissor(false) {
@@ -117,6 +121,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 
 	this->_zbuf = (unsigned int *)gl_malloc(size);
 	memset(this->_zbuf, 0, size);
+	_zbufAllocated = true;
 
 	byte *pixelBuffer = (byte *)gl_malloc(this->ysize * this->linesize);
 	this->pbuf.set(this->cmode, pixelBuffer);
@@ -131,12 +136,64 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+	initSpanKernels();
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer &other) {
+	// Copy the state and the buffer pointers, but not their ownership
+	*this = other;
+	this->frame_buffer_allocated = 0;
+	_zbufAllocated = false;
+}
+
+const SpanKernels *getSpanKernels() {
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &spanKernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &spanKernelsNEON;
+#endif
+	return nullptr;
+}
+
+void FrameBuffer::initSpanKernels() {
+	// The kernels handle 32-bit pixels with whole byte channels, and an
+	// optional alpha channel.
+	_spanKernels = nullptr;
+	if (cmode.bytesPerPixel == 4 && cmode.rLoss == 0 && cmode.gLoss == 0 && cmode.bLoss == 0 &&
+			(cmode.aLoss == 0 || cmode.aLoss == 8))
+		_spanKernels = getSpanKernels();
+}
+
+bool FrameBuffer::getSpanParams(SpanParams &params, bool depthWrite, bool modulate) const {
+	if (!_spanKernels)
+		return false;
+
+	params.aShift = cmode.aShift;
+	params.rShift = cmode.rShift;
+	params.gShift = cmode.gShift;
+	params.bShift = cmode.bShift;
+	params.hasAlpha = cmode.aLoss == 0;
+	params.depthTest = _depthTestEnabled;
+	params.depthWrite = depthWrite;
+	params.depthFunc = _depthFunc;
+	params.alphaTest = _alphaTestEnabled;
+	params.alphaTestFunc = _alphaTestFunc;
+	params.alphaTestRefVal = _alphaTestRefVal;
+	params.blending = _blendingEnabled;
+	params.sourceBlendingFactor = _sourceBlendingFactor;
+	params.destinationBlendingFactor = _destinationBlendingFactor;
+	params.modulate = modulate;
+	return true;
 }
 
 FrameBuffer::~FrameBuffer() {
 	if (frame_buffer_allocated)
 		pbuf.free();
-	gl_free(_zbuf);
+	if (_zbufAllocated)
+		gl_free(_zbuf);
 }
 
 Buffer *FrameBuffer::genOffscreenBuffer() {
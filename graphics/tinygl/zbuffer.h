@@ -74,6 +74,9 @@ static const int DRAW_SMOOTH = 2;
 static const int DRAW_SHADOW_MASK = 3;
 static const int DRAW_SHADOW = 4;
 
+struct SpanKernels;
+struct SpanParams;
+
 struct Buffer {
 	byte *pbuf;
 	unsigned int *zbuf;
@@ -103,6 +106,12 @@ struct ZBufferPoint {
 struct FrameBuffer {
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelBuffer &frame_buffer);
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelFormat &format);
+	/**
+	 * Create a frame buffer which draws into the pixels and the depth
+	 * buffer of @p other, with a copy of its current state. The buffers
+	 * stay owned by @p other.
+	 */
+	explicit FrameBuffer(const FrameBuffer &other);
 	~FrameBuffer();
 
 	Buffer *genOffscreenBuffer();
@@ -241,6 +250,18 @@ struct FrameBuffer {
 		return !_clipRectangle.contains(x, y);
 	}
 
+	/**
+	 * Trim the span of @p count pixels starting at @p x on a line within
+	 * the scissor rectangle to its columns. Returns how many pixels at the
+	 * start of the span are left of it, and sets @p count to the number of
+	 * pixels inside.
+	 */
+	FORCEINLINE int scissorSpan(int x, int &count) {
+		const int skip = CLIP<int>(_clipRectangle.left - x, 0, count);
+		count = CLIP<int>(_clipRectangle.right - x, skip, count) - skip;
+		return skip;
+	}
+
 	FORCEINLINE void writePixel(int pixel, byte aSrc, byte rSrc, byte gSrc, byte bSrc) {
 		if (_alphaTestEnabled) {
 			writePixel<true>(pixel, aSrc, rSrc, gSrc, bSrc);
@@ -515,7 +536,11 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kDepthWrite, bool kEnableScissor>
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
+	void initSpanKernels();
+	bool getSpanParams(SpanParams &params, bool depthWrite, bool modulate) const;
+
 	unsigned int *_zbuf;
+	bool _zbufAllocated;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
 	bool _blendingEnabled;
@@ -526,6 +551,10 @@ private:
 	int _alphaTestFunc;
 	int _alphaTestRefVal;
 	int _depthFunc;
+
+	// SIMD kernels for the spans of triangles, if the CPU and the pixel
+	// format support them.
+	const SpanKernels *_spanKernels;
 };
 
 // memory.c
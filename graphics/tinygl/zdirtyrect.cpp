@@ -30,7 +30,9 @@
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
 #include "common/debug.h"
+#include "common/hashmap.h"
 #include "common/math.h"
+#include "common/system.h"
 
 namespace TinyGL {
 
@@ -113,94 +115,364 @@ void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
 	c->_drawCallsQueue.clear();
 }
 
-static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
+void tglDisposeWorkerContexts(TinyGL::GLContext *c) {
+	for (uint i = 0; i < c->_workerContexts.size(); i++) {
+		delete c->_workerContexts[i]->fb;
+		delete c->_workerContexts[i];
+	}
+	c->_workerContexts.clear();
+}
+
+static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::Array<DirtyRectangle> &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
-static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
-	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
+// Size of the cells of the grid which dirty rectangles are bucketed into
+// while merging them.
+static const int kDirtyRectGridCellSize = 64;
+
+static uint tglFindMergedRectangle(Common::Array<uint> &parents, uint index) {
+	while (parents[index] != index) {
+		parents[index] = parents[parents[index]];
+		index = parents[index];
+	}
+	return index;
+}
 
-	Common::List<DirtyRectangle> rectangles;
+// Merges intersecting rectangles into their bounding rectangle, until none
+// of them intersect. Every rectangle is only tested against those sharing a
+// cell of a coarse grid with it, and the merged rectangles are tested again
+// since their bounding rectangles may intersect others. Merging is the same
+// whatever the order of the rectangles, so this gives the same rectangles
+// as testing every pair.
+static void tglMergeDirtyRectangles(const Common::Rect &bounds, Common::Array<DirtyRectangle> &rectangles) {
+	const int columns = MAX<int>(1, (bounds.width() + kDirtyRectGridCellSize - 1) / kDirtyRectGridCellSize);
+	const int rows = MAX<int>(1, (bounds.height() + kDirtyRectGridCellSize - 1) / kDirtyRectGridCellSize);
+
+	// Each cell holds a linked list of the rectangles overlapping it.
+	Common::Array<int> cells;
+	Common::Array<int> entryRectangles, entryNext;
+	Common::Array<uint> parents;
+	Common::Array<uint> mergedIndices;
+	Common::Array<DirtyRectangle> merged;
+
+	bool restartMerge = true;
+	while (restartMerge && rectangles.size() > 1) {
+		restartMerge = false;
 
-	DrawCallIterator itFrame = c->_drawCallsQueue.begin();
-	DrawCallIterator endFrame = c->_drawCallsQueue.end();
-	DrawCallIterator itPrevFrame = c->_previousFrameDrawCallsQueue.begin();
-	DrawCallIterator endPrevFrame = c->_previousFrameDrawCallsQueue.end();
+		cells.resize(columns * rows);
+		for (uint i = 0; i < cells.size(); i++)
+			cells[i] = -1;
+		entryRectangles.clear();
+		entryNext.clear();
+		parents.resize(rectangles.size());
+		for (uint i = 0; i < parents.size(); i++)
+			parents[i] = i;
+
+		for (uint i = 0; i < rectangles.size(); i++) {
+			const Common::Rect &rectangle = rectangles[i].rectangle;
+			if (rectangle.isEmpty())
+				continue;
+			const int left = CLIP<int>((rectangle.left - bounds.left) / kDirtyRectGridCellSize, 0, columns - 1);
+			const int right = CLIP<int>((rectangle.right - 1 - bounds.left) / kDirtyRectGridCellSize, 0, columns - 1);
+			const int top = CLIP<int>((rectangle.top - bounds.top) / kDirtyRectGridCellSize, 0, rows - 1);
+			const int bottom = CLIP<int>((rectangle.bottom - 1 - bounds.top) / kDirtyRectGridCellSize, 0, rows - 1);
+			for (int y = top; y <= bottom; y++) {
+				for (int x = left; x <= right; x++) {
+					int &cell = cells[y * columns + x];
+					for (int entry = cell; entry != -1; entry = entryNext[entry]) {
+						uint other = entryRectangles[entry];
+						uint root = tglFindMergedRectangle(parents, i);
+						uint otherRoot = tglFindMergedRectangle(parents, other);
+						if (root != otherRoot && rectangle.intersects(rectangles[other].rectangle)) {
+							parents[MAX(root, otherRoot)] = MIN(root, otherRoot);
+							restartMerge = true;
+						}
+					}
+					entryRectangles.push_back(i);
+					entryNext.push_back(cell);
+					cell = entryNext.size() - 1;
+				}
+			}
+		}
 
-	// Compare draw calls.
-	for ( ; itPrevFrame != endPrevFrame && itFrame != endFrame;
-		++itPrevFrame, ++itFrame) {
-			const Graphics::DrawCall &currentCall = **itFrame;
-			const Graphics::DrawCall &previousCall = **itPrevFrame;
+		if (!restartMerge)
+			break;
 
-			if (previousCall != currentCall) {
-				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
-				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
+		// The first rectangle of each set is its root, so the merged ones
+		// keep the order and color of their first rectangle.
+		merged.clear();
+		mergedIndices.resize(rectangles.size());
+		for (uint i = 0; i < rectangles.size(); i++) {
+			uint root = tglFindMergedRectangle(parents, i);
+			if (root == i) {
+				mergedIndices[i] = merged.size();
+				merged.push_back(rectangles[i]);
+			} else {
+				merged[mergedIndices[root]].rectangle.extend(rectangles[i].rectangle);
 			}
+		}
+		rectangles = merged;
 	}
+}
 
-	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
-		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
+#ifdef TINYGL_THREAD_LOCAL
+
+// The screen is split into tiles of its full width, as triangles only step
+// over the lines above and below the scissor rectangle, but test each pixel
+// against its sides.
+static const int kMinTileHeight = 16;
+// Each thread gets several tiles, so that a thread whose tiles are slow to
+// draw does not hold up the others for long.
+static const int kTilesPerThread = 4;
+
+struct DrawCallTiles {
+	TinyGL::GLContext *context;
+	// The rectangles to draw within, or null to draw everywhere.
+	const Common::Array<Common::Rect> *clipRectangles;
+	int tileHeight;
+	// The draw calls overlapping each tile, in the order they were issued.
+	Common::Array<Common::Array<const Graphics::DrawCall *> > tiles;
+};
+
+static void tglUpdateWorkerContexts(TinyGL::GLContext *c) {
+	while ((int)c->_workerContexts.size() < g_system->getParallelJobThreads()) {
+		TinyGL::GLContext *worker = new TinyGL::GLContext();
+		worker->_isWorkerContext = true;
+		c->_workerContexts.push_back(worker);
 	}
 
-	for ( ; itFrame != endFrame; ++itFrame) {
-		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
+	// Copy what executing rasterization and clear draw calls reads from the
+	// context. The frame buffers draw into the same pixels and depth buffer.
+	for (uint i = 0; i < c->_workerContexts.size(); i++) {
+		TinyGL::GLContext *worker = c->_workerContexts[i];
+		delete worker->fb;
+		worker->fb = new TinyGL::FrameBuffer(*c->fb);
+		worker->renderRect = c->renderRect;
+		worker->_textureSize = c->_textureSize;
+		worker->viewport = c->viewport;
+		worker->render_mode = c->render_mode;
+		worker->current_cull_face = c->current_cull_face;
+		worker->lighting_enabled = c->lighting_enabled;
+		worker->cull_face_enabled = c->cull_face_enabled;
+		worker->begin_type = c->begin_type;
+		worker->color_mask = c->color_mask;
+		worker->current_front_face = c->current_front_face;
+		worker->current_shade_model = c->current_shade_model;
+		worker->depth_test = c->depth_test;
+		worker->polygon_mode_back = c->polygon_mode_back;
+		worker->polygon_mode_front = c->polygon_mode_front;
+		worker->shadow_mode = c->shadow_mode;
+		worker->texture_2d_enabled = c->texture_2d_enabled;
+		worker->current_texture = c->current_texture;
+		worker->texture_wrap_s = c->texture_wrap_s;
+		worker->texture_wrap_t = c->texture_wrap_t;
 	}
+}
 
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		(*it).rectangle.right++;
-		(*it).rectangle.bottom++;
+static void tglExecuteTile(void *param, int tile, int thread) {
+	const DrawCallTiles &tiles = *(const DrawCallTiles *)param;
+	TinyGL::GLContext *c = tiles.context->_workerContexts[thread];
+	TinyGL::gl_set_thread_context(c);
+
+	Common::Rect tileRect = c->renderRect;
+	tileRect.top += tile * tiles.tileHeight;
+	tileRect.bottom = MIN<int>(tileRect.top + tiles.tileHeight, tileRect.bottom);
+
+	const Common::Array<const Graphics::DrawCall *> &drawCalls = tiles.tiles[tile];
+	for (uint i = 0; i < drawCalls.size(); i++) {
+		const Common::Rect drawCallRegion = drawCalls[i]->getDirtyRegion();
+		if (!tiles.clipRectangles) {
+			drawCalls[i]->execute(tileRect, true);
+			continue;
+		}
+		for (uint j = 0; j < tiles.clipRectangles->size(); j++) {
+			const Common::Rect clipRectangle = tileRect.findIntersectingRect((*tiles.clipRectangles)[j]);
+			if (clipRectangle.intersects(drawCallRegion))
+				drawCalls[i]->execute(clipRectangle, true);
+		}
 	}
 
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
+	TinyGL::gl_set_thread_context(nullptr);
+}
+
+static void tglFlushTiles(DrawCallTiles &tiles, bool &binned) {
+	if (!binned)
+		return;
+	g_system->runParallelJobs(tglExecuteTile, &tiles, tiles.tiles.size());
+	for (uint i = 0; i < tiles.tiles.size(); i++)
+		tiles.tiles[i].clear();
+	binned = false;
+}
+
+// Executes the draw calls within the clipping rectangles, or everywhere if
+// there are none, like executing them one after the other would. The draw
+// calls are binned into tiles of the screen, which are drawn in parallel on
+// the threads of the backend. The tiles do not overlap, and the draw calls
+// of each tile are executed in order, so the output is the same whatever
+// the threads. Blits are executed on the calling thread between the tiles,
+// as clipping changes which texels scaled and flipped blits pick.
+static void tglExecuteDrawCallsTiled(TinyGL::GLContext *c, const Common::Array<Common::Rect> *clipRectangles) {
+	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+
+	tglUpdateWorkerContexts(c);
+
+	const Common::Rect &renderRect = c->renderRect;
+	const int numTiles = CLIP<int>(c->_rasterizerThreads * kTilesPerThread, 1, MAX<int>(1, renderRect.height() / kMinTileHeight));
+
+	DrawCallTiles tiles;
+	tiles.context = c;
+	tiles.clipRectangles = clipRectangles;
+	tiles.tileHeight = (renderRect.height() + numTiles - 1) / numTiles;
+	tiles.tiles.resize(numTiles);
+	bool binned = false;
+
+	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+		const Graphics::DrawCall *drawCall = *it;
+		const Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+
+		if (drawCall->getType() == Graphics::DrawCall::DrawCall_Blitting) {
+			tglFlushTiles(tiles, binned);
+			if (!clipRectangles) {
+				drawCall->execute(true);
+				continue;
+			}
+			for (uint i = 0; i < clipRectangles->size(); i++) {
+				if ((*clipRectangles)[i].intersects(drawCallRegion))
+					drawCall->execute((*clipRectangles)[i], true);
+			}
+			continue;
+		}
+
+		if (drawCallRegion.isEmpty())
+			continue;
+		// The dirty region is rounded from the vertices, so the draw call is
+		// binned into the tiles of the lines next to it as well
+		const int first = MAX<int>((drawCallRegion.top - 1 - renderRect.top) / tiles.tileHeight, 0);
+		const int last = MIN<int>((drawCallRegion.bottom - renderRect.top) / tiles.tileHeight, numTiles - 1);
+		for (int i = first; i <= last; i++)
+			tiles.tiles[i].push_back(drawCall);
+		binned = true;
+	}
+
+	tglFlushTiles(tiles, binned);
+}
+
+#endif
+
+// Whether the draw calls of this frame are executed in tiles on several
+// threads.
+static bool tglUseTiles(TinyGL::GLContext *c) {
+#ifdef TINYGL_THREAD_LOCAL
+	// Selection writes into a buffer shared by all draw calls
+	return c->_rasterizerThreads > 1 && c->render_mode != TGL_SELECT;
+#else
+	return false;
+#endif
+}
+
+static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
+	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+
+	Common::Array<DirtyRectangle> rectangles;
+
+	// Match the draw calls of this frame with those of the previous one, in
+	// order, looking them up by fingerprint. This way a draw call added to or
+	// removed from the frame only dirties its own region, instead of those of
+	// all the draw calls after it. Unmatched draw calls dirty their region in
+	// the frame they are in.
+	Common::Array<const Graphics::DrawCall *> previousCalls;
+	Common::Array<bool> previousMatched;
+	previousCalls.reserve(c->_previousFrameDrawCallsQueue.size());
+	for (DrawCallIterator it = c->_previousFrameDrawCallsQueue.begin(); it != c->_previousFrameDrawCallsQueue.end(); ++it) {
+		previousCalls.push_back(*it);
+		previousMatched.push_back(false);
+	}
+
+	// The previous draw calls are only indexed once one is missing from its
+	// place, as most frames draw the same calls in the same order.
+	Common::HashMap<uint32, int> firstWithFingerprint;
+	Common::Array<int> nextWithFingerprint;
+	bool indexed = false;
+
+	int lastMatched = -1;
+	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+		const Graphics::DrawCall &currentCall = **it;
+		const uint32 fingerprint = currentCall.getFingerprint();
+
+		int match = -1;
+		if (lastMatched + 1 < (int)previousCalls.size() && previousCalls[lastMatched + 1]->getFingerprint() == fingerprint &&
+				*previousCalls[lastMatched + 1] == currentCall) {
+			match = lastMatched + 1;
+		} else {
+			if (!indexed) {
+				nextWithFingerprint.resize(previousCalls.size());
+				for (int i = previousCalls.size() - 1; i >= 0; i--) {
+					const uint32 previousFingerprint = previousCalls[i]->getFingerprint();
+					nextWithFingerprint[i] = firstWithFingerprint.getValOrDefault(previousFingerprint, -1);
+					firstWithFingerprint[previousFingerprint] = i;
+				}
+				indexed = true;
+			}
+
+			if (firstWithFingerprint.contains(fingerprint)) {
+				// Draw calls before the last match can not be matched anymore.
+				int &first = firstWithFingerprint[fingerprint];
+				while (first != -1 && first <= lastMatched)
+					first = nextWithFingerprint[first];
+				for (int i = first; i != -1; i = nextWithFingerprint[i]) {
+					if (*previousCalls[i] == currentCall) {
+						match = i;
+						break;
 					}
-				} else {
-					++it2;
 				}
 			}
 		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
+
+		if (match != -1) {
+			previousMatched[match] = true;
+			lastMatched = match;
+		} else {
+			_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
 		}
 	}
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		(*it1).rectangle.clip(c->renderRect);
+	for (uint i = 0; i < previousCalls.size(); i++) {
+		if (!previousMatched[i])
+			_appendDirtyRectangle(*previousCalls[i], rectangles, 255, 255, 255);
+	}
+
+	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
+	for (uint i = 0; i < rectangles.size(); i++) {
+		rectangles[i].rectangle.right++;
+		rectangles[i].rectangle.bottom++;
 	}
 
-	if (!rectangles.empty()) {
+	// Merge coalesce dirty rects.
+	tglMergeDirtyRectangles(c->renderRect, rectangles);
+
+	Common::Array<Common::Rect> clipRectangles;
+	for (uint i = 0; i < rectangles.size(); i++) {
+		rectangles[i].rectangle.clip(c->renderRect);
+		if (!rectangles[i].rectangle.isEmpty())
+			clipRectangles.push_back(rectangles[i].rectangle);
+	}
+
+	if (!clipRectangles.empty()) {
 		// Execute draw calls.
-		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+		if (tglUseTiles(c)) {
+#ifdef TINYGL_THREAD_LOCAL
+			tglExecuteDrawCallsTiled(c, &clipRectangles);
+#endif
+		} else {
+			for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (uint i = 0; i < clipRectangles.size(); i++) {
+					if (clipRectangles[i].intersects(drawCallRegion)) {
+						(*it)->execute(clipRectangles[i], true);
+					}
 				}
 			}
 		}
@@ -215,8 +487,8 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 		c->fb->enableBlending(false);
 		c->fb->enableAlphaTest(false);
 
-		for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-			tglDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
+		for (uint i = 0; i < rectangles.size(); i++) {
+			tglDrawRectangle(rectangles[i].rectangle, rectangles[i].r, rectangles[i].g, rectangles[i].b);
 		}
 
 		c->fb->enableBlending(blendingEnabled);
@@ -242,6 +514,16 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 
+#ifdef TINYGL_THREAD_LOCAL
+	if (tglUseTiles(c)) {
+		tglExecuteDrawCallsTiled(c, nullptr);
+		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+			delete *it;
+		}
+		c->_drawCallsQueue.clear();
+	}
+#endif
+
 	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
 		(*it)->execute(true);
 		delete *it;
@@ -287,6 +569,31 @@ bool DrawCall::operator==(const DrawCall &other) const {
 	}
 }
 
+// Draw call fingerprints are FNV-1a hashes over 32 bit words.
+static const uint32 kFingerprintBasis = 2166136261u;
+
+static inline uint32 hashWord(uint32 hash, uint32 value) {
+	return (hash ^ value) * 16777619u;
+}
+
+static inline uint32 hashFloat(uint32 hash, float value) {
+	uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return hashWord(hash, bits);
+}
+
+static inline uint32 hashPointer(uint32 hash, const void *pointer) {
+	uintptr value = (uintptr)pointer;
+	return hashWord(hashWord(hash, (uint32)value), (uint32)((uint64)value >> 32));
+}
+
+static inline uint32 hashRect(uint32 hash, const Common::Rect &rect) {
+	hash = hashWord(hash, rect.left);
+	hash = hashWord(hash, rect.top);
+	hash = hashWord(hash, rect.right);
+	return hashWord(hash, rect.bottom);
+}
+
 RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	_vertexCount = c->vertex_cnt;
@@ -295,9 +602,38 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
 	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	// The tiles of the screen are binned by dirty region as well
+	if (c->_enableDirtyRectangles || c->_rasterizerThreads > 1)
 		computeDirtyRegion();
+	if (c->_enableDirtyRectangles)
+		computeFingerprint();
+}
+
+void RasterizationDrawCall::computeFingerprint() {
+	// Only hashes what tells draw calls apart in practice: the rest of the
+	// state is left to operator==.
+	uint32 hash = hashWord(kFingerprintBasis, DrawCall_Rasterization);
+	hash = hashRect(hash, _dirtyRegion);
+	hash = hashWord(hash, _vertexCount);
+	hash = hashWord(hash, _state.beginType);
+	hash = hashPointer(hash, _state.texture);
+	hash = hashWord(hash, _state.enableBlending);
+	hash = hashWord(hash, _state.sfactor);
+	hash = hashWord(hash, _state.dfactor);
+	for (int i = 0; i < _vertexCount; i++) {
+		const TinyGL::ZBufferPoint &zp = _vertex[i].zp;
+		hash = hashWord(hash, _vertex[i].clip_code);
+		hash = hashWord(hash, zp.x);
+		hash = hashWord(hash, zp.y);
+		hash = hashWord(hash, zp.z);
+		hash = hashWord(hash, zp.s);
+		hash = hashWord(hash, zp.t);
+		hash = hashWord(hash, zp.r);
+		hash = hashWord(hash, zp.g);
+		hash = hashWord(hash, zp.b);
+		hash = hashWord(hash, zp.a);
 	}
+	_fingerprint = hash;
 }
 
 void RasterizationDrawCall::computeDirtyRegion() {
@@ -345,12 +681,17 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	TinyGL::GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	if (c->_isWorkerContext) {
+		c->_workerVertices.resize(_vertexCount);
+		memcpy(c->_workerVertices.begin(), _vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
+		c->vertex = c->_workerVertices.begin();
+	} else {
+		c->vertex = _vertex;
+	}
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (TinyGL::gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (TinyGL::gl_draw_triangle_func)_drawTriangleBack;
 
-	int n = c->vertex_n;
 	int cnt = c->vertex_cnt;
 
 	switch (c->begin_type) {
@@ -398,21 +739,26 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 		}
 		break;
 	case TGL_QUADS:
+		// The edge flags are restored, as draw calls are executed once per
+		// dirty rectangle or tile.
 		for(int i = 0; i < cnt; i += 4) {
+			const int edgeFlag0 = c->vertex[i + 0].edge_flag;
+			const int edgeFlag2 = c->vertex[i + 2].edge_flag;
 			c->vertex[i + 2].edge_flag = 0;
 			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
 			c->vertex[i + 2].edge_flag = 1;
 			c->vertex[i + 0].edge_flag = 0;
 			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 2], &c->vertex[i + 3]);
+			c->vertex[i + 0].edge_flag = edgeFlag0;
+			c->vertex[i + 2].edge_flag = edgeFlag2;
 		}
 		break;
 	case TGL_QUAD_STRIP:
-		for( ; n >= 4; n -= 2) {
-			gl_draw_triangle(c, &c->vertex[0], &c->vertex[1], &c->vertex[2]);
-			gl_draw_triangle(c, &c->vertex[1], &c->vertex[3], &c->vertex[2]);
-			for (int i = 0; i < 2; i++) {
-				c->vertex[i] = c->vertex[i + 2];
-			}
+		// Draw calls are executed once per dirty rectangle, so the vertices
+		// must not be modified.
+		for(int i = 0; i + 3 < cnt; i += 2) {
+			gl_draw_triangle(c, &c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
+			gl_draw_triangle(c, &c->vertex[i + 1], &c->vertex[i + 3], &c->vertex[i + 2]);
 		}
 		break;
 	case TGL_POLYGON: {
@@ -527,9 +873,32 @@ BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransfo
 	_imageVersion = tglGetBlitImageVersion(image);
 	if (TinyGL::gl_get_context()->_enableDirtyRectangles) {
 		computeDirtyRegion();
+		computeFingerprint();
 	}
 }
 
+void BlittingDrawCall::computeFingerprint() {
+	uint32 hash = hashWord(kFingerprintBasis, DrawCall_Blitting);
+	hash = hashPointer(hash, _image);
+	hash = hashWord(hash, _imageVersion);
+	hash = hashWord(hash, _mode);
+	hash = hashRect(hash, _transform._sourceRectangle);
+	hash = hashRect(hash, _transform._destinationRectangle);
+	hash = hashWord(hash, _transform._rotation);
+	hash = hashWord(hash, _transform._originX);
+	hash = hashWord(hash, _transform._originY);
+	hash = hashFloat(hash, _transform._aTint);
+	hash = hashFloat(hash, _transform._rTint);
+	hash = hashFloat(hash, _transform._gTint);
+	hash = hashFloat(hash, _transform._bTint);
+	hash = hashWord(hash, _transform._flipHorizontally);
+	hash = hashWord(hash, _transform._flipVertically);
+	hash = hashWord(hash, _blitState.enableBlending);
+	hash = hashWord(hash, _blitState.sfactor);
+	hash = hashWord(hash, _blitState.dfactor);
+	_fingerprint = hash;
+}
+
 BlittingDrawCall::~BlittingDrawCall() {
 	tglDeleteBlitImage(_image);
 }
@@ -630,9 +999,21 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue) 
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_rasterizerThreads > 1)
 		_dirtyRegion = c->renderRect;
-	}
+	if (c->_enableDirtyRectangles)
+		computeFingerprint();
+}
+
+void ClearBufferDrawCall::computeFingerprint() {
+	uint32 hash = hashWord(kFingerprintBasis, DrawCall_Clear);
+	hash = hashWord(hash, _clearZBuffer);
+	hash = hashWord(hash, _clearColorBuffer);
+	hash = hashWord(hash, _rValue);
+	hash = hashWord(hash, _gValue);
+	hash = hashWord(hash, _bValue);
+	hash = hashWord(hash, _zValue);
+	_fingerprint = hash;
 }
 
 void ClearBufferDrawCall::execute(bool restoreState) const {
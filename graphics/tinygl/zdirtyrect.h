@@ -54,7 +54,7 @@ public:
 		DrawCall_Clear
 	};
 
-	DrawCall(DrawCallType type) : _type(type) { }
+	DrawCall(DrawCallType type) : _fingerprint(0), _type(type) { }
 	virtual ~DrawCall() { }
 	bool operator==(const DrawCall &other) const;
 	bool operator!=(const DrawCall &other) const {
@@ -64,8 +64,12 @@ public:
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
+	// Hash of the draw call, computed when it is issued. Draw calls with
+	// different fingerprints always differ, equal ones still need comparing.
+	uint32 getFingerprint() const { return _fingerprint; }
 protected:
 	Common::Rect _dirtyRegion;
+	uint32 _fingerprint;
 private:
 	DrawCallType _type;
 };
@@ -84,6 +88,7 @@ public:
 
 	void operator delete(void *p) { }
 private:
+	void computeFingerprint();
 	bool _clearZBuffer, _clearColorBuffer;
 	int _rValue, _gValue, _bValue, _zValue;
 };
@@ -104,6 +109,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void computeFingerprint();
 	typedef void (*gl_draw_triangle_func_ptr)(TinyGL::GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	int _vertexCount;
 	TinyGL::GLVertex *_vertex;
@@ -169,6 +175,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void computeFingerprint();
 	BlitImage *_image;
 	BlitTransform _transform;
 	BlittingMode _mode;
@@ -68,6 +68,16 @@ enum {
 #define MAX_TEXTURE_STACK_DEPTH     8
 #define MAX_NAME_STACK_DEPTH        64
 #define MAX_TEXTURE_LEVELS          11
+
+// Draw calls can only be executed on several threads if each of them can
+// have its own context.
+#if defined(__GNUC__)
+#define TINYGL_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define TINYGL_THREAD_LOCAL __declspec(thread)
+#elif __cplusplus >= 201103L
+#define TINYGL_THREAD_LOCAL thread_local
+#endif
 #define T_MAX_LIGHTS                32
 
 #define VERTEX_HASH_SIZE 1031
@@ -189,6 +199,8 @@ struct GLTexture {
 	int versionNumber;
 	struct GLTexture *next, *prev;
 	bool disposed;
+	// Whether the levels after the first one were generated from it
+	bool mipmapsGenerated;
 };
 
 
@@ -250,6 +262,7 @@ private:
 };
 
 struct GLContext;
+struct TransformKernels;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -282,6 +295,7 @@ struct GLContext {
 	int texture_2d_enabled;
 	int texture_mag_filter;
 	int texture_min_filter;
+	int texture_generate_mipmap;
 	unsigned int texture_wrap_s;
 	unsigned int texture_wrap_t;
 
@@ -347,6 +361,9 @@ struct GLContext {
 	int vertex_n, vertex_cnt;
 	int vertex_max;
 	GLVertex *vertex;
+	// vertices are transformed and lit in batches, this many already are
+	int vertex_processed;
+	const TransformKernels *transform_kernels;
 
 	// opengl 1.1 arrays
 	float *vertex_array;
@@ -396,6 +413,16 @@ struct GLContext {
 	Common::List<Graphics::DrawCall *> _previousFrameDrawCallsQueue;
 	int _currentAllocatorIndex;
 	LinearAllocator _drawCallAllocator[2];
+
+	// Draw calls are executed in tiles of the screen, in parallel on this
+	// many threads of the backend
+	int _rasterizerThreads;
+	// One context per thread, which executes the draw calls of its tiles
+	Common::Array<GLContext *> _workerContexts;
+	// Set on the worker contexts. They execute draw calls on copies of the
+	// vertices, as rasterizing writes temporary values into them.
+	bool _isWorkerContext;
+	Common::Array<GLVertex> _workerVertices;
 };
 
 extern GLContext *gl_ctx;
@@ -416,6 +443,9 @@ void gl_draw_triangle_select(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex
 // matrix.c
 void gl_print_matrix(const float *m);
 
+// vertex.c
+void gl_flush_vertices(GLContext *c);
+
 // light.c
 void gl_add_select(GLContext *c, unsigned int zmin, unsigned int zmax);
 void gl_enable_disable_light(GLContext *c, int light, int v);
@@ -438,8 +468,14 @@ void tglIssueDrawCall(Graphics::DrawCall *drawCall);
 // zdirtyrect.cpp
 void tglDisposeResources(GLContext *c);
 void tglDisposeDrawCallLists(TinyGL::GLContext *c);
+void tglDisposeWorkerContexts(GLContext *c);
 
 GLContext *gl_get_context();
+#ifdef TINYGL_THREAD_LOCAL
+// Make gl_get_context() return @p c on the calling thread, or the global
+// context again if it is null.
+void gl_set_thread_context(GLContext *c);
+#endif
 
 // specular buffer "api"
 GLSpecBuf *specbuf_get_buffer(GLContext *c, const int shininess_i, const float shininess);
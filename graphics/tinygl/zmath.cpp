@@ -27,8 +27,10 @@
  */
 
 #include "common/scummsys.h"
+#include "common/system.h"
 
 #include "graphics/tinygl/zmath.h"
+#include "graphics/tinygl/zmath_intern.h"
 
 namespace TinyGL {
 
@@ -339,4 +341,16 @@ void Matrix4::scale(float x, float y, float z) {
 	_m[3][0] *= x; _m[3][1] *= y; _m[3][2] *= z;
 }
 
+const TransformKernels *getTransformKernels() {
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &transformKernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &transformKernelsNEON;
+#endif
+	return nullptr;
+}
+
 } // end of namespace TinyGL
@@ -0,0 +1,58 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZMATH_INTERN_H_
+#define GRAPHICS_TINYGL_ZMATH_INTERN_H_
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zmath.h"
+
+namespace TinyGL {
+
+/**
+ * SIMD versions of the Matrix4 transforms, for whole arrays of vertices.
+ *
+ * Both transform @p count vectors, reading them from @p in and writing them to
+ * @p out. Consecutive vectors are @p stride bytes apart, so they can be
+ * members of a larger structure. The results are the same as those of
+ * Matrix4::transform3x4() and Matrix4::transform().
+ */
+struct TransformKernels {
+	void (*transform3x4)(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride);
+	void (*transform)(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride);
+};
+
+/** Return the kernels for the CPU we are running on, or 0 if there are none. */
+const TransformKernels *getTransformKernels();
+
+#ifdef SCUMMVM_SSE2
+extern const TransformKernels transformKernelsSSE2;
+#endif
+
+#ifdef SCUMMVM_NEON
+extern const TransformKernels transformKernelsNEON;
+#endif
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,79 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/tinygl/zmath_intern.h"
+
+#include <arm_neon.h>
+
+namespace TinyGL {
+
+namespace {
+
+/**
+ * The products are summed in the same order as in the Matrix4 methods, so
+ * the results are exactly the same. Fused multiply-adds would round
+ * differently, hence the separate multiplications and additions.
+ */
+template<bool kUseW>
+void transformVectors(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride) {
+	const float cols[4][4] = {
+		{ m._m[0][0], m._m[1][0], m._m[2][0], m._m[3][0] },
+		{ m._m[0][1], m._m[1][1], m._m[2][1], m._m[3][1] },
+		{ m._m[0][2], m._m[1][2], m._m[2][2], m._m[3][2] },
+		{ m._m[0][3], m._m[1][3], m._m[2][3], m._m[3][3] }
+	};
+	const float32x4_t col0 = vld1q_f32(cols[0]);
+	const float32x4_t col1 = vld1q_f32(cols[1]);
+	const float32x4_t col2 = vld1q_f32(cols[2]);
+	const float32x4_t col3 = vld1q_f32(cols[3]);
+
+	const byte *src = (const byte *)in;
+	byte *dst = (byte *)out;
+	for (int i = 0; i < count; i++, src += stride, dst += stride) {
+		const float *v = (const float *)src;
+		float32x4_t r = vmulq_n_f32(col0, v[0]);
+		r = vaddq_f32(r, vmulq_n_f32(col1, v[1]));
+		r = vaddq_f32(r, vmulq_n_f32(col2, v[2]));
+		if (kUseW)
+			r = vaddq_f32(r, vmulq_n_f32(col3, v[3]));
+		else
+			r = vaddq_f32(r, col3);
+		vst1q_f32((float *)dst, r);
+	}
+}
+
+void transform3x4(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride) {
+	transformVectors<false>(m, in, out, count, stride);
+}
+
+void transform(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride) {
+	transformVectors<true>(m, in, out, count, stride);
+}
+
+} // End of anonymous namespace
+
+const TransformKernels transformKernelsNEON = {
+	transform3x4,
+	transform
+};
+
+} // end of namespace TinyGL
@@ -0,0 +1,72 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/tinygl/zmath_intern.h"
+
+#include <emmintrin.h>
+
+namespace TinyGL {
+
+namespace {
+
+/**
+ * The products are summed in the same order as in the Matrix4 methods, so
+ * the results are exactly the same.
+ */
+template<bool kUseW>
+void transformVectors(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride) {
+	const __m128 col0 = _mm_setr_ps(m._m[0][0], m._m[1][0], m._m[2][0], m._m[3][0]);
+	const __m128 col1 = _mm_setr_ps(m._m[0][1], m._m[1][1], m._m[2][1], m._m[3][1]);
+	const __m128 col2 = _mm_setr_ps(m._m[0][2], m._m[1][2], m._m[2][2], m._m[3][2]);
+	const __m128 col3 = _mm_setr_ps(m._m[0][3], m._m[1][3], m._m[2][3], m._m[3][3]);
+
+	const byte *src = (const byte *)in;
+	byte *dst = (byte *)out;
+	for (int i = 0; i < count; i++, src += stride, dst += stride) {
+		const __m128 v = _mm_loadu_ps((const float *)src);
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), col0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), col1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), col2));
+		if (kUseW)
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), col3));
+		else
+			r = _mm_add_ps(r, col3);
+		_mm_storeu_ps((float *)dst, r);
+	}
+}
+
+void transform3x4(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride) {
+	transformVectors<false>(m, in, out, count, stride);
+}
+
+void transform(const Matrix4 &m, const Vector4 *in, Vector4 *out, int count, int stride) {
+	transformVectors<true>(m, in, out, count, stride);
+}
+
+} // End of anonymous namespace
+
+const TransformKernels transformKernelsSSE2 = {
+	transform3x4,
+	transform
+};
+
+} // end of namespace TinyGL
@@ -0,0 +1,91 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_INTERN_H_
+#define GRAPHICS_TINYGL_ZSPAN_INTERN_H_
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+/**
+ * State which stays the same for all the spans of a triangle. The kernels
+ * only support 32-bit framebuffers with all color channels in whole bytes.
+ */
+struct SpanParams {
+	/** Shifts of the channels in a pixel. Alpha is only stored if hasAlpha is set. */
+	uint8 aShift, rShift, gShift, bShift;
+	bool hasAlpha;
+
+	bool depthTest;
+	bool depthWrite;
+	int depthFunc;
+
+	bool alphaTest;
+	int alphaTestFunc;
+	int alphaTestRefVal;
+
+	bool blending;
+	int sourceBlendingFactor;
+	int destinationBlendingFactor;
+
+	/** Multiply the texels with the interpolated color. */
+	bool modulate;
+};
+
+/**
+ * Values at the first pixel of a span and their steps from one pixel to the
+ * next, in the fixed point formats of ZBufferPoint.
+ */
+struct SpanState {
+	unsigned int z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+};
+
+/**
+ * SIMD versions of the inner loops of FrameBuffer::fillTriangle().
+ *
+ * drawSpan() depth tests, alpha tests and blends a span of pixels, producing
+ * the same result as FrameBuffer::writePixel(). If @p texels is set, it
+ * holds the color of each pixel as A8R8G8B8, otherwise the interpolated color
+ * is drawn. It may leave some pixels at the end of the span, returns the
+ * number of pixels it drew, which is always a multiple of 4, and advances
+ * @p state past them.
+ */
+struct SpanKernels {
+	int (*drawSpan)(const SpanParams &params, SpanState &state, uint32 *pixels, unsigned int *zbuf, int count, const uint32 *texels);
+};
+
+/** Return the kernels for the CPU we are running on, or 0 if there are none. */
+const SpanKernels *getSpanKernels();
+
+#ifdef SCUMMVM_SSE2
+extern const SpanKernels spanKernelsSSE2;
+#endif
+
+#ifdef SCUMMVM_NEON
+extern const SpanKernels spanKernelsNEON;
+#endif
+
+} // end of namespace TinyGL
+
+#endif
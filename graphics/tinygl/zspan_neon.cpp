@@ -0,0 +1,287 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/tinygl/zspan_intern.h"
+#include "graphics/tinygl/gl.h"
+
+#include <arm_neon.h>
+
+namespace TinyGL {
+
+namespace {
+
+inline uint32x4_t ramp(unsigned int value, int step) {
+	const uint32 d = step;
+	const uint32 offsets[4] = { 0, d, 2 * d, 3 * d };
+	return vaddq_u32(vdupq_n_u32(value), vld1q_u32(offsets));
+}
+
+inline uint32x4_t channel(uint32x4_t pixels, int shift) {
+	return vandq_u32(vshlq_u32(pixels, vdupq_n_s32(-shift)), vdupq_n_u32(0xff));
+}
+
+inline uint32x4_t pack(uint32x4_t value, int shift) {
+	return vshlq_u32(value, vdupq_n_s32(shift));
+}
+
+/** Multiply two channels and drop the low 8 bits of the product, see the SSE2 version. */
+inline uint32x4_t mul8(uint32x4_t a, uint32x4_t b) {
+	return vshrq_n_u32(vandq_u32(vmulq_u32(a, b), vdupq_n_u32(0xffff)), 8);
+}
+
+/** Return the lanes for which a func b holds, as checkAlphaTest() and compareDepth(). */
+inline uint32x4_t compare(int func, uint32x4_t a, uint32x4_t b) {
+	switch (func) {
+	case TGL_LESS:
+		return vcltq_u32(a, b);
+	case TGL_EQUAL:
+		return vceqq_u32(a, b);
+	case TGL_LEQUAL:
+		return vcleq_u32(a, b);
+	case TGL_GREATER:
+		return vcgtq_u32(a, b);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_u32(a, b));
+	case TGL_GEQUAL:
+		return vcgeq_u32(a, b);
+	case TGL_ALWAYS:
+		return vdupq_n_u32(0xffffffff);
+	default:
+		return vdupq_n_u32(0);
+	}
+}
+
+/** Signed version of compare(), for the alpha test reference value. */
+inline uint32x4_t compareSigned(int func, int32x4_t a, int32x4_t b) {
+	switch (func) {
+	case TGL_LESS:
+		return vcltq_s32(a, b);
+	case TGL_EQUAL:
+		return vceqq_s32(a, b);
+	case TGL_LEQUAL:
+		return vcleq_s32(a, b);
+	case TGL_GREATER:
+		return vcgtq_s32(a, b);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_s32(a, b));
+	case TGL_GEQUAL:
+		return vcgeq_s32(a, b);
+	case TGL_ALWAYS:
+		return vdupq_n_u32(0xffffffff);
+	default:
+		return vdupq_n_u32(0);
+	}
+}
+
+inline bool any(uint32x4_t mask) {
+	const uint32x2_t half = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+	return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+}
+
+int drawSpan(const SpanParams &params, SpanState &state, uint32 *pixels, unsigned int *zbuf, int count, const uint32 *texels) {
+	const uint32x4_t ones = vdupq_n_u32(0xffffffff);
+	const uint32x4_t byteMask = vdupq_n_u32(0xff);
+	const int32x4_t alphaTestRefVal = vdupq_n_s32(params.alphaTestRefVal);
+
+	uint32x4_t z = ramp(state.z, state.dzdx);
+	uint32x4_t r = ramp(state.r, state.drdx);
+	uint32x4_t g = ramp(state.g, state.dgdx);
+	uint32x4_t b = ramp(state.b, state.dbdx);
+	uint32x4_t a = ramp(state.a, state.dadx);
+	const uint32x4_t dz = vdupq_n_u32(4 * (uint32)state.dzdx);
+	const uint32x4_t dr = vdupq_n_u32(4 * (uint32)state.drdx);
+	const uint32x4_t dg = vdupq_n_u32(4 * (uint32)state.dgdx);
+	const uint32x4_t db = vdupq_n_u32(4 * (uint32)state.dbdx);
+	const uint32x4_t da = vdupq_n_u32(4 * (uint32)state.dadx);
+
+	int j = 0;
+	for (; j + 4 <= count; j += 4) {
+		const uint32x4_t zDst = vld1q_u32((const uint32 *)(zbuf + j));
+		uint32x4_t mask = ones;
+		if (params.depthTest)
+			mask = compare(params.depthFunc, zDst, z);
+
+		if (any(mask)) {
+			uint32x4_t aSrc, rSrc, gSrc, bSrc;
+			if (texels) {
+				const uint32x4_t texel = vld1q_u32(texels + j);
+				aSrc = vshrq_n_u32(texel, 24);
+				rSrc = channel(texel, 16);
+				gSrc = channel(texel, 8);
+				bSrc = vandq_u32(texel, byteMask);
+				if (params.modulate) {
+					aSrc = vandq_u32(mul8(aSrc, vshrq_n_u32(a, 8)), byteMask);
+					rSrc = vandq_u32(mul8(rSrc, vshrq_n_u32(r, 8)), byteMask);
+					gSrc = vandq_u32(mul8(gSrc, vshrq_n_u32(g, 8)), byteMask);
+					bSrc = vandq_u32(mul8(bSrc, vshrq_n_u32(b, 8)), byteMask);
+				}
+			} else {
+				aSrc = channel(a, 8);
+				rSrc = channel(r, 8);
+				gSrc = channel(g, 8);
+				bSrc = channel(b, 8);
+			}
+
+			if (params.alphaTest)
+				mask = vandq_u32(mask, compareSigned(params.alphaTestFunc, vreinterpretq_s32_u32(aSrc), alphaTestRefVal));
+
+			if (params.depthWrite)
+				vst1q_u32((uint32 *)(zbuf + j), vbslq_u32(mask, z, zDst));
+
+			const uint32x4_t dst = vld1q_u32(pixels + j);
+			uint32x4_t color;
+			if (!params.blending) {
+				color = vorrq_u32(vorrq_u32(pack(rSrc, params.rShift), pack(gSrc, params.gShift)), pack(bSrc, params.bShift));
+				if (params.hasAlpha)
+					color = vorrq_u32(color, pack(aSrc, params.aShift));
+			} else {
+				const uint32x4_t aDst = params.hasAlpha ? channel(dst, params.aShift) : byteMask;
+				uint32x4_t rDst = channel(dst, params.rShift);
+				uint32x4_t gDst = channel(dst, params.gShift);
+				uint32x4_t bDst = channel(dst, params.bShift);
+
+				switch (params.sourceBlendingFactor) {
+				case TGL_ZERO:
+					rSrc = gSrc = bSrc = vdupq_n_u32(0);
+					break;
+				case TGL_DST_COLOR:
+					rSrc = mul8(rDst, rSrc);
+					gSrc = mul8(gDst, gSrc);
+					bSrc = mul8(bDst, bSrc);
+					break;
+				case TGL_ONE_MINUS_DST_COLOR:
+					rSrc = mul8(rSrc, vsubq_u32(byteMask, rDst));
+					gSrc = mul8(gSrc, vsubq_u32(byteMask, gDst));
+					bSrc = mul8(bSrc, vsubq_u32(byteMask, bDst));
+					break;
+				case TGL_SRC_ALPHA:
+					rSrc = mul8(rSrc, aSrc);
+					gSrc = mul8(gSrc, aSrc);
+					bSrc = mul8(bSrc, aSrc);
+					break;
+				case TGL_ONE_MINUS_SRC_ALPHA: {
+					const uint32x4_t factor = vsubq_u32(byteMask, aSrc);
+					rSrc = mul8(rSrc, factor);
+					gSrc = mul8(gSrc, factor);
+					bSrc = mul8(bSrc, factor);
+					}
+					break;
+				case TGL_DST_ALPHA:
+					rSrc = mul8(rSrc, aDst);
+					gSrc = mul8(gSrc, aDst);
+					bSrc = mul8(bSrc, aDst);
+					break;
+				case TGL_ONE_MINUS_DST_ALPHA: {
+					const uint32x4_t factor = vsubq_u32(byteMask, aDst);
+					rSrc = mul8(rSrc, factor);
+					gSrc = mul8(gSrc, factor);
+					bSrc = mul8(bSrc, factor);
+					}
+					break;
+				default:
+					break;
+				}
+
+				switch (params.destinationBlendingFactor) {
+				case TGL_ZERO:
+					rDst = gDst = bDst = vdupq_n_u32(0);
+					break;
+				case TGL_DST_COLOR:
+					rDst = mul8(rDst, rSrc);
+					gDst = mul8(gDst, gSrc);
+					bDst = mul8(bDst, bSrc);
+					break;
+				case TGL_ONE_MINUS_DST_COLOR:
+					rDst = mul8(rDst, vsubq_u32(byteMask, rSrc));
+					gDst = mul8(gDst, vsubq_u32(byteMask, gSrc));
+					bDst = mul8(bDst, vsubq_u32(byteMask, bSrc));
+					break;
+				case TGL_SRC_ALPHA:
+					rDst = mul8(rDst, aSrc);
+					gDst = mul8(gDst, aSrc);
+					bDst = mul8(bDst, aSrc);
+					break;
+				case TGL_ONE_MINUS_SRC_ALPHA: {
+					const uint32x4_t factor = vsubq_u32(byteMask, aSrc);
+					rDst = mul8(rDst, factor);
+					gDst = mul8(gDst, factor);
+					bDst = mul8(bDst, factor);
+					}
+					break;
+				case TGL_DST_ALPHA:
+					rDst = mul8(rDst, aDst);
+					gDst = mul8(gDst, aDst);
+					bDst = mul8(bDst, aDst);
+					break;
+				case TGL_ONE_MINUS_DST_ALPHA: {
+					const uint32x4_t factor = vsubq_u32(byteMask, aDst);
+					rDst = mul8(rDst, factor);
+					gDst = mul8(gDst, factor);
+					bDst = mul8(bDst, factor);
+					}
+					break;
+				case TGL_SRC_ALPHA_SATURATE: {
+					// The factor may be negative, the product is truncated to a byte.
+					const int32x4_t oneMinusADst = vsubq_s32(vdupq_n_s32(1), vreinterpretq_s32_u32(aDst));
+					const uint32x4_t factor = vreinterpretq_u32_s32(vminq_s32(vreinterpretq_s32_u32(aSrc), oneMinusADst));
+					rDst = vandq_u32(mul8(rDst, factor), byteMask);
+					gDst = vandq_u32(mul8(gDst, factor), byteMask);
+					bDst = vandq_u32(mul8(bDst, factor), byteMask);
+					}
+					break;
+				default:
+					break;
+				}
+
+				const uint32x4_t finalR = vminq_u32(vaddq_u32(rDst, rSrc), byteMask);
+				const uint32x4_t finalG = vminq_u32(vaddq_u32(gDst, gSrc), byteMask);
+				const uint32x4_t finalB = vminq_u32(vaddq_u32(bDst, bSrc), byteMask);
+				color = vorrq_u32(vorrq_u32(pack(finalR, params.rShift), pack(finalG, params.gShift)), pack(finalB, params.bShift));
+				if (params.hasAlpha)
+					color = vorrq_u32(color, pack(byteMask, params.aShift));
+			}
+
+			vst1q_u32(pixels + j, vbslq_u32(mask, color, dst));
+		}
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	state.z += (unsigned int)j * state.dzdx;
+	state.r += (unsigned int)j * state.drdx;
+	state.g += (unsigned int)j * state.dgdx;
+	state.b += (unsigned int)j * state.dbdx;
+	state.a += (unsigned int)j * state.dadx;
+	return j;
+}
+
+} // End of anonymous namespace
+
+const SpanKernels spanKernelsNEON = {
+	drawSpan
+};
+
+} // end of namespace TinyGL
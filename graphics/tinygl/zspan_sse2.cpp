@@ -0,0 +1,272 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/tinygl/zspan_intern.h"
+#include "graphics/tinygl/gl.h"
+
+#include <emmintrin.h>
+
+namespace TinyGL {
+
+namespace {
+
+inline __m128i ramp(unsigned int value, int step) {
+	const uint32 d = step;
+	return _mm_add_epi32(_mm_set1_epi32(value), _mm_set_epi32(3 * d, 2 * d, d, 0));
+}
+
+inline __m128i channel(__m128i pixels, int shift) {
+	return _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xff));
+}
+
+inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/**
+ * Multiply two channels and drop the low 8 bits of the product. Only the low
+ * 16 bits of the product are computed, which is all the caller keeps once
+ * the result is truncated to a byte.
+ */
+inline __m128i mul8(__m128i a, __m128i b) {
+	return _mm_srli_epi32(_mm_and_si128(_mm_mullo_epi16(a, b), _mm_set1_epi32(0xffff)), 8);
+}
+
+/** Return the lanes for which a func b holds, as checkAlphaTest() and compareDepth(). */
+inline __m128i compare(int func, __m128i a, __m128i b) {
+	const __m128i ones = _mm_set1_epi32(-1);
+
+	switch (func) {
+	case TGL_LESS:
+		return _mm_cmplt_epi32(a, b);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(a, b);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(a, b), ones);
+	case TGL_GREATER:
+		return _mm_cmpgt_epi32(a, b);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(a, b), ones);
+	case TGL_GEQUAL:
+		return _mm_xor_si128(_mm_cmplt_epi32(a, b), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+int drawSpan(const SpanParams &params, SpanState &state, uint32 *pixels, unsigned int *zbuf, int count, const uint32 *texels) {
+	const __m128i ones = _mm_set1_epi32(-1);
+	const __m128i byteMask = _mm_set1_epi32(0xff);
+	// SSE2 only compares signed integers, so the depth values are biased.
+	const __m128i signBit = _mm_set1_epi32(0x80000000);
+	const __m128i alphaTestRefVal = _mm_set1_epi32(params.alphaTestRefVal);
+
+	__m128i z = ramp(state.z, state.dzdx);
+	__m128i r = ramp(state.r, state.drdx);
+	__m128i g = ramp(state.g, state.dgdx);
+	__m128i b = ramp(state.b, state.dbdx);
+	__m128i a = ramp(state.a, state.dadx);
+	const __m128i dz = _mm_set1_epi32(4 * (uint32)state.dzdx);
+	const __m128i dr = _mm_set1_epi32(4 * (uint32)state.drdx);
+	const __m128i dg = _mm_set1_epi32(4 * (uint32)state.dgdx);
+	const __m128i db = _mm_set1_epi32(4 * (uint32)state.dbdx);
+	const __m128i da = _mm_set1_epi32(4 * (uint32)state.dadx);
+
+	int j = 0;
+	for (; j + 4 <= count; j += 4) {
+		const __m128i zDst = _mm_loadu_si128((const __m128i *)(zbuf + j));
+		__m128i mask = ones;
+		if (params.depthTest)
+			mask = compare(params.depthFunc, _mm_xor_si128(zDst, signBit), _mm_xor_si128(z, signBit));
+
+		if (_mm_movemask_epi8(mask) != 0) {
+			__m128i aSrc, rSrc, gSrc, bSrc;
+			if (texels) {
+				const __m128i texel = _mm_loadu_si128((const __m128i *)(texels + j));
+				aSrc = _mm_srli_epi32(texel, 24);
+				rSrc = channel(texel, 16);
+				gSrc = channel(texel, 8);
+				bSrc = _mm_and_si128(texel, byteMask);
+				if (params.modulate) {
+					aSrc = _mm_and_si128(mul8(aSrc, _mm_srli_epi32(a, 8)), byteMask);
+					rSrc = _mm_and_si128(mul8(rSrc, _mm_srli_epi32(r, 8)), byteMask);
+					gSrc = _mm_and_si128(mul8(gSrc, _mm_srli_epi32(g, 8)), byteMask);
+					bSrc = _mm_and_si128(mul8(bSrc, _mm_srli_epi32(b, 8)), byteMask);
+				}
+			} else {
+				aSrc = channel(a, 8);
+				rSrc = channel(r, 8);
+				gSrc = channel(g, 8);
+				bSrc = channel(b, 8);
+			}
+
+			if (params.alphaTest)
+				mask = _mm_and_si128(mask, compare(params.alphaTestFunc, aSrc, alphaTestRefVal));
+
+			if (params.depthWrite)
+				_mm_storeu_si128((__m128i *)(zbuf + j), select(mask, z, zDst));
+
+			const __m128i dst = _mm_loadu_si128((const __m128i *)(pixels + j));
+			__m128i color;
+			if (!params.blending) {
+				color = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(rSrc, _mm_cvtsi32_si128(params.rShift)),
+				                                  _mm_sll_epi32(gSrc, _mm_cvtsi32_si128(params.gShift))),
+				                     _mm_sll_epi32(bSrc, _mm_cvtsi32_si128(params.bShift)));
+				if (params.hasAlpha)
+					color = _mm_or_si128(color, _mm_sll_epi32(aSrc, _mm_cvtsi32_si128(params.aShift)));
+			} else {
+				const __m128i aDst = params.hasAlpha ? channel(dst, params.aShift) : byteMask;
+				__m128i rDst = channel(dst, params.rShift);
+				__m128i gDst = channel(dst, params.gShift);
+				__m128i bDst = channel(dst, params.bShift);
+
+				switch (params.sourceBlendingFactor) {
+				case TGL_ZERO:
+					rSrc = gSrc = bSrc = _mm_setzero_si128();
+					break;
+				case TGL_DST_COLOR:
+					rSrc = mul8(rDst, rSrc);
+					gSrc = mul8(gDst, gSrc);
+					bSrc = mul8(bDst, bSrc);
+					break;
+				case TGL_ONE_MINUS_DST_COLOR:
+					rSrc = mul8(rSrc, _mm_sub_epi32(byteMask, rDst));
+					gSrc = mul8(gSrc, _mm_sub_epi32(byteMask, gDst));
+					bSrc = mul8(bSrc, _mm_sub_epi32(byteMask, bDst));
+					break;
+				case TGL_SRC_ALPHA:
+					rSrc = mul8(rSrc, aSrc);
+					gSrc = mul8(gSrc, aSrc);
+					bSrc = mul8(bSrc, aSrc);
+					break;
+				case TGL_ONE_MINUS_SRC_ALPHA: {
+					const __m128i factor = _mm_sub_epi32(byteMask, aSrc);
+					rSrc = mul8(rSrc, factor);
+					gSrc = mul8(gSrc, factor);
+					bSrc = mul8(bSrc, factor);
+					}
+					break;
+				case TGL_DST_ALPHA:
+					rSrc = mul8(rSrc, aDst);
+					gSrc = mul8(gSrc, aDst);
+					bSrc = mul8(bSrc, aDst);
+					break;
+				case TGL_ONE_MINUS_DST_ALPHA: {
+					const __m128i factor = _mm_sub_epi32(byteMask, aDst);
+					rSrc = mul8(rSrc, factor);
+					gSrc = mul8(gSrc, factor);
+					bSrc = mul8(bSrc, factor);
+					}
+					break;
+				default:
+					break;
+				}
+
+				switch (params.destinationBlendingFactor) {
+				case TGL_ZERO:
+					rDst = gDst = bDst = _mm_setzero_si128();
+					break;
+				case TGL_DST_COLOR:
+					rDst = mul8(rDst, rSrc);
+					gDst = mul8(gDst, gSrc);
+					bDst = mul8(bDst, bSrc);
+					break;
+				case TGL_ONE_MINUS_DST_COLOR:
+					rDst = mul8(rDst, _mm_sub_epi32(byteMask, rSrc));
+					gDst = mul8(gDst, _mm_sub_epi32(byteMask, gSrc));
+					bDst = mul8(bDst, _mm_sub_epi32(byteMask, bSrc));
+					break;
+				case TGL_SRC_ALPHA:
+					rDst = mul8(rDst, aSrc);
+					gDst = mul8(gDst, aSrc);
+					bDst = mul8(bDst, aSrc);
+					break;
+				case TGL_ONE_MINUS_SRC_ALPHA: {
+					const __m128i factor = _mm_sub_epi32(byteMask, aSrc);
+					rDst = mul8(rDst, factor);
+					gDst = mul8(gDst, factor);
+					bDst = mul8(bDst, factor);
+					}
+					break;
+				case TGL_DST_ALPHA:
+					rDst = mul8(rDst, aDst);
+					gDst = mul8(gDst, aDst);
+					bDst = mul8(bDst, aDst);
+					break;
+				case TGL_ONE_MINUS_DST_ALPHA: {
+					const __m128i factor = _mm_sub_epi32(byteMask, aDst);
+					rDst = mul8(rDst, factor);
+					gDst = mul8(gDst, factor);
+					bDst = mul8(bDst, factor);
+					}
+					break;
+				case TGL_SRC_ALPHA_SATURATE: {
+					// The factor may be negative, the product is truncated to a byte.
+					const __m128i oneMinusADst = _mm_sub_epi32(_mm_set1_epi32(1), aDst);
+					const __m128i factor = select(_mm_cmplt_epi32(aSrc, oneMinusADst), aSrc, oneMinusADst);
+					rDst = _mm_and_si128(mul8(rDst, factor), byteMask);
+					gDst = _mm_and_si128(mul8(gDst, factor), byteMask);
+					bDst = _mm_and_si128(mul8(bDst, factor), byteMask);
+					}
+					break;
+				default:
+					break;
+				}
+
+				// The sums are at most 510, so a 16-bit minimum is enough.
+				const __m128i finalR = _mm_min_epi16(_mm_add_epi32(rDst, rSrc), byteMask);
+				const __m128i finalG = _mm_min_epi16(_mm_add_epi32(gDst, gSrc), byteMask);
+				const __m128i finalB = _mm_min_epi16(_mm_add_epi32(bDst, bSrc), byteMask);
+				color = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(finalR, _mm_cvtsi32_si128(params.rShift)),
+				                                  _mm_sll_epi32(finalG, _mm_cvtsi32_si128(params.gShift))),
+				                     _mm_sll_epi32(finalB, _mm_cvtsi32_si128(params.bShift)));
+				if (params.hasAlpha)
+					color = _mm_or_si128(color, _mm_sll_epi32(byteMask, _mm_cvtsi32_si128(params.aShift)));
+			}
+
+			_mm_storeu_si128((__m128i *)(pixels + j), select(mask, color, dst));
+		}
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	state.z += (unsigned int)j * state.dzdx;
+	state.r += (unsigned int)j * state.drdx;
+	state.g += (unsigned int)j * state.dgdx;
+	state.b += (unsigned int)j * state.dbdx;
+	state.a += (unsigned int)j * state.dadx;
+	return j;
+}
+
+} // End of anonymous namespace
+
+const SpanKernels spanKernelsSSE2 = {
+	drawSpan
+};
+
+} // end of namespace TinyGL
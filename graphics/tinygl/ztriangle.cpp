@@ -30,6 +30,7 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan_intern.h"
 
 namespace TinyGL {
 
@@ -152,6 +153,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	// Scanlines outside of the scissor rectangle are only stepped over, and
+	// triangles entirely above or below it are skipped.
+	int clipTop = 0, clipBottom = ysize;
+	if (_enableScissor) {
+		clipTop = _clipRectangle.top;
+		clipBottom = _clipRectangle.bottom;
+		if (p0->y >= clipBottom || p2->y < clipTop)
+			return;
+	}
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -260,6 +271,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		break;
 	}
 
+	// Spans are drawn by the SIMD kernels if there are some. With the scissor
+	// test enabled, the kernels only get the part of each span inside the
+	// scissor rectangle.
+	SpanParams spanParams = SpanParams();
+	const bool useSpanKernels = (kDrawLogic == DRAW_FLAT || kDrawLogic == DRAW_SMOOTH) &&
+	                            getSpanParams(spanParams, kDepthWrite, kInterpRGB);
+
 	if ((kInterpST || kInterpSTZ) && (kDrawLogic == DRAW_FLAT || kDrawLogic == DRAW_SMOOTH)) {
 		texture = current_texture;
 		fdzdx = (float)dzdx;
@@ -360,8 +378,11 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
+			if (y >= clipBottom)
+				return;
+
 			int x = x1;
-			{
+			if (y >= clipTop) {
 				if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
@@ -381,6 +402,25 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					if (kDrawLogic == DRAW_FLAT) {
 						a = a1;
 					}
+					if (kDrawLogic == DRAW_FLAT && useSpanKernels) {
+						int count = n + 1;
+						if (kEnableScissor) {
+							const int skip = scissorSpan(x, count);
+							z += (unsigned int)skip * dzdx;
+							pz += skip;
+							pp += skip;
+							n -= skip;
+							x += skip;
+						}
+						SpanState span = { z, r, g, b, a, dzdx, 0, 0, 0, 0 };
+						if (count > 0)
+							count = _spanKernels->drawSpan(spanParams, span, (uint32 *)pbuf.getRawBuffer(pp), pz, count, nullptr);
+						z = span.z;
+						pz += count;
+						pp += count;
+						n -= count;
+						x += count;
+					}
 					while (n >= 3) {
 						if (kDrawLogic == DRAW_DEPTH_ONLY) {
 							putPixelDepth<kDepthWrite, kEnableScissor>(this, buf, pz, 0, x, y, z, dzdx);
@@ -392,7 +432,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						if (kDrawLogic == DRAW_FLAT) {
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 0, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 1, x, y, z, r, g, b, a, dzdx);
-							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, g, a, dzdx);
+							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 3, x, y, z, r, g, b, a, dzdx);
 						}
 						if (kInterpZ) {
@@ -418,26 +458,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						x += 1;
 					}
 				} else if (kDrawLogic == DRAW_SHADOW_MASK) {
-					unsigned char *pm;
-					int n;
-
-					n = (x2 >> 16) - x1;
-					pm = pm1 + x1;
-					while (n >= 3) {
-						pm[0] = 0xff;
-						pm[1] = 0xff;
-						pm[2] = 0xff;
-						pm[3] = 0xff;
-						pm += 4;
-						n -= 4;
-						x += 4;
-					}
-					while (n >= 0) {
-						pm[0] = 0xff;
-						pm += 1;
-						n -= 1;
-						x += 1;
-					}
+					// The mask is clipped as well, as the tiles of the
+					// screen may be drawn on several threads at once
+					int count = (x2 >> 16) - x1 + 1;
+					if (kEnableScissor)
+						x += scissorSpan(x, count);
+					if (count > 0)
+						memset(pm1 + x, 0xff, count);
 				} else if (kDrawLogic == DRAW_SHADOW) {
 					unsigned char *pm;
 					int n;
@@ -485,6 +512,33 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					g = g1;
 					b = b1;
 					a = a1;
+					if (useSpanKernels) {
+						int count = n + 1;
+						if (kEnableScissor) {
+							const int skip = scissorSpan(x, count);
+							z += (unsigned int)skip * dzdx;
+							r += (unsigned int)skip * drdx;
+							g += (unsigned int)skip * dgdx;
+							b += (unsigned int)skip * dbdx;
+							a += (unsigned int)skip * dadx;
+							pz += skip;
+							buf += skip;
+							n -= skip;
+							x += skip;
+						}
+						SpanState span = { z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx };
+						if (count > 0)
+							count = _spanKernels->drawSpan(spanParams, span, (uint32 *)pbuf.getRawBuffer(buf), pz, count, nullptr);
+						z = span.z;
+						r = span.r;
+						g = span.g;
+						b = span.b;
+						a = span.a;
+						pz += count;
+						buf += count;
+						n -= count;
+						x += count;
+					}
 					while (n >= 3) {
 						putPixelSmooth<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, pz, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 						putPixelSmooth<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, pz, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
@@ -536,9 +590,42 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 							fz += fndzdx;
 							zinv = (float)(1.0 / fz);
 						}
-						for (int _a = 0; _a < NB_INTERP; _a++) {
-							putPixelTextureMappingPerspective<kDepthWrite, kInterpRGB, kDrawLogic == DRAW_SMOOTH, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, texture, wrapS, wrapT,
-							                           pz, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+						if (useSpanKernels && (!kEnableScissor || (x >= _clipRectangle.left && x + NB_INTERP <= _clipRectangle.right))) {
+							// The texels are fetched first, as there is no vector gather,
+							// but only for the pixels which pass the depth test.
+							uint32 texels[NB_INTERP];
+							unsigned int zTexel = z;
+							bool visible = false;
+							for (int _a = 0; _a < NB_INTERP; _a++) {
+								if (compareDepth(zTexel, pz[_a])) {
+									uint8 c_a, c_r, c_g, c_b;
+									texture->getARGBAt(wrapS, wrapT, s, t, c_a, c_r, c_g, c_b);
+									texels[_a] = ((uint32)c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+									visible = true;
+								} else {
+									texels[_a] = 0;
+								}
+								zTexel += dzdx;
+								s += dsdx;
+								t += dtdx;
+							}
+							const bool smooth = kDrawLogic == DRAW_SMOOTH;
+							if (visible) {
+								SpanState span = { z, r, g, b, a, dzdx, smooth ? drdx : 0, smooth ? dgdx : 0, smooth ? dbdx : 0, smooth ? dadx : 0 };
+								_spanKernels->drawSpan(spanParams, span, (uint32 *)pbuf.getRawBuffer(buf), pz, NB_INTERP, texels);
+							}
+							z += NB_INTERP * dzdx;
+							if (smooth) {
+								a += NB_INTERP * dadx;
+								r += NB_INTERP * drdx;
+								g += NB_INTERP * dgdx;
+								b += NB_INTERP * dbdx;
+							}
+						} else {
+							for (int _a = 0; _a < NB_INTERP; _a++) {
+								putPixelTextureMappingPerspective<kDepthWrite, kInterpRGB, kDrawLogic == DRAW_SMOOTH, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, texture, wrapS, wrapT,
+								                           pz, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+							}
 						}
 						pz += NB_INTERP;
 						buf += NB_INTERP;
@@ -632,7 +719,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kDrawMode, bool kDepthWrite, bool kEnableAlphaTest>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
-	if (_enableScissor) {
+	// Only test every pixel against the scissor rectangle if it does not span
+	// the whole width, the scanlines outside of it are never drawn.
+	if (_enableScissor && (_clipRectangle.left > 0 || _clipRectangle.right < xsize)) {
 		fillTriangle<kInterpRGB, kInterpZ, kInterpST, kInterpSTZ, kDrawMode, kDepthWrite, kEnableAlphaTest, true>(p0, p1, p2);
 	} else {
 		fillTriangle<kInterpRGB, kInterpZ, kInterpST, kInterpSTZ, kDrawMode, kDepthWrite, kEnableAlphaTest, false>(p0, p1, p2);
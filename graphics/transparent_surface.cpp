@@ -33,6 +33,8 @@
 #include "common/rect.h"
 #include "common/math.h"
 #include "common/textconsole.h"
+#include "common/system.h"
+#include "graphics/blend_intern.h"
 #include "graphics/conversion.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
@@ -58,6 +60,25 @@ static const int kGIndex = 1;
 static const int kRIndex = 0;
 #endif
 
+const BlendKernels *getBlendKernels() {
+	// The kernels expect the alpha channel in the lowest byte of each pixel
+#ifdef SCUMM_LITTLE_ENDIAN
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return &blendKernelsAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &blendKernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &blendKernelsNEON;
+#endif
+#endif
+	return 0;
+}
+
 void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
@@ -87,14 +108,16 @@ TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Sur
  */
 void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
 
+	const BlendKernels *kernels = getBlendKernels();
 	byte *in;
 	byte *out;
 
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
+		uint32 j = kernels ? kernels->blitOpaque(out, in, width) : 0;
+		memcpy(out + j * 4, in + j * 4, (width - j) * 4);
+		for (out += j * 4; j < width; j++) {
 			out[kAIndex] = 0xFF;
 			out += 4;
 		}
@@ -108,13 +131,15 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  */
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
 
+	const BlendKernels *kernels = getBlendKernels();
 	byte *in;
 	byte *out;
 
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		for (uint32 j = 0; j < width; j++) {
+		uint32 j = kernels ? kernels->blitBinary(out, in, inStep, width) : 0;
+		for (in += (int32)j * inStep, out += j * 4; j < width; j++) {
 			uint32 pix = *(uint32 *)in;
 			int a = in[kAIndex];
 
@@ -142,6 +167,7 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	const BlendKernels *kernels = getBlendKernels();
 	byte *in;
 	byte *out;
 
@@ -150,7 +176,8 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = kernels ? kernels->blitAlphaBlend(out, in, inStep, width, color) : 0;
+			for (in += (int32)j * inStep, out += j * 4; j < width; j++) {
 
 				if (in[kAIndex] != 0) {
 					out[kAIndex] = 255;
@@ -175,7 +202,8 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 		for (uint32 i = 0; i < height; i++) {
 			out = outo;
 			in = ino;
-			for (uint32 j = 0; j < width; j++) {
+			uint32 j = kernels ? kernels->blitAlphaBlend(out, in, inStep, width, color) : 0;
+			for (in += (int32)j * inStep, out += j * 4; j < width; j++) {
 
 				uint32 ina = in[kAIndex] * ca >> 8;
 
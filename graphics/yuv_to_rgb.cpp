@@ -83,8 +83,12 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+#include "common/util.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -100,10 +104,12 @@ public:
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
 	const uint32 *getRGBToPix() const { return _rgbToPix; }
 	const uint32 *getAlphaToPix() const { return _alphaToPix; }
+	const YUVToRGBPlan &getPlan() const { return _plan; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
+	YUVToRGBPlan _plan;
 	uint32 _rgbToPix[3 * 768]; // 9216 bytes
 	uint32 _alphaToPix[256];   // 958 bytes
 };
@@ -164,11 +170,52 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	for (int i = 0; i < 256; i++) {
 		_alphaToPix[i] = format.ARGBToColor(i, 0, 0, 0);
 	}
+
+	_plan.init(format, scale == YUVToRGBManager::kScaleITU, alphaMode);
+}
+
+void YUVToRGBPlan::init(const PixelFormat &format, bool itu_, bool alphaMode) {
+	const uint8 losses[4] = { format.rLoss, format.gLoss, format.bLoss, format.aLoss };
+	const uint8 shifts[4] = { format.rShift, format.gShift, format.bShift, format.aShift };
+
+	bytesPerPixel = format.bytesPerPixel;
+	itu = itu_;
+	supported = true;
+
+	for (int i = 0; i < 4; i++) {
+		const int bits = 8 - losses[i];
+		loss[i] = losses[i];
+		lowShift[i] = shifts[i] < 16 ? shifts[i] : 16;
+		highShift[i] = shifts[i] >= 16 ? shifts[i] - 16 : 16;
+		if (bits > 0 && shifts[i] < 16 && shifts[i] + bits > 16)
+			supported = false;
+	}
+
+	const uint32 alpha = format.ARGBToColor(alphaMode ? 0 : 255, 0, 0, 0);
+	lowAlpha = alpha & 0xFFFF;
+	highAlpha = alpha >> 16;
+}
+
+const YUVToRGBKernels *getYUVToRGBKernels() {
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return &yuvToRGBKernelsAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return &yuvToRGBKernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return &yuvToRGBKernelsNEON;
+#endif
+	return 0;
 }
 
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 	_alphaMode = false;
+	_kernels = getYUVToRGBKernels();
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -208,7 +255,7 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const YUVToRGBKernels *kernels, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
@@ -217,24 +264,22 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const uint32 *rgbToPix = lookup->getRGBToPix();
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		int w = kernels ? kernels->convert444Row(dstPtr, ySrc, uSrc, vSrc, 0, yWidth, lookup->getPlan()) : 0;
+
+		for (; w < yWidth; w++) {
 			const uint32 *L;
 
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
+			int16 cr_r  = Cr_r_tab[vSrc[w]];
+			int16 crb_g = Cr_g_tab[vSrc[w]] + Cb_g_tab[uSrc[w]];
+			int16 cb_b  = Cb_b_tab[uSrc[w]];
 
-			PUT_PIXEL(*ySrc, dstPtr);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
+			PUT_PIXEL(ySrc[w], dstPtr + w * sizeof(PixelInt));
 		}
 
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
-		uSrc += uvPitch - yWidth;
-		vSrc += uvPitch - yWidth;
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
 	}
 }
 
@@ -246,17 +291,19 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	// The kernels leave formats they cannot handle to the lookup tables
+	const YUVToRGBKernels *kernels = lookup->getPlan().supported ? _kernels : 0;
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const YUVToRGBKernels *kernels, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
 
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
@@ -266,29 +313,30 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const uint32 *rgbToPix = lookup->getRGBToPix();
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const uint32 *L;
+		// Both rows share a row of chroma values
+		int w = kernels ? kernels->convert420Rows(dstPtr, dstPtr + dstPitch, ySrc, ySrc + yPitch, uSrc, vSrc, 0, 0, yWidth, lookup->getPlan()) : 0;
 
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
+		for (; w < yWidth; w += 2) {
+			const uint32 *L;
+			byte *d = dstPtr + w * sizeof(PixelInt);
+			const byte *y = ySrc + w;
+
+			int16 cr_r  = Cr_r_tab[vSrc[w >> 1]];
+			int16 crb_g = Cr_g_tab[vSrc[w >> 1]] + Cb_g_tab[uSrc[w >> 1]];
+			int16 cb_b  = Cb_b_tab[uSrc[w >> 1]];
+
+			PUT_PIXEL(*y, d);
+			PUT_PIXEL(*(y + yPitch), d + dstPitch);
+			y++;
+			d += sizeof(PixelInt);
+			PUT_PIXEL(*y, d);
+			PUT_PIXEL(*(y + yPitch), d + dstPitch);
 		}
 
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
 	}
 }
 
@@ -302,11 +350,13 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	const YUVToRGBKernels *kernels = lookup->getPlan().supported ? _kernels : 0;
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define PUT_PIXELA(s, a, d) \
@@ -314,9 +364,8 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b] | aToPix[a])
 
 template<typename PixelInt>
-void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const YUVToRGBKernels *kernels, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
 
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
@@ -327,32 +376,33 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *look
 	const uint32 *aToPix = lookup->getAlphaToPix();
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const uint32 *L;
+		// Both rows share a row of chroma values
+		int w = kernels ? kernels->convert420Rows(dstPtr, dstPtr + dstPitch, ySrc, ySrc + yPitch, uSrc, vSrc, aSrc, aSrc + yPitch, yWidth, lookup->getPlan()) : 0;
 
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXELA(*ySrc, *aSrc, dstPtr);
-			PUT_PIXELA(*(ySrc + yPitch), *(aSrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			aSrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXELA(*ySrc, *aSrc, dstPtr);
-			PUT_PIXELA(*(ySrc + yPitch), *(aSrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			aSrc++;
-			dstPtr += sizeof(PixelInt);
+		for (; w < yWidth; w += 2) {
+			const uint32 *L;
+			byte *d = dstPtr + w * sizeof(PixelInt);
+			const byte *y = ySrc + w;
+			const byte *a = aSrc + w;
+
+			int16 cr_r  = Cr_r_tab[vSrc[w >> 1]];
+			int16 crb_g = Cr_g_tab[vSrc[w >> 1]] + Cb_g_tab[uSrc[w >> 1]];
+			int16 cb_b  = Cb_b_tab[uSrc[w >> 1]];
+
+			PUT_PIXELA(*y, *a, d);
+			PUT_PIXELA(*(y + yPitch), *(a + yPitch), d + dstPitch);
+			y++;
+			a++;
+			d += sizeof(PixelInt);
+			PUT_PIXELA(*y, *a, d);
+			PUT_PIXELA(*(y + yPitch), *(a + yPitch), d + dstPitch);
 		}
 
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		aSrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		aSrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
 	}
 }
 
@@ -366,39 +416,17 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
 
+	const YUVToRGBKernels *kernels = lookup->getPlan().supported ? _kernels : 0;
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
-#define READ_QUAD(ptr, prefix) \
-	byte prefix##A = ptr[index]; \
-	byte prefix##B = ptr[index + 1]; \
-	byte prefix##C = ptr[index + uvPitch]; \
-	byte prefix##D = ptr[index + uvPitch + 1]
-
-#define DO_INTERPOLATION(out) \
-	out = (out##A * (4 - xDiff) * (4 - yDiff) + out##B * xDiff * (4 - yDiff) + \
-			out##C * yDiff * (4 - xDiff) + out##D * xDiff * yDiff) >> 4
-
-#define DO_YUV410_PIXEL() \
-	DO_INTERPOLATION(u); \
-	DO_INTERPOLATION(v); \
-	\
-	cr_r  = Cr_r_tab[v]; \
-	crb_g = Cr_g_tab[v] + Cb_g_tab[u]; \
-	cb_b  = Cb_b_tab[u]; \
-	\
-	PUT_PIXEL(*ySrc, dstPtr); \
-	dstPtr += sizeof(PixelInt); \
-	\
-	ySrc++; \
-	xDiff++
-
 template<typename PixelInt>
-void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const YUVToRGBKernels *kernels, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = colorTab;
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
@@ -406,41 +434,56 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
 
-	int quarterWidth = yWidth >> 2;
+	// The chroma values of a row are interpolated into these in chunks, and
+	// then converted like YUV444
+	const int chunkSize = 256;
+	byte uRow[chunkSize], vRow[chunkSize];
 
 	for (int y = 0; y < yHeight; y++) {
-		for (int x = 0; x < quarterWidth; x++) {
-			// Perform bilinear interpolation on the the chroma values
-			// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
-			// Feel free to optimize further
-			int targetY = y >> 2;
-			int xDiff = 0;
-			int yDiff = y & 3;
-			int index = targetY * uvPitch + x;
-
-			// Declare some variables for the following macros
-			byte u, v;
-			int16 cr_r, crb_g, cb_b;
-			const uint32 *L;
-
-			READ_QUAD(uSrc, u);
-			READ_QUAD(vSrc, v);
-
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
+		// Perform bilinear interpolation on the the chroma values
+		// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
+		const int yDiff = y & 3;
+		const byte *uTop = uSrc + (y >> 2) * uvPitch;
+		const byte *vTop = vSrc + (y >> 2) * uvPitch;
+
+		for (int x0 = 0; x0 < yWidth; x0 += chunkSize) {
+			const int width = MIN(chunkSize, yWidth - x0);
+
+			// Interpolate vertically first, then between the neighbouring
+			// columns for each group of four pixels
+			for (int x = 0; x < width; x += 4) {
+				const int index = (x0 + x) >> 2;
+				const int uLeft = uTop[index] * (4 - yDiff) + uTop[index + uvPitch] * yDiff;
+				const int uRight = uTop[index + 1] * (4 - yDiff) + uTop[index + uvPitch + 1] * yDiff;
+				const int vLeft = vTop[index] * (4 - yDiff) + vTop[index + uvPitch] * yDiff;
+				const int vRight = vTop[index + 1] * (4 - yDiff) + vTop[index + uvPitch + 1] * yDiff;
+
+				for (int xDiff = 0; xDiff < 4; xDiff++) {
+					uRow[x + xDiff] = (uLeft * (4 - xDiff) + uRight * xDiff) >> 4;
+					vRow[x + xDiff] = (vLeft * (4 - xDiff) + vRight * xDiff) >> 4;
+				}
+			}
+
+			byte *dst = dstPtr + x0 * sizeof(PixelInt);
+			const byte *yRow = ySrc + x0;
+			int w = kernels ? kernels->convert444Row(dst, yRow, uRow, vRow, 0, width, lookup->getPlan()) : 0;
+
+			for (; w < width; w++) {
+				const uint32 *L;
+
+				int16 cr_r  = Cr_r_tab[vRow[w]];
+				int16 crb_g = Cr_g_tab[vRow[w]] + Cb_g_tab[uRow[w]];
+				int16 cb_b  = Cb_b_tab[uRow[w]];
+
+				PUT_PIXEL(yRow[w], dst + w * sizeof(PixelInt));
+			}
 		}
 
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
+		dstPtr += dstPitch;
+		ySrc += yPitch;
 	}
 }
 
-#undef READ_QUAD
-#undef DO_INTERPOLATION
-#undef DO_YUV410_PIXEL
-
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -451,11 +494,13 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	const YUVToRGBKernels *kernels = lookup->getPlan().supported ? _kernels : 0;
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, kernels, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 } // End of namespace Graphics
@@ -45,6 +45,7 @@
 namespace Graphics {
 
 class YUVToRGBLookup;
+struct YUVToRGBKernels;
 
 class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
@@ -129,6 +130,7 @@ private:
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale, bool alphaMode = false);
 
 	YUVToRGBLookup *_lookup;
+	const YUVToRGBKernels *_kernels;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	bool _alphaMode;
 };
@@ -0,0 +1,209 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+struct PlanVectors {
+	__m128i loss[4];
+	__m128i lowShift[4];
+	__m128i highShift[4];
+	__m256i lowAlpha, highAlpha;
+};
+
+inline void initPlanVectors(PlanVectors &pv, const YUVToRGBPlan &plan) {
+	for (int i = 0; i < 4; i++) {
+		pv.loss[i] = _mm_cvtsi32_si128(plan.loss[i]);
+		pv.lowShift[i] = _mm_cvtsi32_si128(plan.lowShift[i]);
+		pv.highShift[i] = _mm_cvtsi32_si128(plan.highShift[i]);
+	}
+	pv.lowAlpha = _mm256_set1_epi16((int16)plan.lowAlpha);
+	pv.highAlpha = _mm256_set1_epi16((int16)plan.highAlpha);
+}
+
+inline __m256i load16(const byte *src) {
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+}
+
+/** Return trunc(c * k / 32768) for each 16-bit c in [-128, 128]. */
+inline __m256i mulTrunc(__m256i c, int k) {
+	const __m256i abs = _mm256_abs_epi16(c);
+	const __m256i product = _mm256_mulhi_epu16(_mm256_add_epi16(abs, abs), _mm256_set1_epi16((int16)k));
+	return _mm256_sign_epi16(product, c);
+}
+
+/** Compute the chroma contributions to the channels of 16 pixels. */
+inline void chromaDeltas(const byte *uSrc, const byte *vSrc, __m256i &dR, __m256i &dG, __m256i &dB) {
+	const __m256i bias = _mm256_set1_epi16(128);
+	const __m256i u = _mm256_sub_epi16(load16(uSrc), bias);
+	const __m256i v = _mm256_sub_epi16(load16(vSrc), bias);
+
+	dR = mulTrunc(v, kYUVVToR);
+	dG = _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_add_epi16(mulTrunc(v, kYUVVToG), mulTrunc(u, kYUVUToG)));
+	dB = mulTrunc(u, kYUVUToB);
+}
+
+template<bool kITU>
+inline __m256i channel(__m256i y, __m256i delta) {
+	const __m256i v = _mm256_add_epi16(y, delta);
+	if (!kITU)
+		return _mm256_min_epi16(_mm256_max_epi16(v, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+
+	__m256i scaled = _mm256_min_epi16(_mm256_max_epi16(v, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+	scaled = _mm256_sub_epi16(scaled, _mm256_set1_epi16(16));
+	return _mm256_mulhi_epu16(_mm256_add_epi16(scaled, scaled), _mm256_set1_epi16((int16)kYUVITUScale));
+}
+
+/** Convert and store 16 pixels, given their chroma contributions. */
+template<typename PixelInt, bool kITU, bool kAlpha>
+inline void convert16(byte *dst, const byte *ySrc, const byte *aSrc, __m256i dR, __m256i dG, __m256i dB, const PlanVectors &pv) {
+	const __m256i y = load16(ySrc);
+	const __m256i r = _mm256_srl_epi16(channel<kITU>(y, dR), pv.loss[YUVToRGBPlan::kRed]);
+	const __m256i g = _mm256_srl_epi16(channel<kITU>(y, dG), pv.loss[YUVToRGBPlan::kGreen]);
+	const __m256i b = _mm256_srl_epi16(channel<kITU>(y, dB), pv.loss[YUVToRGBPlan::kBlue]);
+
+	__m256i a = _mm256_setzero_si256();
+	if (kAlpha)
+		a = _mm256_srl_epi16(load16(aSrc), pv.loss[YUVToRGBPlan::kAlpha]);
+
+	__m256i low = _mm256_or_si256(_mm256_sll_epi16(r, pv.lowShift[YUVToRGBPlan::kRed]), _mm256_sll_epi16(g, pv.lowShift[YUVToRGBPlan::kGreen]));
+	low = _mm256_or_si256(low, _mm256_sll_epi16(b, pv.lowShift[YUVToRGBPlan::kBlue]));
+	low = _mm256_or_si256(low, kAlpha ? _mm256_sll_epi16(a, pv.lowShift[YUVToRGBPlan::kAlpha]) : pv.lowAlpha);
+
+	if (sizeof(PixelInt) == 2) {
+		_mm256_storeu_si256((__m256i *)dst, low);
+		return;
+	}
+
+	__m256i high = _mm256_or_si256(_mm256_sll_epi16(r, pv.highShift[YUVToRGBPlan::kRed]), _mm256_sll_epi16(g, pv.highShift[YUVToRGBPlan::kGreen]));
+	high = _mm256_or_si256(high, _mm256_sll_epi16(b, pv.highShift[YUVToRGBPlan::kBlue]));
+	high = _mm256_or_si256(high, kAlpha ? _mm256_sll_epi16(a, pv.highShift[YUVToRGBPlan::kAlpha]) : pv.highAlpha);
+
+	// The unpacks work within 128-bit lanes, so the pixels need reordering
+	const __m256i first = _mm256_unpacklo_epi16(low, high);
+	const __m256i second = _mm256_unpackhi_epi16(low, high);
+	_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(first, second, 0x20));
+	_mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+}
+
+/** Duplicate each 16-bit value, giving the values for the first and the last 16 pixels. */
+inline void duplicate(__m256i v, __m256i &first, __m256i &second) {
+	const __m256i lo = _mm256_unpacklo_epi16(v, v);
+	const __m256i hi = _mm256_unpackhi_epi16(v, v);
+	first = _mm256_permute2x128_si256(lo, hi, 0x20);
+	second = _mm256_permute2x128_si256(lo, hi, 0x31);
+}
+
+template<typename PixelInt, bool kITU, bool kAlpha>
+uint convert444Row(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                   uint width, const YUVToRGBPlan &plan) {
+	PlanVectors pv;
+	initPlanVectors(pv, plan);
+
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m256i dR, dG, dB;
+		chromaDeltas(uSrc + x, vSrc + x, dR, dG, dB);
+		convert16<PixelInt, kITU, kAlpha>(dst + x * sizeof(PixelInt), ySrc + x, kAlpha ? aSrc + x : 0, dR, dG, dB, pv);
+	}
+
+	return x;
+}
+
+template<typename PixelInt, bool kITU, bool kAlpha>
+uint convert420Rows(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                    const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	PlanVectors pv;
+	initPlanVectors(pv, plan);
+
+	uint x = 0;
+	for (; x + 32 <= width; x += 32) {
+		// Each chroma value covers two pixels of both rows
+		__m256i dR, dG, dB;
+		chromaDeltas(uSrc + x / 2, vSrc + x / 2, dR, dG, dB);
+		__m256i dRLo, dRHi, dGLo, dGHi, dBLo, dBHi;
+		duplicate(dR, dRLo, dRHi);
+		duplicate(dG, dGLo, dGHi);
+		duplicate(dB, dBLo, dBHi);
+
+		byte *d0 = dst0 + x * sizeof(PixelInt);
+		byte *d1 = dst1 + x * sizeof(PixelInt);
+		convert16<PixelInt, kITU, kAlpha>(d0, ySrc0 + x, kAlpha ? aSrc0 + x : 0, dRLo, dGLo, dBLo, pv);
+		convert16<PixelInt, kITU, kAlpha>(d0 + 16 * sizeof(PixelInt), ySrc0 + x + 16, kAlpha ? aSrc0 + x + 16 : 0, dRHi, dGHi, dBHi, pv);
+		convert16<PixelInt, kITU, kAlpha>(d1, ySrc1 + x, kAlpha ? aSrc1 + x : 0, dRLo, dGLo, dBLo, pv);
+		convert16<PixelInt, kITU, kAlpha>(d1 + 16 * sizeof(PixelInt), ySrc1 + x + 16, kAlpha ? aSrc1 + x + 16 : 0, dRHi, dGHi, dBHi, pv);
+	}
+
+	return x;
+}
+
+template<typename PixelInt>
+uint convert444RowFormat(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                         uint width, const YUVToRGBPlan &plan) {
+	if (plan.itu)
+		return aSrc ? convert444Row<PixelInt, true, true>(dst, ySrc, uSrc, vSrc, aSrc, width, plan)
+		            : convert444Row<PixelInt, true, false>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+	else
+		return aSrc ? convert444Row<PixelInt, false, true>(dst, ySrc, uSrc, vSrc, aSrc, width, plan)
+		            : convert444Row<PixelInt, false, false>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+}
+
+template<typename PixelInt>
+uint convert420RowsFormat(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                          const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	if (plan.itu)
+		return aSrc0 ? convert420Rows<PixelInt, true, true>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan)
+		             : convert420Rows<PixelInt, true, false>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+	else
+		return aSrc0 ? convert420Rows<PixelInt, false, true>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan)
+		             : convert420Rows<PixelInt, false, false>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+}
+
+uint convert444RowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                       uint width, const YUVToRGBPlan &plan) {
+	if (plan.bytesPerPixel == 2)
+		return convert444RowFormat<uint16>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+	else
+		return convert444RowFormat<uint32>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+}
+
+uint convert420RowsAVX2(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                        const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	if (plan.bytesPerPixel == 2)
+		return convert420RowsFormat<uint16>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+	else
+		return convert420RowsFormat<uint32>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+}
+
+} // End of anonymous namespace
+
+const YUVToRGBKernels yuvToRGBKernelsAVX2 = {
+	convert444RowAVX2,
+	convert420RowsAVX2
+};
+
+} // End of namespace Graphics
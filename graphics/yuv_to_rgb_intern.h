@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+struct PixelFormat;
+
+/**
+ * Factors of the chroma contributions in YUVToRGBManager's color tables, in
+ * 1.15 fixed point. For any chroma value c - 128, the tables hold
+ * trunc(c * factor), which the kernels get exactly as
+ * sign(c) * ((2 * |c| * k) >> 16) with these constants.
+ */
+enum {
+	kYUVVToR = 45919, // 0.419 / 0.299
+	kYUVVToG = 23383, // 0.299 / 0.419
+	kYUVUToG = 11285, // 0.114 / 0.331
+	kYUVUToB = 58111, // 0.587 / 0.331
+	// ((2 * (v - 16)) * k) >> 16 equals (v - 16) * 255 / 219 for 16 <= v <= 235
+	kYUVITUScale = 38155
+};
+
+/**
+ * Describes how the kernels turn a luminance and chroma triplet into a
+ * destination pixel:
+ *
+ *   v = clamp(y + delta, 0, 255)                      for kScaleFull
+ *   v = (clamp(y + delta, 16, 235) - 16) * 255 / 219   for kScaleITU
+ *   dst = (r >> rLoss) << rShift | (g >> gLoss) << gShift
+ *       | (b >> bLoss) << bShift | alpha
+ *
+ * where alpha is the alpha of the lookup tables, or (a >> aLoss) << aShift
+ * if the alpha values are taken from a plane. This gives the same result as
+ * the lookup tables of the scalar code.
+ *
+ * The kernels work on 16-bit lanes, so pixels are assembled from their low
+ * and high 16 bits separately. A shift of 16 moves a channel out of a half.
+ */
+struct YUVToRGBPlan {
+	enum {
+		kRed = 0,
+		kGreen = 1,
+		kBlue = 2,
+		kAlpha = 3
+	};
+
+	uint bytesPerPixel;
+	bool itu;
+	/** False if a channel straddles both halves of the pixel. */
+	bool supported;
+	uint16 loss[4];
+	uint16 lowShift[4];
+	uint16 highShift[4];
+	uint16 lowAlpha, highAlpha;
+
+	void init(const PixelFormat &format, bool itu, bool alphaMode);
+};
+
+/**
+ * SIMD versions of the inner loops of YUVToRGBManager.
+ *
+ * Each function handles one row of YUV444, or two rows of YUV420 sharing a
+ * row of chroma values, so that the chroma contributions are computed only
+ * once. @p aSrc may be nullptr, in which case the alpha of the plan is used.
+ * The functions may leave some pixels at the end of the rows, and return
+ * the number of pixels they handled per row.
+ */
+struct YUVToRGBKernels {
+	uint (*convert444Row)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+	                      uint width, const YUVToRGBPlan &plan);
+	uint (*convert420Rows)(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+	                       const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan);
+};
+
+/** Return the kernels for the CPU we are running on, or 0 if there are none. */
+const YUVToRGBKernels *getYUVToRGBKernels();
+
+#ifdef SCUMMVM_SSE2
+extern const YUVToRGBKernels yuvToRGBKernelsSSE2;
+#endif
+
+#ifdef SCUMMVM_AVX2
+extern const YUVToRGBKernels yuvToRGBKernelsAVX2;
+#endif
+
+#ifdef SCUMMVM_NEON
+extern const YUVToRGBKernels yuvToRGBKernelsNEON;
+#endif
+
+} // End of namespace Graphics
+
+#endif
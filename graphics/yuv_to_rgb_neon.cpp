@@ -0,0 +1,206 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+struct PlanVectors {
+	// Negative counts shift to the right
+	int16x8_t loss[4];
+	int16x8_t lowShift[4];
+	int16x8_t highShift[4];
+	uint16x8_t lowAlpha, highAlpha;
+};
+
+inline void initPlanVectors(PlanVectors &pv, const YUVToRGBPlan &plan) {
+	for (int i = 0; i < 4; i++) {
+		pv.loss[i] = vdupq_n_s16(-(int16)plan.loss[i]);
+		pv.lowShift[i] = vdupq_n_s16(plan.lowShift[i]);
+		pv.highShift[i] = vdupq_n_s16(plan.highShift[i]);
+	}
+	pv.lowAlpha = vdupq_n_u16(plan.lowAlpha);
+	pv.highAlpha = vdupq_n_u16(plan.highAlpha);
+}
+
+inline int16x8_t load8(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+/** Return (a * k) >> 16 for unsigned 16-bit values. */
+inline uint16x8_t mulHigh(uint16x8_t a, uint16 k) {
+	const uint32x4_t lo = vmull_n_u16(vget_low_u16(a), k);
+	const uint32x4_t hi = vmull_n_u16(vget_high_u16(a), k);
+	return vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16));
+}
+
+/** Return trunc(c * k / 32768) for each 16-bit c in [-128, 128]. */
+inline int16x8_t mulTrunc(int16x8_t c, uint16 k) {
+	const int16x8_t abs = vabsq_s16(c);
+	const int16x8_t product = vreinterpretq_s16_u16(mulHigh(vreinterpretq_u16_s16(vaddq_s16(abs, abs)), k));
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(product), product);
+}
+
+/** Compute the chroma contributions to the channels of 8 pixels. */
+inline void chromaDeltas(const byte *uSrc, const byte *vSrc, int16x8_t &dR, int16x8_t &dG, int16x8_t &dB) {
+	const int16x8_t bias = vdupq_n_s16(128);
+	const int16x8_t u = vsubq_s16(load8(uSrc), bias);
+	const int16x8_t v = vsubq_s16(load8(vSrc), bias);
+
+	dR = mulTrunc(v, kYUVVToR);
+	dG = vnegq_s16(vaddq_s16(mulTrunc(v, kYUVVToG), mulTrunc(u, kYUVUToG)));
+	dB = mulTrunc(u, kYUVUToB);
+}
+
+template<bool kITU>
+inline uint16x8_t channel(int16x8_t y, int16x8_t delta) {
+	const int16x8_t v = vaddq_s16(y, delta);
+	if (!kITU)
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(v, vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+	int16x8_t scaled = vminq_s16(vmaxq_s16(v, vdupq_n_s16(16)), vdupq_n_s16(235));
+	scaled = vsubq_s16(scaled, vdupq_n_s16(16));
+	return mulHigh(vreinterpretq_u16_s16(vaddq_s16(scaled, scaled)), kYUVITUScale);
+}
+
+/** Convert and store 8 pixels, given their chroma contributions. */
+template<typename PixelInt, bool kITU, bool kAlpha>
+inline void convert8(byte *dst, const byte *ySrc, const byte *aSrc, int16x8_t dR, int16x8_t dG, int16x8_t dB, const PlanVectors &pv) {
+	const int16x8_t y = load8(ySrc);
+	const uint16x8_t r = vshlq_u16(channel<kITU>(y, dR), pv.loss[YUVToRGBPlan::kRed]);
+	const uint16x8_t g = vshlq_u16(channel<kITU>(y, dG), pv.loss[YUVToRGBPlan::kGreen]);
+	const uint16x8_t b = vshlq_u16(channel<kITU>(y, dB), pv.loss[YUVToRGBPlan::kBlue]);
+
+	uint16x8_t a = vdupq_n_u16(0);
+	if (kAlpha)
+		a = vshlq_u16(vmovl_u8(vld1_u8(aSrc)), pv.loss[YUVToRGBPlan::kAlpha]);
+
+	uint16x8_t low = vorrq_u16(vshlq_u16(r, pv.lowShift[YUVToRGBPlan::kRed]), vshlq_u16(g, pv.lowShift[YUVToRGBPlan::kGreen]));
+	low = vorrq_u16(low, vshlq_u16(b, pv.lowShift[YUVToRGBPlan::kBlue]));
+	low = vorrq_u16(low, kAlpha ? vshlq_u16(a, pv.lowShift[YUVToRGBPlan::kAlpha]) : pv.lowAlpha);
+
+	if (sizeof(PixelInt) == 2) {
+		vst1q_u16((uint16 *)dst, low);
+		return;
+	}
+
+	uint16x8_t high = vorrq_u16(vshlq_u16(r, pv.highShift[YUVToRGBPlan::kRed]), vshlq_u16(g, pv.highShift[YUVToRGBPlan::kGreen]));
+	high = vorrq_u16(high, vshlq_u16(b, pv.highShift[YUVToRGBPlan::kBlue]));
+	high = vorrq_u16(high, kAlpha ? vshlq_u16(a, pv.highShift[YUVToRGBPlan::kAlpha]) : pv.highAlpha);
+
+	const uint16x8x2_t pixels = vzipq_u16(low, high);
+	vst1q_u16((uint16 *)dst, pixels.val[0]);
+	vst1q_u16((uint16 *)(dst + 16), pixels.val[1]);
+}
+
+template<typename PixelInt, bool kITU, bool kAlpha>
+uint convert444Row(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                   uint width, const YUVToRGBPlan &plan) {
+	PlanVectors pv;
+	initPlanVectors(pv, plan);
+
+	uint x = 0;
+	for (; x + 8 <= width; x += 8) {
+		int16x8_t dR, dG, dB;
+		chromaDeltas(uSrc + x, vSrc + x, dR, dG, dB);
+		convert8<PixelInt, kITU, kAlpha>(dst + x * sizeof(PixelInt), ySrc + x, kAlpha ? aSrc + x : 0, dR, dG, dB, pv);
+	}
+
+	return x;
+}
+
+template<typename PixelInt, bool kITU, bool kAlpha>
+uint convert420Rows(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                    const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	PlanVectors pv;
+	initPlanVectors(pv, plan);
+
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		// Each chroma value covers two pixels of both rows
+		int16x8_t dR, dG, dB;
+		chromaDeltas(uSrc + x / 2, vSrc + x / 2, dR, dG, dB);
+		const int16x8x2_t r = vzipq_s16(dR, dR);
+		const int16x8x2_t g = vzipq_s16(dG, dG);
+		const int16x8x2_t b = vzipq_s16(dB, dB);
+
+		byte *d0 = dst0 + x * sizeof(PixelInt);
+		byte *d1 = dst1 + x * sizeof(PixelInt);
+		convert8<PixelInt, kITU, kAlpha>(d0, ySrc0 + x, kAlpha ? aSrc0 + x : 0, r.val[0], g.val[0], b.val[0], pv);
+		convert8<PixelInt, kITU, kAlpha>(d0 + 8 * sizeof(PixelInt), ySrc0 + x + 8, kAlpha ? aSrc0 + x + 8 : 0, r.val[1], g.val[1], b.val[1], pv);
+		convert8<PixelInt, kITU, kAlpha>(d1, ySrc1 + x, kAlpha ? aSrc1 + x : 0, r.val[0], g.val[0], b.val[0], pv);
+		convert8<PixelInt, kITU, kAlpha>(d1 + 8 * sizeof(PixelInt), ySrc1 + x + 8, kAlpha ? aSrc1 + x + 8 : 0, r.val[1], g.val[1], b.val[1], pv);
+	}
+
+	return x;
+}
+
+template<typename PixelInt>
+uint convert444RowFormat(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                         uint width, const YUVToRGBPlan &plan) {
+	if (plan.itu)
+		return aSrc ? convert444Row<PixelInt, true, true>(dst, ySrc, uSrc, vSrc, aSrc, width, plan)
+		            : convert444Row<PixelInt, true, false>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+	else
+		return aSrc ? convert444Row<PixelInt, false, true>(dst, ySrc, uSrc, vSrc, aSrc, width, plan)
+		            : convert444Row<PixelInt, false, false>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+}
+
+template<typename PixelInt>
+uint convert420RowsFormat(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                          const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	if (plan.itu)
+		return aSrc0 ? convert420Rows<PixelInt, true, true>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan)
+		             : convert420Rows<PixelInt, true, false>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+	else
+		return aSrc0 ? convert420Rows<PixelInt, false, true>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan)
+		             : convert420Rows<PixelInt, false, false>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+}
+
+uint convert444RowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                       uint width, const YUVToRGBPlan &plan) {
+	if (plan.bytesPerPixel == 2)
+		return convert444RowFormat<uint16>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+	else
+		return convert444RowFormat<uint32>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+}
+
+uint convert420RowsNEON(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                        const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	if (plan.bytesPerPixel == 2)
+		return convert420RowsFormat<uint16>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+	else
+		return convert420RowsFormat<uint32>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+}
+
+} // End of anonymous namespace
+
+const YUVToRGBKernels yuvToRGBKernelsNEON = {
+	convert444RowNEON,
+	convert420RowsNEON
+};
+
+} // End of namespace Graphics
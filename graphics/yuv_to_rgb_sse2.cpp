@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+struct PlanVectors {
+	__m128i loss[4];
+	__m128i lowShift[4];
+	__m128i highShift[4];
+	__m128i lowAlpha, highAlpha;
+};
+
+inline void initPlanVectors(PlanVectors &pv, const YUVToRGBPlan &plan) {
+	for (int i = 0; i < 4; i++) {
+		pv.loss[i] = _mm_cvtsi32_si128(plan.loss[i]);
+		pv.lowShift[i] = _mm_cvtsi32_si128(plan.lowShift[i]);
+		pv.highShift[i] = _mm_cvtsi32_si128(plan.highShift[i]);
+	}
+	pv.lowAlpha = _mm_set1_epi16((int16)plan.lowAlpha);
+	pv.highAlpha = _mm_set1_epi16((int16)plan.highAlpha);
+}
+
+/** Return trunc(c * k / 32768) for each 16-bit c in [-128, 128]. */
+inline __m128i mulTrunc(__m128i c, int k) {
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i abs = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	const __m128i product = _mm_mulhi_epu16(_mm_add_epi16(abs, abs), _mm_set1_epi16((int16)k));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+/** Compute the chroma contributions to the channels of 8 pixels. */
+inline void chromaDeltas(const byte *uSrc, const byte *vSrc, __m128i &dR, __m128i &dG, __m128i &dB) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)uSrc), zero), bias);
+	const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)vSrc), zero), bias);
+
+	dR = mulTrunc(v, kYUVVToR);
+	dG = _mm_sub_epi16(zero, _mm_add_epi16(mulTrunc(v, kYUVVToG), mulTrunc(u, kYUVUToG)));
+	dB = mulTrunc(u, kYUVUToB);
+}
+
+template<bool kITU>
+inline __m128i channel(__m128i y, __m128i delta) {
+	const __m128i v = _mm_add_epi16(y, delta);
+	if (!kITU)
+		return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(255));
+
+	__m128i scaled = _mm_min_epi16(_mm_max_epi16(v, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+	scaled = _mm_sub_epi16(scaled, _mm_set1_epi16(16));
+	return _mm_mulhi_epu16(_mm_add_epi16(scaled, scaled), _mm_set1_epi16((int16)kYUVITUScale));
+}
+
+/** Convert and store 8 pixels, given their chroma contributions. */
+template<typename PixelInt, bool kITU, bool kAlpha>
+inline void convert8(byte *dst, const byte *ySrc, const byte *aSrc, __m128i dR, __m128i dG, __m128i dB, const PlanVectors &pv) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ySrc), zero);
+	const __m128i r = _mm_srl_epi16(channel<kITU>(y, dR), pv.loss[YUVToRGBPlan::kRed]);
+	const __m128i g = _mm_srl_epi16(channel<kITU>(y, dG), pv.loss[YUVToRGBPlan::kGreen]);
+	const __m128i b = _mm_srl_epi16(channel<kITU>(y, dB), pv.loss[YUVToRGBPlan::kBlue]);
+
+	__m128i a = zero;
+	if (kAlpha)
+		a = _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)aSrc), zero), pv.loss[YUVToRGBPlan::kAlpha]);
+
+	__m128i low = _mm_or_si128(_mm_sll_epi16(r, pv.lowShift[YUVToRGBPlan::kRed]), _mm_sll_epi16(g, pv.lowShift[YUVToRGBPlan::kGreen]));
+	low = _mm_or_si128(low, _mm_sll_epi16(b, pv.lowShift[YUVToRGBPlan::kBlue]));
+	low = _mm_or_si128(low, kAlpha ? _mm_sll_epi16(a, pv.lowShift[YUVToRGBPlan::kAlpha]) : pv.lowAlpha);
+
+	if (sizeof(PixelInt) == 2) {
+		_mm_storeu_si128((__m128i *)dst, low);
+		return;
+	}
+
+	__m128i high = _mm_or_si128(_mm_sll_epi16(r, pv.highShift[YUVToRGBPlan::kRed]), _mm_sll_epi16(g, pv.highShift[YUVToRGBPlan::kGreen]));
+	high = _mm_or_si128(high, _mm_sll_epi16(b, pv.highShift[YUVToRGBPlan::kBlue]));
+	high = _mm_or_si128(high, kAlpha ? _mm_sll_epi16(a, pv.highShift[YUVToRGBPlan::kAlpha]) : pv.highAlpha);
+
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+	_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(low, high));
+}
+
+template<typename PixelInt, bool kITU, bool kAlpha>
+uint convert444Row(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                   uint width, const YUVToRGBPlan &plan) {
+	PlanVectors pv;
+	initPlanVectors(pv, plan);
+
+	uint x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i dR, dG, dB;
+		chromaDeltas(uSrc + x, vSrc + x, dR, dG, dB);
+		convert8<PixelInt, kITU, kAlpha>(dst + x * sizeof(PixelInt), ySrc + x, kAlpha ? aSrc + x : 0, dR, dG, dB, pv);
+	}
+
+	return x;
+}
+
+template<typename PixelInt, bool kITU, bool kAlpha>
+uint convert420Rows(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                    const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	PlanVectors pv;
+	initPlanVectors(pv, plan);
+
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		// Each chroma value covers two pixels of both rows
+		__m128i dR, dG, dB;
+		chromaDeltas(uSrc + x / 2, vSrc + x / 2, dR, dG, dB);
+		const __m128i dRLo = _mm_unpacklo_epi16(dR, dR), dRHi = _mm_unpackhi_epi16(dR, dR);
+		const __m128i dGLo = _mm_unpacklo_epi16(dG, dG), dGHi = _mm_unpackhi_epi16(dG, dG);
+		const __m128i dBLo = _mm_unpacklo_epi16(dB, dB), dBHi = _mm_unpackhi_epi16(dB, dB);
+
+		byte *d0 = dst0 + x * sizeof(PixelInt);
+		byte *d1 = dst1 + x * sizeof(PixelInt);
+		convert8<PixelInt, kITU, kAlpha>(d0, ySrc0 + x, kAlpha ? aSrc0 + x : 0, dRLo, dGLo, dBLo, pv);
+		convert8<PixelInt, kITU, kAlpha>(d0 + 8 * sizeof(PixelInt), ySrc0 + x + 8, kAlpha ? aSrc0 + x + 8 : 0, dRHi, dGHi, dBHi, pv);
+		convert8<PixelInt, kITU, kAlpha>(d1, ySrc1 + x, kAlpha ? aSrc1 + x : 0, dRLo, dGLo, dBLo, pv);
+		convert8<PixelInt, kITU, kAlpha>(d1 + 8 * sizeof(PixelInt), ySrc1 + x + 8, kAlpha ? aSrc1 + x + 8 : 0, dRHi, dGHi, dBHi, pv);
+	}
+
+	return x;
+}
+
+template<typename PixelInt>
+uint convert444RowFormat(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                         uint width, const YUVToRGBPlan &plan) {
+	if (plan.itu)
+		return aSrc ? convert444Row<PixelInt, true, true>(dst, ySrc, uSrc, vSrc, aSrc, width, plan)
+		            : convert444Row<PixelInt, true, false>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+	else
+		return aSrc ? convert444Row<PixelInt, false, true>(dst, ySrc, uSrc, vSrc, aSrc, width, plan)
+		            : convert444Row<PixelInt, false, false>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+}
+
+template<typename PixelInt>
+uint convert420RowsFormat(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                          const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	if (plan.itu)
+		return aSrc0 ? convert420Rows<PixelInt, true, true>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan)
+		             : convert420Rows<PixelInt, true, false>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+	else
+		return aSrc0 ? convert420Rows<PixelInt, false, true>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan)
+		             : convert420Rows<PixelInt, false, false>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+}
+
+uint convert444RowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                       uint width, const YUVToRGBPlan &plan) {
+	if (plan.bytesPerPixel == 2)
+		return convert444RowFormat<uint16>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+	else
+		return convert444RowFormat<uint32>(dst, ySrc, uSrc, vSrc, aSrc, width, plan);
+}
+
+uint convert420RowsSSE2(byte *dst0, byte *dst1, const byte *ySrc0, const byte *ySrc1, const byte *uSrc, const byte *vSrc,
+                        const byte *aSrc0, const byte *aSrc1, uint width, const YUVToRGBPlan &plan) {
+	if (plan.bytesPerPixel == 2)
+		return convert420RowsFormat<uint16>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+	else
+		return convert420RowsFormat<uint32>(dst0, dst1, ySrc0, ySrc1, uSrc, vSrc, aSrc0, aSrc1, width, plan);
+}
+
+} // End of anonymous namespace
+
+const YUVToRGBKernels yuvToRGBKernelsSSE2 = {
+	convert444RowSSE2,
+	convert420RowsSSE2
+};
+
+} // End of namespace Graphics
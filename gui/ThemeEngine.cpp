@@ -89,6 +89,13 @@ struct WidgetDrawData {
 
 	DrawLayer _layer;
 
+	/**
+	 * Whether drawings of this item may be kept in the DrawData cache. Items
+	 * filling the whole surface or blitting bitmaps may draw outside of
+	 * their extended area.
+	 */
+	bool _cacheable;
+
 
 	/**
 	 * Calculates the background threshold offset of a given DrawData item.
@@ -100,6 +107,194 @@ struct WidgetDrawData {
 	void calcBackgroundOffset();
 };
 
+/**
+ * What a drawing of a DrawData item depends on, besides the pixels below.
+ * All steps of an item draw the same pixels as long as the size of the
+ * area, the colors they do not set themselves and the pixels below are the
+ * same. Gradients are dithered by column, so the parity of the position
+ * counts as well.
+ */
+struct DrawDataCacheKey {
+	DrawData _type;
+	uint32 _dynamic;
+	int16 _width, _height;
+	bool _oddX, _oddY;
+	/** Area the drawing covers, relative to the top left corner of the item. */
+	Common::Rect _rect;
+	Graphics::VectorRenderer::ColorState _colors;
+
+	bool operator==(const DrawDataCacheKey &key) const {
+		return _type == key._type && _dynamic == key._dynamic && _width == key._width && _height == key._height &&
+		       _oddX == key._oddX && _oddY == key._oddY && _rect == key._rect && _colors == key._colors;
+	}
+};
+
+struct DrawDataCacheKey_Hash {
+	uint operator()(const DrawDataCacheKey &key) const {
+		uint hash = key._type;
+		hash = hash * 31 + key._dynamic;
+		hash = hash * 31 + ((uint)key._width << 16 | (uint16)key._height);
+		hash = hash * 31 + (key._oddX << 1 | key._oddY);
+		hash = hash * 31 + ((uint)key._rect.left << 16 | (uint16)key._rect.top);
+		hash = hash * 31 + ((uint)key._rect.right << 16 | (uint16)key._rect.bottom);
+		hash = hash * 31 + key._colors.fg;
+		hash = hash * 31 + key._colors.bg;
+		return hash;
+	}
+};
+
+/** A drawing of a DrawData item, for drawing it again with a copy. */
+struct DrawDataCacheEntry {
+	DrawDataCacheKey _key;
+
+	/** Pixels of _key._rect before and after drawing. */
+	Graphics::Surface _background;
+	Graphics::Surface _drawing;
+
+	/** The next drawing with the same key, over other pixels. */
+	DrawDataCacheEntry *_nextWithKey;
+	/** Neighbors in the list of drawings, from the least to the most recently used one. */
+	DrawDataCacheEntry *_lruPrev, *_lruNext;
+
+	~DrawDataCacheEntry() {
+		_background.free();
+		_drawing.free();
+	}
+
+	uint32 size() const {
+		return _background.pitch * _background.h + _drawing.pitch * _drawing.h;
+	}
+};
+
+/** Maximum size of the pixels kept in the DrawData cache, in bytes. */
+static const uint32 kDrawDataCacheSize = 4 * 1024 * 1024;
+/** Maximum number of drawings kept in the DrawData cache. */
+static const uint kDrawDataCacheEntries = 256;
+
+/**
+ * The drawings of DrawData items, looked up by their key and dropped once
+ * they were not used for the longest time.
+ */
+class DrawDataCache {
+public:
+	DrawDataCache() : _lruFirst(nullptr), _lruLast(nullptr), _size(0), _count(0) {}
+	~DrawDataCache() { clear(); }
+
+	/**
+	 * Return the drawing with @p key made over the same pixels as the ones
+	 * of @p rect on @p surface, or 0 if there is none.
+	 */
+	DrawDataCacheEntry *find(const DrawDataCacheKey &key, const Graphics::Surface &surface, const Common::Rect &rect);
+
+	/** Add a drawing, dropping the least recently used ones to make room. */
+	void insert(DrawDataCacheEntry *entry);
+
+	void clear();
+
+private:
+	void lruUnlink(DrawDataCacheEntry *entry);
+	void lruAppend(DrawDataCacheEntry *entry);
+	void remove(DrawDataCacheEntry *entry);
+
+	typedef Common::HashMap<DrawDataCacheKey, DrawDataCacheEntry *, DrawDataCacheKey_Hash> EntryMap;
+
+	/** The first drawing for each key, the others are chained to it. */
+	EntryMap _entries;
+	DrawDataCacheEntry *_lruFirst, *_lruLast;
+	uint32 _size; ///< Size of the cached drawings in bytes
+	uint _count;  ///< Number of cached drawings
+};
+
+DrawDataCacheEntry *DrawDataCache::find(const DrawDataCacheKey &key, const Graphics::Surface &surface, const Common::Rect &rect) {
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end())
+		return nullptr;
+
+	const uint rowSize = rect.width() * surface.format.bytesPerPixel;
+	for (DrawDataCacheEntry *entry = i->_value; entry; entry = entry->_nextWithKey) {
+		int y = 0;
+		for (; y < rect.height(); ++y) {
+			if (memcmp(surface.getBasePtr(rect.left, rect.top + y), entry->_background.getBasePtr(0, y), rowSize))
+				break;
+		}
+
+		if (y == rect.height()) {
+			lruUnlink(entry);
+			lruAppend(entry);
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+void DrawDataCache::insert(DrawDataCacheEntry *entry) {
+	while (_lruFirst && (_size + entry->size() > kDrawDataCacheSize || _count >= kDrawDataCacheEntries))
+		remove(_lruFirst);
+
+	EntryMap::iterator i = _entries.find(entry->_key);
+	if (i != _entries.end()) {
+		entry->_nextWithKey = i->_value;
+		i->_value = entry;
+	} else {
+		entry->_nextWithKey = nullptr;
+		_entries[entry->_key] = entry;
+	}
+
+	lruAppend(entry);
+	_size += entry->size();
+	_count++;
+}
+
+void DrawDataCache::clear() {
+	while (_lruFirst)
+		remove(_lruFirst);
+}
+
+void DrawDataCache::lruUnlink(DrawDataCacheEntry *entry) {
+	if (entry->_lruPrev)
+		entry->_lruPrev->_lruNext = entry->_lruNext;
+	else
+		_lruFirst = entry->_lruNext;
+
+	if (entry->_lruNext)
+		entry->_lruNext->_lruPrev = entry->_lruPrev;
+	else
+		_lruLast = entry->_lruPrev;
+}
+
+void DrawDataCache::lruAppend(DrawDataCacheEntry *entry) {
+	entry->_lruPrev = _lruLast;
+	entry->_lruNext = nullptr;
+	if (_lruLast)
+		_lruLast->_lruNext = entry;
+	else
+		_lruFirst = entry;
+	_lruLast = entry;
+}
+
+void DrawDataCache::remove(DrawDataCacheEntry *entry) {
+	EntryMap::iterator i = _entries.find(entry->_key);
+	assert(i != _entries.end());
+
+	if (i->_value == entry) {
+		if (entry->_nextWithKey)
+			i->_value = entry->_nextWithKey;
+		else
+			_entries.erase(i);
+	} else {
+		DrawDataCacheEntry *prev = i->_value;
+		while (prev->_nextWithKey != entry)
+			prev = prev->_nextWithKey;
+		prev->_nextWithKey = entry->_nextWithKey;
+	}
+
+	lruUnlink(entry);
+	_size -= entry->size();
+	_count--;
+	delete entry;
+}
+
 /**********************************************************
  *  Data definitions for theme engine elements
  *********************************************************/
@@ -189,7 +384,8 @@ static const DrawDataInfo kDrawDataDefaults[] = {
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(nullptr), _vectorRenderer(nullptr),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
+	_font(nullptr), _drawDataCache(new DrawDataCache()),
+	_initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(nullptr) {
 
 	_system = g_system;
@@ -244,6 +440,7 @@ ThemeEngine::~ThemeEngine() {
 
 	unloadTheme();
 	unloadExtraFont();
+	delete _drawDataCache;
 
 	// Release all graphics surfaces
 	for (ImagesMap::iterator i = _bitmaps.begin(); i != _bitmaps.end(); ++i) {
@@ -467,6 +664,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
 
+	// The cached drawings are for the old pixel format and scale
+	clearDrawDataCache();
+
 	// Since we reinitialized our screen surfaces we know nothing has been
 	// drawn so far. Sometimes we still end up with dirty screen bits in the
 	// list. Clearing it avoids invalid overlay writes when the backend
@@ -476,6 +676,7 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 
 void WidgetDrawData::calcBackgroundOffset() {
 	uint maxShadow = 0, maxBevel = 0;
+	_cacheable = true;
 	for (Common::List<Graphics::DrawStep>::const_iterator step = _steps.begin();
 	        step != _steps.end(); ++step) {
 		if ((step->autoWidth || step->autoHeight) && step->shadow > maxShadow)
@@ -483,6 +684,11 @@ void WidgetDrawData::calcBackgroundOffset() {
 
 		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_BEVELSQ && step->bevel > maxBevel)
 			maxBevel = step->bevel;
+
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE ||
+		    step->drawingCall == &Graphics::VectorRenderer::drawCallback_BITMAP ||
+		    step->drawingCall == &Graphics::VectorRenderer::drawCallback_ALPHABITMAP)
+			_cacheable = false;
 	}
 
 	_backgroundOffset = maxBevel;
@@ -845,6 +1051,8 @@ void ThemeEngine::unloadTheme() {
 
 	_themeEval->reset();
 	_themeOk = false;
+
+	clearDrawDataCache();
 }
 
 void ThemeEngine::unloadExtraFont() {
@@ -984,15 +1192,92 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
-			_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+		if (!drawCachedDD(type, area, extendedRect, dynamic)) {
+			Common::List<Graphics::DrawStep>::const_iterator step;
+			for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+				_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+			}
 		}
 
 		addDirtyRect(extendedRect);
 	}
 }
 
+bool ThemeEngine::drawCachedDD(DrawData type, const Common::Rect &area, const Common::Rect &extendedRect, uint32 dynamic) {
+	const WidgetDrawData *drawData = _widgets[type];
+	Graphics::Surface *surface = _vectorRenderer->getActiveSurface();
+
+	if (!drawData->_cacheable || _clip.isEmpty() || !Common::Rect(surface->w, surface->h).contains(extendedRect))
+		return false;
+
+	// Pixels the steps draw outside of the extended area would be missing
+	// from the cached drawing
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_VOID)
+			continue;
+
+		Common::Rect bounds = _vectorRenderer->stepGetBounds(*step, area);
+		bounds.clip(_clip);
+		if (!bounds.isEmpty() && !extendedRect.contains(bounds))
+			return false;
+	}
+
+	DrawDataCacheKey key;
+	key._type = type;
+	key._dynamic = dynamic;
+	key._width = area.width();
+	key._height = area.height();
+	key._oddX = area.left & 1;
+	key._oddY = area.top & 1;
+	key._rect = extendedRect;
+	key._rect.translate(-area.left, -area.top);
+	key._colors = _vectorRenderer->getColorState();
+
+	DrawDataCacheEntry *entry = _drawDataCache->find(key, *surface, extendedRect);
+	if (entry) {
+		surface->copyRectToSurface(entry->_drawing, extendedRect.left, extendedRect.top, Common::Rect(extendedRect.width(), extendedRect.height()));
+
+		// Leave the renderer in the state the steps would have left it in
+		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+			if (step->fgColor.set)
+				_vectorRenderer->setFgColor(step->fgColor.r, step->fgColor.g, step->fgColor.b);
+			if (step->bgColor.set)
+				_vectorRenderer->setBgColor(step->bgColor.r, step->bgColor.g, step->bgColor.b);
+			if (step->bevelColor.set)
+				_vectorRenderer->setBevelColor(step->bevelColor.r, step->bevelColor.g, step->bevelColor.b);
+			if (step->gradColor1.set && step->gradColor2.set)
+				_vectorRenderer->setGradientColors(step->gradColor1.r, step->gradColor1.g, step->gradColor1.b,
+					step->gradColor2.r, step->gradColor2.g, step->gradColor2.b);
+		}
+		return true;
+	}
+
+	const uint32 size = 2 * extendedRect.width() * surface->format.bytesPerPixel * extendedRect.height();
+	if (size > kDrawDataCacheSize / 4)
+		return false;
+
+	entry = new DrawDataCacheEntry;
+	entry->_key = key;
+
+	entry->_background.create(extendedRect.width(), extendedRect.height(), surface->format);
+	entry->_background.copyRectToSurface(*surface, 0, 0, extendedRect);
+
+	for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+		_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+	}
+
+	entry->_drawing.create(extendedRect.width(), extendedRect.height(), surface->format);
+	entry->_drawing.copyRectToSurface(*surface, 0, 0, extendedRect);
+
+	_drawDataCache->insert(entry);
+	return true;
+}
+
+void ThemeEngine::clearDrawDataCache() {
+	_drawDataCache->clear();
+}
+
 void ThemeEngine::drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::U32String &text,
 	bool restoreBg, bool ellipsis, Graphics::TextAlign alignH, TextAlignVertical alignV,
 	int deltax, const Common::Rect &drawableTextArea) {
@@ -50,6 +50,7 @@ class VectorRenderer;
 namespace GUI {
 
 struct WidgetDrawData;
+class DrawDataCache;
 struct TextDrawData;
 struct TextColorData;
 class Dialog;
@@ -716,6 +717,17 @@ protected:
 	                TextAlignVertical alignV = kTextAlignVTop, int deltax = 0,
 	                const Common::Rect &drawableTextArea = Common::Rect(0, 0, 0, 0));
 
+	/**
+	 * Draws the steps of a DrawData item by copying an earlier drawing of it
+	 * over the same pixels, or draws and caches them.
+	 *
+	 * @return false if the item cannot be cached, and has not been drawn.
+	 */
+	bool drawCachedDD(DrawData type, const Common::Rect &area, const Common::Rect &extendedRect, uint32 dynamic);
+
+	/** Drops all cached drawings, when the theme or the surfaces change. */
+	void clearDrawDataCache();
+
 	/**
 	 * DEBUG: Draws a white square and writes some text next to it.
 	 */
@@ -777,6 +789,9 @@ protected:
 	/** Font info. */
 	const Graphics::Font *_font;
 
+	/** Drawings of DrawData items, see drawCachedDD(). */
+	DrawDataCache *_drawDataCache;
+
 	/**
 	 * Array of all the DrawData elements than can be drawn to the screen.
 	 * Must be full so the renderer can work.
@@ -37,6 +37,9 @@
 
 #include "engines/engine.h"
 
+#include "audio/mixer.h"
+#include "audio/mixer_stats.h"
+
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	#include "gui/console.h"
@@ -79,6 +82,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("mixer_stats",		WRAP_METHOD(Debugger, cmdMixerStats));
 }
 
 Debugger::~Debugger() {
@@ -766,6 +771,47 @@ bool Debugger::cmdDebugFlagEnable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdMixerStats(int argc, const char **argv) {
+	Audio::Mixer *mixer = g_system->getMixer();
+	if (!mixer) {
+		debugPrintf("No mixer available\n");
+		return true;
+	}
+
+	if (argc == 1) {
+		Audio::MixerStatistics stats;
+		mixer->getStatistics(stats);
+		debugPrintf("%s", stats.toString().c_str());
+	} else if (!scumm_stricmp(argv[1], "on") || !scumm_stricmp(argv[1], "off")) {
+		const bool enable = !scumm_stricmp(argv[1], "on");
+		mixer->enableStatistics(enable);
+		debugPrintf("Mixer statistics %s\n", enable ? "enabled" : "disabled");
+	} else if (!scumm_stricmp(argv[1], "reset")) {
+		mixer->resetStatistics();
+		debugPrintf("Mixer statistics reset\n");
+	} else if (!scumm_stricmp(argv[1], "json")) {
+		Audio::MixerStatistics stats;
+		mixer->getStatistics(stats);
+		const Common::String json = stats.toJSON() + "\n";
+
+		if (argc < 3) {
+			debugPrintf("%s", json.c_str());
+		} else {
+			Common::DumpFile file;
+			if (!file.open(argv[2])) {
+				debugPrintf("Can't open file %s\n", argv[2]);
+			} else {
+				file.writeString(json);
+				debugPrintf("Mixer statistics written to %s\n", argv[2]);
+			}
+		}
+	} else {
+		debugPrintf("Usage: %s [on | off | reset | json [<filename>]]\n", argv[0]);
+	}
+
+	return true;
+}
+
 bool Debugger::cmdExecFile(int argc, const char **argv) {
 	if (argc <= 1) {
 		debugPrintf("Expected to get the file with debug commands\n");
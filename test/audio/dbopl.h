@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/opl/dbopl.h"
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE && !defined(DISABLE_DOSBOX_OPL)
+#define TEST_DBOPL 1
+#else
+#define TEST_DBOPL 0
+#endif
+
+#if TEST_DBOPL
+using namespace OPL::DOSBox::DBOPL;
+#endif
+
+class DBOPLTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) % max;
+	}
+
+#if TEST_DBOPL
+	/**
+	 * Play random register writes on a chip using the per sample code and
+	 * one using the batched code, and check they generate the same samples.
+	 */
+	void compareChips(Bit32u rate, bool opl3, WaveMulHandler waveMul) {
+		Chip reference, batched;
+		InitTables();
+		reference.Setup(rate);
+		batched.Setup(rate);
+		reference.perSample = true;
+		batched.waveMul = waveMul;
+
+		// Enable the wave form selection and the OPL3 mode
+		reference.WriteReg(0x01, 0x20);
+		batched.WriteReg(0x01, 0x20);
+		if (opl3) {
+			reference.WriteReg(0x105, 0x01);
+			batched.WriteReg(0x105, 0x01);
+		}
+
+		static const uint32 registers[] = { 0x20, 0x40, 0x60, 0x80, 0xe0 };
+		const uint32 channels = opl3 ? 2 : 1;
+
+		Bit32s referenceOutput[2 * 1024], batchedOutput[2 * 1024];
+		_seed = rate;
+		for (int block = 0; block < 400; block++) {
+			for (int write = nextRandom(24); write > 0; write--) {
+				uint32 reg;
+				switch (nextRandom(6)) {
+				case 0:
+				case 1:
+					// Operator registers
+					reg = registers[nextRandom(ARRAYSIZE(registers))] + nextRandom(0x16);
+					break;
+				case 2:
+					// Frequency and key on
+					reg = 0xa0 + nextRandom(9) + (nextRandom(2) ? 0x10 : 0);
+					break;
+				case 3:
+					// Feedback, connection and panning
+					reg = 0xc0 + nextRandom(9);
+					break;
+				case 4:
+					// Four operator connections
+					reg = nextRandom(2) ? 0x104 : 0xbd;
+					break;
+				default:
+					reg = 0xb0 + nextRandom(9);
+					break;
+				}
+
+				if (reg != 0x104)
+					reg += nextRandom(channels) * 0x100;
+				const Bit8u val = nextRandom(256);
+				reference.WriteReg(reg, val);
+				batched.WriteReg(reg, val);
+			}
+
+			const Bitu samples = 1 + nextRandom(1024);
+			if (opl3) {
+				reference.GenerateBlock3(samples, referenceOutput);
+				batched.GenerateBlock3(samples, batchedOutput);
+			} else {
+				reference.GenerateBlock2(samples, referenceOutput);
+				batched.GenerateBlock2(samples, batchedOutput);
+			}
+
+			const Bitu length = samples * (opl3 ? 2 : 1);
+			TS_ASSERT_EQUALS(memcmp(referenceOutput, batchedOutput, length * sizeof(Bit32s)), 0);
+		}
+	}
+
+	void compareChips(bool opl3) {
+		static const Bit32u rates[] = { 49716, 44100, 22050 };
+		for (int i = 0; i < ARRAYSIZE(rates); i++) {
+			compareChips(rates[i], opl3, &WaveMul);
+#ifdef SCUMMVM_SSE2
+			compareChips(rates[i], opl3, &WaveMulSSE2);
+#endif
+#ifdef SCUMMVM_NEON
+			compareChips(rates[i], opl3, &WaveMulNEON);
+#endif
+		}
+	}
+#endif
+
+public:
+	void test_batched_opl2() {
+#if TEST_DBOPL
+		Common::install_null_g_system();
+		compareChips(false);
+#endif
+	}
+
+	void test_batched_opl3() {
+#if TEST_DBOPL
+		Common::install_null_g_system();
+		compareChips(true);
+#endif
+	}
+};
@@ -0,0 +1,159 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/memstream.h"
+
+#include "audio/audiostream.h"
+#include "audio/decoders/decoded_cache.h"
+#include "audio/decoders/raw.h"
+
+#include "helper.h"
+
+static int g_decoderCount = 0;
+
+static Audio::SeekableAudioStream *makeCountingStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	g_decoderCount++;
+	return Audio::makeRawStream(stream, 11025, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, disposeAfterUse);
+}
+
+class DecodedAudioCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	Common::SeekableReadStream *createSineData(int time, int16 **sine) {
+		*sine = createSine<int16>(11025, time);
+		const uint32 size = 11025 * time * sizeof(int16);
+		byte *data = (byte *)malloc(size);
+		for (int i = 0; i < 11025 * time; i++)
+			WRITE_LE_UINT16(data + i * 2, (*sine)[i]);
+		return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	}
+
+	void checkStream(Audio::SeekableAudioStream *stream, const int16 *sine, int samples) {
+		// Read in small parts, like the mixer does
+		int16 *buffer = new int16[samples];
+		int read = 0;
+		while (read < samples) {
+			const int len = stream->readBuffer(buffer + read, MIN(samples - read, 1000));
+			if (len <= 0)
+				break;
+			read += len;
+		}
+		TS_ASSERT_EQUALS(read, samples);
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, samples * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(stream->endOfData(), true);
+		delete[] buffer;
+	}
+
+	/** Play a sound to its end, which adds it to the cache if it fits. */
+	void play(uint32 offset, int time) {
+		int16 *sine;
+		Audio::SeekableAudioStream *stream = Audio::makeCachedAudioStream("test.sou", offset, createSineData(time, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		checkStream(stream, sine, 11025 * time);
+		delete stream;
+		delete[] sine;
+	}
+
+public:
+	void test_cache_hit() {
+		ConfMan.setInt("audio_cache_size", 1024);
+		Audio::purgeDecodedAudioCache();
+		g_decoderCount = 0;
+
+		int16 *sine;
+		Audio::SeekableAudioStream *first = Audio::makeCachedAudioStream("test.sou", 8, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		delete[] sine;
+
+		// Nothing is cached before the first stream was played and destroyed
+		Audio::SeekableAudioStream *second = Audio::makeCachedAudioStream("test.sou", 8, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		TS_ASSERT_EQUALS(g_decoderCount, 2);
+		delete second;
+
+		checkStream(first, sine, 11025);
+		delete first;
+		delete[] sine;
+
+		first = Audio::makeCachedAudioStream("test.sou", 8, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		delete[] sine;
+		second = Audio::makeCachedAudioStream("test.sou", 8, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		TS_ASSERT_EQUALS(g_decoderCount, 2);
+
+		checkStream(first, sine, 11025);
+		checkStream(second, sine, 11025);
+
+		// Purging keeps the samples of playing sounds around
+		Audio::purgeDecodedAudioCache();
+		TS_ASSERT_EQUALS(second->rewind(), true);
+		checkStream(second, sine, 11025);
+
+		delete first;
+		delete second;
+		delete[] sine;
+
+		Audio::SeekableAudioStream *third = Audio::makeCachedAudioStream("test.sou", 8, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		TS_ASSERT_EQUALS(g_decoderCount, 3);
+		delete third;
+		delete[] sine;
+	}
+
+	void test_cache_eviction() {
+		// Sounds of 22050 bytes, so the 100k cache holds four of them
+		ConfMan.setInt("audio_cache_size", 100);
+		Audio::purgeDecodedAudioCache();
+		g_decoderCount = 0;
+
+		for (uint32 offset = 0; offset < 5; offset++)
+			play(offset, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 5);
+
+		// The first one was dropped, the last one is still there
+		play(4, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 5);
+
+		// Using the second one makes the third the least recently used
+		play(1, 1);
+		play(0, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 6);
+		play(1, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 6);
+		play(2, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 7);
+	}
+
+	void test_partly_played_sounds_are_not_cached() {
+		ConfMan.setInt("audio_cache_size", 1024);
+		Audio::purgeDecodedAudioCache();
+		g_decoderCount = 0;
+
+		int16 *sine;
+		Audio::SeekableAudioStream *stream = Audio::makeCachedAudioStream("test.sou", 0, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		int16 buffer[1000];
+		stream->readBuffer(buffer, 1000);
+		delete stream;
+		delete[] sine;
+
+		// Skipping a part of the sound does not cache it either
+		stream = Audio::makeCachedAudioStream("test.sou", 0, createSineData(1, &sine), DisposeAfterUse::YES, &makeCountingStream);
+		stream->readBuffer(buffer, 1000);
+		stream->seek(Audio::Timestamp(0, 500, 11025));
+		checkStream(stream, sine + 500, 11025 - 500);
+		delete stream;
+		delete[] sine;
+
+		play(0, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 3);
+		play(0, 1);
+		TS_ASSERT_EQUALS(g_decoderCount, 3);
+	}
+
+	void test_long_sounds_are_not_cached() {
+		ConfMan.setInt("audio_cache_size", 64);
+		Audio::purgeDecodedAudioCache();
+		g_decoderCount = 0;
+
+		for (int i = 0; i < 2; i++)
+			play(0, 2);
+		TS_ASSERT_EQUALS(g_decoderCount, 2);
+
+		ConfMan.removeKey("audio_cache_size", Common::ConfigManager::kApplicationDomain);
+	}
+};
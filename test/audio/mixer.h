@@ -0,0 +1,160 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kOutputRate = 44100,
+		kCallbackFrames = 512
+	};
+
+	/** Endless silence, which can stop its own channel while being read. */
+	class StoppingStream : public Audio::AudioStream {
+	public:
+		StoppingStream(Audio::Mixer &mixer, bool &destroyed)
+			: _mixer(mixer), _destroyed(destroyed), _stopWhileReading(false), _volumeChanges(0), _reads(0) {
+			_destroyed = false;
+		}
+		~StoppingStream() { _destroyed = true; }
+
+		int readBuffer(int16 *buffer, const int numSamples) {
+			_reads++;
+			if (_stopWhileReading)
+				_mixer.stopHandle(handle);
+			for (int i = 0; i < _volumeChanges; i++)
+				_mixer.setChannelVolume(otherHandle, i & 0xFF);
+			memset(buffer, 0, numSamples * sizeof(int16));
+			return numSamples;
+		}
+		bool isStereo() const { return false; }
+		int getRate() const { return kOutputRate; }
+		bool endOfData() const { return false; }
+
+		Audio::SoundHandle handle, otherHandle;
+		bool _stopWhileReading;
+		/** Number of volume changes of otherHandle made while being read. */
+		int _volumeChanges;
+		int _reads;
+
+	private:
+		Audio::Mixer &_mixer;
+		bool &_destroyed;
+	};
+
+	int16 _buffer[kCallbackFrames * 2];
+
+	void mix(Audio::MixerImpl &mixer) {
+		mixer.mixCallback((byte *)_buffer, sizeof(_buffer));
+	}
+
+	// The default arguments are only declared by Mixer
+	void play(Audio::Mixer &mixer, Audio::AudioStream *stream, Audio::SoundHandle *handle, DisposeAfterUse::Flag dispose) {
+		mixer.playStream(Audio::Mixer::kSFXSoundType, handle, stream, -1, Audio::Mixer::kMaxChannelVolume, 0, dispose);
+	}
+
+public:
+	void test_stop_destroys_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+
+		bool destroyed;
+		StoppingStream *stream = new StoppingStream(mixer, destroyed);
+		play(mixer, stream, &stream->handle, DisposeAfterUse::YES);
+		mix(mixer);
+		TS_ASSERT(mixer.isSoundHandleActive(stream->handle));
+
+		// The stream is gone as soon as stopHandle() returns, even though
+		// no callback ran in the meantime
+		mixer.stopHandle(stream->handle);
+		TS_ASSERT(destroyed);
+		mix(mixer);
+#endif
+	}
+
+	void test_stop_keeps_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+
+		bool destroyed;
+		StoppingStream stream(mixer, destroyed);
+		play(mixer, &stream, &stream.handle, DisposeAfterUse::NO);
+		mix(mixer);
+		TS_ASSERT_EQUALS(stream._reads, 1);
+
+		mixer.stopAll();
+		TS_ASSERT(!mixer.isSoundHandleActive(stream.handle));
+		mix(mixer);
+		TS_ASSERT_EQUALS(stream._reads, 1);
+		TS_ASSERT(!destroyed);
+#endif
+	}
+
+	void test_stop_from_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+
+		bool destroyed;
+		StoppingStream *stream = new StoppingStream(mixer, destroyed);
+		play(mixer, stream, &stream->handle, DisposeAfterUse::YES);
+		Audio::SoundHandle handle = stream->handle;
+
+		// Stopping a channel from its own stream must not wait for the
+		// callback, and the stream stays valid until the callback is done
+		stream->_stopWhileReading = true;
+		mix(mixer);
+		TS_ASSERT(!destroyed);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+
+		// The next callback hands the channel back
+		mix(mixer);
+		mixer.isSoundHandleActive(handle);
+		TS_ASSERT(destroyed);
+#endif
+	}
+
+	void test_full_queue_from_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+
+		bool destroyed, otherDestroyed;
+		StoppingStream *stream = new StoppingStream(mixer, destroyed);
+		StoppingStream *other = new StoppingStream(mixer, otherDestroyed);
+		play(mixer, stream, &stream->handle, DisposeAfterUse::YES);
+		play(mixer, other, &stream->otherHandle, DisposeAfterUse::YES);
+		Audio::SoundHandle handle = stream->handle;
+		Audio::SoundHandle otherHandle = stream->otherHandle;
+
+		// The stream fills the command queue after stopping its own
+		// channel, so the callback applies the commands in the middle of
+		// mixing it. The channel must survive until it was mixed.
+		stream->_stopWhileReading = true;
+		stream->_volumeChanges = 1000;
+		mix(mixer);
+		TS_ASSERT(!destroyed);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(destroyed);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(otherHandle), 999 & 0xFF);
+
+		mix(mixer);
+		TS_ASSERT(!otherDestroyed);
+		TS_ASSERT_EQUALS(other->_reads, 2);
+#endif
+	}
+};
@@ -0,0 +1,131 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+#include "audio/mixer_stats.h"
+#include "audio/decoders/raw.h"
+
+#include "../null_osystem.h"
+#include "helper.h"
+
+class MixerStatisticsTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kOutputRate = 44100,
+		kCallbackFrames = 1024
+	};
+
+	int16 _buffer[kCallbackFrames * 2];
+
+	void mix(Audio::MixerImpl &mixer, int callbacks) {
+		for (int i = 0; i < callbacks; i++)
+			mixer.mixCallback((byte *)_buffer, sizeof(_buffer));
+	}
+
+	// The default arguments are only declared by Mixer
+	void play(Audio::Mixer &mixer, Audio::Mixer::SoundType type, Audio::AudioStream *stream, int id = -1) {
+		mixer.playStream(type, 0, stream, id);
+	}
+
+	Audio::AudioStream *createStream() {
+		return createSineStream<int16>(kOutputRate, 1, 0, false, false);
+	}
+
+public:
+	void test_disabled() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+		play(mixer, Audio::Mixer::kSFXSoundType, createStream(), 42);
+		mix(mixer, 4);
+
+		Audio::MixerStatistics stats;
+		mixer.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.enabled, false);
+		TS_ASSERT_EQUALS(stats.outputRate, (uint)kOutputRate);
+		TS_ASSERT_EQUALS(stats.callbacks, 0u);
+		TS_ASSERT_EQUALS(stats.channels.size(), 1u);
+		TS_ASSERT_EQUALS(stats.channels[0].id, 42);
+		TS_ASSERT_EQUALS(stats.channels[0].type, (int)Audio::Mixer::kSFXSoundType);
+		TS_ASSERT_EQUALS(stats.channels[0].frames, 0u);
+#endif
+	}
+
+	void test_counters() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+		mixer.enableStatistics(true);
+		play(mixer, Audio::Mixer::kMusicSoundType, createStream());
+		mix(mixer, 10);
+
+		Audio::MixerStatistics stats;
+		mixer.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.enabled, true);
+		TS_ASSERT_EQUALS(stats.callbacks, 10u);
+		TS_ASSERT_EQUALS(stats.bufferFrames, (uint)kCallbackFrames);
+		TS_ASSERT_EQUALS(stats.skippedCallbacks, 0u);
+		TS_ASSERT_EQUALS(stats.channelUnderruns, 0u);
+
+		uint32 histogramTotal = 0;
+		for (int i = 0; i < Audio::MixerStatistics::kHistogramBuckets; i++)
+			histogramTotal += stats.callbackHistogram[i];
+		TS_ASSERT_EQUALS(histogramTotal, 10u);
+
+		TS_ASSERT_EQUALS(stats.channels.size(), 1u);
+		TS_ASSERT_EQUALS(stats.channels[0].frames, 10u * kCallbackFrames);
+		TS_ASSERT_EQUALS(stats.channels[0].underruns, 0u);
+		TS_ASSERT_EQUALS(stats.channels[0].queuedFrames, 0u);
+		TS_ASSERT_DIFFERS(stats.toJSON().find("\"callbacks\": 10,"), Common::String::npos);
+
+		// The reset is applied by the next callback
+		mixer.resetStatistics();
+		mix(mixer, 1);
+		mixer.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.callbacks, 1u);
+		TS_ASSERT_EQUALS(stats.channels[0].frames, (uint64)kCallbackFrames);
+#endif
+	}
+
+	void test_underruns() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(kOutputRate);
+		mixer.setReady(true);
+		mixer.enableStatistics(true);
+
+		Audio::QueuingAudioStream *queue = Audio::makeQueuingAudioStream(kOutputRate, false);
+		play(mixer, Audio::Mixer::kSpeechSoundType, queue);
+
+		// Running dry counts once, no matter how long it lasts
+		queue->queueAudioStream(createStream());
+		mix(mixer, kOutputRate / kCallbackFrames + 4);
+
+		Audio::MixerStatistics stats;
+		mixer.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.channelUnderruns, 1u);
+		TS_ASSERT_EQUALS(stats.channels[0].underruns, 1u);
+
+		queue->queueAudioStream(createStream());
+		mix(mixer, kOutputRate / kCallbackFrames + 4);
+
+		mixer.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.channelUnderruns, 2u);
+
+		// A stream which ends normally is not an underrun
+		queue->queueAudioStream(createStream());
+		queue->finish();
+		mix(mixer, kOutputRate / kCallbackFrames + 4);
+
+		mixer.getStatistics(stats);
+		TS_ASSERT_EQUALS(stats.channelUnderruns, 2u);
+		TS_ASSERT_EQUALS(stats.channels.size(), 0u);
+#endif
+	}
+};
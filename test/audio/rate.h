@@ -0,0 +1,403 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate_intern.h"
+#include "common/array.h"
+
+#include "../null_osystem.h"
+
+#include <math.h>
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/** A random sample, with a good share of full scale ones. */
+	int16 randomSample() {
+		switch (nextRandom() % 4) {
+		case 0:
+			return Audio::ST_SAMPLE_MAX;
+		case 1:
+			return Audio::ST_SAMPLE_MIN;
+		default:
+			return (int16)(nextRandom() & 0xFFFF);
+		}
+	}
+
+	/** An endless stream whose samples are given by a function of the frame number. */
+	class SignalStream : public Audio::AudioStream {
+	public:
+		SignalStream(bool stereo, int rate) : _stereo(stereo), _rate(rate), _frame(0), _channel(0) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) {
+			// Return short reads now and then, as real streams do
+			int count = (_frame % 3) ? numSamples : MAX(1, numSamples / 3);
+			if (_stereo)
+				count = MAX(2, count & ~1);
+			for (int i = 0; i < count; i++) {
+				buffer[i] = sample(_frame, _channel);
+				if (!_stereo || ++_channel == 2) {
+					_channel = 0;
+					_frame++;
+				}
+			}
+			return count;
+		}
+		bool isStereo() const { return _stereo; }
+		int getRate() const { return _rate; }
+		bool endOfData() const { return false; }
+
+		virtual int16 sample(uint frame, int channel) const = 0;
+
+	private:
+		const bool _stereo;
+		const int _rate;
+		uint _frame;
+		int _channel;
+	};
+
+	class ConstantStream : public SignalStream {
+	public:
+		ConstantStream(bool stereo, int rate, int16 left, int16 right) : SignalStream(stereo, rate), _left(left), _right(right) {}
+		int16 sample(uint frame, int channel) const { return channel ? _right : _left; }
+
+	private:
+		const int16 _left, _right;
+	};
+
+	class SineStream : public SignalStream {
+	public:
+		SineStream(int rate, double frequency) : SignalStream(false, rate), _frequency(frequency) {}
+		int16 sample(uint frame, int channel) const {
+			return (int16)floor(sin(2 * M_PI * _frequency * frame / getRate()) * 30000 + 0.5);
+		}
+
+	private:
+		const double _frequency;
+	};
+
+	/** A full scale square wave, starting with @p halfPeriod frames of the maximum. */
+	class SquareStream : public SignalStream {
+	public:
+		SquareStream(int rate, uint halfPeriod) : SignalStream(false, rate), _halfPeriod(halfPeriod) {}
+		int16 sample(uint frame, int channel) const {
+			return ((frame / _halfPeriod) % 2) ? Audio::ST_SAMPLE_MIN : Audio::ST_SAMPLE_MAX;
+		}
+
+	private:
+		const uint _halfPeriod;
+	};
+
+	struct MixFunc {
+		const char *name;
+		Audio::RateMixFunc func;
+	};
+
+	/** The SIMD mixing functions which were compiled in and which the CPU supports. */
+	Common::Array<MixFunc> getMixFuncs() {
+		Common::Array<MixFunc> funcs;
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			MixFunc func = { "SSE2", Audio::mixBufferSSE2 };
+			funcs.push_back(func);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			MixFunc func = { "AVX2", Audio::mixBufferAVX2 };
+			funcs.push_back(func);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			MixFunc func = { "NEON", Audio::mixBufferNEON };
+			funcs.push_back(func);
+		}
+#endif
+#endif
+		return funcs;
+	}
+
+	struct ConvolveFunc {
+		const char *name;
+		Audio::RateConvolveFunc func;
+	};
+
+	Common::Array<ConvolveFunc> getConvolveFuncs() {
+		Common::Array<ConvolveFunc> funcs;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			ConvolveFunc func = { "SSE2", Audio::convolveSSE2 };
+			funcs.push_back(func);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			ConvolveFunc func = { "AVX2", Audio::convolveAVX2 };
+			funcs.push_back(func);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			ConvolveFunc func = { "NEON", Audio::convolveNEON };
+			funcs.push_back(func);
+		}
+#endif
+		return funcs;
+	}
+
+	/**
+	 * Run @p conv on @p stream, skip the first @p skip frames and return
+	 * the next @p frames ones, mixed at full volume into silence.
+	 */
+	static void flow(Audio::RateConverter *conv, Audio::AudioStream &stream, uint skip, uint frames, Common::Array<int16> &output) {
+		Common::Array<int16> skipped(skip * 2 + 2);
+		for (uint done = 0; done < skip; ) {
+			const uint len = MIN<uint>(skip - done, 300);
+			done += conv->flow(stream, &skipped[0], len, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		}
+
+		output.resize(frames * 2);
+		memset(&output[0], 0, frames * 2 * sizeof(int16));
+		TS_ASSERT_EQUALS(conv->flow(stream, &output[0], frames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), (int)frames);
+	}
+
+public:
+	void test_mix_functions_match_scalar() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Common::Array<MixFunc> funcs = getMixFuncs();
+		_seed = 1;
+
+		// Enough frames for the widest vector, plus every tail length
+		enum { kMaxLen = 67 };
+		int16 input[kMaxLen * 2], expected[kMaxLen * 2], output[kMaxLen * 2];
+
+		for (uint f = 0; f < funcs.size(); f++) {
+			for (int mode = 0; mode < 3; mode++) {
+				const bool stereo = mode != 0;
+				const bool reverseStereo = mode == 2;
+
+				for (uint len = 0; len <= kMaxLen; len++) {
+					for (int round = 0; round < 4; round++) {
+						for (int i = 0; i < kMaxLen * 2; i++) {
+							input[i] = randomSample();
+							expected[i] = output[i] = randomSample();
+						}
+
+						// Include the extreme volumes
+						const Audio::st_volume_t volL = (round == 0) ? (uint32)Audio::Mixer::kMaxMixerVolume : nextRandom() % (Audio::Mixer::kMaxMixerVolume + 1);
+						const Audio::st_volume_t volR = (round == 1) ? 0U : nextRandom() % (Audio::Mixer::kMaxMixerVolume + 1);
+
+						Audio::mixBuffer(expected, input, len, volL, volR, stereo, reverseStereo);
+						funcs[f].func(output, input, len, volL, volR, stereo, reverseStereo);
+						TSM_ASSERT_EQUALS(funcs[f].name, memcmp(output, expected, sizeof(output)), 0);
+					}
+				}
+			}
+		}
+#endif
+	}
+
+	void test_mix_saturation() {
+#if NULL_OSYSTEM_IS_AVAILABLE && !defined(OUTPUT_UNSIGNED_AUDIO)
+		Common::install_null_g_system();
+
+		Common::Array<MixFunc> funcs = getMixFuncs();
+		MixFunc scalar = { "C", Audio::mixBuffer };
+		funcs.push_back(scalar);
+
+		enum { kLen = 37 };
+		int16 input[kLen * 2], output[kLen * 2];
+
+		for (uint f = 0; f < funcs.size(); f++) {
+			// Left input at the maximum, right at the minimum, mixed into a
+			// buffer which is already close to the limits
+			for (int i = 0; i < kLen; i++) {
+				input[i * 2 + 0] = Audio::ST_SAMPLE_MAX;
+				input[i * 2 + 1] = Audio::ST_SAMPLE_MIN;
+				output[i * 2 + 0] = 30000;
+				output[i * 2 + 1] = -30000;
+			}
+			funcs[f].func(output, input, kLen, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume, true, false);
+			for (int i = 0; i < kLen; i++) {
+				TSM_ASSERT_EQUALS(funcs[f].name, output[i * 2 + 0], Audio::ST_SAMPLE_MAX);
+				TSM_ASSERT_EQUALS(funcs[f].name, output[i * 2 + 1], Audio::ST_SAMPLE_MIN);
+			}
+
+			// With reversed stereo, the channels saturate on the other side
+			for (int i = 0; i < kLen * 2; i++)
+				output[i] = 0;
+			funcs[f].func(output, input, kLen, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume / 2, true, true);
+			for (int i = 0; i < kLen; i++) {
+				TSM_ASSERT_EQUALS(funcs[f].name, output[i * 2 + 0], Audio::ST_SAMPLE_MIN / 2);
+				TSM_ASSERT_EQUALS(funcs[f].name, output[i * 2 + 1], Audio::ST_SAMPLE_MAX);
+			}
+
+			// Mono input goes to both channels
+			for (int i = 0; i < kLen * 2; i++) {
+				input[i] = Audio::ST_SAMPLE_MIN;
+				output[i] = Audio::ST_SAMPLE_MIN + 10;
+			}
+			funcs[f].func(output, input, kLen, Audio::Mixer::kMaxMixerVolume, 0, false, false);
+			for (int i = 0; i < kLen; i++) {
+				TSM_ASSERT_EQUALS(funcs[f].name, output[i * 2 + 0], Audio::ST_SAMPLE_MIN);
+				TSM_ASSERT_EQUALS(funcs[f].name, output[i * 2 + 1], Audio::ST_SAMPLE_MIN + 10);
+			}
+		}
+#endif
+	}
+
+	void test_convolve_functions_match_scalar() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Common::Array<ConvolveFunc> funcs = getConvolveFuncs();
+		_seed = 2;
+
+		// The coefficients have to be 32 byte aligned
+		int16 storage[64 + 16];
+		int16 *coeffs = (int16 *)((uintptr)(storage + 16) & ~(uintptr)31);
+		int16 samples[65];
+
+		for (uint f = 0; f < funcs.size(); f++) {
+			for (uint taps = 16; taps <= 64; taps *= 2) {
+				for (int round = 0; round < 20; round++) {
+					// Coefficients in the range of the ones of a real filter
+					for (uint i = 0; i < taps; i++)
+						coeffs[i] = (int16)((int)(nextRandom() % 12288) - 4096);
+					for (uint i = 0; i < ARRAYSIZE(samples); i++)
+						samples[i] = randomSample();
+
+					// Unaligned samples as well
+					const int16 *start = samples + (round % 2);
+					TSM_ASSERT_EQUALS(funcs[f].name, funcs[f].func(start, coeffs, taps), Audio::convolve(start, coeffs, taps));
+				}
+			}
+		}
+#endif
+	}
+
+	void test_sinc_identity_rate() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		for (int quality = 1; quality <= 3; quality++) {
+			// The filter has no delay, so the output follows the input
+			SineStream stream(44100, 440);
+			Audio::RateConverter *conv = Audio::makeSincRateConverter(44100, 44100, false, false, quality, Audio::mixBuffer);
+			TS_ASSERT(conv);
+			if (!conv)
+				continue;
+
+			Common::Array<int16> output;
+			flow(conv, stream, 0, 2000, output);
+			for (uint i = 0; i < 2000; i++) {
+				// The start differs, as the filter sees silence before the
+				// first sample instead of the continued sine
+				if (i < 32)
+					continue;
+
+				const int16 expected = stream.sample(i, 0);
+				TS_ASSERT_LESS_THAN_EQUALS(ABS(output[i * 2 + 0] - expected), 16);
+				TS_ASSERT_EQUALS(output[i * 2 + 0], output[i * 2 + 1]);
+			}
+
+			delete conv;
+		}
+#endif
+	}
+
+	void test_sinc_dc_gain() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		static const Audio::st_rate_t rates[][2] = {
+			{ 22050, 44100 }, { 44100, 48000 }, { 48000, 44100 }, { 48000, 22050 }, { 11025, 48000 }, { 32000, 32000 }
+		};
+
+		for (uint r = 0; r < ARRAYSIZE(rates); r++) {
+			for (int quality = 1; quality <= 3; quality++) {
+				for (int mode = 0; mode < 3; mode++) {
+					const bool stereo = mode != 0;
+					const bool reverseStereo = mode == 2;
+
+					ConstantStream stream(stereo, rates[r][0], 20000, -12345);
+					Audio::RateConverter *conv = Audio::makeSincRateConverter(rates[r][0], rates[r][1], stereo, reverseStereo, quality, Audio::mixBuffer);
+					TS_ASSERT(conv);
+					if (!conv)
+						continue;
+
+					// Skip the start, where the filter still covers the
+					// silence before the first sample
+					Common::Array<int16> output;
+					flow(conv, stream, 200, 1000, output);
+
+					const int16 left = stereo ? (reverseStereo ? -12345 : 20000) : 20000;
+					const int16 right = stereo ? (reverseStereo ? 20000 : -12345) : 20000;
+					for (uint i = 0; i < 1000; i++) {
+						TS_ASSERT_LESS_THAN_EQUALS(ABS(output[i * 2 + 0] - left), 20);
+						TS_ASSERT_LESS_THAN_EQUALS(ABS(output[i * 2 + 1] - right), 20);
+					}
+
+					delete conv;
+				}
+			}
+		}
+#endif
+	}
+
+	void test_sinc_full_scale() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		static const Audio::st_rate_t rates[][2] = {
+			{ 22050, 44100 }, { 44100, 48000 }, { 48000, 22050 }, { 44100, 44100 }
+		};
+
+		for (uint r = 0; r < ARRAYSIZE(rates); r++) {
+			for (int quality = 1; quality <= 3; quality++) {
+				const uint halfPeriod = 150;
+				SquareStream stream(rates[r][0], halfPeriod);
+				Audio::RateConverter *conv = Audio::makeSincRateConverter(rates[r][0], rates[r][1], false, false, quality, Audio::mixBuffer);
+				TS_ASSERT(conv);
+				if (!conv)
+					continue;
+
+				const uint frames = 3000;
+				Common::Array<int16> output;
+				flow(conv, stream, 0, frames, output);
+
+				// The filter overshoots at the edges. The output has to be
+				// clipped there, and must not wrap around, so it has the sign
+				// of the input wherever the two input samples around the
+				// output position agree.
+				for (uint i = 0; i < frames; i++) {
+					const uint64 pos = (uint64)i * rates[r][0] / rates[r][1];
+					const int16 before = stream.sample((uint)pos, 0);
+					const int16 after = stream.sample((uint)pos + 1, 0);
+					if (before != after)
+						continue;
+
+					if (before > 0) {
+						TS_ASSERT_LESS_THAN(0, output[i * 2]);
+					} else {
+						TS_ASSERT_LESS_THAN(output[i * 2], 0);
+					}
+				}
+
+				delete conv;
+			}
+		}
+#endif
+	}
+};
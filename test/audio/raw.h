@@ -3,6 +3,9 @@
 #include "audio/decoders/raw.h"
 #include "audio/audiostream.h"
 
+#include "common/memstream.h"
+#include "common/substream.h"
+
 #include "helper.h"
 
 class RawStreamTestSuite : public CxxTest::TestSuite
@@ -25,6 +28,37 @@ private:
 	}
 
 public:
+	void test_read_buffer_from_non_memory_stream() {
+		// Streams which are not kept in memory are converted block by block
+		const int totalSamples = 11025 * 2 * 2;
+		int16 *sine = createSine<int16>(11025, 2 * 2);
+		byte *data = (byte *)malloc(totalSamples * sizeof(int16));
+		for (int i = 0; i < totalSamples; ++i)
+			WRITE_LE_UINT16(data + i * 2, sine[i]);
+
+		Common::SeekableReadStream *memStream = new Common::MemoryReadStream(data, totalSamples * sizeof(int16), DisposeAfterUse::YES);
+		Common::SeekableReadStream *subStream = new Common::SeekableSubReadStream(memStream, 0, memStream->size(), DisposeAfterUse::YES);
+		Audio::SeekableAudioStream *s = Audio::makeRawStream(subStream, 11025,
+			Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | Audio::FLAG_STEREO, DisposeAfterUse::YES);
+
+		int16 *buffer = new int16[totalSamples];
+		int read = 0;
+		// Use odd read sizes to cross block boundaries
+		while (read < totalSamples) {
+			const int samples = s->readBuffer(buffer + read, MIN(1234, totalSamples - read));
+			if (samples <= 0)
+				break;
+			read += samples;
+		}
+		TS_ASSERT_EQUALS(read, totalSamples);
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, sizeof(int16) * totalSamples), 0);
+		TS_ASSERT_EQUALS(s->endOfData(), true);
+
+		free(sine);
+		delete[] buffer;
+		delete s;
+	}
+
 	void test_read_buffer_8_bit_signed_mono() {
 		readBufferTestTemplate<int8>(11025, 2, false, false);
 	}
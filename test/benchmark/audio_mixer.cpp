@@ -0,0 +1,208 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/random.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/flac.h"
+#include "audio/decoders/mp3.h"
+#include "audio/decoders/raw.h"
+#include "audio/decoders/vorbis.h"
+
+#include "test/benchmark/benchmark.h"
+
+namespace Benchmark {
+
+enum {
+	kOutputRate = 44100,
+	// Sample pairs per mixer callback, as used by the SDL backend at 44.1 kHz
+	kCallbackSamples = 2048
+};
+
+typedef Audio::SeekableAudioStream *(*StreamFactory)(int rate, const Options &options);
+
+static Audio::SeekableAudioStream *createRawStream(int rate, const Options &options) {
+	// Two seconds of a stereo sine sweep, looped while mixing
+	const uint32 samples = rate * 2 * 2;
+	int16 *data = (int16 *)malloc(samples * sizeof(int16));
+	for (uint32 i = 0; i < samples / 2; i++) {
+		data[i * 2] = data[i * 2 + 1] = (int16)(16000 * sin(i * (0.01 + i * 1e-7)));
+	}
+
+	return Audio::makeRawStream((const byte *)data, samples * sizeof(int16), rate,
+	                            Audio::FLAG_16BITS | Audio::FLAG_STEREO | Audio::FLAG_LITTLE_ENDIAN);
+}
+
+static Audio::SeekableAudioStream *createADPCMStream(int rate, const Options &options) {
+	// IMA ADPCM decodes any input, so two seconds of noise will do
+	const uint32 size = rate * 2;
+	byte *data = (byte *)malloc(size);
+	Common::RandomSource rnd("bench");
+	for (uint32 i = 0; i < size; i++)
+		data[i] = rnd.getRandomNumber(255);
+
+	Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	return Audio::makeADPCMStream(stream, DisposeAfterUse::YES, size, Audio::kADPCMDVI, rate, 2);
+}
+
+#if defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC)
+static Common::SeekableReadStream *openSampleFile(const Options &options, const char *name) {
+	if (options.dataPath.empty())
+		return 0;
+
+	Common::FSNode node = Common::FSNode(options.dataPath).getChild(name);
+	if (!node.exists())
+		return 0;
+
+	return node.createReadStream();
+}
+#endif
+
+#ifdef USE_MAD
+static Audio::SeekableAudioStream *createMP3Stream(int rate, const Options &options) {
+	Common::SeekableReadStream *stream = openSampleFile(options, "bench.mp3");
+	return stream ? Audio::makeMP3Stream(stream, DisposeAfterUse::YES) : 0;
+}
+#endif
+
+#ifdef USE_VORBIS
+static Audio::SeekableAudioStream *createVorbisStream(int rate, const Options &options) {
+	Common::SeekableReadStream *stream = openSampleFile(options, "bench.ogg");
+	return stream ? Audio::makeVorbisStream(stream, DisposeAfterUse::YES) : 0;
+}
+#endif
+
+#ifdef USE_FLAC
+static Audio::SeekableAudioStream *createFLACStream(int rate, const Options &options) {
+	Common::SeekableReadStream *stream = openSampleFile(options, "bench.flac");
+	return stream ? Audio::makeFLACStream(stream, DisposeAfterUse::YES) : 0;
+}
+#endif
+
+struct StreamType {
+	const char *name;
+	StreamFactory create;
+	/** Whether the sample rate is given by the sample file. */
+	bool fixedRate;
+};
+
+static const StreamType streamTypes[] = {
+	{ "raw", &createRawStream, false },
+	{ "adpcm", &createADPCMStream, false },
+#ifdef USE_MAD
+	{ "mp3", &createMP3Stream, true },
+#endif
+#ifdef USE_VORBIS
+	{ "vorbis", &createVorbisStream, true },
+#endif
+#ifdef USE_FLAC
+	{ "flac", &createFLACStream, true },
+#endif
+};
+
+static const int inputRates[] = { 11025, 22050, 44100, 48000 };
+
+static void runMixer(const Common::String &name, const StreamType &type, int rate, const Options &options) {
+	Audio::MixerImpl mixer(kOutputRate);
+	mixer.setReady(true);
+
+	int inputRate = rate;
+	for (int i = 0; i < options.channels; i++) {
+		Audio::SeekableAudioStream *stream = type.create(rate, options);
+		if (!stream) {
+			printf("%-20s skipped, no sample file in --data directory\n", name.c_str());
+			return;
+		}
+
+		inputRate = stream->getRate();
+		Audio::Mixer &m = mixer;
+		m.playStream(Audio::Mixer::kPlainSoundType, 0, Audio::makeLoopingAudioStream(stream, 0));
+	}
+
+	int16 *buffer = new int16[kCallbackSamples * 2];
+	const int callbacks = options.seconds * kOutputRate / kCallbackSamples;
+
+	// Warm up, so that converters and decoders have allocated their buffers
+	mixer.mixCallback((byte *)buffer, kCallbackSamples * 4);
+
+	uint64 total = 0, worst = 0;
+	const uint32 allocations = getAllocationCount();
+	for (int i = 0; i < callbacks; i++) {
+		const uint64 start = getNanoseconds();
+		mixer.mixCallback((byte *)buffer, kCallbackSamples * 4);
+		const uint64 duration = getNanoseconds() - start;
+
+		total += duration;
+		worst = MAX(worst, duration);
+	}
+	const uint32 callbackAllocations = getAllocationCount() - allocations;
+
+	delete[] buffer;
+
+	// Nanoseconds per output sample pair and channel, and how much of the
+	// real time budget of a callback the worst case used
+	const double nsPerSample = (double)total / ((double)callbacks * kCallbackSamples * options.channels);
+	const double budget = kCallbackSamples * 1e9 / kOutputRate;
+	const double baseline = recordResult(name, nsPerSample);
+
+	printf("%-20s %6d Hz %8.2f ns/sample %10.1f us avg %10.1f us worst (%5.1f%%) %8.2f allocs/callback",
+	       name.c_str(), inputRate, nsPerSample, total / 1000.0 / callbacks, worst / 1000.0,
+	       worst * 100.0 / budget, (double)callbackAllocations / callbacks);
+	if (baseline > 0)
+		printf("  %+6.1f%% vs. baseline", (nsPerSample - baseline) * 100.0 / baseline);
+	printf("\n");
+}
+
+void runAudioMixer(const Options &options) {
+	ConfMan.setInt("resampler_quality", options.resamplerQuality);
+
+	printf("Mixer: %d channels, %d Hz output, %d sample pairs per callback, resampler quality %d\n",
+	       options.channels, kOutputRate, kCallbackSamples, options.resamplerQuality);
+
+	// The benchmarks are named audio/<stream type>/<input rate>, or just
+	// audio/<stream type> if the rate is given by the sample file
+	for (uint i = 0; i < ARRAYSIZE(streamTypes); i++) {
+		const Common::String typeName = Common::String("audio/") + streamTypes[i].name;
+
+		if (streamTypes[i].fixedRate) {
+			if (typeName.hasPrefix(options.filter))
+				runMixer(typeName, streamTypes[i], 0, options);
+			continue;
+		}
+
+		for (uint j = 0; j < ARRAYSIZE(inputRates); j++) {
+			const Common::String name = Common::String::format("%s/%d", typeName.c_str(), inputRates[j]);
+			if (name.hasPrefix(options.filter))
+				runMixer(name, streamTypes[i], inputRates[j], options);
+		}
+	}
+}
+
+} // End of namespace Benchmark
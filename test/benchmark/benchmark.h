@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+#include "common/scummsys.h"
+#include "common/str.h"
+
+namespace Benchmark {
+
+struct Options {
+	Options() : channels(8), seconds(10), resamplerQuality(0) {}
+
+	/** Only run the benchmarks whose name starts with this. */
+	Common::String filter;
+	/** Directory holding sample files for the benchmarks which need them. */
+	Common::String dataPath;
+	/** File with the results of an earlier run to compare against. */
+	Common::String baselinePath;
+	/** File to save the results of this run to. */
+	Common::String saveBaselinePath;
+	int channels;
+	int seconds;
+	int resamplerQuality;
+};
+
+/** Returns a monotonic time stamp in nanoseconds. */
+uint64 getNanoseconds();
+
+/** Returns the number of calls to operator new so far. */
+uint32 getAllocationCount();
+
+/**
+ * Records the result of the benchmark @p name for --save-baseline. Returns
+ * the result of the same benchmark in the --baseline file, or 0 if there is
+ * none.
+ */
+double recordResult(const Common::String &name, double value);
+
+void runAudioMixer(const Options &options);
+void runGraphics(const Options &options);
+
+} // End of namespace Benchmark
+
+#endif
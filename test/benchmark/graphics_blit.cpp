@@ -0,0 +1,488 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+
+#include "common/array.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/colormasks.h"
+#include "graphics/conversion.h"
+#include "graphics/managed_surface.h"
+#include "graphics/primitives.h"
+#include "graphics/scaler.h"
+#include "graphics/transparent_surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "test/benchmark/benchmark.h"
+
+namespace Benchmark {
+
+enum {
+	/** Minimum time to repeat each benchmark for, in nanoseconds. */
+	kMinDuration = 250000000,
+	/** Minimum number of repetitions of each benchmark. */
+	kMinRuns = 3
+};
+
+static Graphics::PixelFormat formatCLUT8() { return Graphics::PixelFormat::createFormatCLUT8(); }
+static Graphics::PixelFormat formatRGB555() { return Graphics::createPixelFormat<555>(); }
+static Graphics::PixelFormat formatRGB565() { return Graphics::createPixelFormat<565>(); }
+static Graphics::PixelFormat formatRGBA8888() { return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0); }
+static Graphics::PixelFormat formatABGR8888() { return Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24); }
+static Graphics::PixelFormat formatXRGB8888() { return Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0); }
+
+static void fillRandom(byte *data, uint size, Common::RandomSource &rnd) {
+	for (uint i = 0; i < size; i++)
+		data[i] = rnd.getRandomNumber(255);
+}
+
+static void fillRandom(Graphics::Surface &surface, Common::RandomSource &rnd) {
+	fillRandom((byte *)surface.getPixels(), surface.pitch * surface.h, rnd);
+}
+
+/**
+ * A single benchmark. run() is called repeatedly and returns the number of
+ * destination pixels it wrote, which gives the MPixel/s figure.
+ */
+class GraphicsBenchmark {
+public:
+	GraphicsBenchmark(const Common::String &name) : _name(name) {}
+	virtual ~GraphicsBenchmark() {}
+
+	const Common::String &getName() const { return _name; }
+	virtual uint32 run() = 0;
+
+private:
+	Common::String _name;
+};
+
+#pragma mark - Format conversion
+
+class CrossBlitBenchmark : public GraphicsBenchmark {
+public:
+	CrossBlitBenchmark(const char *name, const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &dstFormat, int w, int h)
+		: GraphicsBenchmark(name) {
+		Common::RandomSource rnd("bench");
+		_src.create(w, h, srcFormat);
+		_dst.create(w, h, dstFormat);
+		fillRandom(_src, rnd);
+	}
+
+	~CrossBlitBenchmark() {
+		_src.free();
+		_dst.free();
+	}
+
+	uint32 run() {
+		Graphics::crossBlit((byte *)_dst.getPixels(), (const byte *)_src.getPixels(), _dst.pitch, _src.pitch,
+		                    _src.w, _src.h, _dst.format, _src.format);
+		return _dst.w * _dst.h;
+	}
+
+private:
+	Graphics::Surface _src, _dst;
+};
+
+class ScaleBlitBenchmark : public GraphicsBenchmark {
+public:
+	ScaleBlitBenchmark(const char *name, const Graphics::PixelFormat &format, int srcW, int srcH, int dstW, int dstH, bool bilinear)
+		: GraphicsBenchmark(name), _bilinear(bilinear) {
+		Common::RandomSource rnd("bench");
+		_src.create(srcW, srcH, format);
+		_dst.create(dstW, dstH, format);
+		fillRandom(_src, rnd);
+	}
+
+	~ScaleBlitBenchmark() {
+		_src.free();
+		_dst.free();
+	}
+
+	uint32 run() {
+		if (_bilinear)
+			Graphics::scaleBlitBilinear((byte *)_dst.getPixels(), (const byte *)_src.getPixels(), _dst.pitch, _src.pitch,
+			                            _dst.w, _dst.h, _src.w, _src.h, _src.format);
+		else
+			Graphics::scaleBlit((byte *)_dst.getPixels(), (const byte *)_src.getPixels(), _dst.pitch, _src.pitch,
+			                    _dst.w, _dst.h, _src.w, _src.h, _src.format);
+		return _dst.w * _dst.h;
+	}
+
+private:
+	Graphics::Surface _src, _dst;
+	bool _bilinear;
+};
+
+#pragma mark - Sprites
+
+class TransparentBlitBenchmark : public GraphicsBenchmark {
+public:
+	enum Mode {
+		kModeOpaque,
+		kModeAlpha,
+		kModeTinted,
+		kModeScaled
+	};
+
+	TransparentBlitBenchmark(const char *name, Mode mode)
+		: GraphicsBenchmark(name), _mode(mode) {
+		Common::RandomSource rnd("bench");
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		_sprite.create(256, 256, format);
+		_target.create(640, 480, format);
+		fillRandom(_sprite, rnd);
+		fillRandom(_target, rnd);
+
+		if (mode == kModeOpaque)
+			_sprite.setAlpha(255);
+	}
+
+	~TransparentBlitBenchmark() {
+		_sprite.free();
+		_target.free();
+	}
+
+	uint32 run() {
+		switch (_mode) {
+		case kModeTinted:
+			_sprite.blit(_target, 100, 100, Graphics::FLIP_NONE, nullptr, TS_ARGB(192, 255, 128, 64));
+			return _sprite.w * _sprite.h;
+		case kModeScaled:
+			_sprite.blit(_target, 50, 50, Graphics::FLIP_NONE, nullptr, TS_ARGB(255, 255, 255, 255), 400, 300);
+			return 400 * 300;
+		default:
+			_sprite.blit(_target, 100, 100);
+			return _sprite.w * _sprite.h;
+		}
+	}
+
+private:
+	Graphics::TransparentSurface _sprite;
+	Graphics::Surface _target;
+	Mode _mode;
+};
+
+class TransBlitFromBenchmark : public GraphicsBenchmark {
+public:
+	TransBlitFromBenchmark(const char *name, const Graphics::PixelFormat &format)
+		: GraphicsBenchmark(name), _target(640, 480, format) {
+		Common::RandomSource rnd("bench");
+		_sprite.create(320, 200, format);
+		fillRandom(_sprite, rnd);
+
+		// Make about a quarter of the sprite transparent, in runs like
+		// the shapes of typical game sprites
+		for (int y = 0; y < _sprite.h; y++) {
+			const int start = rnd.getRandomNumber(_sprite.w / 4);
+			const int end = _sprite.w - rnd.getRandomNumber(_sprite.w / 4);
+			for (int x = 0; x < _sprite.w; x++) {
+				byte *pixel = (byte *)_sprite.getBasePtr(x, y);
+				if (x < start || x >= end)
+					memset(pixel, 0, format.bytesPerPixel);
+				else
+					pixel[0] |= 1;
+			}
+		}
+	}
+
+	~TransBlitFromBenchmark() {
+		_sprite.free();
+	}
+
+	uint32 run() {
+		_target.transBlitFrom(_sprite, Common::Point(160, 140), 0);
+		return _sprite.w * _sprite.h;
+	}
+
+private:
+	Graphics::Surface _sprite;
+	Graphics::ManagedSurface _target;
+};
+
+#pragma mark - Scalers
+
+class ScalerBenchmark : public GraphicsBenchmark {
+public:
+	ScalerBenchmark(const char *name, ScalerProc *scaler, int factor)
+		: GraphicsBenchmark(name), _scaler(scaler) {
+		Common::RandomSource rnd("bench");
+
+		// The scalers look at the neighbours of the edge pixels, so the
+		// source has a border around it, like in the backends
+		_src.create(kWidth + 2 * kBorder, kHeight + 2 * kBorder, formatRGB565());
+		_dst.create(kWidth * factor, kHeight * factor, formatRGB565());
+
+		// Mostly flat areas with some noise, as the hq scalers have fast
+		// paths for equal neighbours
+		for (int y = 0; y < _src.h; y++) {
+			for (int x = 0; x < _src.w; x++) {
+				const uint16 color = ((x / 16) * 0x0841 + (y / 16) * 0x1082) & 0xFFFF;
+				*(uint16 *)_src.getBasePtr(x, y) = rnd.getRandomNumber(7) ? color : rnd.getRandomNumber(0xFFFF);
+			}
+		}
+	}
+
+	~ScalerBenchmark() {
+		_src.free();
+		_dst.free();
+	}
+
+	uint32 run() {
+		_scaler((const uint8 *)_src.getBasePtr(kBorder, kBorder), _src.pitch, (uint8 *)_dst.getPixels(), _dst.pitch, kWidth, kHeight);
+		return _dst.w * _dst.h;
+	}
+
+private:
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kBorder = 4
+	};
+
+	ScalerProc *_scaler;
+	Graphics::Surface _src, _dst;
+};
+
+#pragma mark - YUV conversion
+
+class YUVBenchmark : public GraphicsBenchmark {
+public:
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	YUVBenchmark(const char *name, Subsampling subsampling, const Graphics::PixelFormat &format, int w, int h)
+		: GraphicsBenchmark(name), _subsampling(subsampling) {
+		Common::RandomSource rnd("bench");
+		const int shift = subsampling == k444 ? 0 : (subsampling == k420 ? 1 : 2);
+
+		_yPitch = w;
+		// YUV410 interpolates with the next chroma row and column
+		_uvPitch = (w >> shift) + 1;
+		_y.resize(_yPitch * h);
+		_u.resize(_uvPitch * ((h >> shift) + 1));
+		_v.resize(_u.size());
+		fillRandom(_y.data(), _y.size(), rnd);
+		fillRandom(_u.data(), _u.size(), rnd);
+		fillRandom(_v.data(), _v.size(), rnd);
+
+		_dst.create(w, h, format);
+	}
+
+	~YUVBenchmark() {
+		_dst.free();
+	}
+
+	uint32 run() {
+		switch (_subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&_dst, Graphics::YUVToRGBManager::kScaleITU, _y.data(), _u.data(), _v.data(),
+			                       _dst.w, _dst.h, _yPitch, _uvPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&_dst, Graphics::YUVToRGBManager::kScaleITU, _y.data(), _u.data(), _v.data(),
+			                       _dst.w, _dst.h, _yPitch, _uvPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&_dst, Graphics::YUVToRGBManager::kScaleITU, _y.data(), _u.data(), _v.data(),
+			                       _dst.w, _dst.h, _yPitch, _uvPitch);
+			break;
+		}
+		return _dst.w * _dst.h;
+	}
+
+private:
+	Subsampling _subsampling;
+	int _yPitch, _uvPitch;
+	Common::Array<byte> _y, _u, _v;
+	Graphics::Surface _dst;
+};
+
+#pragma mark - Primitives
+
+class PrimitivesBenchmark : public GraphicsBenchmark {
+public:
+	enum Shape {
+		kShapeLine,
+		kShapeThickLine,
+		kShapeFilledRect,
+		kShapeRoundRect,
+		kShapeEllipse
+	};
+
+	PrimitivesBenchmark(const char *name, Shape shape)
+		: GraphicsBenchmark(name), _shape(shape) {
+		Common::RandomSource rnd("bench");
+		_dst.create(640, 480, formatXRGB8888());
+
+		for (uint i = 0; i < ARRAYSIZE(_coords); i++) {
+			_coords[i].left = rnd.getRandomNumber(_dst.w - 1);
+			_coords[i].top = rnd.getRandomNumber(_dst.h - 1);
+			_coords[i].right = rnd.getRandomNumber(_dst.w - 1);
+			_coords[i].bottom = rnd.getRandomNumber(_dst.h - 1);
+		}
+	}
+
+	~PrimitivesBenchmark() {
+		_dst.free();
+	}
+
+	uint32 run() {
+		_plotted = 0;
+
+		for (uint i = 0; i < ARRAYSIZE(_coords); i++) {
+			const Common::Rect &c = _coords[i];
+			Common::Rect rect(MIN(c.left, c.right), MIN(c.top, c.bottom), MAX(c.left, c.right) + 1, MAX(c.top, c.bottom) + 1);
+			const int color = i * 0x10101;
+
+			switch (_shape) {
+			case kShapeLine:
+				Graphics::drawLine(c.left, c.top, c.right, c.bottom, color, plotPixel, this);
+				break;
+			case kShapeThickLine:
+				Graphics::drawThickLine(c.left, c.top, c.right, c.bottom, 3, 3, color, plotPixel, this);
+				break;
+			case kShapeFilledRect:
+				Graphics::drawFilledRect(rect, color, plotPixel, this);
+				break;
+			case kShapeRoundRect:
+				Graphics::drawRoundRect(rect, 8, color, true, plotPixel, this);
+				break;
+			case kShapeEllipse:
+				Graphics::drawEllipse(rect.left, rect.top, rect.right - 1, rect.bottom - 1, color, true, plotPixel, this);
+				break;
+			}
+		}
+
+		return _plotted;
+	}
+
+private:
+	static void plotPixel(int x, int y, int color, void *data) {
+		PrimitivesBenchmark *benchmark = (PrimitivesBenchmark *)data;
+		Graphics::Surface &dst = benchmark->_dst;
+		if (x >= 0 && x < dst.w && y >= 0 && y < dst.h)
+			*(uint32 *)dst.getBasePtr(x, y) = color;
+		benchmark->_plotted++;
+	}
+
+	Shape _shape;
+	Graphics::Surface _dst;
+	Common::Rect _coords[64];
+	uint32 _plotted;
+};
+
+#pragma mark -
+
+static void runBenchmark(GraphicsBenchmark &benchmark) {
+	// Warm up, so that caches and lookup tables are set up
+	benchmark.run();
+
+	uint64 pixels = 0, duration = 0;
+	int runs = 0;
+	const uint64 start = getNanoseconds();
+	while (runs < kMinRuns || duration < kMinDuration) {
+		pixels += benchmark.run();
+		runs++;
+		duration = getNanoseconds() - start;
+	}
+
+	const double mpixels = pixels * 1000.0 / duration;
+	const double baseline = recordResult(benchmark.getName(), mpixels);
+
+	printf("%-40s %9.1f MPixel/s %10.1f us/run", benchmark.getName().c_str(), mpixels, duration / 1000.0 / runs);
+	if (baseline > 0)
+		printf("  %+6.1f%% vs. baseline", (mpixels - baseline) * 100.0 / baseline);
+	printf("\n");
+}
+
+void runGraphics(const Options &options) {
+	printf("Graphics: CPU features:%s%s%s\n",
+	       g_system->hasFeature(OSystem::kFeatureCpuSSE2) ? " SSE2" : "",
+	       g_system->hasFeature(OSystem::kFeatureCpuAVX2) ? " AVX2" : "",
+	       g_system->hasFeature(OSystem::kFeatureCpuNEON) ? " NEON" : "");
+
+	Common::Array<GraphicsBenchmark *> benchmarks;
+
+	benchmarks.push_back(new CrossBlitBenchmark("graphics/crossblit/rgb565-rgba8888", formatRGB565(), formatRGBA8888(), 640, 480));
+	benchmarks.push_back(new CrossBlitBenchmark("graphics/crossblit/rgba8888-rgb565", formatRGBA8888(), formatRGB565(), 640, 480));
+	benchmarks.push_back(new CrossBlitBenchmark("graphics/crossblit/rgba8888-abgr8888", formatRGBA8888(), formatABGR8888(), 640, 480));
+	benchmarks.push_back(new CrossBlitBenchmark("graphics/crossblit/rgb555-rgb565", formatRGB555(), formatRGB565(), 640, 480));
+	benchmarks.push_back(new CrossBlitBenchmark("graphics/crossblit/rgba8888-rgba8888", formatRGBA8888(), formatRGBA8888(), 1280, 720));
+
+	benchmarks.push_back(new ScaleBlitBenchmark("graphics/scaleblit/rgb565-2x", formatRGB565(), 320, 200, 640, 400, false));
+	benchmarks.push_back(new ScaleBlitBenchmark("graphics/scaleblit/rgba8888-2x", formatRGBA8888(), 320, 200, 640, 400, false));
+	benchmarks.push_back(new ScaleBlitBenchmark("graphics/scaleblit/rgba8888-bilinear", formatRGBA8888(), 640, 480, 800, 600, true));
+
+	benchmarks.push_back(new TransparentBlitBenchmark("graphics/transparent/opaque", TransparentBlitBenchmark::kModeOpaque));
+	benchmarks.push_back(new TransparentBlitBenchmark("graphics/transparent/alpha", TransparentBlitBenchmark::kModeAlpha));
+	benchmarks.push_back(new TransparentBlitBenchmark("graphics/transparent/tinted", TransparentBlitBenchmark::kModeTinted));
+	benchmarks.push_back(new TransparentBlitBenchmark("graphics/transparent/scaled", TransparentBlitBenchmark::kModeScaled));
+	benchmarks.push_back(new TransBlitFromBenchmark("graphics/transblit/clut8", formatCLUT8()));
+	benchmarks.push_back(new TransBlitFromBenchmark("graphics/transblit/rgb565", formatRGB565()));
+	benchmarks.push_back(new TransBlitFromBenchmark("graphics/transblit/rgba8888", formatRGBA8888()));
+
+	InitScalers(565);
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/normal1x", Normal1x, 1));
+#ifdef USE_SCALERS
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/normal2x", Normal2x, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/normal3x", Normal3x, 3));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/advmame2x", AdvMame2x, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/advmame3x", AdvMame3x, 3));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/2xsai", _2xSaI, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/super2xsai", Super2xSaI, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/supereagle", SuperEagle, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/tv2x", TV2x, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/dotmatrix", DotMatrix, 2));
+#ifdef USE_HQ_SCALERS
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/hq2x", HQ2x, 2));
+	benchmarks.push_back(new ScalerBenchmark("graphics/scaler/hq3x", HQ3x, 3));
+#endif
+#endif
+
+	benchmarks.push_back(new YUVBenchmark("graphics/yuv/444-rgb565", YUVBenchmark::k444, formatRGB565(), 640, 480));
+	benchmarks.push_back(new YUVBenchmark("graphics/yuv/444-xrgb8888", YUVBenchmark::k444, formatXRGB8888(), 640, 480));
+	benchmarks.push_back(new YUVBenchmark("graphics/yuv/420-rgb565", YUVBenchmark::k420, formatRGB565(), 640, 480));
+	benchmarks.push_back(new YUVBenchmark("graphics/yuv/420-xrgb8888", YUVBenchmark::k420, formatXRGB8888(), 640, 480));
+	benchmarks.push_back(new YUVBenchmark("graphics/yuv/420-xrgb8888-720p", YUVBenchmark::k420, formatXRGB8888(), 1280, 720));
+	benchmarks.push_back(new YUVBenchmark("graphics/yuv/410-rgb565", YUVBenchmark::k410, formatRGB565(), 640, 480));
+
+	benchmarks.push_back(new PrimitivesBenchmark("graphics/primitives/line", PrimitivesBenchmark::kShapeLine));
+	benchmarks.push_back(new PrimitivesBenchmark("graphics/primitives/thickline", PrimitivesBenchmark::kShapeThickLine));
+	benchmarks.push_back(new PrimitivesBenchmark("graphics/primitives/filledrect", PrimitivesBenchmark::kShapeFilledRect));
+	benchmarks.push_back(new PrimitivesBenchmark("graphics/primitives/roundrect", PrimitivesBenchmark::kShapeRoundRect));
+	benchmarks.push_back(new PrimitivesBenchmark("graphics/primitives/ellipse", PrimitivesBenchmark::kShapeEllipse));
+
+	for (uint i = 0; i < benchmarks.size(); i++) {
+		if (benchmarks[i]->getName().hasPrefix(options.filter))
+			runBenchmark(*benchmarks[i]);
+		delete benchmarks[i];
+	}
+
+	DestroyScalers();
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,204 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Headless benchmarks of performance critical code paths. Use the 'bench'
+// target to build and run them, and 'test/bench --help' for the options.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/system.h"
+
+#include "test/null_osystem.h"
+#include "test/benchmark/benchmark.h"
+
+static uint32 g_allocationCount = 0;
+
+void *operator new(size_t size) {
+	g_allocationCount++;
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		abort();
+	return ptr;
+}
+
+void *operator new[](size_t size) {
+	g_allocationCount++;
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		abort();
+	return ptr;
+}
+
+void operator delete(void *ptr) throw() {
+	free(ptr);
+}
+
+void operator delete[](void *ptr) throw() {
+	free(ptr);
+}
+
+namespace Benchmark {
+
+uint64 getNanoseconds() {
+#if defined(WIN32)
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (uint64)(counter.QuadPart / (double)frequency.QuadPart * 1e9);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+uint32 getAllocationCount() {
+	return g_allocationCount;
+}
+
+typedef Common::HashMap<Common::String, double> ResultMap;
+
+static ResultMap *g_baseline = 0;
+static Common::Array<Common::String> *g_resultNames = 0;
+static ResultMap *g_results = 0;
+
+double recordResult(const Common::String &name, double value) {
+	if (!g_results->contains(name))
+		g_resultNames->push_back(name);
+	(*g_results)[name] = value;
+
+	return g_baseline->getValOrDefault(name, 0.0);
+}
+
+/** Baselines are text files with one result per line, as the name followed by the value. */
+static bool loadBaseline(const Common::String &path) {
+	FILE *file = fopen(path.c_str(), "r");
+	if (!file)
+		return false;
+
+	char name[256];
+	double value;
+	while (fscanf(file, "%255s %lf", name, &value) == 2)
+		(*g_baseline)[name] = value;
+
+	fclose(file);
+	return true;
+}
+
+static bool saveBaseline(const Common::String &path) {
+	FILE *file = fopen(path.c_str(), "w");
+	if (!file)
+		return false;
+
+	for (uint i = 0; i < g_resultNames->size(); i++)
+		fprintf(file, "%s %.3f\n", (*g_resultNames)[i].c_str(), (*g_results)[(*g_resultNames)[i]]);
+
+	return fclose(file) == 0;
+}
+
+} // End of namespace Benchmark
+
+static void usage() {
+	printf("Usage: bench [OPTIONS]\n"
+	       "  --filter=NAME              Only run benchmarks whose name starts with NAME,\n"
+	       "                             e.g. audio/raw/22050 or graphics/yuv\n"
+	       "  --data=DIR                 Directory with bench.mp3, bench.ogg and bench.flac\n"
+	       "  --baseline=FILE            Compare the results with those saved in FILE\n"
+	       "  --save-baseline=FILE       Save the results to FILE\n"
+	       "  --channels=NUM             Number of simultaneous sounds (default: 8)\n"
+	       "  --seconds=NUM              Length of audio to mix per run (default: 10)\n"
+	       "  --resampler-quality=NUM    Resampler quality to use (default: 0)\n");
+}
+
+static bool parseOption(const char *arg, const char *name, const char *&value) {
+	const size_t len = strlen(name);
+	if (strncmp(arg, name, len) != 0 || arg[len] != '=')
+		return false;
+	value = arg + len + 1;
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	Benchmark::Options options;
+
+	for (int i = 1; i < argc; i++) {
+		const char *value;
+		if (parseOption(argv[i], "--filter", value)) {
+			options.filter = value;
+		} else if (parseOption(argv[i], "--data", value)) {
+			options.dataPath = value;
+		} else if (parseOption(argv[i], "--baseline", value)) {
+			options.baselinePath = value;
+		} else if (parseOption(argv[i], "--save-baseline", value)) {
+			options.saveBaselinePath = value;
+		} else if (parseOption(argv[i], "--channels", value)) {
+			options.channels = MAX(1, atoi(value));
+		} else if (parseOption(argv[i], "--seconds", value)) {
+			options.seconds = MAX(1, atoi(value));
+		} else if (parseOption(argv[i], "--resampler-quality", value)) {
+			options.resamplerQuality = atoi(value);
+		} else {
+			usage();
+			return strcmp(argv[i], "--help") ? 1 : 0;
+		}
+	}
+
+	Benchmark::ResultMap baseline, results;
+	Common::Array<Common::String> resultNames;
+	Benchmark::g_baseline = &baseline;
+	Benchmark::g_results = &results;
+	Benchmark::g_resultNames = &resultNames;
+
+	if (!options.baselinePath.empty() && !Benchmark::loadBaseline(options.baselinePath)) {
+		printf("Could not read baseline file '%s'\n", options.baselinePath.c_str());
+		return 1;
+	}
+
+	Common::install_null_g_system();
+
+	// The suites only run the benchmarks matching the filter themselves
+	if (Common::String("audio/").hasPrefix(options.filter) || options.filter.hasPrefix("audio/"))
+		Benchmark::runAudioMixer(options);
+	if (Common::String("graphics/").hasPrefix(options.filter) || options.filter.hasPrefix("graphics/"))
+		Benchmark::runGraphics(options);
+
+	if (!options.saveBaselinePath.empty() && !Benchmark::saveBaseline(options.saveBaselinePath)) {
+		printf("Could not write baseline file '%s'\n", options.saveBaselinePath.c_str());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,278 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/blend_intern.h"
+
+#include "common/array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class BlendTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxWidth = 37,
+		// Colors are in the byte order of TransparentSurface on little
+		// endian systems, the only ones the kernels are used on
+		kAIndex = 0,
+		kBIndex = 1,
+		kGIndex = 2,
+		kRIndex = 3
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/** Random pixels, with plenty of fully transparent and opaque ones. */
+	void fillPixels(byte *data, uint width) {
+		for (uint i = 0; i < width * 4; i++)
+			data[i] = nextRandom() & 0xFF;
+
+		for (uint i = 0; i < width; i++) {
+			switch (nextRandom() % 3) {
+			case 0:
+				data[i * 4 + kAIndex] = 0;
+				break;
+			case 1:
+				data[i * 4 + kAIndex] = 0xFF;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	struct Kernels {
+		const char *name;
+		const Graphics::BlendKernels *kernels;
+	};
+
+	/** The kernels which were compiled in and which the CPU supports. */
+	Common::Array<Kernels> getKernels() {
+		Common::Array<Kernels> kernels;
+#ifdef SCUMM_LITTLE_ENDIAN
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			Kernels entry = { "SSE2", &Graphics::blendKernelsSSE2 };
+			kernels.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			Kernels entry = { "AVX2", &Graphics::blendKernelsAVX2 };
+			kernels.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			Kernels entry = { "NEON", &Graphics::blendKernelsNEON };
+			kernels.push_back(entry);
+		}
+#endif
+#endif
+		return kernels;
+	}
+
+	// The scalar loops of TransparentSurface and ManagedSurface, for a
+	// single pixel
+
+	static void blitOpaque(byte *out, const byte *in) {
+		memcpy(out, in, 4);
+		out[kAIndex] = 0xFF;
+	}
+
+	static void blitBinary(byte *out, const byte *in) {
+		if (in[kAIndex] != 0) {
+			memcpy(out, in, 4);
+			out[kAIndex] = 0xFF;
+		}
+	}
+
+	static void blitAlphaBlend(byte *out, const byte *in, uint32 color) {
+		if (color == 0xFFFFFFFF) {
+			if (in[kAIndex] != 0) {
+				out[kAIndex] = 255;
+				out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
+				out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
+				out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
+			}
+		} else {
+			const byte ca = (color >> 24) & 0xFF;
+			const byte cr = (color >> 16) & 0xFF;
+			const byte cg = (color >> 8) & 0xFF;
+			const byte cb = color & 0xFF;
+			const uint32 ina = in[kAIndex] * ca >> 8;
+
+			if (ina != 0) {
+				out[kAIndex] = 255;
+				out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8);
+				out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8);
+				out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8);
+
+				out[kBIndex] = out[kBIndex] + (in[kBIndex] * ina * cb >> 16);
+				out[kGIndex] = out[kGIndex] + (in[kGIndex] * ina * cg >> 16);
+				out[kRIndex] = out[kRIndex] + (in[kRIndex] * ina * cr >> 16);
+			}
+		}
+	}
+
+	enum Mode {
+		kModeOpaque,
+		kModeBinary,
+		kModeAlphaBlend
+	};
+
+	/**
+	 * Blit a row of @p width pixels with a kernel and pixel by pixel, and
+	 * check the pixels the kernel handled are the same.
+	 */
+	void checkBlit(const Kernels &kernels, Mode mode, uint width, bool flipped, uint32 color) {
+		byte in[kMaxWidth * 4];
+		byte out[kMaxWidth * 4];
+		byte expected[kMaxWidth * 4];
+
+		fillPixels(in, width);
+		fillPixels(out, kMaxWidth);
+		memcpy(expected, out, sizeof(out));
+
+		// A flipped row is read from its last pixel backwards
+		const int32 inStep = flipped ? -4 : 4;
+		const byte *inStart = flipped ? in + (width - 1) * 4 : in;
+
+		uint32 done = 0;
+		switch (mode) {
+		case kModeOpaque:
+			done = kernels.kernels->blitOpaque(out, inStart, width);
+			break;
+		case kModeBinary:
+			done = kernels.kernels->blitBinary(out, inStart, inStep, width);
+			break;
+		case kModeAlphaBlend:
+			done = kernels.kernels->blitAlphaBlend(out, inStart, inStep, width, color);
+			break;
+		}
+
+		TSM_ASSERT(kernels.name, done <= width);
+		for (uint32 i = 0; i < done; i++) {
+			const byte *pixel = inStart + (int32)i * inStep;
+			switch (mode) {
+			case kModeOpaque:
+				blitOpaque(expected + i * 4, pixel);
+				break;
+			case kModeBinary:
+				blitBinary(expected + i * 4, pixel);
+				break;
+			case kModeAlphaBlend:
+				blitAlphaBlend(expected + i * 4, pixel, color);
+				break;
+			}
+		}
+
+		// Pixels the kernel left over must be untouched
+		TSM_ASSERT_SAME_DATA(kernels.name, out, expected, sizeof(out));
+	}
+
+	template<typename T>
+	void checkTransCopy(const Kernels &kernels, uint width, T compareMask) {
+		T src[kMaxWidth];
+		T dst[kMaxWidth];
+		T expected[kMaxWidth];
+
+		const T transColor = (T)nextRandom();
+		for (uint i = 0; i < kMaxWidth; i++) {
+			// Make about half the pixels transparent, the bits outside of
+			// the mask do not matter for that
+			src[i] = (T)(nextRandom() | (nextRandom() << 16));
+			if (nextRandom() & 1)
+				src[i] = (transColor & compareMask) | (src[i] & ~compareMask);
+			dst[i] = expected[i] = (T)(nextRandom() | (nextRandom() << 16));
+		}
+
+		const uint32 done = transCopy(kernels, dst, src, width, transColor, compareMask);
+		TSM_ASSERT(kernels.name, done <= width);
+		for (uint i = 0; i < done; i++) {
+			if ((src[i] & compareMask) != (transColor & compareMask))
+				expected[i] = src[i];
+		}
+
+		TSM_ASSERT_SAME_DATA(kernels.name, dst, expected, sizeof(dst));
+	}
+
+	static uint32 transCopy(const Kernels &kernels, uint16 *dst, const uint16 *src, uint32 width, uint16 transColor, uint16 compareMask) {
+		return kernels.kernels->transCopy16(dst, src, width, transColor, compareMask);
+	}
+
+	static uint32 transCopy(const Kernels &kernels, uint32 *dst, const uint32 *src, uint32 width, uint32 transColor, uint32 compareMask) {
+		return kernels.kernels->transCopy32(dst, src, width, transColor, compareMask);
+	}
+
+public:
+	void test_blit_opaque() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 1;
+
+		const Common::Array<Kernels> kernels = getKernels();
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint width = 1; width <= kMaxWidth; width++)
+				checkBlit(kernels[k], kModeOpaque, width, false, 0xFFFFFFFF);
+		}
+#endif
+	}
+
+	void test_blit_binary() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 2;
+
+		const Common::Array<Kernels> kernels = getKernels();
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint width = 1; width <= kMaxWidth; width++) {
+				checkBlit(kernels[k], kModeBinary, width, false, 0xFFFFFFFF);
+				checkBlit(kernels[k], kModeBinary, width, true, 0xFFFFFFFF);
+			}
+		}
+#endif
+	}
+
+	void test_blit_alpha_blend() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 3;
+
+		const Common::Array<Kernels> kernels = getKernels();
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint width = 1; width <= kMaxWidth; width++) {
+				// Without and with color modulation, including a fully
+				// transparent and a fully opaque one
+				const uint32 colors[] = { 0xFFFFFFFF, 0x00FFFFFF, 0xFF808080, nextRandom() | (nextRandom() << 16) };
+				for (uint c = 0; c < ARRAYSIZE(colors); c++) {
+					checkBlit(kernels[k], kModeAlphaBlend, width, false, colors[c]);
+					checkBlit(kernels[k], kModeAlphaBlend, width, true, colors[c]);
+				}
+			}
+		}
+#endif
+	}
+
+	void test_trans_copy() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 4;
+
+		const Common::Array<Kernels> kernels = getKernels();
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint width = 1; width <= kMaxWidth; width++) {
+				checkTransCopy<uint16>(kernels[k], width, 0xFFFF);
+				// Only RGB is compared in 32bpp, with alpha in either end
+				checkTransCopy<uint32>(kernels[k], width, 0x00FFFFFF);
+				checkTransCopy<uint32>(kernels[k], width, 0xFFFFFF00);
+			}
+		}
+#endif
+	}
+};
@@ -0,0 +1,176 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/conversion.h"
+#include "graphics/conversion_intern.h"
+#include "graphics/pixelformat.h"
+
+#include "common/array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class ConversionTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxWidth = 67,
+		kHeight = 3
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	void fillRandom(byte *data, uint size) {
+		for (uint i = 0; i < size; i++)
+			data[i] = nextRandom() & 0xFF;
+	}
+
+	struct Kernel {
+		const char *name;
+		Graphics::CrossBlitRowFunc func;
+	};
+
+	/** The kernels which were compiled in and which the CPU supports. */
+	Common::Array<Kernel> getKernels() {
+		Common::Array<Kernel> kernels;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			Kernel kernel = { "SSE2", Graphics::crossBlitRowSSE2 };
+			kernels.push_back(kernel);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			Kernel kernel = { "AVX2", Graphics::crossBlitRowAVX2 };
+			kernels.push_back(kernel);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			Kernel kernel = { "NEON", Graphics::crossBlitRowNEON };
+			kernels.push_back(kernel);
+		}
+#endif
+		return kernels;
+	}
+
+	Common::Array<Graphics::PixelFormat> getFormats() {
+		Common::Array<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));   // RGB565
+		formats.push_back(Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0));   // RGB555
+		formats.push_back(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15));  // ARGB1555
+		formats.push_back(Graphics::PixelFormat(2, 5, 5, 5, 1, 0, 5, 10, 15));  // ABGR1555
+		formats.push_back(Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0));   // RGBA4444
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));  // RGBA8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));  // ARGB8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));  // ABGR8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0));  // BGRA8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));   // XRGB8888
+		formats.push_back(Graphics::PixelFormat(4, 3, 3, 2, 0, 5, 2, 0, 0));    // RGB332, not supported by the kernels
+		return formats;
+	}
+
+	static uint32 readPixel(const byte *src, uint bytesPerPixel) {
+		return bytesPerPixel == 2 ? *(const uint16 *)src : *(const uint32 *)src;
+	}
+
+	/** Convert like crossBlitLogic() does, one pixel at a time. */
+	static void convertReference(byte *dst, const byte *src, uint w, const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+		for (uint x = 0; x < w; x++) {
+			byte a, r, g, b;
+			srcFmt.colorToARGB(readPixel(src + x * srcFmt.bytesPerPixel, srcFmt.bytesPerPixel), a, r, g, b);
+			const uint32 color = dstFmt.ARGBToColor(a, r, g, b);
+			if (dstFmt.bytesPerPixel == 2)
+				*(uint16 *)(dst + x * 2) = color;
+			else
+				*(uint32 *)(dst + x * 4) = color;
+		}
+	}
+
+public:
+	void test_kernels_match_scalar_code() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 1;
+
+		const Common::Array<Kernel> kernels = getKernels();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+
+		uint32 src[kMaxWidth + 1];
+		uint32 expected[kMaxWidth + 1];
+		uint32 dst[kMaxWidth + 1];
+
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint i = 0; i < formats.size(); i++) {
+				for (uint j = 0; j < formats.size(); j++) {
+					const Graphics::PixelFormat &srcFmt = formats[i];
+					const Graphics::PixelFormat &dstFmt = formats[j];
+
+					Graphics::CrossBlitPlan plan;
+					if (i == j || !plan.init(srcFmt, dstFmt))
+						continue;
+
+					for (uint w = 1; w <= kMaxWidth; w++) {
+						fillRandom((byte *)src, sizeof(src));
+						convertReference((byte *)expected, (const byte *)src, w, dstFmt, srcFmt);
+
+						// The kernel must not touch anything past the row
+						memset(dst, 0xCD, sizeof(dst));
+						const uint done = kernels[k].func((byte *)dst, (const byte *)src, w, plan);
+						TSM_ASSERT(kernels[k].name, done <= w);
+						if (w >= 32)
+							TSM_ASSERT(kernels[k].name, done > 0);
+						TSM_ASSERT_SAME_DATA(kernels[k].name, dst, expected, done * dstFmt.bytesPerPixel);
+
+						const byte *end = (const byte *)dst + done * dstFmt.bytesPerPixel;
+						for (const byte *p = end; p < (const byte *)(dst + kMaxWidth + 1); p++)
+							TSM_ASSERT_EQUALS(kernels[k].name, *p, 0xCD);
+					}
+				}
+			}
+		}
+#endif
+	}
+
+	void test_crossblit_matches_scalar_code() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 2;
+
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+
+		// Rows are padded, so the pitch is not a multiple of the width
+		const uint pitch = (kMaxWidth + 1) * 4;
+		byte src[pitch * kHeight];
+		byte expected[pitch * kHeight];
+		byte dst[pitch * kHeight];
+
+		for (uint i = 0; i < formats.size(); i++) {
+			for (uint j = 0; j < formats.size(); j++) {
+				const Graphics::PixelFormat &srcFmt = formats[i];
+				const Graphics::PixelFormat &dstFmt = formats[j];
+
+				// Same formats are copied as they are, including unused bits
+				if (i == j)
+					continue;
+
+				for (uint w = 1; w <= kMaxWidth; w += 2) {
+					fillRandom(src, sizeof(src));
+					memset(expected, 0xCD, sizeof(expected));
+					memset(dst, 0xCD, sizeof(dst));
+
+					for (uint y = 0; y < kHeight; y++)
+						convertReference(expected + y * pitch, src + y * pitch, w, dstFmt, srcFmt);
+
+					TS_ASSERT(Graphics::crossBlit(dst, src, pitch, pitch, w, kHeight, dstFmt, srcFmt));
+					TS_ASSERT_SAME_DATA(dst, expected, sizeof(dst));
+				}
+			}
+		}
+#endif
+	}
+};
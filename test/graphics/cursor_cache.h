@@ -0,0 +1,146 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/cursor_cache.h"
+
+class CursorCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	struct Params {
+		int scale;
+		uint32 keyColor;
+	};
+
+	/** Make a 4x3 CLUT8 image filled with @p color. */
+	static void makeImage(Graphics::Surface &image, byte color) {
+		image.create(4, 3, Graphics::PixelFormat::createFormatCLUT8());
+		image.fillRect(Common::Rect(4, 3), color);
+	}
+
+	static Params makeParams(int scale, uint32 keyColor) {
+		Params params;
+		memset(&params, 0, sizeof(params));
+		params.scale = scale;
+		params.keyColor = keyColor;
+		return params;
+	}
+
+	static bool isFilledWith(const Graphics::Surface *image, byte color) {
+		if (!image || image->w != 4 || image->h != 3)
+			return false;
+		for (int y = 0; y < image->h; y++) {
+			for (int x = 0; x < image->w; x++) {
+				if (*(const byte *)image->getBasePtr(x, y) != color)
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_hit_and_miss() {
+		Graphics::CursorCache cache;
+		const byte data[] = { 1, 2, 3, 4, 5, 6 };
+		const Params params = makeParams(2, 0);
+
+		TS_ASSERT(!cache.find(data, sizeof(data), &params, sizeof(params)));
+
+		Graphics::Surface image;
+		makeImage(image, 7);
+		const Graphics::Surface *inserted = cache.insert(data, sizeof(data), &params, sizeof(params), image);
+
+		// The cache keeps its own copy of the image
+		TS_ASSERT(inserted);
+		TS_ASSERT_DIFFERS(inserted->getPixels(), image.getPixels());
+		image.fillRect(Common::Rect(4, 3), 9);
+		image.free();
+
+		const Graphics::Surface *found = cache.find(data, sizeof(data), &params, sizeof(params));
+		TS_ASSERT_EQUALS(found, inserted);
+		TS_ASSERT(isFilledWith(found, 7));
+
+		// Inserting the same key again replaces the image
+		makeImage(image, 8);
+		TS_ASSERT_EQUALS(cache.insert(data, sizeof(data), &params, sizeof(params), image), inserted);
+		TS_ASSERT(isFilledWith(cache.find(data, sizeof(data), &params, sizeof(params)), 8));
+		image.free();
+
+		cache.clear();
+		TS_ASSERT(!cache.find(data, sizeof(data), &params, sizeof(params)));
+	}
+
+	void test_key_comparison() {
+		Graphics::CursorCache cache;
+		const byte data[] = { 1, 2, 3, 4, 5, 6 };
+		const byte otherData[] = { 1, 2, 3, 4, 5, 7 };
+		const Params params = makeParams(2, 0);
+
+		Graphics::Surface image;
+		makeImage(image, 1);
+		cache.insert(data, sizeof(data), &params, sizeof(params), image);
+		image.free();
+
+		// Any difference in the data or in the parameters is a miss
+		const Params otherScale = makeParams(3, 0);
+		const Params otherKey = makeParams(2, 255);
+		TS_ASSERT(!cache.find(otherData, sizeof(otherData), &params, sizeof(params)));
+		TS_ASSERT(!cache.find(data, sizeof(data) - 1, &params, sizeof(params)));
+		TS_ASSERT(!cache.find(data, sizeof(data), &otherScale, sizeof(otherScale)));
+		TS_ASSERT(!cache.find(data, sizeof(data), &otherKey, sizeof(otherKey)));
+		TS_ASSERT(!cache.find(data, sizeof(data), &params, sizeof(params) - 1));
+
+		// The key is the parameters followed by the data, moving bytes from
+		// one to the other does not make it match
+		byte joined[sizeof(params) + sizeof(data)];
+		memcpy(joined, &params, sizeof(params));
+		memcpy(joined + sizeof(params), data, sizeof(data));
+		TS_ASSERT(!cache.find(joined + sizeof(params) - 1, sizeof(data) + 1, joined, sizeof(params) - 1));
+
+		// Copies of the key do match
+		const Params sameParams = makeParams(2, 0);
+		byte sameData[sizeof(data)];
+		memcpy(sameData, data, sizeof(data));
+		TS_ASSERT(isFilledWith(cache.find(sameData, sizeof(sameData), &sameParams, sizeof(sameParams)), 1));
+
+		// Entries for the same data with other parameters are kept apart
+		makeImage(image, 2);
+		cache.insert(data, sizeof(data), &otherScale, sizeof(otherScale), image);
+		image.free();
+		TS_ASSERT(isFilledWith(cache.find(data, sizeof(data), &params, sizeof(params)), 1));
+		TS_ASSERT(isFilledWith(cache.find(data, sizeof(data), &otherScale, sizeof(otherScale)), 2));
+	}
+
+	void test_lru_eviction() {
+		Graphics::CursorCache cache(3);
+		const Params params = makeParams(1, 0);
+		byte data[4][2] = { { 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 3 } };
+
+		Graphics::Surface image;
+		for (int i = 0; i < 3; i++) {
+			makeImage(image, i);
+			cache.insert(data[i], sizeof(data[i]), &params, sizeof(params), image);
+			image.free();
+		}
+
+		// Using the oldest entry makes the second one the least recently used
+		TS_ASSERT(cache.find(data[0], sizeof(data[0]), &params, sizeof(params)));
+
+		makeImage(image, 3);
+		cache.insert(data[3], sizeof(data[3]), &params, sizeof(params), image);
+		image.free();
+
+		TS_ASSERT(isFilledWith(cache.find(data[0], sizeof(data[0]), &params, sizeof(params)), 0));
+		TS_ASSERT(!cache.find(data[1], sizeof(data[1]), &params, sizeof(params)));
+		TS_ASSERT(isFilledWith(cache.find(data[2], sizeof(data[2]), &params, sizeof(params)), 2));
+		TS_ASSERT(isFilledWith(cache.find(data[3], sizeof(data[3]), &params, sizeof(params)), 3));
+
+		// Now entry 0 is the least recently used one
+		makeImage(image, 1);
+		cache.insert(data[1], sizeof(data[1]), &params, sizeof(params), image);
+		image.free();
+
+		TS_ASSERT(!cache.find(data[0], sizeof(data[0]), &params, sizeof(params)));
+		TS_ASSERT(isFilledWith(cache.find(data[1], sizeof(data[1]), &params, sizeof(params)), 1));
+		TS_ASSERT(isFilledWith(cache.find(data[2], sizeof(data[2]), &params, sizeof(params)), 2));
+		TS_ASSERT(isFilledWith(cache.find(data[3], sizeof(data[3]), &params, sizeof(params)), 3));
+	}
+};
@@ -0,0 +1,250 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_region.h"
+
+#include "common/array.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 200,
+		kHeight = 150,
+		kTileWidth = 16,
+		kTileHeight = 20
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	Common::Rect randomRect(int maxSize) {
+		const int x = (int)(nextRandom() % (kWidth + 20)) - 10;
+		const int y = (int)(nextRandom() % (kHeight + 20)) - 10;
+		return Common::Rect(x, y, x + 1 + nextRandom() % maxSize, y + 1 + nextRandom() % maxSize);
+	}
+
+	/** Count, for each pixel, how many of @p rects cover it. */
+	static void coverage(const Common::Array<Common::Rect> &rects, uint start, byte *counts) {
+		memset(counts, 0, kWidth * kHeight);
+		for (uint i = start; i < rects.size(); i++) {
+			const Common::Rect &r = rects[i];
+			for (int y = r.top; y < r.bottom; y++)
+				for (int x = r.left; x < r.right; x++)
+					counts[y * kWidth + x]++;
+		}
+	}
+
+	static void mark(const Common::Rect &rect, byte *marked) {
+		Common::Rect r = rect;
+		r.clip(Common::Rect(kWidth, kHeight));
+		for (int y = r.top; y < r.bottom; y++)
+			memset(marked + y * kWidth + r.left, 1, r.width());
+	}
+
+	/** Mark the whole tiles which contain a marked pixel. */
+	static void markDirtyTiles(const byte *marked, byte *tiles) {
+		memset(tiles, 0, kWidth * kHeight);
+		for (int ty = 0; ty < kHeight; ty += kTileHeight) {
+			for (int tx = 0; tx < kWidth; tx += kTileWidth) {
+				const Common::Rect tile(tx, ty, tx + kTileWidth, ty + kTileHeight);
+				bool dirty = false;
+				for (int y = ty; y < MIN<int>(tile.bottom, kHeight); y++) {
+					for (int x = tx; x < MIN<int>(tile.right, kWidth); x++)
+						dirty |= marked[y * kWidth + x] != 0;
+				}
+				if (dirty)
+					mark(tile, tiles);
+			}
+		}
+	}
+
+	/**
+	 * Check that the rectangles from @p start on lie inside the area, do
+	 * not overlap and cover all marked pixels. Returns the number of
+	 * covered pixels which were not marked.
+	 */
+	int checkRects(const Common::Array<Common::Rect> &rects, uint start, const byte *marked) {
+		byte *counts = new byte[kWidth * kHeight];
+
+		for (uint i = start; i < rects.size(); i++) {
+			TS_ASSERT(!rects[i].isEmpty());
+			TS_ASSERT(Common::Rect(kWidth, kHeight).contains(rects[i]));
+		}
+		coverage(rects, start, counts);
+
+		int overlapping = 0, missing = 0, extra = 0;
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			if (counts[i] > 1)
+				overlapping++;
+			if (marked[i] && !counts[i])
+				missing++;
+			if (!marked[i] && counts[i])
+				extra++;
+		}
+		TS_ASSERT_EQUALS(overlapping, 0);
+		TS_ASSERT_EQUALS(missing, 0);
+
+		delete[] counts;
+		return extra;
+	}
+
+	/** Return the number of pixels covered by @p rects outside of @p allowed. */
+	int countOutside(const Common::Array<Common::Rect> &rects, const byte *allowed) {
+		byte *counts = new byte[kWidth * kHeight];
+		coverage(rects, 0, counts);
+
+		int outside = 0;
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			if (counts[i] && !allowed[i])
+				outside++;
+		}
+
+		delete[] counts;
+		return outside;
+	}
+
+public:
+	void test_rects_stay_in_dirty_tiles() {
+		_seed = 1;
+		byte *marked = new byte[kWidth * kHeight];
+		byte *tiles = new byte[kWidth * kHeight];
+
+		for (int round = 0; round < 50; round++) {
+			Graphics::DirtyRegion region(kTileWidth, kTileHeight);
+			region.setSize(kWidth, kHeight);
+			memset(marked, 0, kWidth * kHeight);
+
+			const int count = 1 + nextRandom() % 20;
+			const int maxSize = round % 2 ? 12 : 90;
+			for (int i = 0; i < count; i++) {
+				const Common::Rect r = randomRect(maxSize);
+				region.addRect(r);
+				mark(r, marked);
+			}
+
+			// Without a limit, the rects cover all dirty pixels, and only
+			// clean pixels of tiles which are dirty as well
+			Common::Array<Common::Rect> rects;
+			region.getRects(rects, kWidth * kHeight);
+			checkRects(rects, 0, marked);
+			markDirtyTiles(marked, tiles);
+			TS_ASSERT_EQUALS(countOutside(rects, tiles), 0);
+		}
+
+		delete[] marked;
+		delete[] tiles;
+	}
+
+	void test_tile_aligned_rects_are_exact() {
+		Graphics::DirtyRegion region(kTileWidth, kTileHeight);
+		region.setSize(kWidth, kHeight);
+
+		byte *marked = new byte[kWidth * kHeight];
+		memset(marked, 0, kWidth * kHeight);
+
+		const Common::Rect marks[] = {
+			Common::Rect(0, 0, 3 * kTileWidth, kTileHeight),
+			Common::Rect(kTileWidth, kTileHeight, 2 * kTileWidth, 4 * kTileHeight),
+			Common::Rect(5 * kTileWidth, 2 * kTileHeight, kWidth, kHeight),
+			Common::Rect(37, 45, 38, 46)
+		};
+		for (uint i = 0; i < ARRAYSIZE(marks); i++) {
+			region.addRect(marks[i]);
+			mark(marks[i], marked);
+		}
+
+		// The rects are appended to the ones already in the array
+		Common::Array<Common::Rect> rects;
+		rects.push_back(Common::Rect(1, 1));
+		region.getRects(rects, 16);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(1, 1));
+		TS_ASSERT_EQUALS(checkRects(rects, 1, marked), 0);
+		TS_ASSERT_EQUALS(region.getBounds(), Common::Rect(0, 0, kWidth, kHeight));
+
+		delete[] marked;
+	}
+
+	void test_max_rects() {
+		_seed = 2;
+		byte *marked = new byte[kWidth * kHeight];
+
+		for (uint maxRects = 1; maxRects <= 12; maxRects++) {
+			Graphics::DirtyRegion region(kTileWidth, kTileHeight);
+			region.setSize(kWidth, kHeight);
+			memset(marked, 0, kWidth * kHeight);
+
+			// Scattered single pixels, far more than the limit
+			for (int i = 0; i < 200; i++) {
+				const Common::Rect r = randomRect(2);
+				region.addRect(r);
+				mark(r, marked);
+			}
+
+			Common::Array<Common::Rect> rects;
+			region.getRects(rects, maxRects);
+			TS_ASSERT_LESS_THAN_EQUALS(rects.size(), maxRects);
+			checkRects(rects, 0, marked);
+		}
+
+		delete[] marked;
+	}
+
+	void test_set_size_keeps_areas() {
+		Graphics::DirtyRegion region(kTileWidth, kTileHeight);
+		region.setSize(kWidth / 2, kHeight / 2);
+		region.addRect(Common::Rect(5, 7, 30, 33));
+		region.addRect(Common::Rect(60, 50, 90, 70));
+
+		byte *marked = new byte[kWidth * kHeight];
+		memset(marked, 0, kWidth * kHeight);
+		mark(Common::Rect(5, 7, 30, 33), marked);
+		mark(Common::Rect(60, 50, 90, 70), marked);
+
+		// Growing keeps everything
+		region.setSize(kWidth, kHeight);
+		TS_ASSERT_EQUALS(region.getWidth(), kWidth);
+		TS_ASSERT_EQUALS(region.getBounds(), Common::Rect(5, 7, 90, 70));
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects, 16);
+		TS_ASSERT_EQUALS(checkRects(rects, 0, marked), 0);
+
+		// Shrinking keeps what is still inside
+		region.setSize(70, 60);
+		TS_ASSERT_EQUALS(region.getBounds(), Common::Rect(5, 7, 70, 60));
+		memset(marked, 0, kWidth * kHeight);
+		mark(Common::Rect(5, 7, 30, 33), marked);
+		mark(Common::Rect(60, 50, 70, 60), marked);
+		rects.clear();
+		region.getRects(rects, 16);
+		TS_ASSERT_EQUALS(checkRects(rects, 0, marked), 0);
+
+		delete[] marked;
+	}
+
+	void test_clear() {
+		Graphics::DirtyRegion region(kTileWidth, kTileHeight);
+		region.setSize(kWidth, kHeight);
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(10, 10, 150, 120));
+		region.addRect(Common::Rect(-5, -5, 0, 0));
+		TS_ASSERT(!region.isEmpty());
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+		TS_ASSERT(region.getBounds().isEmpty());
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects, 16);
+		TS_ASSERT_EQUALS(rects.size(), 0U);
+
+		// Nothing of the old areas comes back
+		region.addRect(Common::Rect(40, 40, 41, 41));
+		region.getRects(rects, 16);
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(40, 40, 41, 41));
+	}
+};
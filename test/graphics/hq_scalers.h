@@ -0,0 +1,214 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixelformat.h"
+#include "graphics/scaler.h"
+
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq_intern.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class HQScalersTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_HQ_SCALERS
+private:
+	enum {
+		kMaxWidth = 300,
+		kHeight = 5
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/** Whether @p a and @p b differ by exactly the threshold of diffYUV(), or by one more. */
+	static bool isAtThreshold(uint16 a, uint16 b) {
+		const int yuvA = RGBtoYUV[a], yuvB = RGBtoYUV[b];
+		const int y = ABS(((yuvA >> 16) & 0xFF) - ((yuvB >> 16) & 0xFF));
+		const int u = ABS(((yuvA >> 8) & 0xFF) - ((yuvB >> 8) & 0xFF));
+		const int v = ABS((yuvA & 0xFF) - (yuvB & 0xFF));
+		return y == 0x30 || y == 0x31 || u == 0x07 || u == 0x08 || v == 0x06 || v == 0x07;
+	}
+
+	uint16 nudge(uint16 color, const Graphics::PixelFormat &format) {
+		byte r, g, b;
+		format.colorToRGB(color, r, g, b);
+		r = CLIP<int>(r + (int)(nextRandom() % 97) - 48, 0, 255);
+		g = CLIP<int>(g + (int)(nextRandom() % 97) - 48, 0, 255);
+		b = CLIP<int>(b + (int)(nextRandom() % 97) - 48, 0, 255);
+		return format.RGBToColor(r, g, b);
+	}
+
+	/**
+	 * Fill an image with random pixels. With @p edges set, most pixels
+	 * differ from their left neighbor by just about the thresholds of
+	 * diffYUV(), and the rows repeat with small changes. Returns how many
+	 * pixels are right at a threshold.
+	 */
+	int fillImage(uint16 *pixels, uint size, uint pitch, const Graphics::PixelFormat &format, bool edges) {
+		int atThreshold = 0;
+
+		for (uint i = 0; i < size; i++) {
+			uint16 color = nextRandom();
+			if (format.gLoss == 3)
+				color &= 0x7FFF;
+
+			if (edges && i % pitch != 0) {
+				const uint16 left = pixels[i - 1];
+				if (i >= pitch && nextRandom() % 4 == 0) {
+					color = pixels[i - pitch];
+				} else {
+					color = nudge(left, format);
+					for (int tries = 0; tries < 32 && !isAtThreshold(left, color); tries++)
+						color = nudge(left, format);
+				}
+
+				if (isAtThreshold(left, color))
+					atThreshold++;
+			}
+
+			pixels[i] = color;
+		}
+
+		return atThreshold;
+	}
+
+	struct PatternProc {
+		const char *name;
+		HQPatternProc *proc;
+		int bitFormat;
+	};
+
+	/** The pattern functions which were compiled in and which the CPU supports. */
+	Common::Array<PatternProc> getPatternProcs() {
+		Common::Array<PatternProc> procs;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			PatternProc proc565 = { "SSE2 565", computeHQPatterns565SSE2, 565 };
+			PatternProc proc555 = { "SSE2 555", computeHQPatterns555SSE2, 555 };
+			procs.push_back(proc565);
+			procs.push_back(proc555);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			PatternProc proc565 = { "NEON 565", computeHQPatterns565NEON, 565 };
+			PatternProc proc555 = { "NEON 555", computeHQPatterns555NEON, 555 };
+			procs.push_back(proc565);
+			procs.push_back(proc555);
+		}
+#endif
+		return procs;
+	}
+
+	static Graphics::PixelFormat getFormat(int bitFormat) {
+		return bitFormat == 565 ? Graphics::createPixelFormat<565>() : Graphics::createPixelFormat<555>();
+	}
+
+	/**
+	 * Scale an image with the hq scaler @p scaler once with the scalar
+	 * pattern code and once with the SIMD one, and check that the results
+	 * are the same.
+	 */
+	void checkScaler(ScalerProc *scaler, int scale, int bitFormat, int width, bool edges) {
+		const Graphics::PixelFormat format = getFormat(bitFormat);
+
+		// The scalers read one pixel around the image
+		const uint srcPitch = width + 2;
+		Common::Array<uint16> src(srcPitch * (kHeight + 2));
+		const uint dstPitch = width * scale;
+		Common::Array<uint16> expected(dstPitch * kHeight * scale);
+		Common::Array<uint16> dst(dstPitch * kHeight * scale);
+
+		InitScalers(bitFormat);
+		fillImage(&src[0], src.size(), srcPitch, format, edges);
+		const uint8 *srcPtr = (const uint8 *)&src[srcPitch + 1];
+
+		// Without a system, InitScalers() does not pick a SIMD version
+		OSystem *system = g_system;
+		g_system = 0;
+		InitScalers(bitFormat);
+		g_system = system;
+		scaler(srcPtr, srcPitch * 2, (uint8 *)&expected[0], dstPitch * 2, width, kHeight);
+
+		InitScalers(bitFormat);
+		scaler(srcPtr, srcPitch * 2, (uint8 *)&dst[0], dstPitch * 2, width, kHeight);
+
+		TS_ASSERT_SAME_DATA(&dst[0], &expected[0], dst.size() * 2);
+	}
+
+	void checkScalers(bool edges) {
+		const int widths[] = { 1, 2, 7, 8, 9, 15, 16, 17, 31, 33, 63, 67, 255, 256, 257, kMaxWidth };
+		const int bitFormats[] = { 565, 555 };
+
+		for (uint f = 0; f < ARRAYSIZE(bitFormats); f++) {
+			for (uint w = 0; w < ARRAYSIZE(widths); w++) {
+				checkScaler(HQ2x, 2, bitFormats[f], widths[w], edges);
+				checkScaler(HQ3x, 3, bitFormats[f], widths[w], edges);
+			}
+		}
+
+		DestroyScalers();
+	}
+#endif
+
+public:
+	void test_patterns_match_scalar_code() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_HQ_SCALERS)
+		Common::install_null_g_system();
+		_seed = 1;
+
+		const Common::Array<PatternProc> procs = getPatternProcs();
+		for (uint i = 0; i < procs.size(); i++) {
+			const Graphics::PixelFormat format = getFormat(procs[i].bitFormat);
+			InitScalers(procs[i].bitFormat);
+
+			int atThreshold = 0;
+			for (int width = 1; width <= 67; width++) {
+				for (int edges = 0; edges < 2; edges++) {
+					// Three rows, with one more pixel on either side
+					const int pitch = width + 2;
+					uint16 pixels[3 * (67 + 2)];
+					atThreshold += fillImage(pixels, 3 * pitch, pitch, format, edges != 0);
+
+					const uint16 *p = pixels + pitch + 1;
+					uint8 patterns[67];
+					const int done = procs[i].proc(p, pitch, width, patterns);
+					TSM_ASSERT(procs[i].name, done <= width);
+					if (width >= 16)
+						TSM_ASSERT(procs[i].name, done > 0);
+
+					for (int x = 0; x < done; x++) {
+						const uint16 *c = p + x;
+						const int expected = computeHQPattern(c[-1 - pitch], c[-pitch], c[1 - pitch],
+						                                      c[-1], c[0], c[1],
+						                                      c[-1 + pitch], c[pitch], c[1 + pitch]);
+						TSM_ASSERT_EQUALS(procs[i].name, patterns[x], expected);
+					}
+				}
+			}
+
+			// Make sure the thresholds were actually put to the test
+			TSM_ASSERT_LESS_THAN(procs[i].name, 500, atThreshold);
+		}
+
+		DestroyScalers();
+#endif
+	}
+
+	void test_hq_scalers_match_scalar_code() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_HQ_SCALERS)
+		Common::install_null_g_system();
+		_seed = 2;
+		checkScalers(false);
+		checkScalers(true);
+#endif
+	}
+};
@@ -0,0 +1,288 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixelformat.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zbuffer.h"
+#include "graphics/tinygl/zspan_intern.h"
+#endif
+
+#include "common/array.h"
+#include "common/rect.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class TinyGLSpanTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_TINYGL
+private:
+	enum {
+		kMaxWidth = 37,
+		kStates = 300,
+		kTriangleWidth = 64,
+		kTriangleHeight = 48
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	uint32 nextRandom32() {
+		return nextRandom() | (nextRandom() << 16);
+	}
+
+	struct Kernels {
+		const char *name;
+		const TinyGL::SpanKernels *kernels;
+	};
+
+	/** The kernels which were compiled in and which the CPU supports. */
+	Common::Array<Kernels> getKernels() {
+		Common::Array<Kernels> kernels;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			Kernels entry = { "SSE2", &TinyGL::spanKernelsSSE2 };
+			kernels.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			Kernels entry = { "NEON", &TinyGL::spanKernelsNEON };
+			kernels.push_back(entry);
+		}
+#endif
+		return kernels;
+	}
+
+	/** The framebuffer formats the kernels support. */
+	Common::Array<Graphics::PixelFormat> getFormats() {
+		Common::Array<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));  // XRGB8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)); // RGBA8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24)); // ABGR8888
+		return formats;
+	}
+
+	/** Set up random depth, alpha and blending state, the same on both framebuffers. */
+	void setRandomState(TinyGL::FrameBuffer &fb1, TinyGL::FrameBuffer &fb2, TinyGL::SpanParams &params) {
+		static const int funcs[] = { TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS };
+		static const int sourceFactors[] = { TGL_ZERO, TGL_ONE, TGL_DST_COLOR, TGL_ONE_MINUS_DST_COLOR, TGL_SRC_ALPHA,
+		                                     TGL_ONE_MINUS_SRC_ALPHA, TGL_DST_ALPHA, TGL_ONE_MINUS_DST_ALPHA, TGL_SRC_ALPHA_SATURATE };
+		static const int destinationFactors[] = { TGL_ZERO, TGL_ONE, TGL_SRC_COLOR, TGL_ONE_MINUS_SRC_COLOR, TGL_SRC_ALPHA,
+		                                          TGL_ONE_MINUS_SRC_ALPHA, TGL_DST_ALPHA, TGL_ONE_MINUS_DST_ALPHA };
+
+		params.depthTest = nextRandom() % 4 != 0;
+		params.depthFunc = funcs[nextRandom() % ARRAYSIZE(funcs)];
+		params.depthWrite = nextRandom() % 3 != 0;
+		params.alphaTest = nextRandom() % 3 == 0;
+		params.alphaTestFunc = funcs[nextRandom() % ARRAYSIZE(funcs)];
+		params.alphaTestRefVal = nextRandom() % 256;
+		params.blending = nextRandom() % 2 == 0;
+		params.sourceBlendingFactor = sourceFactors[nextRandom() % ARRAYSIZE(sourceFactors)];
+		params.destinationBlendingFactor = destinationFactors[nextRandom() % ARRAYSIZE(destinationFactors)];
+
+		TinyGL::FrameBuffer *fbs[] = { &fb1, &fb2 };
+		for (int i = 0; i < 2; i++) {
+			fbs[i]->enableDepthTest(params.depthTest);
+			fbs[i]->setDepthFunc(params.depthFunc);
+			fbs[i]->enableDepthWrite(params.depthWrite);
+			fbs[i]->enableAlphaTest(params.alphaTest);
+			fbs[i]->setAlphaTestFunc(params.alphaTestFunc, params.alphaTestRefVal);
+			fbs[i]->enableBlending(params.blending);
+			fbs[i]->setBlendingFactors(params.sourceBlendingFactor, params.destinationBlendingFactor);
+		}
+	}
+
+	/**
+	 * Draw a span pixel by pixel, like putPixelSmooth() and
+	 * putPixelTextureMappingPerspective() in ztriangle.cpp do.
+	 */
+	static void drawReference(TinyGL::FrameBuffer &fb, const TinyGL::SpanParams &params, TinyGL::SpanState &state, int count, const uint32 *texels) {
+		unsigned int *zbuf = fb.getZBuffer();
+		for (int i = 0; i < count; i++) {
+			if (fb.compareDepth(state.z, zbuf[i])) {
+				byte a = state.a >> (ZB_POINT_ALPHA_BITS - 8);
+				byte r = state.r >> (ZB_POINT_RED_BITS - 8);
+				byte g = state.g >> (ZB_POINT_GREEN_BITS - 8);
+				byte b = state.b >> (ZB_POINT_BLUE_BITS - 8);
+				if (texels) {
+					byte c_a = texels[i] >> 24, c_r = texels[i] >> 16, c_g = texels[i] >> 8, c_b = texels[i];
+					if (params.modulate) {
+						c_a = (c_a * (state.a >> (ZB_POINT_ALPHA_BITS - 8))) >> (ZB_POINT_ALPHA_BITS - 8);
+						c_r = (c_r * (state.r >> (ZB_POINT_RED_BITS - 8))) >> (ZB_POINT_RED_BITS - 8);
+						c_g = (c_g * (state.g >> (ZB_POINT_GREEN_BITS - 8))) >> (ZB_POINT_GREEN_BITS - 8);
+						c_b = (c_b * (state.b >> (ZB_POINT_BLUE_BITS - 8))) >> (ZB_POINT_BLUE_BITS - 8);
+					}
+					a = c_a;
+					r = c_r;
+					g = c_g;
+					b = c_b;
+				}
+				if (params.depthWrite && (!params.alphaTest || fb.checkAlphaTest(a)))
+					zbuf[i] = state.z;
+				fb.writePixel(i, a, r, g, b);
+			}
+			state.z += state.dzdx;
+			state.r += state.drdx;
+			state.g += state.dgdx;
+			state.b += state.dbdx;
+			state.a += state.dadx;
+		}
+	}
+
+	void checkSpan(const Kernels &kernels, const Graphics::PixelFormat &format, int texelMode) {
+		TinyGL::FrameBuffer expected(kMaxWidth, 1, format);
+		TinyGL::FrameBuffer fb(kMaxWidth, 1, format);
+
+		TinyGL::SpanParams params = TinyGL::SpanParams();
+		params.aShift = format.aShift;
+		params.rShift = format.rShift;
+		params.gShift = format.gShift;
+		params.bShift = format.bShift;
+		params.hasAlpha = format.aLoss == 0;
+		params.modulate = texelMode == 2;
+		setRandomState(expected, fb, params);
+
+		uint32 *pixels = (uint32 *)fb.getPixelBuffer();
+		unsigned int *zbuf = fb.getZBuffer();
+		uint32 texels[kMaxWidth];
+		for (int i = 0; i < kMaxWidth; i++) {
+			pixels[i] = nextRandom32();
+			zbuf[i] = nextRandom32();
+			texels[i] = nextRandom32();
+		}
+		memcpy(expected.getPixelBuffer(), pixels, kMaxWidth * 4);
+		memcpy(expected.getZBuffer(), zbuf, kMaxWidth * 4);
+
+		TinyGL::SpanState span;
+		span.z = nextRandom32();
+		span.dzdx = (int)nextRandom32() >> (nextRandom() % 24);
+		// Sometimes start at the depth of the first pixel, for TGL_EQUAL and
+		// the other tests which pass on equal values
+		if (nextRandom() % 4 == 0)
+			span.z = zbuf[0];
+		span.r = nextRandom32() >> 8;
+		span.g = nextRandom32() >> 8;
+		span.b = nextRandom32() >> 8;
+		span.a = nextRandom32() >> 8;
+		span.drdx = (int)nextRandom32() >> 20;
+		span.dgdx = (int)nextRandom32() >> 20;
+		span.dbdx = (int)nextRandom32() >> 20;
+		span.dadx = (int)nextRandom32() >> 20;
+		TinyGL::SpanState expectedSpan = span;
+
+		const int count = 1 + nextRandom() % kMaxWidth;
+		const uint32 *spanTexels = texelMode != 0 ? texels : nullptr;
+		const int done = kernels.kernels->drawSpan(params, span, pixels, zbuf, count, spanTexels);
+		TSM_ASSERT(kernels.name, done >= 0 && done <= count && done % 4 == 0);
+		if (count >= 4)
+			TSM_ASSERT(kernels.name, done > 0);
+
+		drawReference(expected, params, expectedSpan, done, spanTexels);
+
+		// Pixels the kernel left over must be untouched
+		TSM_ASSERT_SAME_DATA(kernels.name, pixels, expected.getPixelBuffer(), kMaxWidth * 4);
+		TSM_ASSERT_SAME_DATA(kernels.name, zbuf, expected.getZBuffer(), kMaxWidth * 4);
+
+		TSM_ASSERT_EQUALS(kernels.name, span.z, expectedSpan.z);
+		TSM_ASSERT_EQUALS(kernels.name, span.r, expectedSpan.r);
+		TSM_ASSERT_EQUALS(kernels.name, span.g, expectedSpan.g);
+		TSM_ASSERT_EQUALS(kernels.name, span.b, expectedSpan.b);
+		TSM_ASSERT_EQUALS(kernels.name, span.a, expectedSpan.a);
+	}
+
+	void randomPoint(TinyGL::ZBufferPoint &p) {
+		p = TinyGL::ZBufferPoint();
+		p.x = nextRandom() % kTriangleWidth;
+		p.y = nextRandom() % kTriangleHeight;
+		p.z = nextRandom() << 8;
+		p.r = nextRandom() % (ZB_POINT_RED_MAX + 1);
+		p.g = nextRandom() % (ZB_POINT_GREEN_MAX + 1);
+		p.b = nextRandom() % (ZB_POINT_BLUE_MAX + 1);
+		p.a = nextRandom() % (ZB_POINT_ALPHA_MAX + 1);
+	}
+#endif
+
+public:
+	void test_kernels_match_scalar_code() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_TINYGL)
+		Common::install_null_g_system();
+		_seed = 1;
+
+		const Common::Array<Kernels> kernels = getKernels();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint f = 0; f < formats.size(); f++) {
+				// Interpolated colors, texels, and texels modulated by the colors
+				for (int texelMode = 0; texelMode < 3; texelMode++) {
+					for (int i = 0; i < kStates; i++)
+						checkSpan(kernels[k], formats[f], texelMode);
+				}
+			}
+		}
+#endif
+	}
+
+	void test_scissored_triangles_match_unscissored() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_TINYGL)
+		Common::install_null_g_system();
+		_seed = 2;
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 0, 16, 8, 0, 0);
+		const int size = kTriangleWidth * kTriangleHeight * 4;
+
+		for (int i = 0; i < 200; i++) {
+			TinyGL::FrameBuffer full(kTriangleWidth, kTriangleHeight, format);
+			TinyGL::FrameBuffer clipped(kTriangleWidth, kTriangleHeight, format);
+			for (int j = 0; j < kTriangleWidth * kTriangleHeight; j++) {
+				((uint32 *)full.getPixelBuffer())[j] = ((uint32 *)clipped.getPixelBuffer())[j] = nextRandom32();
+				full.getZBuffer()[j] = clipped.getZBuffer()[j] = nextRandom() << 8;
+			}
+			Common::Array<byte> initialPixels(size);
+			memcpy(&initialPixels[0], clipped.getPixelBuffer(), size);
+
+			// The scissor rectangle never spans the whole width, so every
+			// pixel is tested against it
+			const int left = 1 + nextRandom() % (kTriangleWidth / 2), top = nextRandom() % (kTriangleHeight / 2);
+			const Common::Rect rect(left, top, left + 1 + nextRandom() % (kTriangleWidth - left - 1), top + 1 + nextRandom() % (kTriangleHeight - top));
+			clipped.setScissorRectangle(rect);
+
+			full.enableDepthTest(true);
+			clipped.enableDepthTest(true);
+
+			TinyGL::ZBufferPoint points[3];
+			for (int p = 0; p < 3; p++)
+				randomPoint(points[p]);
+
+			TinyGL::ZBufferPoint p0 = points[0], p1 = points[1], p2 = points[2];
+			TinyGL::ZBufferPoint q0 = points[0], q1 = points[1], q2 = points[2];
+			if (i % 2) {
+				full.fillTriangleSmooth(&p0, &p1, &p2);
+				clipped.fillTriangleSmooth(&q0, &q1, &q2);
+			} else {
+				full.fillTriangleFlat(&p0, &p1, &p2);
+				clipped.fillTriangleFlat(&q0, &q1, &q2);
+			}
+
+			const uint32 *fullPixels = (const uint32 *)full.getPixelBuffer();
+			const uint32 *clippedPixels = (const uint32 *)clipped.getPixelBuffer();
+			for (int y = 0; y < kTriangleHeight; y++) {
+				for (int x = 0; x < kTriangleWidth; x++) {
+					const int j = y * kTriangleWidth + x;
+					if (rect.contains(x, y)) {
+						TS_ASSERT_EQUALS(clippedPixels[j], fullPixels[j]);
+						TS_ASSERT_EQUALS(clipped.getZBuffer()[j], full.getZBuffer()[j]);
+					} else {
+						TS_ASSERT_EQUALS(clippedPixels[j], ((const uint32 *)&initialPixels[0])[j]);
+					}
+				}
+			}
+		}
+#endif
+	}
+};
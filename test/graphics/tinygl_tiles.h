@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zblit.h"
+#include "graphics/tinygl/zbuffer.h"
+#include "graphics/tinygl/zgl.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class TinyGLTilesTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_TINYGL
+private:
+	enum {
+		kWidth = 96,
+		kHeight = 80,
+		kFrames = 3,
+		kTriangles = 24
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/** A random float in the range -range to range. */
+	float randomFloat(float range) {
+		return ((float)(nextRandom() % 20001) / 10000.0f - 1.0f) * range;
+	}
+
+	void drawRandomPrimitive() {
+		if (nextRandom() % 2)
+			tglEnable(TGL_DEPTH_TEST);
+		else
+			tglDisable(TGL_DEPTH_TEST);
+		if (nextRandom() % 3 == 0) {
+			tglEnable(TGL_BLEND);
+			tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		} else {
+			tglDisable(TGL_BLEND);
+		}
+		tglShadeModel(nextRandom() % 2 ? TGL_SMOOTH : TGL_FLAT);
+		tglPolygonMode(TGL_FRONT_AND_BACK, nextRandom() % 4 == 0 ? TGL_LINE : TGL_FILL);
+
+		const bool quad = nextRandom() % 3 == 0;
+		tglBegin(quad ? TGL_QUADS : TGL_TRIANGLES);
+		for (int i = 0; i < (quad ? 4 : 3); i++) {
+			tglColor4f((nextRandom() % 256) / 255.0f, (nextRandom() % 256) / 255.0f,
+			           (nextRandom() % 256) / 255.0f, (nextRandom() % 256) / 255.0f);
+			// Some of the vertices are outside of the screen
+			tglVertex3f(randomFloat(1.2f), randomFloat(1.2f), randomFloat(0.9f));
+		}
+		tglEnd();
+	}
+
+	/**
+	 * Render the same frames with @p threads rasterizer threads, and return
+	 * the pixels and the depth buffer of each frame.
+	 */
+	Common::Array<byte> render(int threads, bool dirtyRects) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::FrameBuffer *fb = new TinyGL::FrameBuffer(kWidth, kHeight, format);
+		TinyGL::glInit(fb, 256);
+		tglEnableDirtyRects(dirtyRects);
+		TinyGL::gl_get_context()->_rasterizerThreads = threads;
+
+		Graphics::Surface surface;
+		surface.create(12, 10, format);
+		_seed = 7;
+		for (int y = 0; y < surface.h; y++) {
+			for (int x = 0; x < surface.w; x++)
+				*(uint32 *)surface.getBasePtr(x, y) = nextRandom() * 65537;
+		}
+		Graphics::BlitImage *image = Graphics::tglGenBlitImage();
+		Graphics::tglUploadBlitImage(image, surface, 0, false);
+		surface.free();
+
+		Common::Array<byte> result;
+		const int pixelSize = kWidth * kHeight * format.bytesPerPixel;
+		const int zSize = kWidth * kHeight * sizeof(uint);
+		for (int frame = 0; frame < kFrames; frame++) {
+			tglClearColor(0.25f, 0.5f, 0.75f, 1.0f);
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+			// The first half of the scene stays the same from one frame to
+			// the next, so that only parts of the screen are redrawn
+			_seed = 11;
+			for (int i = 0; i < kTriangles / 2; i++)
+				drawRandomPrimitive();
+
+			Graphics::BlitTransform transform(frame * 7, 20 + frame * 9);
+			transform.scale(30, 15);
+			Graphics::tglBlit(image, transform);
+
+			_seed = 100 + frame;
+			for (int i = kTriangles / 2; i < kTriangles; i++)
+				drawRandomPrimitive();
+
+			TinyGL::tglPresentBuffer();
+
+			const uint oldSize = result.size();
+			result.resize(oldSize + pixelSize + zSize);
+			memcpy(&result[oldSize], fb->getPixelBuffer(), pixelSize);
+			memcpy(&result[oldSize + pixelSize], fb->getZBuffer(), zSize);
+		}
+
+		Graphics::tglDeleteBlitImage(image);
+		TinyGL::glClose();
+		delete fb;
+		return result;
+	}
+#endif
+
+public:
+	void test_tiles_match_sequential_drawing() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++) {
+			const Common::Array<byte> expected = render(1, dirtyRects);
+			for (int threads = 2; threads <= 5; threads += 3) {
+				const Common::Array<byte> tiled = render(threads, dirtyRects);
+				TS_ASSERT_EQUALS(tiled.size(), expected.size());
+				TS_ASSERT_EQUALS(memcmp(&tiled[0], &expected[0], expected.size()), 0);
+			}
+		}
+#endif
+	}
+};
@@ -0,0 +1,244 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixelformat.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zbuffer.h"
+#include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zmath_intern.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class TinyGLTransformTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_TINYGL
+private:
+	enum {
+		kMaxCount = 11,
+		kGuard = 0x5A
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/** A random float in the range -range to range. */
+	float randomFloat(float range) {
+		return ((float)(nextRandom() % 20001) / 10000.0f - 1.0f) * range;
+	}
+
+	struct Kernels {
+		const char *name;
+		const TinyGL::TransformKernels *kernels;
+	};
+
+	/** The kernels which were compiled in and which the CPU supports. */
+	Common::Array<Kernels> getKernels() {
+		Common::Array<Kernels> kernels;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			Kernels entry = { "SSE2", &TinyGL::transformKernelsSSE2 };
+			kernels.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			Kernels entry = { "NEON", &TinyGL::transformKernelsNEON };
+			kernels.push_back(entry);
+		}
+#endif
+		return kernels;
+	}
+
+	TinyGL::Matrix4 randomMatrix() {
+		TinyGL::Matrix4 m;
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++)
+				m._m[i][j] = randomFloat(4.0f);
+		}
+		return m;
+	}
+
+	/**
+	 * Transform @p count random vectors @p stride bytes apart with the
+	 * kernel and with the Matrix4 method, and check that the results are the
+	 * same, and that the bytes between the vectors are left alone.
+	 */
+	void checkTransform(const Kernels &kernels, bool useW, int count, int stride) {
+		const TinyGL::Matrix4 m = randomMatrix();
+
+		// The output vectors are at an offset within the structures, as
+		// they are in GLVertex
+		const int outOffset = stride >= 2 * (int)sizeof(TinyGL::Vector4) ? (int)sizeof(TinyGL::Vector4) : 0;
+		Common::Array<byte> in(stride * kMaxCount), out(stride * kMaxCount), expected(stride * kMaxCount);
+		memset(&out[0], kGuard, out.size());
+		memset(&expected[0], kGuard, expected.size());
+
+		for (int i = 0; i < kMaxCount; i++) {
+			TinyGL::Vector4 v(randomFloat(100.0f), randomFloat(100.0f), randomFloat(100.0f), useW ? randomFloat(2.0f) : 1.0f);
+			memcpy(&in[i * stride], &v, sizeof(v));
+		}
+
+		for (int i = 0; i < count; i++) {
+			TinyGL::Vector4 v, result;
+			memcpy(&v, &in[i * stride], sizeof(v));
+			if (useW)
+				m.transform(v, result);
+			else
+				m.transform3x4(v, result);
+			memcpy(&expected[i * stride + outOffset], &result, sizeof(result));
+		}
+
+		const TinyGL::Vector4 *src = (const TinyGL::Vector4 *)&in[0];
+		TinyGL::Vector4 *dst = (TinyGL::Vector4 *)&out[outOffset];
+		if (useW)
+			kernels.kernels->transform(m, src, dst, count, stride);
+		else
+			kernels.kernels->transform3x4(m, src, dst, count, stride);
+
+		TSM_ASSERT_EQUALS(kernels.name, memcmp(&out[0], &expected[0], out.size()), 0);
+	}
+
+	TinyGL::FrameBuffer *_fb;
+
+	void createContext() {
+		_fb = new TinyGL::FrameBuffer(64, 64, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		TinyGL::glInit(_fb, 256);
+
+		// Otherwise draw calls with an empty dirty region are dropped as
+		// well, whether glEnd culled them or not
+		tglEnableDirtyRects(false);
+	}
+
+	void destroyContext() {
+		TinyGL::glClose();
+		delete _fb;
+	}
+
+	/** Draw a triangle with the given vertices, and return the number of draw calls queued for it. */
+	int drawTriangle(const float (*vertices)[3]) {
+		TinyGL::GLContext *c = TinyGL::gl_get_context();
+		const int queued = c->_drawCallsQueue.size();
+
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < 3; i++)
+			tglVertex3f(vertices[i][0], vertices[i][1], vertices[i][2]);
+		tglEnd();
+
+		return c->_drawCallsQueue.size() - queued;
+	}
+#endif
+
+public:
+	void test_kernels_match_matrix4() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Common::Array<Kernels> kernels = getKernels();
+		_seed = 1;
+
+		// Packed vectors, vectors in small structures and vectors in GLVertex
+		const int strides[] = { 16, 20, 32, 48, (int)sizeof(TinyGL::GLVertex) };
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint s = 0; s < ARRAYSIZE(strides); s++) {
+				for (int count = 0; count <= kMaxCount; count++) {
+					checkTransform(kernels[k], false, count, strides[s]);
+					checkTransform(kernels[k], true, count, strides[s]);
+				}
+			}
+		}
+#endif
+	}
+
+	void test_end_culls_outside_primitives() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// The matrices are the identity, so the coordinates are clip
+		// coordinates with W = 1
+		static const float visible[3][3] = { { -0.5f, -0.5f, 0 }, { 0.5f, -0.5f, 0 }, { 0, 0.5f, 0 } };
+		static const float right[3][3] = { { 1.5f, -0.5f, 0 }, { 2.5f, -0.5f, 0 }, { 2, 0.5f, 0 } };
+		static const float behind[3][3] = { { -0.5f, -0.5f, 2 }, { 0.5f, -0.5f, 3 }, { 0, 0.5f, 2 } };
+		// Outside of a different plane each, but partially visible
+		static const float crossing[3][3] = { { -2, -0.5f, 0 }, { 2, -0.5f, 0 }, { 0, 2, 0 } };
+
+		for (int lit = 0; lit < 2; lit++) {
+			createContext();
+			if (lit) {
+				tglEnable(TGL_LIGHTING);
+				tglEnable(TGL_LIGHT0);
+			}
+
+			TS_ASSERT_EQUALS(drawTriangle(visible), 1);
+			TS_ASSERT_EQUALS(drawTriangle(right), 0);
+			TS_ASSERT_EQUALS(drawTriangle(behind), 0);
+			TS_ASSERT_EQUALS(drawTriangle(crossing), 1);
+
+			// A batch is only dropped when all of its primitives are outside
+			tglBegin(TGL_TRIANGLES);
+			for (int i = 0; i < 3; i++)
+				tglVertex3f(right[i][0], right[i][1], right[i][2]);
+			for (int i = 0; i < 3; i++)
+				tglVertex3f(visible[i][0], visible[i][1], visible[i][2]);
+			const int queued = TinyGL::gl_get_context()->_drawCallsQueue.size();
+			tglEnd();
+			TS_ASSERT_EQUALS((int)TinyGL::gl_get_context()->_drawCallsQueue.size() - queued, 1);
+
+			destroyContext();
+		}
+#endif
+	}
+
+	void test_material_change_inside_begin_end() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		createContext();
+
+		tglEnable(TGL_LIGHTING);
+		tglEnable(TGL_LIGHT0);
+		tglNormal3f(0, 0, 1);
+
+		static const float red[4] = { 1, 0, 0, 1 };
+		static const float green[4] = { 0, 1, 0, 1 };
+		static const float vertices[6][3] = {
+			{ -0.5f, -0.5f, 0 }, { 0.5f, -0.5f, 0 }, { 0, 0.5f, 0 },
+			{ -0.5f, 0.5f, 0 }, { 0.5f, 0.5f, 0 }, { 0, -0.5f, 0 }
+		};
+
+		// The vertices given before the material changes are lit with the
+		// old material, the others with the new one
+		tglBegin(TGL_TRIANGLES);
+		tglMaterialfv(TGL_FRONT_AND_BACK, TGL_AMBIENT_AND_DIFFUSE, red);
+		for (int i = 0; i < 4; i++)
+			tglVertex3f(vertices[i][0], vertices[i][1], vertices[i][2]);
+		tglMaterialfv(TGL_FRONT_AND_BACK, TGL_AMBIENT_AND_DIFFUSE, green);
+		for (int i = 4; i < 6; i++)
+			tglVertex3f(vertices[i][0], vertices[i][1], vertices[i][2]);
+		tglEnd();
+
+		const TinyGL::GLContext *c = TinyGL::gl_get_context();
+		TS_ASSERT_EQUALS(c->vertex_n, 6);
+		for (int i = 0; i < 6; i++) {
+			const TinyGL::Vector4 &color = c->vertex[i].color;
+			if (i < 4) {
+				TS_ASSERT_LESS_THAN(0.5f, color.X);
+				TS_ASSERT_EQUALS(color.Y, 0.0f);
+			} else {
+				TS_ASSERT_EQUALS(color.X, 0.0f);
+				TS_ASSERT_LESS_THAN(0.5f, color.Y);
+			}
+			TS_ASSERT_EQUALS(color.Z, 0.0f);
+		}
+
+		destroyContext();
+#endif
+	}
+};
@@ -0,0 +1,353 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "common/array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxWidth = 68,
+		kHeight = 8
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+	/**
+	 * Random values, with the ones at the edges of the ITU luminance range
+	 * and of the chroma range showing up more often.
+	 */
+	void fillPlane(byte *data, uint size) {
+		static const byte edges[] = { 0, 1, 15, 16, 17, 127, 128, 129, 234, 235, 236, 254, 255 };
+		for (uint i = 0; i < size; i++) {
+			if (nextRandom() & 1)
+				data[i] = edges[nextRandom() % ARRAYSIZE(edges)];
+			else
+				data[i] = nextRandom() & 0xFF;
+		}
+	}
+
+	/**
+	 * The lookup tables of YUVToRGBManager, set up the same way, to convert
+	 * pixel by pixel.
+	 */
+	class Reference {
+	public:
+		Reference(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
+			const int alphaValue = alphaMode ? 0 : 255;
+
+			for (int i = 0; i < 768; i++) {
+				int value;
+				if (scale == Graphics::YUVToRGBManager::kScaleFull)
+					value = CLIP(i - 256, 0, 255);
+				else
+					value = (CLIP(i - 256, 16, 235) - 16) * 255 / 219;
+
+				_rgbToPix[0 * 768 + i] = format.ARGBToColor(alphaValue, value, 0, 0);
+				_rgbToPix[1 * 768 + i] = format.ARGBToColor(alphaValue, 0, value, 0);
+				_rgbToPix[2 * 768 + i] = format.ARGBToColor(alphaValue, 0, 0, value);
+			}
+
+			for (int i = 0; i < 256; i++) {
+				_alphaToPix[i] = format.ARGBToColor(i, 0, 0, 0);
+
+				int16 CR = (i - 128), CB = CR;
+				_crRTab[i] = (int16) ( (0.419 / 0.299) * CR) + 0 * 768 + 256;
+				_crGTab[i] = (int16) (-(0.299 / 0.419) * CR) + 1 * 768 + 256;
+				_cbGTab[i] = (int16) (-(0.114 / 0.331) * CB);
+				_cbBTab[i] = (int16) ( (0.587 / 0.331) * CB) + 2 * 768 + 256;
+			}
+		}
+
+		uint32 convert(byte y, byte u, byte v) const {
+			const uint32 *L = &_rgbToPix[y];
+			return L[_crRTab[v]] | L[_crGTab[v] + _cbGTab[u]] | L[_cbBTab[u]];
+		}
+
+		uint32 convert(byte y, byte u, byte v, byte a) const {
+			return convert(y, u, v) | _alphaToPix[a];
+		}
+
+	private:
+		uint32 _rgbToPix[3 * 768];
+		uint32 _alphaToPix[256];
+		int16 _crRTab[256], _crGTab[256], _cbGTab[256], _cbBTab[256];
+	};
+
+	static void writePixel(byte *dst, uint bytesPerPixel, uint32 color) {
+		if (bytesPerPixel == 2)
+			*(uint16 *)dst = color;
+		else
+			*(uint32 *)dst = color;
+	}
+
+	Common::Array<Graphics::PixelFormat> getFormats() {
+		Common::Array<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));   // RGB565
+		formats.push_back(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15));  // ARGB1555
+		formats.push_back(Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0));   // RGBA4444
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));  // RGBA8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));  // ARGB8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));  // ABGR8888
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));   // XRGB8888
+		// Green straddles both halves of the pixel, which the kernels do
+		// not handle
+		formats.push_back(Graphics::PixelFormat(4, 8, 8, 8, 0, 20, 12, 4, 0));
+		return formats;
+	}
+
+	struct Kernels {
+		const char *name;
+		const Graphics::YUVToRGBKernels *kernels;
+	};
+
+	/** The kernels which were compiled in and which the CPU supports. */
+	Common::Array<Kernels> getKernels() {
+		Common::Array<Kernels> kernels;
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			Kernels entry = { "SSE2", &Graphics::yuvToRGBKernelsSSE2 };
+			kernels.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			Kernels entry = { "AVX2", &Graphics::yuvToRGBKernelsAVX2 };
+			kernels.push_back(entry);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			Kernels entry = { "NEON", &Graphics::yuvToRGBKernelsNEON };
+			kernels.push_back(entry);
+		}
+#endif
+		return kernels;
+	}
+
+	/** The planes of a YUV image, with room for any of the subsamplings. */
+	struct Planes {
+		byte y[kMaxWidth * kHeight];
+		byte a[kMaxWidth * kHeight];
+		// One extra row and column, which YUV410 reads from
+		byte u[(kMaxWidth + 1) * (kHeight + 1)];
+		byte v[(kMaxWidth + 1) * (kHeight + 1)];
+	};
+
+	void fillPlanes(Planes &planes) {
+		fillPlane(planes.y, sizeof(planes.y));
+		fillPlane(planes.a, sizeof(planes.a));
+		fillPlane(planes.u, sizeof(planes.u));
+		fillPlane(planes.v, sizeof(planes.v));
+	}
+
+	enum Subsampling {
+		k444,
+		k420,
+		k420Alpha,
+		k410
+	};
+
+	/** Convert the planes with YUVToRGBManager, and pixel by pixel. */
+	void checkConversion(Subsampling subsampling, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		const int yPitch = kMaxWidth;
+		const int uvPitch = kMaxWidth + 1;
+
+		Planes planes;
+		fillPlanes(planes);
+
+		Graphics::Surface dst;
+		dst.create(width, height, format);
+		Graphics::Surface expected;
+		expected.create(width, height, format);
+
+		const Reference reference(format, scale, subsampling == k420Alpha);
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				const byte luma = planes.y[y * yPitch + x];
+				uint32 color = 0;
+
+				switch (subsampling) {
+				case k444:
+					color = reference.convert(luma, planes.u[y * uvPitch + x], planes.v[y * uvPitch + x]);
+					break;
+				case k420:
+					color = reference.convert(luma, planes.u[(y >> 1) * uvPitch + (x >> 1)], planes.v[(y >> 1) * uvPitch + (x >> 1)]);
+					break;
+				case k420Alpha:
+					color = reference.convert(luma, planes.u[(y >> 1) * uvPitch + (x >> 1)], planes.v[(y >> 1) * uvPitch + (x >> 1)],
+					                          planes.a[y * yPitch + x]);
+					break;
+				case k410: {
+					// Bilinear interpolation between the four surrounding
+					// chroma values
+					const int index = (y >> 2) * uvPitch + (x >> 2);
+					const int xDiff = x & 3;
+					const int yDiff = y & 3;
+					const byte *uvs[2] = { planes.u, planes.v };
+					byte uv[2];
+					for (int i = 0; i < 2; i++) {
+						const byte *p = uvs[i];
+						uv[i] = (p[index] * (4 - xDiff) * (4 - yDiff) + p[index + 1] * xDiff * (4 - yDiff) +
+						         p[index + uvPitch] * yDiff * (4 - xDiff) + p[index + uvPitch + 1] * xDiff * yDiff) >> 4;
+					}
+					color = reference.convert(luma, uv[0], uv[1]);
+					break;
+				}
+				}
+
+				writePixel((byte *)expected.getBasePtr(x, y), format.bytesPerPixel, color);
+			}
+		}
+
+		switch (subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, planes.y, planes.u, planes.v, width, height, yPitch, uvPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, planes.y, planes.u, planes.v, width, height, yPitch, uvPitch);
+			break;
+		case k420Alpha:
+			YUVToRGBMan.convert420Alpha(&dst, scale, planes.y, planes.u, planes.v, planes.a, width, height, yPitch, uvPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, planes.y, planes.u, planes.v, width, height, yPitch, uvPitch);
+			break;
+		}
+
+		for (int y = 0; y < height; y++)
+			TS_ASSERT_SAME_DATA(dst.getBasePtr(0, y), expected.getBasePtr(0, y), width * format.bytesPerPixel);
+
+		dst.free();
+		expected.free();
+	}
+
+	void checkConversions(Subsampling subsampling, int widthStep) {
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU
+		};
+
+		for (uint i = 0; i < formats.size(); i++) {
+			for (uint s = 0; s < ARRAYSIZE(scales); s++) {
+				for (int width = widthStep; width <= kMaxWidth; width += widthStep)
+					checkConversion(subsampling, formats[i], scales[s], width, kHeight);
+			}
+		}
+	}
+
+public:
+	void test_convert444() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 1;
+		checkConversions(k444, 1);
+#endif
+	}
+
+	void test_convert420() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 2;
+		checkConversions(k420, 2);
+#endif
+	}
+
+	void test_convert420_alpha() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 3;
+		checkConversions(k420Alpha, 2);
+#endif
+	}
+
+	void test_convert410() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 4;
+		checkConversions(k410, 4);
+#endif
+	}
+
+	void test_kernels_match_scalar_code() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		_seed = 5;
+
+		const Common::Array<Kernels> kernels = getKernels();
+		const Common::Array<Graphics::PixelFormat> formats = getFormats();
+
+		for (uint k = 0; k < kernels.size(); k++) {
+			for (uint i = 0; i < formats.size(); i++) {
+				const Graphics::PixelFormat &format = formats[i];
+				const uint bpp = format.bytesPerPixel;
+
+				for (int itu = 0; itu < 2; itu++) {
+					for (int alpha = 0; alpha < 2; alpha++) {
+						Graphics::YUVToRGBPlan plan;
+						plan.init(format, itu != 0, alpha != 0);
+						if (!plan.supported)
+							continue;
+
+						const Reference reference(format, itu ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull, alpha != 0);
+
+						for (uint width = 2; width <= kMaxWidth; width += 2) {
+							Planes planes;
+							fillPlanes(planes);
+							const byte *aSrc0 = alpha ? planes.a : 0;
+							const byte *aSrc1 = alpha ? planes.a + kMaxWidth : 0;
+
+							// The kernels must not write past the pixels they report
+							byte dst0[kMaxWidth * 4], dst1[kMaxWidth * 4];
+							byte expected0[kMaxWidth * 4], expected1[kMaxWidth * 4];
+							memset(dst0, 0xCD, sizeof(dst0));
+							memset(dst1, 0xCD, sizeof(dst1));
+							memcpy(expected0, dst0, sizeof(dst0));
+							memcpy(expected1, dst1, sizeof(dst1));
+
+							// YUV444, with the alpha plane if there is one
+							uint done = kernels[k].kernels->convert444Row(dst0, planes.y, planes.u, planes.v, aSrc0, width, plan);
+							TSM_ASSERT(kernels[k].name, done <= width);
+							if (width >= 32)
+								TSM_ASSERT(kernels[k].name, done > 0);
+							for (uint x = 0; x < done; x++) {
+								const uint32 color = alpha ? reference.convert(planes.y[x], planes.u[x], planes.v[x], planes.a[x])
+								                           : reference.convert(planes.y[x], planes.u[x], planes.v[x]);
+								writePixel(expected0 + x * bpp, bpp, color);
+							}
+							TSM_ASSERT_SAME_DATA(kernels[k].name, dst0, expected0, sizeof(dst0));
+
+							// YUV420, two rows sharing their chroma values
+							memset(dst0, 0xCD, sizeof(dst0));
+							memcpy(expected0, dst0, sizeof(dst0));
+							done = kernels[k].kernels->convert420Rows(dst0, dst1, planes.y, planes.y + kMaxWidth, planes.u, planes.v,
+							                                          aSrc0, aSrc1, width, plan);
+							TSM_ASSERT(kernels[k].name, done <= width);
+							for (uint x = 0; x < done; x++) {
+								const byte u = planes.u[x >> 1], v = planes.v[x >> 1];
+								const byte y0 = planes.y[x], y1 = planes.y[kMaxWidth + x];
+								const byte a0 = planes.a[x], a1 = planes.a[kMaxWidth + x];
+								writePixel(expected0 + x * bpp, bpp, alpha ? reference.convert(y0, u, v, a0) : reference.convert(y0, u, v));
+								writePixel(expected1 + x * bpp, bpp, alpha ? reference.convert(y1, u, v, a1) : reference.convert(y1, u, v));
+							}
+							TSM_ASSERT_SAME_DATA(kernels[k].name, dst0, expected0, sizeof(dst0));
+							TSM_ASSERT_SAME_DATA(kernels[k].name, dst1, expected1, sizeof(dst1));
+						}
+					}
+				}
+			}
+		}
+#endif
+	}
+};
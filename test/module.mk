@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/math/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -27,7 +27,7 @@ TEST_LIBS += test/null_osystem.o \
 	backends/modular-backend.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a
+TEST_LIBS +=	graphics/libgraphics.a audio/libaudio.a math/libmath.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -75,10 +75,26 @@ test/runner.cpp: $(TESTS)
 clean: clean-test
 clean-test:
 	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat
+	-$(RM) test/bench $(BENCH_OBJS)
 	-rmdir test/engine-data
 
 copy-dat:
 	$(MKDIR) test/engine-data
 	$(CP) $(srcdir)/dists/engine-data/encoding.dat test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+######################################################################
+# Benchmarks of performance critical code.
+# Use the 'bench' target to run them, e.g. make bench BENCH_ARGS=--help
+######################################################################
+
+BENCH_OBJS := test/benchmark/main.o \
+	test/benchmark/audio_mixer.o \
+	test/benchmark/graphics_blit.o
+BENCH_LIBS := $(TEST_LIBS)
+
+bench: test/bench
+	./test/bench $(BENCH_ARGS)
+test/bench: $(BENCH_OBJS) $(BENCH_LIBS)
+	+$(QUIET_LINK)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) -o $@ $(BENCH_OBJS) $(BENCH_LIBS) $(TEST_LDFLAGS)
+
+.PHONY: test clean-test copy-dat bench